@@ -0,0 +1,84 @@
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <vector>
+
+#include "dali/kernels/signal/resampling.h"
+
+namespace dali {
+
+using kernels::signal::resampling::Resampler;
+using kernels::signal::resampling::resampled_length;
+
+class ResamplingFixture : public benchmark::Fixture {
+ public:
+  void SetUp(benchmark::State& st) override {
+    in_rate_ = st.range(0);
+    out_rate_ = st.range(1);
+    channels_ = st.range(2);
+    n_in_ = in_rate_;  // 1 second of audio
+    n_out_ = resampled_length(n_in_, in_rate_, out_rate_);
+    in_.resize(n_in_ * channels_);
+    out_.resize(n_out_ * channels_);
+    for (int64_t i = 0; i < n_in_ * channels_; i++)
+      in_[i] = std::sin(i * 0.1f);
+    resampler_.Initialize(16);
+  }
+
+  void TearDown(benchmark::State& st) override {
+    st.SetItemsProcessed(st.iterations() * n_out_ * channels_);
+  }
+
+  std::vector<float> in_, out_;
+  int64_t n_in_ = 0, n_out_ = 0;
+  double in_rate_ = 0, out_rate_ = 0;
+  int channels_ = 1;
+  Resampler resampler_;
+};
+
+static void ResamplingArgs(benchmark::internal::Benchmark* b) {
+  for (int channels : {1, 2}) {
+    b->Args({44100, 16000, channels});
+    b->Args({48000, 16000, channels});
+    b->Args({16000, 44100, channels});
+  }
+}
+
+BENCHMARK_DEFINE_F(ResamplingFixture, Windowed)(benchmark::State& st) {
+  for (auto _ : st) {
+    if (channels_ == 1)
+      resampler_.ResampleWindowed(out_.data(), 0, n_out_, out_rate_, in_.data(), n_in_, in_rate_);
+    else
+      resampler_.ResampleWindowed<-1>(out_.data(), 0, n_out_, out_rate_,
+                                      in_.data(), n_in_, in_rate_, channels_);
+    benchmark::DoNotOptimize(out_.data());
+    benchmark::ClobberMemory();
+  }
+}
+
+BENCHMARK_DEFINE_F(ResamplingFixture, Polyphase)(benchmark::State& st) {
+  for (auto _ : st) {
+    resampler_.Resample(out_.data(), 0, n_out_, out_rate_, in_.data(), n_in_, in_rate_,
+                        channels_);
+    benchmark::DoNotOptimize(out_.data());
+    benchmark::ClobberMemory();
+  }
+}
+
+BENCHMARK_REGISTER_F(ResamplingFixture, Windowed)->Apply(ResamplingArgs);
+BENCHMARK_REGISTER_F(ResamplingFixture, Polyphase)->Apply(ResamplingArgs);
+
+}  // namespace dali
@@ -543,6 +543,31 @@ void daliGetReaderMetadata(daliPipelineHandle* pipe_handle, const char *reader_n
   meta->stick_to_shard = returned_meta.stick_to_shard;
 }
 
+void daliGetReaderState(daliPipelineHandle* pipe_handle, const char *reader_name,
+                        daliReaderState* state) {
+  DALI_ENFORCE(state, "Provided pointer to state cannot be NULL.");
+  dali::Pipeline* pipeline = reinterpret_cast<dali::Pipeline*>(pipe_handle->pipe);
+  dali::ReaderState returned_state = pipeline->GetReaderState(reader_name);
+  state->consumed_samples = returned_state.consumed_samples;
+  state->epoch_size = returned_state.epoch_size;
+  state->seed = returned_state.seed;
+  state->number_of_shards = returned_state.number_of_shards;
+  state->shard_id = returned_state.shard_id;
+}
+
+void daliRestoreReaderState(daliPipelineHandle* pipe_handle, const char *reader_name,
+                            const daliReaderState* state) {
+  DALI_ENFORCE(state, "Provided pointer to state cannot be NULL.");
+  dali::Pipeline* pipeline = reinterpret_cast<dali::Pipeline*>(pipe_handle->pipe);
+  dali::ReaderState restored_state;
+  restored_state.consumed_samples = state->consumed_samples;
+  restored_state.epoch_size = state->epoch_size;
+  restored_state.seed = state->seed;
+  restored_state.number_of_shards = state->number_of_shards;
+  restored_state.shard_id = state->shard_id;
+  pipeline->RestoreReaderState(reader_name, restored_state);
+}
+
 void daliGetExecutorMetadata(daliPipelineHandle* pipe_handle, daliExecutorMetadata **operator_meta,
                              size_t *operator_meta_num) {
   dali::Pipeline* pipeline = reinterpret_cast<dali::Pipeline*>(pipe_handle->pipe);
@@ -745,4 +745,71 @@ TYPED_TEST(CApiTest, CpuOnlyTest) {
   daliDeserializeDefault(&handle, ser.c_str(), ser.size());
 }
 
+namespace {
+
+std::string GetReaderPipeline() {
+  Pipeline pipe(batch_size, num_thread, device_id, seed, pipelined, prefetch_queue_depth, async);
+  std::string file_root = testing::dali_extra_path() + "/db/single/jpeg/";
+  pipe.AddOperator(OpSpec("FileReader")
+                       .AddArg("device", "cpu")
+                       .AddArg("file_root", file_root)
+                       .AddArg("file_list", file_root + "image_list.txt")
+                       .AddArg("random_shuffle", true)
+                       .AddArg("initial_fill", 16)
+                       .AddOutput("compressed_images", "cpu")
+                       .AddOutput("labels", "cpu"), "Reader");
+  pipe.SetOutputNames({{"labels", "cpu"}});
+  return pipe.SerializeToProtobuf();
+}
+
+std::vector<int> GetLabels(daliPipelineHandle *handle) {
+  daliShareOutput(handle);
+  std::vector<int> labels(batch_size);
+  daliOutputCopy(handle, labels.data(), 0, CPU, 0, DALI_ext_default);
+  daliOutputRelease(handle);
+  return labels;
+}
+
+}  // namespace
+
+TEST(CApiReaderStateTest, CountsReturnedBatches) {
+  static_assert(prefetch_queue_depth > 1, "The test needs the executor to prefetch the batches");
+  auto serialized = GetReaderPipeline();
+  daliPipelineHandle handle;
+  daliCreatePipeline(&handle, serialized.c_str(), serialized.size(), batch_size, num_thread,
+                     device_id, false, prefetch_queue_depth, prefetch_queue_depth,
+                     prefetch_queue_depth, false);
+  daliPrefetchUniform(&handle, prefetch_queue_depth);
+
+  // the reader has already run prefetch_queue_depth times, but nothing has been returned yet
+  daliReaderState state;
+  daliGetReaderState(&handle, "Reader", &state);
+  EXPECT_EQ(state.consumed_samples, 0);
+
+  const int returned = 3;
+  for (int i = 0; i < returned; i++) {
+    GetLabels(&handle);
+    daliRun(&handle);
+    daliGetReaderState(&handle, "Reader", &state);
+    EXPECT_EQ(state.consumed_samples, (i + 1) * batch_size);
+  }
+  std::vector<std::vector<int>> expected;
+  for (int i = 0; i < prefetch_queue_depth; i++)
+    expected.push_back(GetLabels(&handle));
+  daliDeletePipeline(&handle);
+
+  // a pipeline restored from the state continues right after the returned batches
+  daliPipelineHandle restored;
+  daliCreatePipeline(&restored, serialized.c_str(), serialized.size(), batch_size, num_thread,
+                     device_id, false, prefetch_queue_depth, prefetch_queue_depth,
+                     prefetch_queue_depth, false);
+  daliRestoreReaderState(&restored, "Reader", &state);
+  daliPrefetchUniform(&restored, prefetch_queue_depth);
+  for (int i = 0; i < prefetch_queue_depth; i++)
+    EXPECT_EQ(GetLabels(&restored), expected[i]);
+  daliGetReaderState(&restored, "Reader", &state);
+  EXPECT_EQ(state.consumed_samples, (returned + prefetch_queue_depth) * batch_size);
+  daliDeletePipeline(&restored);
+}
+
 }  // namespace dali
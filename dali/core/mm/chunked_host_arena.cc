@@ -0,0 +1,50 @@
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/core/mm/chunked_host_arena.h"
+#include "dali/core/error_handling.h"
+#include "dali/core/mm/detail/align.h"
+
+namespace dali {
+namespace mm {
+
+constexpr int64_t chunked_host_arena::kDefaultChunkSize;
+constexpr int64_t chunked_host_arena::kAlignment;
+
+chunked_host_arena::chunked_host_arena(int64_t chunk_size) : chunk_size_(chunk_size) {
+  DALI_ENFORCE(chunk_size > 0, "The chunk size must be positive");
+}
+
+std::shared_ptr<uint8_t> chunked_host_arena::allocate_block(int64_t size) {
+  std::shared_ptr<uint8_t> block(new uint8_t[size + kAlignment - 1],
+                                 std::default_delete<uint8_t[]>());
+  return std::shared_ptr<uint8_t>(block, detail::align_ptr(block.get(), kAlignment));
+}
+
+std::shared_ptr<uint8_t> chunked_host_arena::allocate(int64_t size) {
+  DALI_ENFORCE(size >= 0, "The size of an allocation cannot be negative");
+  if (size > chunk_size_ / 4)
+    return allocate_block(size);
+
+  int64_t offset = align_up(chunk_used_, kAlignment);
+  if (!chunk_ || offset + size > chunk_size_) {
+    chunk_ = allocate_block(chunk_size_);
+    offset = 0;
+  }
+  chunk_used_ = offset + size;
+  return std::shared_ptr<uint8_t>(chunk_, chunk_.get() + offset);
+}
+
+}  // namespace mm
+}  // namespace dali
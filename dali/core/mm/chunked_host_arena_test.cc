@@ -0,0 +1,77 @@
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "dali/core/mm/chunked_host_arena.h"
+#include "dali/core/mm/detail/align.h"
+
+namespace dali {
+namespace mm {
+namespace test {
+
+TEST(MMTest, ChunkedHostArenaAlignment) {
+  chunked_host_arena arena(1024);
+  for (int64_t size : { 1, 0, 3, 64, 65, 100, 255, 256, 257, 1000 }) {
+    auto buf = arena.allocate(size);
+    ASSERT_NE(buf, nullptr);
+    EXPECT_TRUE(detail::is_aligned(buf.get(), chunked_host_arena::kAlignment));
+  }
+  EXPECT_TRUE(detail::is_aligned(chunked_host_arena::allocate_block(10).get(),
+                                 chunked_host_arena::kAlignment));
+}
+
+TEST(MMTest, ChunkedHostArenaChunks) {
+  chunked_host_arena arena(1024);
+  auto a = arena.allocate(100);
+  auto b = arena.allocate(100);
+  // small buffers are taken from the same chunk, one after another
+  EXPECT_EQ(b.get(), a.get() + 128);
+  EXPECT_EQ(a.use_count(), 3);  // a, b and the current chunk
+
+  // buffers larger than a quarter of the chunk get a block of their own
+  auto big = arena.allocate(257);
+  EXPECT_EQ(big.use_count(), 1);
+  auto c = arena.allocate(200);
+  EXPECT_EQ(c.get(), b.get() + 128);
+
+  // when the buffer doesn't fit, a new chunk is started
+  for (int i = 0; i < 3; i++)
+    arena.allocate(200);
+  auto d = arena.allocate(200);
+  EXPECT_EQ(d.use_count(), 2);
+  EXPECT_EQ(a.use_count(), 3);  // a, b, c share the old chunk
+}
+
+TEST(MMTest, ChunkedHostArenaOutlivesArena) {
+  std::shared_ptr<uint8_t> buf;
+  {
+    chunked_host_arena arena(1024);
+    buf = arena.allocate(100);
+    for (int i = 0; i < 100; i++)
+      buf.get()[i] = i;
+  }
+  for (int i = 0; i < 100; i++)
+    EXPECT_EQ(buf.get()[i], i);
+}
+
+TEST(MMTest, ChunkedHostArenaInvalidArgs) {
+  EXPECT_THROW(chunked_host_arena(0), std::exception);
+  chunked_host_arena arena(1024);
+  EXPECT_THROW(arena.allocate(-1), std::exception);
+}
+
+}  // namespace test
+}  // namespace mm
+}  // namespace dali
@@ -84,6 +84,33 @@ ShmHandle ShmHandle::CreateHandle() {
   return fd;
 }
 
+ShmHandle ShmHandle::OpenNamed(const std::string &name, bool create, bool *created) {
+  DALI_ENFORCE(!name.empty() && name[0] == '/' && name.find('/', 1) == std::string::npos,
+               make_string("Invalid shared memory name: \"", name,
+                           "\". It must start with '/' and contain no other slashes."));
+  if (created)
+    *created = false;
+  if (create) {
+    auto fd = ShmHandle(shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR));
+    if (fd >= 0) {
+      if (created)
+        *created = true;
+      return fd;
+    }
+    if (errno != EEXIST)
+      POSIX_CHECK_STATUS_EX(-1, "shm_open", make_string("Cannot create \"", name, "\"."));
+  }
+  auto fd = ShmHandle(shm_open(name.c_str(), O_RDWR, 0));
+  POSIX_CHECK_STATUS_EX(fd, "shm_open", make_string("Cannot open \"", name, "\"."));
+  return fd;
+}
+
+void ShmHandle::UnlinkNamed(const std::string &name) {
+  // Another process may have already removed the name - this is not an error.
+  if (shm_unlink(name.c_str()) == -1 && errno != ENOENT)
+    POSIX_CHECK_STATUS_EX(-1, "shm_unlink", make_string("Cannot unlink \"", name, "\"."));
+}
+
 void ShmHandle::DestroyHandle(shm_handle_t h) {
   if (h >= 0) {
     POSIX_CALL(::close(h));
@@ -0,0 +1,124 @@
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "dali/core/philox.h"
+
+namespace dali {
+
+TEST(Philox, KnownAnswer) {
+  // Random123 known answer test for philox4x32-10 with zero key and counter
+  Philox4x32_10 rng(0);
+  EXPECT_EQ(rng(), 0x6627e8d5u);
+  EXPECT_EQ(rng(), 0xe169c58du);
+  EXPECT_EQ(rng(), 0xbc57ac4cu);
+  EXPECT_EQ(rng(), 0x9b00dbd8u);
+}
+
+TEST(Philox, FillAndSkip) {
+  const uint64_t key = 0x123456789abcdefull;
+  Philox4x32_10 ref(key, 5);
+  std::vector<uint32_t> seq(1000);
+  for (auto &x : seq)
+    x = ref();
+
+  for (int offset : { 0, 1, 3, 4, 17, 100 }) {
+    for (int n : { 0, 1, 2, 5, 16, 33, 300 }) {
+      Philox4x32_10 rng(key, 5, offset);
+      EXPECT_EQ(rng.position(), static_cast<uint64_t>(offset));
+      std::vector<uint32_t> out(n);
+      rng.fill(out.data(), n);
+      for (int i = 0; i < n; i++)
+        ASSERT_EQ(out[i], seq[offset + i]) << "offset = " << offset << " n = " << n;
+      EXPECT_EQ(rng(), seq[offset + n]);
+      rng.skipahead(7);
+      EXPECT_EQ(rng(), seq[offset + n + 8]);
+      EXPECT_EQ(rng.position(), static_cast<uint64_t>(offset + n + 9));
+    }
+  }
+
+  Philox4x32_10 other(key, 6);
+  EXPECT_NE(other(), seq[0]);
+}
+
+TEST(Philox, UniformFill) {
+  Philox4x32_10 rng(1234);
+  const int N = 100001;
+  std::vector<float> out(N);
+  uniform_fill(out.data(), N, rng, -2.0f, 3.0f);
+  double sum = 0;
+  for (float x : out) {
+    ASSERT_GE(x, -2.0f);
+    ASSERT_LT(x, 3.0f);
+    sum += x;
+  }
+  EXPECT_NEAR(sum / N, 0.5, 0.05);
+
+  Philox4x32_10 a(42), b(42);
+  uniform_fill(out.data(), 7, a, 0.0f, 1.0f);
+  for (int i = 0; i < 7; i++)
+    EXPECT_EQ(out[i], (b() >> 8) * (1.0f / (1 << 24)));
+  EXPECT_EQ(a(), b());
+}
+
+TEST(Philox, NormalFill) {
+  Philox4x32_10 rng(4321);
+  const int N = 200001;
+  std::vector<float> out(N);
+  normal_fill(out.data(), N, rng, 1.0f, 2.0f);
+  double sum = 0, sum2 = 0;
+  for (float x : out) {
+    ASSERT_TRUE(std::isfinite(x));
+    sum += x;
+    sum2 += (x - 1.0) * (x - 1.0);
+  }
+  EXPECT_NEAR(sum / N, 1.0, 0.02);
+  EXPECT_NEAR(std::sqrt(sum2 / N), 2.0, 0.02);
+
+  // the values must match the textbook Box-Muller transform
+  Philox4x32_10 a(7), b(7);
+  normal_fill(out.data(), 99, a, 0.0f, 1.0f);
+  for (int i = 0; i < 99; i += 2) {
+    uint32_t x = b(), y = b();
+    double u = ((x >> 8) + 1) / 16777216.0;
+    double t = (y >> 8) / 16777216.0 * 2 * M_PI - M_PI / 4;
+    double r = std::sqrt(-2 * std::log(u));
+    EXPECT_NEAR(out[i], r * std::cos(t), 1e-5) << i;
+    if (i + 1 < 99)
+      EXPECT_NEAR(out[i + 1], r * std::sin(t), 1e-5) << i;
+  }
+
+  // the result doesn't depend on how the sequence is split
+  Philox4x32_10 c(7);
+  std::vector<float> parts(99);
+  normal_fill(parts.data(), 10, c, 0.0f, 1.0f);
+  normal_fill(parts.data() + 10, 89, c, 0.0f, 1.0f);
+  for (int i = 0; i < 99; i++)
+    EXPECT_EQ(parts[i], out[i]);
+}
+
+TEST(Philox, StdDistributions) {
+  Philox4x32_10 rng(99);
+  std::poisson_distribution<int> dist(4.5);
+  double sum = 0;
+  const int N = 100000;
+  for (int i = 0; i < N; i++)
+    sum += dist(rng);
+  EXPECT_NEAR(sum / N, 4.5, 0.05);
+}
+
+}  // namespace dali
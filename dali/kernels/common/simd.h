@@ -20,8 +20,10 @@
 #endif
 
 #include <cstddef>
+#include <cstdint>
 #include <limits>
 #include <type_traits>
+#include "dali/core/convert.h"
 #include "dali/core/force_inline.h"
 
 namespace dali {
@@ -326,6 +328,112 @@ DALI_FORCEINLINE static void store(Out *out, multivec<num_vecs> m) noexcept {
   }
 }
 
+/**
+ * @brief Loads 16 consecutive values and converts them to float.
+ */
+template <typename T>
+DALI_FORCEINLINE float4x4 load16(const T *in) {
+  float tmp[16];
+  for (int i = 0; i < 16; i++)
+    tmp[i] = static_cast<float>(in[i]);
+  return {{ _mm_loadu_ps(tmp), _mm_loadu_ps(tmp + 4), _mm_loadu_ps(tmp + 8),
+            _mm_loadu_ps(tmp + 12) }};
+}
+
+DALI_FORCEINLINE float4x4 load16(const float *in) {
+  return {{ _mm_loadu_ps(in), _mm_loadu_ps(in + 4), _mm_loadu_ps(in + 8),
+            _mm_loadu_ps(in + 12) }};
+}
+
+DALI_FORCEINLINE float4x4 load16(const uint8_t *in) {
+  return load_f(in);
+}
+
+DALI_FORCEINLINE float4x4 load16(const int8_t *in) {
+  return load_f(in);
+}
+
+template <typename T>
+DALI_FORCEINLINE float4x4 load16_16bit(const T *in) {
+  float4x2 lo = load_f(in), hi = load_f(in + 8);
+  return {{ lo.v[0], lo.v[1], hi.v[0], hi.v[1] }};
+}
+
+DALI_FORCEINLINE float4x4 load16(const uint16_t *in) {
+  return load16_16bit(in);
+}
+
+DALI_FORCEINLINE float4x4 load16(const int16_t *in) {
+  return load16_16bit(in);
+}
+
+/**
+ * @brief Rounds half away from zero, like std::round used by ConvertSat.
+ *
+ * The input must be within int32 range.
+ */
+DALI_FORCEINLINE __m128i round_i32(__m128 f) {
+  __m128i i = _mm_cvttps_epi32(f);
+  __m128 frac = _mm_sub_ps(f, _mm_cvtepi32_ps(i));
+  __m128i up = _mm_castps_si128(_mm_cmpge_ps(frac, _mm_set1_ps(0.5f)));
+  __m128i down = _mm_castps_si128(_mm_cmple_ps(frac, _mm_set1_ps(-0.5f)));
+  return _mm_add_epi32(_mm_sub_epi32(i, up), down);  // masks are -1 where true
+}
+
+template <typename Out>
+DALI_FORCEINLINE i128x4 clamp_round16(float4x4 f) {
+  __m128 lo = _mm_set1_ps(static_cast<float>(std::numeric_limits<Out>::min()));
+  __m128 hi = _mm_set1_ps(static_cast<float>(std::numeric_limits<Out>::max()));
+  return {{ round_i32(_mm_min_ps(_mm_max_ps(f.v[0], lo), hi)),
+            round_i32(_mm_min_ps(_mm_max_ps(f.v[1], lo), hi)),
+            round_i32(_mm_min_ps(_mm_max_ps(f.v[2], lo), hi)),
+            round_i32(_mm_min_ps(_mm_max_ps(f.v[3], lo), hi)) }};
+}
+
+/**
+ * @brief Converts 16 floats to Out with ConvertSat semantics and stores them.
+ */
+template <typename Out>
+DALI_FORCEINLINE void store16(Out *out, float4x4 f) {
+  float tmp[16];
+  _mm_storeu_ps(tmp, f.v[0]);
+  _mm_storeu_ps(tmp + 4, f.v[1]);
+  _mm_storeu_ps(tmp + 8, f.v[2]);
+  _mm_storeu_ps(tmp + 12, f.v[3]);
+  for (int i = 0; i < 16; i++)
+    out[i] = ConvertSat<Out>(tmp[i]);
+}
+
+DALI_FORCEINLINE void store16(float *out, float4x4 f) {
+  _mm_storeu_ps(out, f.v[0]);
+  _mm_storeu_ps(out + 4, f.v[1]);
+  _mm_storeu_ps(out + 8, f.v[2]);
+  _mm_storeu_ps(out + 12, f.v[3]);
+}
+
+DALI_FORCEINLINE void store16(uint8_t *out, float4x4 f) {
+  store_i32(out, clamp_round16<uint8_t>(f));
+}
+
+DALI_FORCEINLINE void store16(int8_t *out, float4x4 f) {
+  store_i32(out, clamp_round16<int8_t>(f));
+}
+
+template <typename T>
+DALI_FORCEINLINE void store16_16bit(T *out, float4x4 f) {
+  i128x4 iv = clamp_round16<T>(f);
+  store_i32(out, i128x2{{ iv.v[0], iv.v[1] }});
+  store_i32(out + 8, i128x2{{ iv.v[2], iv.v[3] }});
+}
+
+DALI_FORCEINLINE void store16(uint16_t *out, float4x4 f) {
+  store16_16bit(out, f);
+}
+
+DALI_FORCEINLINE void store16(int16_t *out, float4x4 f) {
+  store16_16bit(out, f);
+}
+
 #endif  // __SSE2__
 
 }  // namespace simd
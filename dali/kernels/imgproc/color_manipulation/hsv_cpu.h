@@ -19,6 +19,7 @@
 #include "dali/core/convert.h"
 #include "dali/kernels/kernel.h"
 #include "dali/kernels/imgproc/roi.h"
+#include "dali/kernels/imgproc/pointwise/linear_transformation_cpu.h"
 
 namespace dali {
 namespace kernels {
@@ -62,6 +63,25 @@ class HsvCpu {
 
     ptrdiff_t row_stride = image_width * num_channels;
     auto *row = in.data + adjusted_roi.lo.y * row_stride;
+    if (num_channels == hsv::kNchannels) {
+      // hue is a shift, saturation and value are scales - a diagonal affine transform
+      mat3 m = mat3::eye();
+      m(1, 1) = saturation;
+      m(2, 2) = value;
+      vec3 offset(hue, 0, 0);
+      int64_t row_pixels = adjusted_roi.hi.x - adjusted_roi.lo.x;
+      int64_t nrows = adjusted_roi.hi.y - adjusted_roi.lo.y;
+      if (row_pixels == image_width) {  // full rows are contiguous
+        row_pixels *= nrows;
+        nrows = 1;
+      }
+      for (int64_t y = 0; y < nrows; y++) {
+        TransformPixels3(ptr, row + adjusted_roi.lo.x * num_channels, row_pixels, m, offset);
+        ptr += row_pixels * hsv::kNchannels;
+        row += row_stride;
+      }
+      return;
+    }
     for (int y = adjusted_roi.lo.y; y < adjusted_roi.hi.y; y++) {
       for (int x = adjusted_roi.lo.x; x < adjusted_roi.hi.x; x++) {
         auto elem = row + x * num_channels;
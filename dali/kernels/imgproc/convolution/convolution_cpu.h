@@ -15,16 +15,70 @@
 #ifndef DALI_KERNELS_IMGPROC_CONVOLUTION_CONVOLUTION_CPU_H_
 #define DALI_KERNELS_IMGPROC_CONVOLUTION_CONVOLUTION_CPU_H_
 
+#include <type_traits>
 #include "dali/core/boundary.h"
 #include "dali/core/convert.h"
+#include "dali/core/force_inline.h"
 #include "dali/core/format.h"
 #include "dali/core/tensor_view.h"
+#include "dali/kernels/common/simd.h"
 #include "dali/kernels/common/utils.h"
 #include "dali/kernels/kernel.h"
 #include "dali/pipeline/util/operator_impl_utils.h"
 
 namespace dali {
 namespace kernels {
+
+namespace conv_detail {
+
+/**
+ * @brief Number of consecutive elements convolved at once by the vectorized loops
+ */
+static constexpr int kVecSize = 16;
+
+/**
+ * @brief The vectorized loops accumulate in float, so they are used only when the
+ *        scalar code would accumulate in float as well.
+ */
+template <typename In, typename W>
+struct is_vectorizable
+    : std::integral_constant<bool, std::is_same<W, float>::value &&
+                                   std::is_same<decltype(W() * In()), float>::value> {};
+
+#ifdef __SSE2__
+
+using simd::load16;
+using simd::store16;
+
+DALI_FORCEINLINE void zero(simd::float4x4 &acc) {
+  acc.v[0] = acc.v[1] = acc.v[2] = acc.v[3] = _mm_setzero_ps();
+}
+
+/**
+ * @brief acc += w * in[0:kVecSize]
+ */
+template <typename In>
+DALI_FORCEINLINE void mul_add(simd::float4x4 &acc, const In *in, float w) {
+  simd::float4x4 v = load16(in);
+  __m128 wv = _mm_set1_ps(w);
+  acc.v[0] = _mm_add_ps(acc.v[0], _mm_mul_ps(v.v[0], wv));
+  acc.v[1] = _mm_add_ps(acc.v[1], _mm_mul_ps(v.v[1], wv));
+  acc.v[2] = _mm_add_ps(acc.v[2], _mm_mul_ps(v.v[2], wv));
+  acc.v[3] = _mm_add_ps(acc.v[3], _mm_mul_ps(v.v[3], wv));
+}
+
+DALI_FORCEINLINE void apply_scale(simd::float4x4 &acc, float scale) {
+  __m128 s = _mm_set1_ps(scale);
+  acc.v[0] = _mm_mul_ps(acc.v[0], s);
+  acc.v[1] = _mm_mul_ps(acc.v[1], s);
+  acc.v[2] = _mm_mul_ps(acc.v[2], s);
+  acc.v[3] = _mm_mul_ps(acc.v[3], s);
+}
+
+#endif  // __SSE2__
+
+}  // namespace conv_detail
+
 /**
  * @brief Cyclic buffer used for storing input window for convolution.
  *
@@ -106,6 +160,34 @@ class CyclicWindowWrapper {
 
   template <typename U, typename W>
   void CalculateDot(U* __restrict__ output, const W* __restrict__ window, float scale) const {
+    int c0 = 0;
+#ifdef __SSE2__
+    if (conv_detail::is_vectorizable<T, W>::value) {
+      // Convolve kVecSize lanes at a time, keeping the sums in registers
+      for (; c0 + conv_detail::kVecSize <= NumLanes(); c0 += conv_detail::kVecSize) {
+        simd::float4x4 acc;
+        conv_detail::zero(acc);
+        int window_idx = 0;
+        for (int buf_idx = start_; buf_idx < length_; buf_idx++, window_idx++)
+          conv_detail::mul_add(acc, data_ + buf_idx * NumLanes() + c0, window[window_idx]);
+        for (int buf_idx = 0; buf_idx < end_; buf_idx++, window_idx++)
+          conv_detail::mul_add(acc, data_ + buf_idx * NumLanes() + c0, window[window_idx]);
+        conv_detail::apply_scale(acc, scale);
+        conv_detail::store16(output + c0, acc);
+      }
+      // the remaining lanes
+      for (int c = c0; c < NumLanes(); c++) {
+        W acc = 0;
+        int window_idx = 0;
+        for (int buf_idx = start_; buf_idx < length_; buf_idx++, window_idx++)
+          acc += window[window_idx] * data_[buf_idx * NumLanes() + c];
+        for (int buf_idx = 0; buf_idx < end_; buf_idx++, window_idx++)
+          acc += window[window_idx] * data_[buf_idx * NumLanes() + c];
+        output[c] = ConvertSat<U>(acc * scale);
+      }
+      return;
+    }
+#endif
     std::array<W, max_lanes> tmp;
     CalculateDot(tmp.data(), window);
     for (int c = 0; c < NumLanes(); c++) {
@@ -196,6 +278,21 @@ void ConvolveInnerDim(Out* out, const In* in, const W* window, int window_size,
     }
     int64_t flat_x = x0 * channels;
     int64_t flat_xout = xout * channels;
+#ifdef __SSE2__
+    if (conv_detail::is_vectorizable<In, W>::value) {
+      // The same window is applied to consecutive (flat) elements, so several pixels
+      // and channels can be processed at once.
+      for (; flat_x + conv_detail::kVecSize <= flat_x_limit;
+           flat_x += conv_detail::kVecSize, flat_xout += conv_detail::kVecSize) {
+        simd::float4x4 acc;
+        conv_detail::zero(acc);
+        for (int k = 0; k < window_size; k++)
+          conv_detail::mul_add(acc, &in_axis[flat_x + k * channels], window[k]);
+        conv_detail::apply_scale(acc, scale);
+        conv_detail::store16(&out_axis[flat_xout], acc);
+      }
+    }
+#endif
     // This loop won't execute if the window_size > axis_size
     for (; flat_x < flat_x_limit; flat_x++, flat_xout++) {
       float acc = 0;
@@ -221,6 +318,57 @@ void ConvolveInnerDim(Out* out, const In* in, const W* window, int window_size,
   }
 }
 
+/**
+ * @brief Apply convolution along an outer axis, when the output doesn't alias the input.
+ *
+ * The data is viewed as [axis_size, inner_elements]. Only the outputs in range
+ * [out_begin, out_end) of the axis are calculated and `out` points to the first of them.
+ * `in` points to the input at `in_begin` position of the axis and it must contain all
+ * the positions needed for the output range (after applying the reflect 101 border).
+ *
+ * The window is slid along the axis over strips of inner elements, so that the rows of a strip
+ * within the window stay in cache.
+ */
+template <typename Out, typename In, typename W>
+void ConvolveOuterDim(Out* out, const In* in, const W* window, int window_size,
+                      int64_t axis_size, int64_t inner_elements, int64_t out_begin,
+                      int64_t out_end, int64_t in_begin, float scale) {
+  constexpr int64_t kStripSize = 256;
+  int radius = (window_size - 1) / 2;
+  for (int64_t strip_begin = 0; strip_begin < inner_elements; strip_begin += kStripSize) {
+    int64_t strip_end = std::min(strip_begin + kStripSize, inner_elements);
+    for (int64_t y = out_begin; y < out_end; y++) {
+      Out* out_row = out + (y - out_begin) * inner_elements;
+      bool interior = y >= radius && y + radius < axis_size;
+      auto in_row = [=](int k) {
+        int64_t in_y = y - radius + k;
+        if (!interior)
+          in_y = boundary::idx_reflect_101(in_y, axis_size);
+        return in + (in_y - in_begin) * inner_elements;
+      };
+      int64_t x = strip_begin;
+#ifdef __SSE2__
+      if (conv_detail::is_vectorizable<In, W>::value) {
+        for (; x + conv_detail::kVecSize <= strip_end; x += conv_detail::kVecSize) {
+          simd::float4x4 acc;
+          conv_detail::zero(acc);
+          for (int k = 0; k < window_size; k++)
+            conv_detail::mul_add(acc, in_row(k) + x, window[k]);
+          conv_detail::apply_scale(acc, scale);
+          conv_detail::store16(out_row + x, acc);
+        }
+      }
+#endif
+      for (; x < strip_end; x++) {
+        W acc = 0;
+        for (int k = 0; k < window_size; k++)
+          acc += in_row(k)[x] * window[k];
+        out_row[x] = ConvertSat<Out>(acc * scale);
+      }
+    }
+  }
+}
+
 template <int axis, bool has_channels, int max_lanes, typename Out, typename In, typename W,
           int ndim>
 void ConvolveInplaceAxisLoop(Out* out, const In* in, const W* window,
@@ -299,10 +447,11 @@ void ConvolveInplaceOuterLoop(Out* out, const In* in, const W* window,
  * The innermost dimension performed _not_ in-place uses implementation that will be faster
  * than in-place one that requires additional copy.
  *
- * For non-innermost convolution a sliding window (using a cyclic buffer) over several lanes is used
- * (can be comprised of several pixels, one channel is one lane). Can be safely performed in-place.
+ * Non-innermost convolution performed _not_ in-place reads the input rows directly, processing
+ * several consecutive inner elements at once.
  *
- * The same implementation is used for in-place innermost convolution.
+ * For in-place convolution a sliding window (using a cyclic buffer) over several lanes is used
+ * (can be comprised of several pixels, one channel is one lane).
  */
 template <typename Out, typename In, typename W, int ndim, int axis, bool has_channels = true>
 struct ConvolutionCpu {
@@ -330,16 +479,44 @@ struct ConvolutionCpu {
         ctx.scratchpad->Allocate<In>(AllocType::Host, input_window_buf_size);
     auto strides = GetStrides(in.shape);
 
-    if (axis == ndim - has_channels - 1 &&
-        static_cast<const void*>(out.data) != static_cast<const void*>(in.data)) {
+    bool in_place = static_cast<const void*>(out.data) == static_cast<const void*>(in.data);
+    if (axis == ndim - has_channels - 1 && !in_place) {
       ConvolveInnerDim<has_channels>(out.data, in.data, window.data, diameter, in.shape, strides,
                                      scale);
+    } else if (!in_place) {
+      int64_t outer_elements = volume(&in.shape[0], &in.shape[axis]);
+      int64_t axis_size = in.shape[axis];
+      int64_t inner_elements = strides[axis];
+      for (int64_t o = 0; o < outer_elements; o++) {
+        int64_t offset = o * axis_size * inner_elements;
+        ConvolveOuterDim(out.data + offset, in.data + offset, window.data, diameter, axis_size,
+                         inner_elements, 0, axis_size, 0, scale);
+      }
     } else {
       ConvolveInplaceOuterLoop<axis, has_channels, kStripSize, Out, In, W, ndim>(
           out.data, in.data, window.data, in.shape, strides, diameter, input_window_buffer, scale);
     }
   }
 
+  /**
+   * @brief Calculate only the outputs in range [out_begin, out_end) of the outermost axis.
+   *
+   * `in` holds only a part of the input, starting at position `in_begin` of the outermost axis,
+   * that contains all the positions within the window radius of the output range
+   * (after applying the border). The extent of the axis is taken from the `out` shape.
+   */
+  void Run(KernelContext& ctx, const TensorView<StorageCPU, Out, ndim> out,
+           const TensorView<StorageCPU, const In, ndim>& in,
+           const TensorView<StorageCPU, const W, 1>& window, float scale, int64_t out_begin,
+           int64_t out_end, int64_t in_begin) {
+    static_assert(axis == 0, "Partial output is supported only for the outermost axis");
+    assert(static_cast<const void*>(out.data) != static_cast<const void*>(in.data));
+    int64_t inner_elements = volume(&out.shape[1], &out.shape[ndim]);
+    ConvolveOuterDim(out.data + out_begin * inner_elements, in.data, window.data,
+                     window.num_elements(), out.shape[0], inner_elements, out_begin, out_end,
+                     in_begin, scale);
+  }
+
  private:
   static_assert(0 <= axis && axis < (has_channels ? ndim - 1 : ndim),
                 "Selected axis must be in [0, ndim) when there is no channel axis, or in [0, ndim "
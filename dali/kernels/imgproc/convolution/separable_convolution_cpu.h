@@ -15,6 +15,8 @@
 #ifndef DALI_KERNELS_IMGPROC_CONVOLUTION_SEPARABLE_CONVOLUTION_CPU_H_
 #define DALI_KERNELS_IMGPROC_CONVOLUTION_SEPARABLE_CONVOLUTION_CPU_H_
 
+#include <tuple>
+#include <utility>
 #include "dali/core/convert.h"
 #include "dali/core/format.h"
 #include "dali/core/tensor_view.h"
@@ -27,6 +29,35 @@
 namespace dali {
 namespace kernels {
 
+namespace conv_detail {
+
+/**
+ * @brief Select the rows of `in` (the outermost axis) needed to calculate the output rows
+ *        [row_begin, row_end) with a window of given size.
+ *
+ * @return The view of the selected rows and the index of the first one.
+ */
+template <typename T, int ndim>
+std::pair<TensorView<StorageCPU, T, ndim>, int64_t> GetInputBand(
+    const TensorView<StorageCPU, T, ndim>& in, int window_size, int64_t row_begin,
+    int64_t row_end) {
+  int64_t rows = in.shape[0];
+  int radius = (window_size - 1) / 2;
+  int64_t in_begin = 0, in_end = rows;
+  // When the radius is smaller than the extent, the border reflects an index at most once,
+  // so it stays within the rows adjacent to the range.
+  if (radius < rows) {
+    in_begin = std::max<int64_t>(row_begin - radius, 0);
+    in_end = std::min<int64_t>(row_end + radius, rows);
+  }
+  auto band_shape = in.shape;
+  band_shape[0] = in_end - in_begin;
+  int64_t row_volume = volume(&in.shape[1], &in.shape[ndim]);
+  return {{in.data + in_begin * row_volume, band_shape}, in_begin};
+}
+
+}  // namespace conv_detail
+
 /**
  * @brief Apply convolution in all spatial axes, starting from the innermost to outermost.
  *        If channel axis is pressent, the convolution is not applied there.
@@ -104,8 +135,25 @@ struct SeparableConvolutionCpu<Out, In, W, 2, has_channels> {
            const TensorView<StorageCPU, const In, ndim>& in,
            const std::array<TensorView<StorageCPU, const W, 1>, axes>& windows,
            W scale = 1) {
-    auto *tmp = ctx.scratchpad->Allocate<Intermediate>(AllocType::Host, volume(in.shape));
-    auto intermediate = TensorView<StorageCPU, Intermediate, ndim>(tmp, in.shape);
+    Run(ctx, out, in, windows, scale, 0, in.shape[0]);
+  }
+
+  /**
+   * @brief Calculate only the rows [row_begin, row_end) of the output (the outermost axis).
+   *
+   * The inner axes are convolved only for the input rows within the window radius of that
+   * range, so a sample can be split into bands processed concurrently by one kernel instance.
+   */
+  void Run(KernelContext& ctx, const TensorView<StorageCPU, Out, ndim> out,
+           const TensorView<StorageCPU, const In, ndim>& in,
+           const std::array<TensorView<StorageCPU, const W, 1>, axes>& windows,
+           W scale, int64_t row_begin, int64_t row_end) {
+    TensorView<StorageCPU, const In, ndim> band;
+    int64_t band_begin;
+    std::tie(band, band_begin) =
+        conv_detail::GetInputBand(in, windows[0].num_elements(), row_begin, row_end);
+    auto* tmp = ctx.scratchpad->Allocate<Intermediate>(AllocType::Host, volume(band.shape));
+    auto intermediate = TensorView<StorageCPU, Intermediate, ndim>(tmp, band.shape);
 
     // Prepare the scratchpad with all the remaining memory requested by sub-kernels
     PreallocatedScratchpad sub_scratch;
@@ -119,9 +167,10 @@ struct SeparableConvolutionCpu<Out, In, W, 2, has_channels> {
     sub_ctx.scratchpad = &sub_scratch;
 
     // Clear the scratchpad for sub-kernels to reuse memory
-    conv_innermost_.Run(sub_ctx, intermediate, in, windows[1]);
+    conv_innermost_.Run(sub_ctx, intermediate, band, windows[1]);
     sub_scratch.Clear();
-    conv_outermost_.Run(sub_ctx, out, intermediate, windows[0], scale);
+    conv_outermost_.Run(sub_ctx, out, intermediate, windows[0], scale, row_begin, row_end,
+                        band_begin);
   }
 
   scratch_sizes_t sub_scratch_sizes_;
@@ -160,8 +209,25 @@ struct SeparableConvolutionCpu<Out, In, W, 3, has_channels> {
            const TensorView<StorageCPU, const In, ndim>& in,
            const std::array<TensorView<StorageCPU, const W, 1>, axes>& windows,
            W scale = 1) {
-    auto* tmp = ctx.scratchpad->Allocate<Intermediate>(AllocType::Host, volume(in.shape));
-    auto intermediate = TensorView<StorageCPU, Intermediate, ndim>(tmp, in.shape);
+    Run(ctx, out, in, windows, scale, 0, in.shape[0]);
+  }
+
+  /**
+   * @brief Calculate only the rows [row_begin, row_end) of the output (the outermost axis).
+   *
+   * The inner axes are convolved only for the input rows within the window radius of that
+   * range, so a sample can be split into bands processed concurrently by one kernel instance.
+   */
+  void Run(KernelContext& ctx, const TensorView<StorageCPU, Out, ndim> out,
+           const TensorView<StorageCPU, const In, ndim>& in,
+           const std::array<TensorView<StorageCPU, const W, 1>, axes>& windows,
+           W scale, int64_t row_begin, int64_t row_end) {
+    TensorView<StorageCPU, const In, ndim> band;
+    int64_t band_begin;
+    std::tie(band, band_begin) =
+        conv_detail::GetInputBand(in, windows[0].num_elements(), row_begin, row_end);
+    auto* tmp = ctx.scratchpad->Allocate<Intermediate>(AllocType::Host, volume(band.shape));
+    auto intermediate = TensorView<StorageCPU, Intermediate, ndim>(tmp, band.shape);
 
     // Prepare the scratchpad with all the remaining memory requested by sub-kernels
     PreallocatedScratchpad sub_scratch;
@@ -175,11 +241,12 @@ struct SeparableConvolutionCpu<Out, In, W, 3, has_channels> {
     sub_ctx.scratchpad = &sub_scratch;
 
     // Clear the scratchpad for sub-kernels to reuse memory
-    conv_innermost_.Run(sub_ctx, intermediate, in, windows[2]);
+    conv_innermost_.Run(sub_ctx, intermediate, band, windows[2]);
     sub_scratch.Clear();
     conv_middle_.Run(sub_ctx, intermediate, intermediate, windows[1]);
     sub_scratch.Clear();
-    conv_outermost_.Run(sub_ctx, out, intermediate, windows[0], scale);
+    conv_outermost_.Run(sub_ctx, out, intermediate, windows[0], scale, row_begin, row_end,
+                        band_begin);
   }
 
   scratch_sizes_t sub_scratch_sizes_;
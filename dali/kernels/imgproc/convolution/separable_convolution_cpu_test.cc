@@ -16,6 +16,7 @@
 #include <cmath>
 #include <complex>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 #include "dali/kernels/common/utils.h"
@@ -155,6 +156,71 @@ TEST(SeparableConvolutionTest, Axes2WithChannels) {
   Check(out_v, baseline_out_v);
 }
 
+TEST(SeparableConvolutionTest, Axes2Uint8RowBands) {
+  std::array<int, 2> window_dims = {9, 7};
+  TestTensorList<float, 1> kernel_window_0, kernel_window_1;
+  TestTensorList<uint8_t, 3> input, output, band_output;
+  TestTensorList<float, 3> intermediate, baseline_output;
+
+  TensorListShape<3> data_shape = uniform_list_shape<3>(1, {37, 45, 3});
+
+  kernel_window_0.reshape(uniform_list_shape<1>(1, {window_dims[0]}));
+  kernel_window_1.reshape(uniform_list_shape<1>(1, {window_dims[1]}));
+  input.reshape(data_shape);
+  intermediate.reshape(data_shape);
+  output.reshape(data_shape);
+  band_output.reshape(data_shape);
+  baseline_output.reshape(data_shape);
+
+  auto kernel_window_0_v = kernel_window_0.cpu()[0];
+  auto kernel_window_1_v = kernel_window_1.cpu()[0];
+  auto in_v = input.cpu()[0];
+  auto interm_v = intermediate.cpu()[0];
+  auto out_v = output.cpu()[0];
+  auto band_out_v = band_output.cpu()[0];
+  auto baseline_out_v = baseline_output.cpu()[0];
+
+  std::mt19937 rng;
+  UniformRandomFill(in_v, rng, 0, 255);
+  testing::InitTriangleWindow(kernel_window_0_v);
+  testing::InitTriangleWindow(kernel_window_1_v);
+  float window_sum_0 = 0, window_sum_1 = 0;
+  for (int i = 0; i < window_dims[0]; i++)
+    window_sum_0 += kernel_window_0_v.data[i];
+  for (int i = 0; i < window_dims[1]; i++)
+    window_sum_1 += kernel_window_1_v.data[i];
+  float scale = 1.0f / (window_sum_0 * window_sum_1);
+
+  SeparableConvolutionCpu<uint8_t, uint8_t, float, 2, true> kernel;
+  KernelContext ctx;
+
+  auto req = kernel.Setup(ctx, data_shape[0], window_dims);
+
+  ScratchpadAllocator scratch_alloc;
+  scratch_alloc.Reserve(req.scratch_sizes);
+  auto scratchpad = scratch_alloc.GetScratchpad();
+  ctx.scratchpad = &scratchpad;
+
+  kernel.Run(ctx, out_v, in_v, {kernel_window_0_v, kernel_window_1_v}, scale);
+  testing::BaselineConvolve(interm_v, in_v, kernel_window_1_v, 1, window_dims[1] / 2);
+  testing::BaselineConvolve(baseline_out_v, interm_v, kernel_window_0_v, 0, window_dims[0] / 2);
+  for (int64_t i = 0; i < baseline_out_v.num_elements(); i++) {
+    ASSERT_EQ(out_v.data[i], ConvertSat<uint8_t>(baseline_out_v.data[i] * scale))
+        << " at index " << i;
+  }
+
+  // The bands include the borders and a band thinner than the window
+  ConstantFill(band_out_v, 0);
+  std::vector<std::pair<int, int>> bands = {{0, 2}, {2, 13}, {13, 16}, {16, 35}, {35, 37}};
+  for (auto &band : bands) {
+    auto band_scratchpad = scratch_alloc.GetScratchpad();
+    ctx.scratchpad = &band_scratchpad;
+    kernel.Run(ctx, band_out_v, in_v, {kernel_window_0_v, kernel_window_1_v}, scale,
+               band.first, band.second);
+  }
+  Check(band_out_v, out_v);
+}
+
 TEST(SeparableConvolutionTest, Axes2NoChannels) {
   std::array<int, 2> window_dims = {5, 7};
   TestTensorList<float, 1> kernel_window_0, kernel_window_1;
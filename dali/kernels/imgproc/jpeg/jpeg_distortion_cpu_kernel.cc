@@ -0,0 +1,402 @@
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/kernels/imgproc/jpeg/jpeg_distortion_cpu_kernel.h"
+#include <algorithm>
+#include <cmath>
+#include "dali/core/format.h"
+#include "dali/core/tensor_shape_print.h"
+#include "dali/core/util.h"
+#include "dali/kernels/common/simd.h"
+#include "dali/kernels/kernel_req.h"
+#include "dali/kernels/imgproc/jpeg/jpeg_quantization_table.h"
+
+namespace dali {
+namespace kernels {
+namespace jpeg {
+
+namespace {
+
+using Block = float[8][8];
+
+/**
+ * @brief Rounds to nearest (ties to even, like the SSE conversion) and clamps to [0, 255]
+ */
+inline int RoundU8(float x) {
+  return std::nearbyint(std::min(std::max(x, 0.0f), 255.0f));
+}
+
+// cos(k * pi / 16) / 2 - the factor 1/2 (and 1/sqrt(2) for k = 0) makes the DCT orthonormal
+constexpr float kC1 = 0.49039264f, kC2 = 0.46193977f, kC3 = 0.41573481f, kC4 = 0.35355339f,
+                kC5 = 0.27778512f, kC6 = 0.19134172f, kC7 = 0.09754516f;
+
+/**
+ * @brief In-place 8-point orthonormal DCT-II, split into the even and odd parts
+ *
+ * T is either float or a SIMD vector, in which case several transforms are calculated at once.
+ */
+template <typename T>
+inline void Dct8(T *v) {
+  T s0 = v[0] + v[7], s1 = v[1] + v[6], s2 = v[2] + v[5], s3 = v[3] + v[4];
+  T d0 = v[0] - v[7], d1 = v[1] - v[6], d2 = v[2] - v[5], d3 = v[3] - v[4];
+  T e0 = s0 + s3, e1 = s1 + s2, e2 = s0 - s3, e3 = s1 - s2;
+  v[0] = kC4 * (e0 + e1);
+  v[4] = kC4 * (e0 - e1);
+  v[2] = kC2 * e2 + kC6 * e3;
+  v[6] = kC6 * e2 - kC2 * e3;
+  v[1] = kC1 * d0 + kC3 * d1 + kC5 * d2 + kC7 * d3;
+  v[3] = kC3 * d0 - kC7 * d1 - kC1 * d2 - kC5 * d3;
+  v[5] = kC5 * d0 - kC1 * d1 + kC7 * d2 + kC3 * d3;
+  v[7] = kC7 * d0 - kC5 * d1 + kC3 * d2 - kC1 * d3;
+}
+
+/**
+ * @brief In-place 8-point inverse of Dct8
+ */
+template <typename T>
+inline void Idct8(T *v) {
+  T p0 = kC4 * (v[0] + v[4]), p1 = kC4 * (v[0] - v[4]);
+  T p2 = kC2 * v[2] + kC6 * v[6], p3 = kC6 * v[2] - kC2 * v[6];
+  T e0 = p0 + p2, e1 = p1 + p3, e2 = p1 - p3, e3 = p0 - p2;
+  T o0 = kC1 * v[1] + kC3 * v[3] + kC5 * v[5] + kC7 * v[7];
+  T o1 = kC3 * v[1] - kC7 * v[3] - kC1 * v[5] - kC5 * v[7];
+  T o2 = kC5 * v[1] - kC1 * v[3] + kC7 * v[5] + kC3 * v[7];
+  T o3 = kC7 * v[1] - kC5 * v[3] + kC3 * v[5] - kC1 * v[7];
+  v[0] = e0 + o0;  v[7] = e0 - o0;
+  v[1] = e1 + o1;  v[6] = e1 - o1;
+  v[2] = e2 + o2;  v[5] = e2 - o2;
+  v[3] = e3 + o3;  v[4] = e3 - o3;
+}
+
+/**
+ * @brief Quantization table and its reciprocal
+ *
+ * With SSE, the blocks are quantized in the transposed layout produced by QuantizeBlock,
+ * so the tables are stored transposed, in groups of 4 rows: `q[h][j][i] == table(4*h + i, j)`.
+ */
+struct QuantizationTable {
+  explicit QuantizationTable(const mat<8, 8, uint8_t> &table) {
+    for (int i = 0; i < 8; i++) {
+      for (int j = 0; j < 8; j++) {
+#ifdef __SSE2__
+        float &qij = q[i / 4][j][i % 4], &qij_inv = q_inv[i / 4][j][i % 4];
+#else
+        float &qij = q[i][j], &qij_inv = q_inv[i][j];
+#endif
+        qij = table(i, j);
+        qij_inv = 1.0f / table(i, j);
+      }
+    }
+  }
+#ifdef __SSE2__
+  alignas(16) float q[2][8][4], q_inv[2][8][4];
+#else
+  Block q, q_inv;
+#endif
+};
+
+#ifdef __SSE2__
+/**
+ * @brief Transposes an 8x8 matrix stored as v[h][i] = row i, columns [4*h, 4*h + 4)
+ */
+inline void Transpose8x8(__m128 (&v)[2][8]) {
+  for (int h = 0; h < 2; h++) {
+    _MM_TRANSPOSE4_PS(v[h][0], v[h][1], v[h][2], v[h][3]);
+    _MM_TRANSPOSE4_PS(v[h][4], v[h][5], v[h][6], v[h][7]);
+  }
+  for (int i = 0; i < 4; i++)
+    std::swap(v[0][4 + i], v[1][i]);
+}
+
+/**
+ * @brief Forward DCT, quantization and inverse DCT of an 8x8 block stored in a plane, in place
+ */
+inline void QuantizeBlock(float *plane, ptrdiff_t stride, const QuantizationTable &table) {
+  __m128 v[2][8];
+  for (int h = 0; h < 2; h++)
+    for (int i = 0; i < 8; i++)
+      v[h][i] = _mm_loadu_ps(plane + i * stride + 4 * h);
+  // columns, then rows - the coefficients end up transposed
+  Dct8(v[0]);
+  Dct8(v[1]);
+  Transpose8x8(v);
+  Dct8(v[0]);
+  Dct8(v[1]);
+  for (int h = 0; h < 2; h++) {
+    for (int j = 0; j < 8; j++) {
+      __m128 x = _mm_mul_ps(v[h][j], _mm_load_ps(table.q_inv[h][j]));
+      x = _mm_cvtepi32_ps(_mm_cvtps_epi32(x));
+      v[h][j] = _mm_mul_ps(x, _mm_load_ps(table.q[h][j]));
+    }
+  }
+  Idct8(v[0]);
+  Idct8(v[1]);
+  Transpose8x8(v);
+  Idct8(v[0]);
+  Idct8(v[1]);
+  for (int h = 0; h < 2; h++)
+    for (int i = 0; i < 8; i++)
+      _mm_storeu_ps(plane + i * stride + 4 * h, v[h][i]);
+}
+#else
+inline void QuantizeBlock(float *plane, ptrdiff_t stride, const QuantizationTable &table) {
+  Block blk;
+  for (int j = 0; j < 8; j++) {
+    float col[8];
+    for (int i = 0; i < 8; i++)
+      col[i] = plane[i * stride + j];
+    Dct8(col);
+    for (int i = 0; i < 8; i++)
+      blk[i][j] = col[i];
+  }
+  for (int i = 0; i < 8; i++) {
+    Dct8(blk[i]);
+    for (int j = 0; j < 8; j++)
+      blk[i][j] = table.q[i][j] * std::nearbyint(blk[i][j] * table.q_inv[i][j]);
+    Idct8(blk[i]);
+  }
+  for (int j = 0; j < 8; j++) {
+    float col[8];
+    for (int i = 0; i < 8; i++)
+      col[i] = blk[i][j];
+    Idct8(col);
+    for (int i = 0; i < 8; i++)
+      plane[i * stride + j] = col[i];
+  }
+}
+#endif
+
+/**
+ * @brief Buffers holding one row of MCUs (16 rows of pixels)
+ *
+ * The width is aligned to the MCU size; the pixels beyond the image are replicated from the edge.
+ */
+struct McuRow {
+  explicit McuRow(int width) : width(align_up(width, 16)) {}
+
+  int64_t rgb_size() const { return 3 * 16 * width; }
+  int64_t luma_size() const { return 16 * width; }
+  int64_t chroma_size() const { return 8 * width / 2; }
+
+  uint8_t *r(int row) const { return rgb + row * width; }
+  uint8_t *g(int row) const { return rgb + (16 + row) * width; }
+  uint8_t *b(int row) const { return rgb + (32 + row) * width; }
+
+  int width;
+  uint8_t *rgb = nullptr;  // planar R, G, B
+  float *luma = nullptr;   // Y - 128,  16 x width
+  float *cb = nullptr;     // Cb - 128, 8 x width / 2
+  float *cr = nullptr;     // Cr - 128, 8 x width / 2
+};
+
+inline void Deinterleave(uint8_t *r, uint8_t *g, uint8_t *b, const uint8_t *rgb,
+                         int width, int aligned_width) {
+  for (int x = 0; x < width; x++, rgb += 3) {
+    r[x] = rgb[0];
+    g[x] = rgb[1];
+    b[x] = rgb[2];
+  }
+  for (int x = width; x < aligned_width; x++) {
+    r[x] = r[width - 1];
+    g[x] = g[width - 1];
+    b[x] = b[width - 1];
+  }
+}
+
+inline void Interleave(uint8_t *rgb, const uint8_t *r, const uint8_t *g, const uint8_t *b,
+                       int width) {
+  for (int x = 0; x < width; x++, rgb += 3) {
+    rgb[0] = r[x];
+    rgb[1] = g[x];
+    rgb[2] = b[x];
+  }
+}
+
+/**
+ * @brief Calculates Y - 128 for one row of pixels
+ */
+inline void RgbToLuma(float *luma, const uint8_t *r, const uint8_t *g, const uint8_t *b,
+                      int width) {
+  int x = 0;
+#ifdef __SSE2__
+  for (; x + 16 <= width; x += 16) {
+    auto R = simd::load_f(r + x), G = simd::load_f(g + x), B = simd::load_f(b + x);
+    for (int v = 0; v < 4; v++) {
+      __m128 Y = _mm_add_ps(_mm_add_ps(_mm_mul_ps(R.v[v], _mm_set1_ps(0.299f)),
+                                       _mm_mul_ps(G.v[v], _mm_set1_ps(0.587f))),
+                            _mm_mul_ps(B.v[v], _mm_set1_ps(0.114f)));
+      Y = _mm_cvtepi32_ps(simd::clamp_round(Y, 0, 255));
+      _mm_storeu_ps(luma + x + 4 * v, _mm_sub_ps(Y, _mm_set1_ps(128.0f)));
+    }
+  }
+#endif
+  for (; x < width; x++)
+    luma[x] = RoundU8(0.299f * r[x] + 0.587f * g[x] + 0.114f * b[x]) - 128.0f;
+}
+
+/**
+ * @brief Calculates Cb - 128 and Cr - 128 for one row of chroma, from the average color of
+ *        2x2 pixels taken from two rows of pixels
+ */
+inline void RgbToChroma(float *cb, float *cr,
+                        const uint8_t *r0, const uint8_t *g0, const uint8_t *b0,
+                        const uint8_t *r1, const uint8_t *g1, const uint8_t *b1,
+                        int width) {
+  int x = 0;
+#ifdef __SSE2__
+  // Sums 2x2 pixels and rounds the average - produces 8 values from 2x16 pixels
+  auto avg = [](const uint8_t *row0, const uint8_t *row1) {
+    __m128i zero = _mm_setzero_si128(), ones = _mm_set1_epi16(1), two = _mm_set1_epi32(2);
+    __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row0));
+    __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row1));
+    __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+    __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+    lo = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(lo, ones), two), 2);
+    hi = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(hi, ones), two), 2);
+    return simd::float4x2{{ _mm_cvtepi32_ps(lo), _mm_cvtepi32_ps(hi) }};
+  };
+  for (; x + 16 <= width; x += 16) {
+    auto R = avg(r0 + x, r1 + x), G = avg(g0 + x, g1 + x), B = avg(b0 + x, b1 + x);
+    for (int v = 0; v < 2; v++) {
+      __m128 Cb = _mm_add_ps(_mm_add_ps(_mm_mul_ps(R.v[v], _mm_set1_ps(-0.16873589f)),
+                                        _mm_mul_ps(G.v[v], _mm_set1_ps(-0.33126411f))),
+                             _mm_mul_ps(B.v[v], _mm_set1_ps(0.5f)));
+      __m128 Cr = _mm_add_ps(_mm_add_ps(_mm_mul_ps(R.v[v], _mm_set1_ps(0.5f)),
+                                        _mm_mul_ps(G.v[v], _mm_set1_ps(-0.41868759f))),
+                             _mm_mul_ps(B.v[v], _mm_set1_ps(-0.08131241f)));
+      // Cb and Cr are already shifted by -128, so they're clamped to [-128, 127]
+      Cb = _mm_cvtepi32_ps(simd::clamp_round(Cb, -128, 127));
+      Cr = _mm_cvtepi32_ps(simd::clamp_round(Cr, -128, 127));
+      _mm_storeu_ps(cb + x / 2 + 4 * v, Cb);
+      _mm_storeu_ps(cr + x / 2 + 4 * v, Cr);
+    }
+  }
+#endif
+  for (; x < width; x += 2) {
+    float R = (r0[x] + r0[x + 1] + r1[x] + r1[x + 1] + 2) >> 2;
+    float G = (g0[x] + g0[x + 1] + g1[x] + g1[x + 1] + 2) >> 2;
+    float B = (b0[x] + b0[x + 1] + b1[x] + b1[x + 1] + 2) >> 2;
+    cb[x / 2] = RoundU8(-0.16873589f * R - 0.33126411f * G + 0.5f * B + 128.0f) - 128.0f;
+    cr[x / 2] = RoundU8(0.5f * R - 0.41868759f * G - 0.08131241f * B + 128.0f) - 128.0f;
+  }
+}
+
+/**
+ * @brief Converts one row of Y and the corresponding row of subsampled chroma back to RGB
+ */
+inline void YCbCrToRgb(uint8_t *r, uint8_t *g, uint8_t *b,
+                       const float *luma, const float *cb, const float *cr, int width) {
+  int x = 0;
+#ifdef __SSE2__
+  for (; x + 16 <= width; x += 16) {
+    simd::i128x4 R, G, B;
+    for (int h = 0; h < 2; h++) {
+      // 4 chroma values cover 8 pixels
+      __m128 Cb = _mm_cvtepi32_ps(simd::clamp_round(_mm_loadu_ps(cb + x / 2 + 4 * h), -128, 127));
+      __m128 Cr = _mm_cvtepi32_ps(simd::clamp_round(_mm_loadu_ps(cr + x / 2 + 4 * h), -128, 127));
+      __m128 Cb2[2] = { _mm_unpacklo_ps(Cb, Cb), _mm_unpackhi_ps(Cb, Cb) };
+      __m128 Cr2[2] = { _mm_unpacklo_ps(Cr, Cr), _mm_unpackhi_ps(Cr, Cr) };
+      for (int i = 0; i < 2; i++) {
+        int v = 2 * h + i;
+        __m128 Y = _mm_add_ps(_mm_loadu_ps(luma + x + 4 * v), _mm_set1_ps(128.0f));
+        Y = _mm_cvtepi32_ps(simd::clamp_round(Y, 0, 255));
+        R.v[v] = _mm_cvtps_epi32(_mm_add_ps(Y, _mm_mul_ps(Cr2[i], _mm_set1_ps(1.402f))));
+        G.v[v] = _mm_cvtps_epi32(_mm_sub_ps(_mm_sub_ps(Y,
+                                    _mm_mul_ps(Cb2[i], _mm_set1_ps(0.34413629f))),
+                                    _mm_mul_ps(Cr2[i], _mm_set1_ps(0.71413629f))));
+        B.v[v] = _mm_cvtps_epi32(_mm_add_ps(Y, _mm_mul_ps(Cb2[i], _mm_set1_ps(1.772f))));
+      }
+    }
+    simd::store_i32(r + x, R);
+    simd::store_i32(g + x, G);
+    simd::store_i32(b + x, B);
+  }
+#endif
+  for (; x < width; x++) {
+    float Y = RoundU8(luma[x] + 128.0f);
+    float Cb = RoundU8(cb[x / 2] + 128.0f) - 128.0f;
+    float Cr = RoundU8(cr[x / 2] + 128.0f) - 128.0f;
+    r[x] = RoundU8(Y + 1.402f * Cr);
+    g[x] = RoundU8(Y - 0.34413629f * Cb - 0.71413629f * Cr);
+    b[x] = RoundU8(Y + 1.772f * Cb);
+  }
+}
+
+}  // namespace
+
+KernelRequirements JpegCompressionDistortionCPU::Setup(KernelContext &ctx,
+                                                       const InTensorCPU<uint8_t, 3> &in) {
+  DALI_ENFORCE(in.shape[2] == 3,
+    make_string("Expected RGB samples with HWC layout, got shape: ", in.shape));
+  KernelRequirements req;
+  McuRow mcu_row(in.shape[1]);
+  ScratchpadEstimator se;
+  se.add<uint8_t>(AllocType::Host, mcu_row.rgb_size());
+  se.add<float>(AllocType::Host, mcu_row.luma_size());
+  se.add<float>(AllocType::Host, mcu_row.chroma_size());
+  se.add<float>(AllocType::Host, mcu_row.chroma_size());
+  req.scratch_sizes = se.sizes;
+  req.output_shapes = {TensorListShape<3>({in.shape})};
+  return req;
+}
+
+void JpegCompressionDistortionCPU::Run(KernelContext &ctx, const OutTensorCPU<uint8_t, 3> &out,
+                                       const InTensorCPU<uint8_t, 3> &in, int quality) {
+  QuantizationTable luma_table(GetLumaQuantizationTable(quality));
+  QuantizationTable chroma_table(GetChromaQuantizationTable(quality));
+
+  const int H = in.shape[0], W = in.shape[1];
+  const int64_t row_stride = W * 3;
+  McuRow mcu(W);
+  const int aligned_width = mcu.width;
+  const int chroma_width = aligned_width / 2;
+  mcu.rgb = ctx.scratchpad->Allocate<uint8_t>(AllocType::Host, mcu.rgb_size());
+  mcu.luma = ctx.scratchpad->Allocate<float>(AllocType::Host, mcu.luma_size());
+  mcu.cb = ctx.scratchpad->Allocate<float>(AllocType::Host, mcu.chroma_size());
+  mcu.cr = ctx.scratchpad->Allocate<float>(AllocType::Host, mcu.chroma_size());
+
+  for (int mcu_y = 0; mcu_y < H; mcu_y += 16) {
+    // Rows beyond the image are replicated from the edge
+    for (int r = 0; r < 16; r++) {
+      int y = std::min(mcu_y + r, H - 1);
+      Deinterleave(mcu.r(r), mcu.g(r), mcu.b(r), in.data + y * row_stride, W, aligned_width);
+      RgbToLuma(mcu.luma + r * aligned_width, mcu.r(r), mcu.g(r), mcu.b(r), aligned_width);
+    }
+    for (int r = 0; r < 8; r++) {
+      RgbToChroma(mcu.cb + r * chroma_width, mcu.cr + r * chroma_width,
+                  mcu.r(2 * r), mcu.g(2 * r), mcu.b(2 * r),
+                  mcu.r(2 * r + 1), mcu.g(2 * r + 1), mcu.b(2 * r + 1), aligned_width);
+    }
+
+    for (int by = 0; by < 16; by += 8) {
+      for (int bx = 0; bx < aligned_width; bx += 8)
+        QuantizeBlock(mcu.luma + by * aligned_width + bx, aligned_width, luma_table);
+    }
+    for (int bx = 0; bx < chroma_width; bx += 8) {
+      QuantizeBlock(mcu.cb + bx, chroma_width, chroma_table);
+      QuantizeBlock(mcu.cr + bx, chroma_width, chroma_table);
+    }
+
+    int rows = std::min(16, H - mcu_y);
+    for (int r = 0; r < rows; r++) {
+      YCbCrToRgb(mcu.r(r), mcu.g(r), mcu.b(r), mcu.luma + r * aligned_width,
+                 mcu.cb + (r / 2) * chroma_width, mcu.cr + (r / 2) * chroma_width, aligned_width);
+      Interleave(out.data + (mcu_y + r) * row_stride, mcu.r(r), mcu.g(r), mcu.b(r), W);
+    }
+  }
+}
+
+}  // namespace jpeg
+}  // namespace kernels
+}  // namespace dali
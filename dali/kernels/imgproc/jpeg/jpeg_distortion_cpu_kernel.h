@@ -0,0 +1,47 @@
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_KERNELS_IMGPROC_JPEG_JPEG_DISTORTION_CPU_KERNEL_H_
+#define DALI_KERNELS_IMGPROC_JPEG_JPEG_DISTORTION_CPU_KERNEL_H_
+
+#include "dali/core/tensor_view.h"
+#include "dali/kernels/kernel.h"
+
+namespace dali {
+namespace kernels {
+namespace jpeg {
+
+/**
+ * @brief Produces JPEG compression artifacts by running the lossy part of
+ * JPEG compression and decompression.
+ *
+ * The image is processed in 16x16 pixel MCUs: the colors are converted to YCbCr with 4:2:0
+ * chroma subsampling, the 8x8 blocks are transformed with DCT, quantized and transformed back.
+ * No bitstream is produced, so the entropy coding (lossless) part of the codec is skipped.
+ * The results are equivalent to the ones of JpegCompressionDistortionGPU with subsampling
+ * in both directions.
+ */
+class DLL_PUBLIC JpegCompressionDistortionCPU {
+ public:
+  KernelRequirements Setup(KernelContext &ctx, const InTensorCPU<uint8_t, 3> &in);
+
+  void Run(KernelContext &ctx, const OutTensorCPU<uint8_t, 3> &out,
+           const InTensorCPU<uint8_t, 3> &in, int quality);
+};
+
+}  // namespace jpeg
+}  // namespace kernels
+}  // namespace dali
+
+#endif  // DALI_KERNELS_IMGPROC_JPEG_JPEG_DISTORTION_CPU_KERNEL_H_
@@ -0,0 +1,128 @@
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <opencv2/opencv.hpp>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+#include "dali/core/convert.h"
+#include "dali/kernels/imgproc/jpeg/jpeg_distortion_cpu_kernel.h"
+#include "dali/kernels/scratch.h"
+#include "dali/test/dali_test_config.h"
+#include "dali/util/image.h"
+
+namespace dali {
+namespace kernels {
+namespace jpeg {
+namespace test {
+
+namespace {
+
+/**
+ * @brief Converts to YCbCr, subsamples the chroma (4:2:0) and converts back to RGB
+ */
+std::vector<uint8_t> ChromaSubsampleRef(const uint8_t *in, int H, int W) {
+  std::vector<uint8_t> out(H * W * 3);
+  auto px = [&](int y, int x) { return in + (std::min(y, H - 1) * W + std::min(x, W - 1)) * 3; };
+  for (int y = 0; y < H; y++) {
+    for (int x = 0; x < W; x++) {
+      const uint8_t *p = px(y, x);
+      float r = p[0], g = p[1], b = p[2];
+      float Y = ConvertSat<uint8_t>(0.299f * r + 0.587f * g + 0.114f * b);
+      float avg[3];
+      int y0 = y & -2, x0 = x & -2;
+      for (int c = 0; c < 3; c++) {
+        avg[c] = ConvertSat<uint8_t>(0.25f * (px(y0, x0)[c] + px(y0, x0 + 1)[c] +
+                                              px(y0 + 1, x0)[c] + px(y0 + 1, x0 + 1)[c]));
+      }
+      float cb = ConvertSat<uint8_t>(
+        -0.16873589f * avg[0] - 0.33126411f * avg[1] + 0.5f * avg[2] + 128.0f) - 128.0f;
+      float cr = ConvertSat<uint8_t>(
+        0.5f * avg[0] - 0.41868759f * avg[1] - 0.08131241f * avg[2] + 128.0f) - 128.0f;
+      uint8_t *o = &out[(y * W + x) * 3];
+      o[0] = ConvertSat<uint8_t>(Y + 1.402f * cr);
+      o[1] = ConvertSat<uint8_t>(Y - 0.34413629f * cb - 0.71413629f * cr);
+      o[2] = ConvertSat<uint8_t>(Y + 1.772f * cb);
+    }
+  }
+  return out;
+}
+
+void RunKernel(std::vector<uint8_t> &out, const uint8_t *in, int H, int W, int quality) {
+  JpegCompressionDistortionCPU kernel;
+  KernelContext ctx;
+  TensorShape<3> sh{H, W, 3};
+  InTensorCPU<uint8_t, 3> in_view(in, sh);
+  auto req = kernel.Setup(ctx, in_view);
+  ASSERT_EQ(req.output_shapes[0][0], sh);
+  ScratchpadAllocator scratch_alloc;
+  scratch_alloc.Reserve(req.scratch_sizes);
+  auto scratchpad = scratch_alloc.GetScratchpad();
+  ctx.scratchpad = &scratchpad;
+  out.resize(volume(sh));
+  OutTensorCPU<uint8_t, 3> out_view(out.data(), sh);
+  kernel.Run(ctx, out_view, in_view, quality);
+}
+
+}  // namespace
+
+TEST(JpegDistortionTestCPU, HighestQualityOnlySubsamplesChroma) {
+  std::mt19937 rng(1234);
+  std::uniform_int_distribution<int> dist(0, 255);
+  for (auto hw : {std::make_pair(7, 9), std::make_pair(8, 16), std::make_pair(33, 47)}) {
+    int H = hw.first, W = hw.second;
+    std::vector<uint8_t> in(H * W * 3), out;
+    for (auto &v : in)
+      v = dist(rng);
+    RunKernel(out, in.data(), H, W, 100);
+    auto ref = ChromaSubsampleRef(in.data(), H, W);
+    for (int i = 0; i < H * W * 3; i++) {
+      // with quality 100, the quantization step is 1 for all the coefficients
+      ASSERT_NEAR(out[i], ref[i], 3) << "at " << i << " for image " << H << "x" << W;
+    }
+  }
+}
+
+TEST(JpegDistortionTestCPU, CompareWithLibjpeg) {
+  auto paths = ImageList(testing::dali_extra_path() + "/db/single/bmp", {".bmp"}, 3);
+  for (auto &path : paths) {
+    cv::Mat bgr = cv::imread(path), rgb;
+    cv::cvtColor(bgr, rgb, cv::COLOR_BGR2RGB);
+    for (int quality : {1, 5, 50, 95}) {
+      std::vector<uint8_t> out;
+      RunKernel(out, rgb.data, rgb.rows, rgb.cols, quality);
+
+      std::vector<uint8_t> encoded;
+      cv::imencode(".jpg", bgr, encoded, {cv::IMWRITE_JPEG_QUALITY, quality});
+      cv::Mat ref;
+      cv::cvtColor(cv::imdecode(encoded, cv::IMREAD_COLOR), ref, cv::COLOR_BGR2RGB);
+
+      cv::Mat out_mat(rgb.rows, rgb.cols, CV_8UC3, out.data()), diff;
+      cv::absdiff(out_mat, ref, diff);
+      double min_val, max_val;
+      cv::minMaxLoc(diff.reshape(1), &min_val, &max_val);
+      auto mean = cv::mean(diff);
+      EXPECT_LE(max_val, 80) << path << " quality " << quality;
+      for (int c = 0; c < 3; c++)
+        EXPECT_LE(mean[c], 3) << path << " quality " << quality;
+    }
+  }
+}
+
+}  // namespace test
+}  // namespace jpeg
+}  // namespace kernels
+}  // namespace dali
@@ -17,16 +17,150 @@
 
 #include <vector>
 #include <utility>
+#include <type_traits>
 #include "dali/core/format.h"
 #include "dali/core/convert.h"
 #include "dali/core/geom/box.h"
+#include "dali/core/geom/mat.h"
 #include "dali/kernels/common/block_setup.h"
+#include "dali/kernels/common/simd.h"
 #include "dali/kernels/imgproc/surface.h"
 #include "dali/kernels/imgproc/roi.h"
 
 namespace dali {
 namespace kernels {
 
+namespace detail {
+
+template <typename Out, typename In>
+void TransformPixels3(Out *out, const In *in, int64_t npixels, const mat3 &m, vec3 t,
+                      std::false_type) {
+  for (int64_t i = 0; i < npixels; i++, in += 3, out += 3) {
+    vec3 v_in;
+    for (int k = 0; k < 3; k++)
+      v_in[k] = in[k];
+    vec3 v = m * v_in + t;
+    out[0] = ConvertSat<Out>(v[0]);
+    out[1] = ConvertSat<Out>(v[1]);
+    out[2] = ConvertSat<Out>(v[2]);
+  }
+}
+
+#ifdef __SSE2__
+
+template <typename T>
+struct is_simd_pixel_type
+    : std::integral_constant<bool, std::is_same<T, uint8_t>::value ||
+                                   std::is_same<T, int8_t>::value ||
+                                   std::is_same<T, uint16_t>::value ||
+                                   std::is_same<T, int16_t>::value ||
+                                   std::is_same<T, float>::value> {};
+
+/**
+ * @brief Coefficients of a 3x3 affine transform, laid out for interleaved 3-channel pixels
+ *
+ * 4 pixels (12 values) occupy 3 vectors. Lane `l` of vector `j` holds channel
+ * `c = (4 * j + l) % 3`, so its result is the sum of `m(c, k) * x[4 * j + l + (k - c)]`.
+ * For each shift `s = k - c` in [-2, 2] the input is loaded at an offset of `s` and multiplied
+ * by the coefficients, which are zero in the lanes where `c + s` is not a valid channel.
+ * The non-zero products are summed in the same order as in `mat3 * vec3`, so the results
+ * don't differ from those of the scalar code.
+ */
+struct InterleavedMat3 {
+  __m128 coeffs[3][5];
+  __m128 offset[3];
+
+  InterleavedMat3(const mat3 &m, vec3 t) {
+    for (int j = 0; j < 3; j++) {
+      float c[5][4], o[4];
+      for (int l = 0; l < 4; l++) {
+        int ch = (4 * j + l) % 3;
+        o[l] = t[ch];
+        for (int s = -2; s <= 2; s++) {
+          int k = ch + s;
+          c[s + 2][l] = k >= 0 && k < 3 ? m(ch, k) : 0.0f;
+        }
+      }
+      for (int s = 0; s < 5; s++)
+        coeffs[j][s] = _mm_loadu_ps(c[s]);
+      offset[j] = _mm_loadu_ps(o);
+    }
+  }
+
+  DALI_FORCEINLINE __m128 apply(const float *x, int j) const {
+    __m128 acc = _mm_mul_ps(coeffs[j][0], _mm_loadu_ps(x - 2));
+    acc = _mm_add_ps(acc, _mm_mul_ps(coeffs[j][1], _mm_loadu_ps(x - 1)));
+    acc = _mm_add_ps(acc, _mm_mul_ps(coeffs[j][2], _mm_loadu_ps(x)));
+    acc = _mm_add_ps(acc, _mm_mul_ps(coeffs[j][3], _mm_loadu_ps(x + 1)));
+    acc = _mm_add_ps(acc, _mm_mul_ps(coeffs[j][4], _mm_loadu_ps(x + 2)));
+    return _mm_add_ps(acc, offset[j]);
+  }
+};
+
+template <typename Out, typename In>
+void TransformPixels3(Out *out, const In *in, int64_t npixels, const mat3 &m, vec3 t,
+                      std::true_type) {
+  constexpr int kChunkPixels = 64;
+  constexpr int kChunk = 3 * kChunkPixels;  // divisible by both 12 and 16
+  InterleavedMat3 im(m, t);
+  // the input is converted to float, with 4 elements of padding on each side
+  alignas(16) float x[kChunk + 8];
+  alignas(16) float y[kChunk];
+  for (int i = 0; i < 4; i++)
+    x[i] = x[kChunk + 4 + i] = 0;
+
+  int64_t p = 0;
+  for (; p + kChunkPixels <= npixels; p += kChunkPixels, in += kChunk, out += kChunk) {
+    for (int i = 0; i < kChunk; i += 16) {
+      simd::float4x4 v = simd::load16(in + i);
+      _mm_store_ps(x + 4 + i, v.v[0]);
+      _mm_store_ps(x + 8 + i, v.v[1]);
+      _mm_store_ps(x + 12 + i, v.v[2]);
+      _mm_store_ps(x + 16 + i, v.v[3]);
+    }
+    for (int i = 0; i < kChunk; i += 12) {
+      _mm_store_ps(y + i, im.apply(x + 4 + i, 0));
+      _mm_store_ps(y + i + 4, im.apply(x + 8 + i, 1));
+      _mm_store_ps(y + i + 8, im.apply(x + 12 + i, 2));
+    }
+    for (int i = 0; i < kChunk; i += 16) {
+      simd::store16(out + i, simd::float4x4{{ _mm_load_ps(y + i), _mm_load_ps(y + i + 4),
+                                              _mm_load_ps(y + i + 8), _mm_load_ps(y + i + 12) }});
+    }
+  }
+  TransformPixels3(out, in, npixels - p, m, t, std::false_type());
+}
+
+template <typename Out, typename In>
+void TransformPixels3(Out *out, const In *in, int64_t npixels, const mat3 &m, vec3 t) {
+  using simd_supported = std::integral_constant<bool, is_simd_pixel_type<Out>::value &&
+                                                      is_simd_pixel_type<In>::value>;
+  TransformPixels3(out, in, npixels, m, t, simd_supported());
+}
+
+#else
+
+template <typename Out, typename In>
+void TransformPixels3(Out *out, const In *in, int64_t npixels, const mat3 &m, vec3 t) {
+  TransformPixels3(out, in, npixels, m, t, std::false_type());
+}
+
+#endif  // __SSE2__
+
+}  // namespace detail
+
+/**
+ * @brief Applies an affine transform `m * x + t` to each of `npixels` consecutive,
+ *        interleaved 3-channel pixels
+ *
+ * The results are the same as those of the scalar `mat3 * vec3 + vec3` followed by `ConvertSat`,
+ * but the common pixel types are processed with SIMD instructions.
+ */
+template <typename Out, typename In>
+void TransformPixels3(Out *out, const In *in, int64_t npixels, const mat3 &m, vec3 t) {
+  detail::TransformPixels3(out, in, npixels, m, t);
+}
+
 template <typename OutputType, typename InputType, int channels_out, int channels_in, int ndims>
 class LinearTransformationCpu {
  private:
@@ -57,7 +191,13 @@ class LinearTransformationCpu {
             const InTensorCPU<InputType, ndims> &in, Mat tmatrix = Mat::eye(), Vec tvector = {},
             const Roi<spatial_ndims_> *roi = nullptr) {
     auto adjusted_roi = AdjustRoi(roi, in.shape);
-    auto ptr = out.data;
+    using is_3ch = std::integral_constant<bool, channels_in == 3 && channels_out == 3>;
+    RunImpl(out.data, in, tmatrix, tvector, adjusted_roi, is_3ch());
+  }
+
+ private:
+  void RunImpl(OutputType *ptr, const InTensorCPU<InputType, ndims> &in, const Mat &tmatrix,
+               const Vec &tvector, const Roi<spatial_ndims_> &adjusted_roi, std::false_type) {
     auto in_width = in.shape[1];
 
     for (int y = adjusted_roi.lo.y; y < adjusted_roi.hi.y; y++) {
@@ -74,6 +214,21 @@ class LinearTransformationCpu {
       }
     }
   }
+
+  void RunImpl(OutputType *ptr, const InTensorCPU<InputType, ndims> &in, const Mat &tmatrix,
+               const Vec &tvector, const Roi<spatial_ndims_> &adjusted_roi, std::true_type) {
+    auto in_width = in.shape[1];
+    int64_t row_pixels = adjusted_roi.hi.x - adjusted_roi.lo.x;
+    int64_t nrows = adjusted_roi.hi.y - adjusted_roi.lo.y;
+    if (row_pixels == in_width) {  // full rows are contiguous
+      row_pixels *= nrows;
+      nrows = 1;
+    }
+    auto *row_ptr = &in.data[(adjusted_roi.lo.y * in_width + adjusted_roi.lo.x) * 3];
+    for (int64_t y = 0; y < nrows; y++, ptr += 3 * row_pixels, row_ptr += 3 * in_width) {
+      TransformPixels3(ptr, row_ptr, row_pixels, tmatrix, tvector);
+    }
+  }
 };
 
 }  // namespace kernels
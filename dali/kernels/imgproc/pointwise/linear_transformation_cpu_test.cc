@@ -164,6 +164,47 @@ TYPED_TEST(LinearTransformationCpuTest, run_test_with_roi) {
   Check(out, view_as_tensor<float>(mat), EqualUlp());
 }
 
+template <typename Out, typename In>
+void RunTest3Channels(const Roi<2> *roi) {
+  TensorShape<kNDims> in_shape = {17, 70, 3};
+  std::vector<In> input(volume(in_shape));
+  std::mt19937_64 rng;
+  UniformRandomFill(input, rng, 0., 100.);
+  mat3 m = {{{0.299f, 0.587f, 0.114f}, {-0.169f, -0.331f, 0.5f}, {0.5f, -0.419f, -0.081f}}};
+  vec3 t = {0.5f, 128, 128};
+
+  LinearTransformationCpu<Out, In, 3, 3, kNDims> kernel;
+  KernelContext ctx;
+  InTensorCPU<In, kNDims> in(input.data(), in_shape);
+  auto reqs = kernel.Setup(ctx, in, m, t, roi);
+  auto out_shape = reqs.output_shapes[0][0].template to_static<kNDims>();
+  std::vector<Out> output(volume(out_shape));
+  kernel.Run(ctx, make_tensor_cpu(output.data(), out_shape), in, m, t, roi);
+
+  auto adjusted_roi = AdjustRoi(roi, in_shape);
+  int idx = 0;
+  for (int y = adjusted_roi.lo.y; y < adjusted_roi.hi.y; y++) {
+    for (int x = adjusted_roi.lo.x; x < adjusted_roi.hi.x; x++) {
+      const In *px = &input[(y * in_shape[1] + x) * 3];
+      vec3 v = m * vec3(px[0], px[1], px[2]) + t;
+      for (int c = 0; c < 3; c++, idx++)
+        ASSERT_EQ(output[idx], ConvertSat<Out>(v[c])) << "at " << y << ", " << x << ", " << c;
+    }
+  }
+}
+
+TEST(LinearTransformationCpu3ChannelsTest, run_test) {
+  Roi<2> roi = {{3, 1}, {68, 15}};
+  const Roi<2> *rois[] = {nullptr, &roi};
+  for (auto *r : rois) {
+    RunTest3Channels<uint8_t, uint8_t>(r);
+    RunTest3Channels<float, uint8_t>(r);
+    RunTest3Channels<int16_t, float>(r);
+    RunTest3Channels<float, float>(r);
+    RunTest3Channels<int32_t, int32_t>(r);
+  }
+}
+
 }  // namespace test
 }  // namespace kernels
 }  // namespace dali
@@ -15,12 +15,10 @@
 #ifndef DALI_KERNELS_IMGPROC_STRUCTURE_CONNECTED_COMPONENTS_H_
 #define DALI_KERNELS_IMGPROC_STRUCTURE_CONNECTED_COMPONENTS_H_
 
-#include <set>
+#include <algorithm>
 #include <stdexcept>
 #include <unordered_map>
-#include <unordered_set>
-#include <mutex>
-#include <thread>
+#include <vector>
 #include "dali/core/tensor_view.h"
 #include "dali/core/geom/vec.h"
 #include "dali/core/geom/box.h"
@@ -29,7 +27,6 @@
 #include "dali/kernels/common/utils.h"
 #include "dali/kernels/kernel.h"
 #include "dali/core/exec/engine.h"
-#include "dali/core/spinlock.h"
 
 namespace dali {
 namespace kernels {
@@ -60,6 +57,17 @@ struct TensorSlice {
       sub<ndim-1>(size, 1)
     };
   }
+
+  /**
+   * @brief Returns a slab consisting of outer indices [begin, end)
+   */
+  DALI_HOST_DEV DALI_FORCEINLINE
+  TensorSlice<T, ndim> slab(int64_t begin, int64_t end) const noexcept {
+    TensorSlice<T, ndim> ret = *this;
+    ret.data += stride[0] * begin;
+    ret.size[0] = end - begin;
+    return ret;
+  }
 };
 
 
@@ -203,19 +211,31 @@ void LabelSlice(OutLabel *label_base,
     return;
   }
 
+  // The outer dimension is split into slabs of consecutive slices; each slab is labeled
+  // sequentially and then the slabs are merged at their boundaries.
+  constexpr int kSlabsPerThread = 4;
+  int64_t num_slabs = std::min<int64_t>(n, engine.NumThreads() * kSlabsPerThread);
+  auto slab_start = [=](int64_t slab) {
+    return n * slab / num_slabs;
+  };
+
   SequentialExecutionEngine seq_engn;
 
-  for (int64_t i = 0; i < n; i++) {
-    auto out_slice = out.slice(i);
-    auto in_slice = in.slice(i);
+  for (int64_t slab = 0; slab < num_slabs; slab++) {
+    int64_t start = slab_start(slab), end = slab_start(slab + 1);
+    auto out_slab = out.slab(start, end);
+    auto in_slab = in.slab(start, end);
     engine.AddWork([=, &seq_engn](int){
-      LabelSlice(label_base, out_slice, in_slice, background, seq_engn);
-    });
+      LabelSlice(label_base, out_slab, in_slab, background, seq_engn);
+    }, (end - start) * volume(sub<ndim-1>(in.size, 1)));
   }
   engine.RunAll();
 
-  for (int64_t stride = 1; stride <= n; stride *= 2) {
-    for (int64_t i = stride; i < n; i += 2*stride) {
+  // Merge the slabs pairwise - in each round, the merged groups of slabs are disjoint,
+  // so they can be processed in parallel.
+  for (int64_t stride = 1; stride < num_slabs; stride *= 2) {
+    for (int64_t slab = stride; slab < num_slabs; slab += 2*stride) {
+      int64_t i = slab_start(slab);
       auto out_slice = out.slice(i);
       auto in_slice = in.slice(i);
       auto prev_out = out.slice(i-1);
@@ -252,6 +272,54 @@ void RemapChunk(span<OutLabel> chunk, const LabelMapping &mapping) {
   }
 }
 
+/**
+ * @brief Label information gathered by FlattenChunk
+ */
+template <typename OutLabel>
+struct ChunkLabels {
+  std::vector<OutLabel> roots;           // roots within the chunk, in ascending order
+  std::vector<OutLabel> external;        // labels pointing to elements before the chunk
+  std::vector<OutLabel> external_roots;  // roots of the `external` labels
+};
+
+/**
+ * @brief Replaces the labels in range [chunk_start, chunk_end) with their roots, as long as
+ *        the root is within the range.
+ *
+ * Labels which point to elements before `chunk_start` are stored in `info.external` and left
+ * unchanged. Only the elements within the chunk are accessed, so the chunks can be processed
+ * in parallel.
+ */
+template <typename OutLabel>
+void FlattenChunk(OutLabel *labels, int64_t chunk_start, int64_t chunk_end,
+                  ChunkLabels<OutLabel> &info) {
+  constexpr OutLabel old_bg_label = static_cast<OutLabel>(-1);
+  OutLabel prev = old_bg_label;
+  OutLabel flat = old_bg_label;
+  for (int64_t i = chunk_start; i < chunk_end; i++) {
+    OutLabel curr = labels[i];
+    if (curr == old_bg_label)
+      continue;
+    if (curr != prev) {
+      // look up the parent only when the value changes - this saves a lot of memory accesses
+      prev = curr;
+      int64_t parent = curr;
+      if (parent == i) {
+        flat = curr;
+        info.roots.push_back(curr);
+      } else if (parent >= chunk_start) {
+        flat = labels[parent];  // already flattened
+      } else {
+        flat = curr;
+      }
+      if (static_cast<int64_t>(flat) < chunk_start &&
+          (info.external.empty() || info.external.back() != flat))
+        info.external.push_back(flat);
+    }
+    labels[i] = flat;
+  }
+}
+
 /**
  * @brief Compacts label indices in `labels`
  *
@@ -270,96 +338,76 @@ int64_t CompactLabels(OutLabel *labels,
                       ExecutionEngine &engine,
                       OutLabel bg_label = 0) {
   constexpr OutLabel old_bg_label = static_cast<OutLabel>(-1);
-  OutLabel curr_label = 1;
-  std::unordered_map<OutLabel, OutLabel> label_map;
-  disjoint_set<OutLabel, OutLabel> ds;
 
   const int64_t chunk_size = 16<<10;
   int num_chunks = std::min<int>(div_ceil(volume, chunk_size), engine.NumThreads());
+  auto chunk_start = [=](int chunk) {
+    return volume * chunk / num_chunks;
+  };
 
   // Optimized label compaction algorithm:
   //
-  // Labels are scanned and only when the label value changes are we invoking ds.find.
-  // In the second pass, we only look up the map when the value changes, but this time we
-  // can't call ds.find, because we're overwriting the labels array and the disjoint set
-  // structure is effectively corrupted.
-
-  std::set<OutLabel> label_set;
-
-  if (num_chunks == 1) {
-    std::unordered_set<OutLabel> tmp_set;
-    OutLabel prev = old_bg_label;
-    OutLabel remapped = old_bg_label;
-    for (int64_t i = 0; i < volume; i++) {
-      if (labels[i] != old_bg_label) {
-        if (labels[i] != prev) {
-          prev = labels[i];
-          // look up `ds` only when the value changes - this saves a lot of lookups
-          remapped = ds.find(labels, i);
-          // no need to assign labels[i] = remapped; find did it
-          tmp_set.insert(remapped);
-        } else {
-          labels[i] = remapped;
-        }
-      }
-    }
-    for (auto l : tmp_set)
-      label_set.insert(l);
-  } else {
-    SmallVector<std::unordered_set<OutLabel>, 16> tmp_sets;
-    tmp_sets.resize(engine.NumThreads());
-    spinlock lock;
-    for (int chunk = 0; chunk < num_chunks; chunk++) {
-      int64_t chunk_start = volume * chunk / num_chunks;
-      int64_t chunk_end = volume * (chunk + 1) / num_chunks;
-
-      engine.AddWork([=, &tmp_sets, &lock](int thread) {
-        OutLabel prev = old_bg_label;
-        OutLabel remapped = old_bg_label;
-        for (int64_t i = chunk_start; i < chunk_end; i++) {
-          OutLabel curr = labels[i];
-          if (curr != old_bg_label) {
-            if (curr != prev) {
-              {
-                std::lock_guard<spinlock> g(lock);
-                prev = curr;
-                // look up `ds` only when the value changes - this saves a lot of lookups
-                remapped = ds.find(labels, i);
-              }
-              tmp_sets[thread].insert(remapped);
-            } else {
-              labels[i] = remapped;
-            }
-          }
-        }
-      });
-    }
-    engine.RunAll();
+  // Merging always attaches the root with a higher index to the one with a lower index,
+  // so a parent precedes its children and a single forward pass replaces each label with its
+  // root - and the roots are the elements which are labeled with their own index.
+  //
+  // When processing in parallel, the labels pointing to preceding chunks cannot be resolved
+  // in the first pass. Since each such element points to a root or to an earlier chunk,
+  // the chains are short; they are followed in a separate, read-only pass.
+  // Finally, these labels are added to the label map, so that the remapping pass needs no
+  // further lookups in the disjoint set.
+
+  std::vector<ChunkLabels<OutLabel>> chunks(num_chunks);
+  for (int chunk = 0; chunk < num_chunks; chunk++) {
+    engine.AddWork([=, &chunks](int) {
+      FlattenChunk(labels, chunk_start(chunk), chunk_start(chunk + 1), chunks[chunk]);
+    });
+  }
+  engine.RunAll();
 
-    for (auto &tmp_set : tmp_sets)
-      for (OutLabel l : tmp_set)
-        label_set.insert(l);
+  for (int chunk = 1; chunk < num_chunks; chunk++) {
+    if (chunks[chunk].external.empty())
+      continue;
+    engine.AddWork([=, &chunks](int) {
+      auto &info = chunks[chunk];
+      info.external_roots.reserve(info.external.size());
+      for (OutLabel x : info.external) {
+        while (labels[x] != x)
+          x = labels[x];
+        info.external_roots.push_back(x);
+      }
+    });
   }
+  engine.RunAll();
 
+  std::unordered_map<OutLabel, OutLabel> label_map;
+  int64_t num_labels = 0;
   OutLabel next_label = 0;
-  for (auto old : label_set) {
-    if (next_label == bg_label)
-      next_label++;
-    label_map[old] = next_label++;
+  for (auto &info : chunks) {
+    for (auto old : info.roots) {
+      if (next_label == bg_label)
+        next_label++;
+      label_map[old] = next_label++;
+    }
+    num_labels += info.roots.size();
+  }
+  for (auto &info : chunks) {
+    for (size_t i = 0; i < info.external.size(); i++) {
+      OutLabel new_label = label_map[info.external_roots[i]];
+      label_map[info.external[i]] = new_label;
+    }
   }
   label_map[old_bg_label] = bg_label;
 
-  OutLabel prev = old_bg_label;
-
   for (int chunk = 0; chunk < num_chunks; chunk++) {
-    int64_t chunk_start = volume * chunk / num_chunks;
-    int64_t chunk_end = volume * (chunk + 1) / num_chunks;
+    int64_t start = chunk_start(chunk);
+    int64_t end = chunk_start(chunk + 1);
     engine.AddWork([=, &label_map](int) {
-      RemapChunk(make_span(labels + chunk_start, chunk_end - chunk_start), label_map);
+      RemapChunk(make_span(labels + start, end - start), label_map);
     });
   }
   engine.RunAll();
-  return label_set.size();
+  return num_labels;
 }
 
 template <typename OutLabel>
@@ -13,7 +13,13 @@
 // limitations under the License.
 
 #include <gtest/gtest.h>
+#include <atomic>
 #include <cassert>
+#include <functional>
+#include <queue>
+#include <random>
+#include <thread>
+#include <utility>
 #include <vector>
 #include "dali/kernels/imgproc/structure/connected_components.h"
 #include "dali/test/tensor_test_utils.h"
@@ -155,5 +161,110 @@ TEST(ConnectedComponets, 3D) {
   Check(out, ref);
 }
 
+namespace {
+
+/**
+ * @brief Runs the work items on `num_threads` threads, in order reversed with respect to
+ *        the submission, to make dependencies on the order more likely to show up.
+ */
+class TestThreadedEngine {
+ public:
+  explicit TestThreadedEngine(int num_threads) : num_threads_(num_threads) {}
+
+  template <typename FunctionLike>
+  void AddWork(FunctionLike &&f, int64_t priority = 0, bool start_immediately = false) {
+    work_.emplace_back(std::forward<FunctionLike>(f));
+  }
+
+  void RunAll() {
+    std::atomic<int> next{static_cast<int>(work_.size())};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads_; t++) {
+      threads.emplace_back([&, t]() {
+        for (int i; (i = --next) >= 0; )
+          work_[i](t);
+      });
+    }
+    for (auto &t : threads)
+      t.join();
+    work_.clear();
+  }
+
+  int NumThreads() const noexcept { return num_threads_; }
+
+ private:
+  int num_threads_;
+  std::vector<std::function<void(int)>> work_;
+};
+
+/**
+ * @brief Labels 6-connected regions with flood fill; the labels are assigned in the order
+ *        of the first element of each region.
+ */
+std::vector<int> RefLabel3D(const std::vector<uint8_t> &in, TensorShape<3> shape, int &n) {
+  std::vector<int> out(in.size(), -1);
+  n = 0;
+  int64_t strides[3] = { shape[1] * shape[2], shape[2], 1 };
+  for (int64_t start = 0; start < static_cast<int64_t>(in.size()); start++) {
+    if (in[start] == 0) {
+      out[start] = 0;
+      continue;
+    }
+    if (out[start] >= 0)
+      continue;
+    int label = ++n;
+    std::queue<int64_t> q;
+    out[start] = label;
+    q.push(start);
+    while (!q.empty()) {
+      int64_t idx = q.front();
+      q.pop();
+      for (int d = 0; d < 3; d++) {
+        int64_t coord = idx / strides[d] % shape[d];
+        for (int dir = -1; dir <= 1; dir += 2) {
+          if (coord + dir < 0 || coord + dir >= shape[d])
+            continue;
+          int64_t neighbor = idx + dir * strides[d];
+          if (in[neighbor] == in[start] && out[neighbor] < 0) {
+            out[neighbor] = label;
+            q.push(neighbor);
+          }
+        }
+      }
+    }
+  }
+  return out;
+}
+
+}  // namespace
+
+TEST(ConnectedComponets, 3D_MultiThreaded) {
+  TensorShape<3> shape = { 37, 61, 53 };
+  std::vector<uint8_t> input(volume(shape));
+  std::mt19937 rng(1234);
+  std::uniform_int_distribution<int> noise(0, 15);
+  for (int z = 0, i = 0; z < shape[0]; z++)
+    for (int y = 0; y < shape[1]; y++)
+      for (int x = 0; x < shape[2]; x++, i++) {
+        // stripes crossing the slabs and chunks, broken up by noise
+        int v = (x / 5 + y / 7 + z / 3) % 3;
+        int r = noise(rng);
+        input[i] = r < 2 ? r : v;
+      }
+
+  int ref_n = 0;
+  auto ref = RefLabel3D(input, shape, ref_n);
+  InTensorCPU<uint8_t, 3> in = make_tensor_cpu<3>(input.data(), shape);
+
+  for (int num_threads : { 1, 3, 4 }) {
+    std::vector<int> output(input.size());
+    OutTensorCPU<int, 3> out = make_tensor_cpu<3>(output.data(), shape);
+    TestThreadedEngine engine(num_threads);
+    int64_t n = connected_components::LabelConnectedRegions(out, in, engine, 0, 0);
+    EXPECT_EQ(n, ref_n) << "with " << num_threads << " threads";
+    EXPECT_EQ(output, ref) << "with " << num_threads << " threads";
+  }
+}
+
 }  // namespace kernels
 }  // namespace dali
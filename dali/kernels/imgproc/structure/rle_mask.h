@@ -0,0 +1,391 @@
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_KERNELS_IMGPROC_STRUCTURE_RLE_MASK_H_
+#define DALI_KERNELS_IMGPROC_STRUCTURE_RLE_MASK_H_
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+#include "dali/core/geom/box.h"
+#include "dali/core/span.h"
+#include "dali/core/tensor_view.h"
+
+namespace dali {
+namespace kernels {
+namespace rle {
+
+/**
+ * @brief A run of equal, non-background values in one row of a mask
+ */
+template <typename Label>
+struct RLERun {
+  int64_t begin, end;  // [begin, end) range of columns
+  Label value;
+};
+
+/**
+ * @brief Run-length encoded 2D mask
+ *
+ * Each row is encoded separately, as a sorted list of non-overlapping runs of non-zero
+ * values. The background (0) is implicit, so the memory footprint is proportional to the
+ * number of runs rather than to the area of the mask.
+ *
+ * The runs of row `y` are `runs[row_offsets[y]] ... runs[row_offsets[y + 1] - 1]`.
+ *
+ * The mask is built row by row with `AddRun` and `EndRow`, after `Reset`.
+ */
+template <typename Label>
+struct RLEMask {
+  int64_t height = 0, width = 0;
+  std::vector<int64_t> row_offsets = {0};
+  std::vector<RLERun<Label>> runs;
+
+  void Reset(int64_t h, int64_t w) {
+    height = h;
+    width = w;
+    row_offsets.clear();
+    row_offsets.reserve(h + 1);
+    row_offsets.push_back(0);
+    runs.clear();
+  }
+
+  /**
+   * @brief Appends a run to the current row; merges it with the previous one, if they touch
+   *        and have the same value.
+   */
+  void AddRun(int64_t begin, int64_t end, Label value) {
+    assert(begin < end);
+    if (static_cast<int64_t>(runs.size()) > row_offsets.back()) {
+      auto &last = runs.back();
+      assert(last.end <= begin);
+      if (last.end == begin && last.value == value) {
+        last.end = end;
+        return;
+      }
+    }
+    runs.push_back({ begin, end, value });
+  }
+
+  void EndRow() {
+    row_offsets.push_back(runs.size());
+  }
+
+  /**
+   * @brief Appends a row with the same contents as row `y`
+   */
+  void CopyRow(int64_t y) {
+    assert(y < num_rows());
+    runs.insert(runs.end(), runs.begin() + row_offsets[y], runs.begin() + row_offsets[y + 1]);
+    EndRow();
+  }
+
+  /**
+   * @brief Number of rows encoded so far
+   */
+  int64_t num_rows() const {
+    return row_offsets.size() - 1;
+  }
+
+  span<const RLERun<Label>> row(int64_t y) const {
+    assert(y >= 0 && y < num_rows());
+    return make_span(runs.data() + row_offsets[y], row_offsets[y + 1] - row_offsets[y]);
+  }
+};
+
+/**
+ * @brief Encodes a dense 2D mask; zeros are treated as background
+ */
+template <typename Label, typename In>
+void Encode(RLEMask<Label> &out, TensorView<StorageCPU, In, 2> in) {
+  int64_t h = in.shape[0], w = in.shape[1];
+  out.Reset(h, w);
+  for (int64_t y = 0; y < h; y++) {
+    const In *row = in.data + y * w;
+    int64_t x = 0;
+    while (x < w) {
+      while (x < w && row[x] == 0)
+        x++;
+      if (x == w)
+        break;
+      int64_t begin = x;
+      In value = row[x];
+      while (x < w && row[x] == value)
+        x++;
+      out.AddRun(begin, x, static_cast<Label>(value));
+    }
+    out.EndRow();
+  }
+}
+
+/**
+ * @brief Writes the runs of `in` to `out`, leaving the background pixels untouched
+ *
+ * This can be used to overlay several masks, in which case the masks painted later win.
+ */
+template <typename Out, typename Label>
+void Paint(TensorView<StorageCPU, Out, 2> out, const RLEMask<Label> &in) {
+  assert(out.shape[0] == in.height && out.shape[1] == in.width);
+  for (int64_t y = 0; y < in.height; y++) {
+    Out *row = out.data + y * in.width;
+    for (auto &run : in.row(y))
+      std::fill(row + run.begin, row + run.end, static_cast<Out>(run.value));
+  }
+}
+
+/**
+ * @brief Decodes the mask into a dense 2D tensor
+ */
+template <typename Out, typename Label>
+void Decode(TensorView<StorageCPU, Out, 2> out, const RLEMask<Label> &in) {
+  std::fill(out.data, out.data + volume(out.shape), Out());
+  Paint(out, in);
+}
+
+/**
+ * @brief Converts a COCO-style, column-major RLE to a row-wise `RLEMask`
+ *
+ * The counts alternate between background and foreground runs, starting with background,
+ * and traverse the mask column by column.
+ *
+ * The conversion never touches individual pixels: for each column, the rows whose state
+ * differs from the previous column are found by merging the boundaries of both columns' runs.
+ * A foreground run is opened in the rows that become foreground and closed in the ones that
+ * become background, so the cost is proportional to the number of runs in the output.
+ *
+ * @param value the value assigned to the foreground
+ */
+template <typename Label, typename Count>
+void FromColumnMajorCounts(RLEMask<Label> &out, int64_t height, int64_t width,
+                           span<const Count> counts, Label value) {
+  struct RowRun {
+    int64_t row, begin, end;
+  };
+  std::vector<RowRun> row_runs;
+  std::vector<int64_t> open(height, -1);  // first column of the run open in a row, or -1
+  std::vector<int64_t> prev, curr;  // boundaries of the foreground ranges in adjacent columns
+
+  // Toggles the rows whose state in column `x` (`curr`) differs from column `x - 1` (`prev`)
+  auto flush = [&](int64_t x) {
+    auto toggle = [&](int64_t y0, int64_t y1) {
+      for (int64_t y = y0; y < y1; y++) {
+        if (open[y] < 0) {
+          open[y] = x;
+        } else {
+          row_runs.push_back({ y, open[y], x });
+          open[y] = -1;
+        }
+      }
+    };
+    size_t i = 0, j = 0;
+    int64_t start = -1;
+    auto boundary = [&](int64_t b) {
+      if (start < 0) {
+        start = b;
+      } else {
+        toggle(start, b);
+        start = -1;
+      }
+    };
+    while (i < prev.size() || j < curr.size()) {
+      if (j == curr.size() || (i < prev.size() && prev[i] < curr[j])) {
+        boundary(prev[i++]);
+      } else if (i == prev.size() || curr[j] < prev[i]) {
+        boundary(curr[j++]);
+      } else {  // the same boundary in both columns - no change
+        i++;
+        j++;
+      }
+    }
+    assert(start < 0);
+    prev.swap(curr);
+    curr.clear();
+  };
+
+  int64_t col = 0;
+  int64_t pos = 0;
+  const int64_t total = height * width;
+  for (int64_t k = 1; k < counts.size() && pos < total; k += 2) {
+    pos += counts[k - 1];
+    int64_t end = std::min<int64_t>(pos + counts[k], total);
+    while (pos < end) {
+      int64_t x = pos / height, y = pos % height;
+      if (x != col) {
+        flush(col);
+        if (x != col + 1)
+          flush(col + 1);  // an empty column in between closes all runs
+        col = x;
+      }
+      int64_t len = std::min(end - pos, height - y);
+      if (!curr.empty() && curr.back() == y)
+        curr.back() = y + len;
+      else
+        curr.insert(curr.end(), { y, y + len });
+      pos += len;
+    }
+  }
+  flush(col);
+  flush(col + 1);  // close the runs that reach the last column
+
+  // The runs of each row were produced in the order of columns - a stable counting sort
+  // by row gives a valid RLEMask.
+  out.Reset(height, width);
+  out.row_offsets.resize(height + 1, 0);
+  for (auto &r : row_runs)
+    out.row_offsets[r.row + 1]++;
+  for (int64_t y = 0; y < height; y++)
+    out.row_offsets[y + 1] += out.row_offsets[y];
+  out.runs.resize(row_runs.size());
+  std::vector<int64_t> fill(out.row_offsets.begin(), out.row_offsets.end() - 1);
+  for (auto &r : row_runs)
+    out.runs[fill[r.row]++] = { r.begin, r.end, value };
+}
+
+/**
+ * @brief Crops a mask to a window of size `height` x `width` that starts at (`y0`, `x0`)
+ *
+ * The window may extend beyond the bounds of the mask, in which case the area outside is
+ * filled with background.
+ */
+template <typename Label>
+void Crop(RLEMask<Label> &out, const RLEMask<Label> &in,
+          int64_t y0, int64_t x0, int64_t height, int64_t width) {
+  assert(&out != &in);
+  out.Reset(height, width);
+  for (int64_t y = 0; y < height; y++) {
+    int64_t src_y = y + y0;
+    if (src_y >= 0 && src_y < in.height) {
+      auto runs = in.row(src_y);
+      // skip the runs that end before the window
+      auto it = std::upper_bound(runs.begin(), runs.end(), x0,
+                                 [](int64_t x, const RLERun<Label> &r) { return x < r.end; });
+      for (; it != runs.end() && it->begin < x0 + width; ++it) {
+        int64_t begin = std::max(it->begin, x0) - x0;
+        int64_t end = std::min(it->end, x0 + width) - x0;
+        out.AddRun(begin, end, it->value);
+      }
+    }
+    out.EndRow();
+  }
+}
+
+/**
+ * @brief Flips the mask horizontally and/or vertically
+ */
+template <typename Label>
+void Flip(RLEMask<Label> &out, const RLEMask<Label> &in, bool horizontal, bool vertical) {
+  assert(&out != &in);
+  out.Reset(in.height, in.width);
+  out.runs.reserve(in.runs.size());
+  for (int64_t y = 0; y < in.height; y++) {
+    auto runs = in.row(vertical ? in.height - 1 - y : y);
+    if (horizontal) {
+      for (int64_t i = runs.size() - 1; i >= 0; i--)
+        out.AddRun(in.width - runs[i].end, in.width - runs[i].begin, runs[i].value);
+    } else {
+      out.runs.insert(out.runs.end(), runs.begin(), runs.end());
+    }
+    out.EndRow();
+  }
+}
+
+namespace detail {
+
+/**
+ * @brief Returns the first output coordinate which is mapped by nearest neighbor
+ *        resampling to a source coordinate >= `src`
+ *
+ * The source coordinate of output pixel `x` is `floor((x + 0.5) * in_size / out_size)`;
+ * integer arithmetic is used to avoid rounding errors at run boundaries.
+ */
+inline int64_t NNFirstDst(int64_t src, int64_t in_size, int64_t out_size) {
+  // smallest x such that (2x + 1) * in_size >= 2 * src * out_size
+  int64_t num = 2 * src * out_size - in_size;
+  if (num <= 0)
+    return 0;
+  int64_t den = 2 * in_size;
+  return std::min((num + den - 1) / den, out_size);
+}
+
+inline int64_t NNSrc(int64_t dst, int64_t in_size, int64_t out_size) {
+  return (2 * dst + 1) * in_size / (2 * out_size);
+}
+
+}  // namespace detail
+
+/**
+ * @brief Resizes the mask with nearest neighbor interpolation
+ *
+ * The sampling matches that of the `ResampleNN` kernel. Each run is mapped to a range of
+ * output columns directly and rows that sample the same source row are copied.
+ */
+template <typename Label>
+void ResizeNearest(RLEMask<Label> &out, const RLEMask<Label> &in,
+                   int64_t out_height, int64_t out_width) {
+  assert(&out != &in);
+  out.Reset(out_height, out_width);
+  int64_t prev_src_y = -1;
+  for (int64_t y = 0; y < out_height; y++) {
+    int64_t src_y = detail::NNSrc(y, in.height, out_height);
+    if (src_y == prev_src_y) {
+      out.CopyRow(y - 1);
+      continue;
+    }
+    prev_src_y = src_y;
+    for (auto &run : in.row(src_y)) {
+      int64_t begin = detail::NNFirstDst(run.begin, in.width, out_width);
+      int64_t end = detail::NNFirstDst(run.end, in.width, out_width);
+      if (begin < end)
+        out.AddRun(begin, end, run.value);
+    }
+    out.EndRow();
+  }
+}
+
+/**
+ * @brief Calculates a bounding box for each label in the mask
+ *
+ * The box index for a label is `label - 1` (there's no box for the background). Labels whose
+ * box index is outside of the valid range of indices in `boxes` are ignored.
+ * The box coordinates follow the order of the dimensions: (row, column).
+ */
+template <typename Coord, typename Label>
+void GetLabelBoundingBoxes(span<Box<2, Coord>> boxes, const RLEMask<Label> &in) {
+  for (auto &box : boxes)
+    box = {};
+  const unsigned nboxes = boxes.size();
+  for (int64_t y = 0; y < in.height; y++) {
+    for (auto &run : in.row(y)) {
+      // deliberate use of unsigned overflow to detect negative labels as out-of-range
+      unsigned idx = static_cast<unsigned>(run.value) - 1u;
+      if (idx >= nboxes)
+        continue;
+      vec<2, Coord> lo = { static_cast<Coord>(y), static_cast<Coord>(run.begin) };
+      vec<2, Coord> hi = { static_cast<Coord>(y + 1), static_cast<Coord>(run.end) };
+      auto &box = boxes[idx];
+      if (box.empty()) {
+        box = { lo, hi };
+      } else {
+        box.lo = min(box.lo, lo);
+        box.hi = max(box.hi, hi);
+      }
+    }
+  }
+}
+
+}  // namespace rle
+}  // namespace kernels
+}  // namespace dali
+
+#endif  // DALI_KERNELS_IMGPROC_STRUCTURE_RLE_MASK_H_
@@ -0,0 +1,202 @@
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "dali/kernels/imgproc/structure/rle_mask.h"
+
+namespace dali {
+namespace kernels {
+namespace rle {
+
+namespace {
+
+/**
+ * @brief Generates a mask with a few rectangles of different labels on zero background
+ */
+std::vector<int> RandomMask(int h, int w, int nlabels, std::mt19937 &rng) {
+  std::vector<int> mask(h * w, 0);
+  for (int l = 1; l <= nlabels; l++) {
+    std::uniform_int_distribution<int> ydist(0, h - 1), xdist(0, w - 1);
+    int y0 = ydist(rng), y1 = ydist(rng), x0 = xdist(rng), x1 = xdist(rng);
+    if (y0 > y1) std::swap(y0, y1);
+    if (x0 > x1) std::swap(x0, x1);
+    std::bernoulli_distribution hole(0.1);
+    for (int y = y0; y <= y1; y++)
+      for (int x = x0; x <= x1; x++)
+        if (!hole(rng))
+          mask[y * w + x] = l;
+  }
+  return mask;
+}
+
+std::vector<int> Decoded(const RLEMask<int> &rle) {
+  std::vector<int> out(rle.height * rle.width, -1);
+  Decode(make_tensor_cpu<2>(out.data(), { rle.height, rle.width }), rle);
+  return out;
+}
+
+void CheckValid(const RLEMask<int> &rle) {
+  ASSERT_EQ(rle.num_rows(), rle.height);
+  for (int64_t y = 0; y < rle.height; y++) {
+    int64_t prev_end = 0;
+    for (auto &run : rle.row(y)) {
+      EXPECT_LE(prev_end, run.begin);
+      EXPECT_LT(run.begin, run.end);
+      EXPECT_NE(run.value, 0);
+      prev_end = run.end;
+    }
+    EXPECT_LE(prev_end, rle.width);
+  }
+}
+
+}  // namespace
+
+TEST(RLEMask, EncodeDecode) {
+  std::mt19937 rng(1234);
+  int h = 37, w = 53;
+  auto mask = RandomMask(h, w, 4, rng);
+  RLEMask<int> rle;
+  Encode(rle, make_tensor_cpu<2>(mask.data(), { h, w }));
+  CheckValid(rle);
+  EXPECT_LT(rle.runs.size(), mask.size() / 4);
+  EXPECT_EQ(Decoded(rle), mask);
+}
+
+TEST(RLEMask, FromColumnMajorCounts) {
+  std::mt19937 rng(4321);
+  for (int iter = 0; iter < 20; iter++) {
+    int h = 1 + rng() % 30, w = 1 + rng() % 30;
+    auto mask = RandomMask(h, w, 3, rng);
+    for (auto &v : mask)
+      v = v != 0;
+    // COCO-style column-major counts, starting with background
+    std::vector<unsigned> counts;
+    int value = 0, count = 0;
+    for (int x = 0; x < w; x++) {
+      for (int y = 0; y < h; y++) {
+        if (mask[y * w + x] != value) {
+          counts.push_back(count);
+          count = 0;
+          value = !value;
+        }
+        count++;
+      }
+    }
+    counts.push_back(count);
+
+    RLEMask<int> rle;
+    FromColumnMajorCounts(rle, h, w, make_cspan(counts), 7);
+    CheckValid(rle);
+    for (auto &v : mask)
+      v *= 7;
+    EXPECT_EQ(Decoded(rle), mask) << "h = " << h << " w = " << w;
+  }
+}
+
+TEST(RLEMask, Crop) {
+  std::mt19937 rng(42);
+  int h = 31, w = 29;
+  auto mask = RandomMask(h, w, 3, rng);
+  RLEMask<int> rle, cropped;
+  Encode(rle, make_tensor_cpu<2>(mask.data(), { h, w }));
+  for (int iter = 0; iter < 20; iter++) {
+    int y0 = static_cast<int>(rng() % (h + 10)) - 5, x0 = static_cast<int>(rng() % (w + 10)) - 5;
+    int ch = 1 + rng() % h, cw = 1 + rng() % w;
+    Crop(cropped, rle, y0, x0, ch, cw);
+    CheckValid(cropped);
+    std::vector<int> ref(ch * cw, 0);
+    for (int y = 0; y < ch; y++)
+      for (int x = 0; x < cw; x++)
+        if (y + y0 >= 0 && y + y0 < h && x + x0 >= 0 && x + x0 < w)
+          ref[y * cw + x] = mask[(y + y0) * w + x + x0];
+    EXPECT_EQ(Decoded(cropped), ref);
+  }
+}
+
+TEST(RLEMask, Flip) {
+  std::mt19937 rng(123);
+  int h = 23, w = 41;
+  auto mask = RandomMask(h, w, 5, rng);
+  RLEMask<int> rle, flipped;
+  Encode(rle, make_tensor_cpu<2>(mask.data(), { h, w }));
+  for (int hor = 0; hor < 2; hor++) {
+    for (int vert = 0; vert < 2; vert++) {
+      Flip(flipped, rle, hor, vert);
+      CheckValid(flipped);
+      std::vector<int> ref(h * w);
+      for (int y = 0; y < h; y++)
+        for (int x = 0; x < w; x++)
+          ref[y * w + x] = mask[(vert ? h - 1 - y : y) * w + (hor ? w - 1 - x : x)];
+      EXPECT_EQ(Decoded(flipped), ref);
+    }
+  }
+}
+
+TEST(RLEMask, ResizeNearest) {
+  std::mt19937 rng(321);
+  int h = 27, w = 35;
+  auto mask = RandomMask(h, w, 4, rng);
+  RLEMask<int> rle, resized;
+  Encode(rle, make_tensor_cpu<2>(mask.data(), { h, w }));
+  int sizes[][2] = { { 27, 35 }, { 54, 70 }, { 13, 17 }, { 100, 9 }, { 5, 131 }, { 1, 1 } };
+  for (auto &size : sizes) {
+    int oh = size[0], ow = size[1];
+    ResizeNearest(resized, rle, oh, ow);
+    CheckValid(resized);
+    std::vector<int> ref(oh * ow);
+    for (int y = 0; y < oh; y++) {
+      int sy = std::floor((y + 0.5) * h / oh);
+      for (int x = 0; x < ow; x++) {
+        int sx = std::floor((x + 0.5) * w / ow);
+        ref[y * ow + x] = mask[sy * w + sx];
+      }
+    }
+    EXPECT_EQ(Decoded(resized), ref) << oh << "x" << ow;
+  }
+}
+
+TEST(RLEMask, BoundingBoxes) {
+  std::mt19937 rng(5);
+  int h = 43, w = 39;
+  auto mask = RandomMask(h, w, 6, rng);
+  mask[0] = -1;  // out of range label - ignored
+  RLEMask<int> rle;
+  Encode(rle, make_tensor_cpu<2>(mask.data(), { h, w }));
+
+  std::vector<Box<2, int>> boxes(5), ref(5);  // label 6 doesn't fit
+  GetLabelBoundingBoxes(make_span(boxes), rle);
+  for (int y = 0; y < h; y++) {
+    for (int x = 0; x < w; x++) {
+      int idx = mask[y * w + x] - 1;
+      if (idx < 0 || idx >= 5)
+        continue;
+      ivec2 lo = { y, x }, hi = { y + 1, x + 1 };
+      if (ref[idx].empty()) {
+        ref[idx] = { lo, hi };
+      } else {
+        ref[idx].lo = min(ref[idx].lo, lo);
+        ref[idx].hi = max(ref[idx].hi, hi);
+      }
+    }
+  }
+  for (int i = 0; i < 5; i++)
+    EXPECT_EQ(boxes[i], ref[i]) << "label " << i + 1;
+}
+
+}  // namespace rle
+}  // namespace kernels
+}  // namespace dali
@@ -16,7 +16,10 @@
 #define DALI_KERNELS_IMGPROC_WARP_CPU_H_
 
 #include <algorithm>
+#include <cmath>
+#include <type_traits>
 #include "dali/core/common.h"
+#include "dali/core/convert.h"
 #include "dali/core/geom/vec.h"
 #include "dali/core/geom/transform.h"
 #include "dali/core/static_switch.h"
@@ -95,21 +98,12 @@ class WarpCPU {
       const InTensorCPU<InputType, 3> &input,
       Mapping_ &mapping,
       BorderType border = {}) {
-    int out_w = output.shape[1];
-    int out_h = output.shape[0];
-    int c     = output.shape[2];
-
     Surface2D<const InputType> in = as_surface_channel_last(input);
-
-    Sampler2D<static_interp, InputType> sampler(in);
-
-    for (int y = 0; y < out_h; y++) {
-      OutputType *out_row = output(y, 0);
-      for (int x = 0; x < out_w; x++) {
-        auto src = warp::map_coords(mapping, ivec2(x, y));
-        sampler(&out_row[c*x], src, border);
-      }
-    }
+    VALUE_SWITCH(in.channels, static_channels, (1, 3), (
+        RunGeneric2D<static_interp, static_channels>(output, in, mapping, border);
+      ), (  // NOLINT
+        RunGeneric2D<static_interp, -1>(output, in, mapping, border);
+      ));  // NOLINT
   }
 
   template <DALIInterpType static_interp, typename Mapping_>
@@ -147,37 +141,273 @@ class WarpCPU {
       const InTensorCPU<InputType, 3> &input,
       AffineMapping<2> &mapping,
       BorderType border = {}) {
+    Surface2D<const InputType> in = as_surface_channel_last(input);
+    VALUE_SWITCH(in.channels, static_channels, (1, 3), (
+        RunAffine2D<static_interp, static_channels>(output, in, mapping, border);
+      ), (  // NOLINT
+        RunAffine2D<static_interp, -1>(output, in, mapping, border);
+      ));  // NOLINT
+  }
+
+  /// @brief Size of the output tiles processed by the 2D affine warp
+  static constexpr int kTileW = 128, kTileH = 64;
+
+  /**
+   * @brief Returns the range of source coordinates, in which the sampler doesn't reach outside
+   *        of the image
+   *
+   * The range is shrunk by half a pixel, which makes it robust to rounding errors.
+   */
+  template <DALIInterpType static_interp>
+  static void InteriorBounds(vec2 &lo, vec2 &hi, const Surface2D<const InputType> &in) {
+    // linear interpolation accesses the pixels at floor(x - 0.5) and floor(x - 0.5) + 1
+    float margin = static_interp == DALI_INTERP_LINEAR ? 1.0f : 0.5f;
+    lo = vec2(margin, margin);
+    hi = vec2(in.size.x - margin, in.size.y - margin);
+  }
+
+  /**
+   * @brief Narrows the range [x_begin, x_end) to the values of x, for which
+   *        `start + x * step` lies within [lo, hi).
+   */
+  static void NarrowRange(int &x_begin, int &x_end, float start, float step, float lo, float hi) {
+    if (step == 0) {
+      if (!(start >= lo && start < hi))
+        x_end = x_begin;
+      return;
+    }
+    double t0 = (static_cast<double>(lo) - start) / step;
+    double t1 = (static_cast<double>(hi) - start) / step;
+    if (step < 0)
+      std::swap(t0, t1);
+    double b = std::ceil(t0), e = std::ceil(t1);
+    if (b > x_begin)
+      x_begin = b < x_end ? static_cast<int>(b) : x_end;
+    if (e < x_end)
+      x_end = e > x_begin ? static_cast<int>(e) : x_begin;
+  }
+
+  /**
+   * @brief Converts the result of interpolation to the output type
+   *
+   * Integral outputs are rounded half up - unlike `std::round`, used by ConvertSat, this doesn't
+   * need a call to the math library. The result differs only for negative ties.
+   */
+  template <typename T = OutputType>
+  static DALI_FORCEINLINE std::enable_if_t<std::is_integral<T>::value, T> ConvertInterp(float v) {
+    // Interpolated unsigned integers are non-negative and don't exceed the input range,
+    // so if the output range is not smaller, truncating v + 0.5 is enough.
+    constexpr bool no_clamp = std::is_integral<InputType>::value &&
+                              std::is_unsigned<InputType>::value &&
+                              sizeof(InputType) < sizeof(int) &&
+                              max_value<InputType>() <= max_value<T>();
+    if (no_clamp)
+      return static_cast<T>(static_cast<int>(v + 0.5f));
+    else
+      return clamp<T>(std::floor(v + 0.5f));
+  }
+
+  template <typename T = OutputType>
+  static DALI_FORCEINLINE std::enable_if_t<!std::is_integral<T>::value, T> ConvertInterp(float v) {
+    return ConvertSat<T>(v);
+  }
+
+  /**
+   * @brief Samples a pixel without border handling - `src` must be within the interior bounds
+   */
+  template <DALIInterpType static_interp, int static_channels>
+  static DALI_FORCEINLINE void SampleInterior(OutputType *out,
+                                              const Surface2D<const InputType> &in, vec2 src) {
+    const int nch = static_channels < 0 ? in.channels : static_channels;
+    // the coordinates are positive, so truncation is equivalent to floor
+    if (static_interp == DALI_INTERP_NN) {
+      const InputType *p = &in(static_cast<int>(src.x), static_cast<int>(src.y));
+      for (int c = 0; c < nch; c++)
+        out[c] = ConvertSat<OutputType>(p[c]);
+    } else {
+      float x = src.x - 0.5f;
+      float y = src.y - 0.5f;
+      int x0 = x;
+      int y0 = y;
+      const InputType *p0 = &in(x0, y0);
+      SampleLinear<static_channels>(out, p0, p0 + in.strides.y, in.strides.x, in.channels,
+                                    x - x0, y - y0);
+    }
+  }
+
+  /**
+   * @brief Bilinear interpolation between pixels at p0, p0 + dx and the ones at p1, p1 + dx
+   */
+  template <int static_channels>
+  static DALI_FORCEINLINE void SampleLinear(OutputType *out,
+                                            const InputType *p0, const InputType *p1,
+                                            int64_t dx, int channels, float qx, float qy) {
+    const int nch = static_channels < 0 ? channels : static_channels;
+    float px = 1 - qx;
+    for (int c = 0; c < nch; c++) {
+      float s0 = p0[c] * px + p0[c + dx] * qx;
+      float s1 = p1[c] * px + p1[c + dx] * qx;
+      out[c] = ConvertInterp(s0 + (s1 - s0) * qy);
+    }
+  }
+
+  template <DALIInterpType static_interp, int static_channels, typename Mapping_>
+  void RunGeneric2D(
+      const OutTensorCPU<OutputType, 3> &output,
+      Surface2D<const InputType> in,
+      Mapping_ &mapping,
+      BorderType border) {
     int out_w = output.shape[1];
     int out_h = output.shape[0];
     int c     = output.shape[2];
 
-    Surface2D<const InputType> in = as_surface_channel_last(input);
+    Sampler2D<static_interp, InputType> sampler(in);
+    vec2 lo, hi;
+    InteriorBounds<static_interp>(lo, hi, in);
+    // integer mappings produce pixel indices, which are always sampled with NN
+    constexpr bool fp_mapping = warp::is_fp_mapping<std::remove_const_t<Mapping_>>::value;
 
+    for (int y = 0; y < out_h; y++) {
+      OutputType *out_row = output(y, 0);
+      for (int x = 0; x < out_w; x++) {
+        auto src = warp::map_coords(mapping, ivec2(x, y));
+        if (fp_mapping && src.x >= lo.x && src.x < hi.x && src.y >= lo.y && src.y < hi.y)
+          SampleInterior<static_interp, static_channels>(&out_row[c*x], in, vec2(src));
+        else
+          sampler(&out_row[c*x], src, border);
+      }
+    }
+  }
+
+  template <DALIInterpType static_interp, int static_channels>
+  void RunAffine2D(
+      const OutTensorCPU<OutputType, 3> &output,
+      const Surface2D<const InputType> &in,
+      const AffineMapping<2> &mapping,
+      const BorderType &border) {
+    int out_w = output.shape[1];
+    int out_h = output.shape[0];
+
+    vec2 lo, hi;
+    InteriorBounds<static_interp>(lo, hi, in);
+
+    // Pure scaling and translation - the source x depends only on destination x
+    // and the source y only on destination y
+    bool separable = mapping.transform(0, 1) == 0 && mapping.transform(1, 0) == 0;
+
+    // The output is processed in tiles, so that the source pixels used by a tile stay in cache,
+    // regardless of the rotation angle.
+    for (int y_tile = 0; y_tile < out_h; y_tile += kTileH) {
+      int y_tile_end = std::min(y_tile + kTileH, out_h);
+      for (int x_tile = 0; x_tile < out_w; x_tile += kTileW) {
+        int x_tile_end = std::min(x_tile + kTileW, out_w);
+        if (separable) {
+          AffineTileSeparable<static_interp, static_channels>(
+              output, in, mapping, border, lo, hi, x_tile, x_tile_end, y_tile, y_tile_end);
+        } else {
+          AffineTile<static_interp, static_channels>(
+              output, in, mapping, border, lo, hi, x_tile, x_tile_end, y_tile, y_tile_end);
+        }
+      }
+    }
+  }
+
+  // NOTE: The per-pixel functions take the surface and the border by value - otherwise the
+  // compiler would have to assume that writing the output (e.g. uint8_t, which can alias
+  // anything) may modify them and reload them in every pixel.
+
+  template <DALIInterpType static_interp, int static_channels>
+  void AffineTile(
+      const OutTensorCPU<OutputType, 3> &output,
+      Surface2D<const InputType> in,
+      const AffineMapping<2> &mapping,
+      BorderType border,
+      vec2 lo, vec2 hi,
+      int x_tile, int x_tile_end, int y_tile, int y_tile_end) {
+    int c = output.shape[2];
     Sampler2D<static_interp, InputType> sampler(in);
 
     // Optimization: instead of naively calculating source coordinates for each destination pixel,
-    // we can exploit the linearity of the affine transform and just add ds/dx derivative
-    // for each x.
+    // we can exploit the linearity of the affine transform: src = row_start + x * dsdx.
     vec2 dsdx = mapping.transform.col(0);
 
-    // use tiles to produce "checkpoints" to avoid excessive accumulation error
-    constexpr int tile_w = 256;
-    vec2 dsdx_tile = tile_w * dsdx;
+    for (int y = y_tile; y < y_tile_end; y++) {
+      OutputType *out_row = output(y, 0);
+      vec2 row_start = warp::map_coords(mapping, ivec2(0, y));
+      // the pixels in [x0, x1) don't need border handling
+      int x0 = x_tile, x1 = x_tile_end;
+      NarrowRange(x0, x1, row_start.x, dsdx.x, lo.x, hi.x);
+      NarrowRange(x0, x1, row_start.y, dsdx.y, lo.y, hi.y);
+      int x = x_tile;
+      for (; x < x0; x++)
+        sampler(&out_row[c*x], row_start + static_cast<float>(x) * dsdx, border);
+      for (; x < x1; x++)
+        SampleInterior<static_interp, static_channels>(
+            &out_row[c*x], in, row_start + static_cast<float>(x) * dsdx);
+      for (; x < x_tile_end; x++)
+        sampler(&out_row[c*x], row_start + static_cast<float>(x) * dsdx, border);
+    }
+  }
 
-    for (int y = 0; y < out_h; y++) {
+  template <DALIInterpType static_interp, int static_channels>
+  void AffineTileSeparable(
+      const OutTensorCPU<OutputType, 3> &output,
+      Surface2D<const InputType> in,
+      const AffineMapping<2> &mapping,
+      BorderType border,
+      vec2 lo, vec2 hi,
+      int x_tile, int x_tile_end, int y_tile, int y_tile_end) {
+    int c = output.shape[2];
+    const int nch = static_channels < 0 ? in.channels : static_channels;
+    Sampler2D<static_interp, InputType> sampler(in);
+    vec2 dsdx = mapping.transform.col(0);
+    float offset = static_interp == DALI_INTERP_LINEAR ? 0.5f : 0.0f;
+
+    // The source columns (and interpolation weights) are the same in each row of the tile
+    float col_start = warp::map_coords(mapping, ivec2(0, 0)).x;
+    int x0 = x_tile, x1 = x_tile_end;
+    NarrowRange(x0, x1, col_start, dsdx.x, lo.x, hi.x);
+    int64_t col_offset[kTileW];
+    float col_q[kTileW];
+    for (int x = x0; x < x1; x++) {
+      float sx = col_start + static_cast<float>(x) * dsdx.x - offset;
+      int ix = sx;
+      col_offset[x - x_tile] = ix * in.strides.x;
+      col_q[x - x_tile] = sx - ix;
+    }
+
+    for (int y = y_tile; y < y_tile_end; y++) {
       OutputType *out_row = output(y, 0);
-      auto src_tile = warp::map_coords(mapping, ivec2(0, y));
-      for (int x_tile = 0; x_tile < out_w; x_tile += tile_w, src_tile += dsdx_tile) {
-        int x_tile_end = std::min(x_tile + tile_w, out_w);
-        auto src = src_tile;
-        for (int x = x_tile; x < x_tile_end; x++, src += dsdx) {
-          sampler(&out_row[c*x], src, border);
+      vec2 row_start = warp::map_coords(mapping, ivec2(0, y));
+      bool interior_row = row_start.y >= lo.y && row_start.y < hi.y;
+      int row_x0 = interior_row ? x0 : x_tile_end;
+      int row_x1 = interior_row ? x1 : x_tile_end;
+      int x = x_tile;
+      for (; x < row_x0; x++)
+        sampler(&out_row[c*x], row_start + static_cast<float>(x) * dsdx, border);
+      if (row_x0 < row_x1) {
+        float sy = row_start.y - offset;
+        int iy = sy;
+        float qy = sy - iy;
+        const InputType *p0 = &in(0, iy);
+        const InputType *p1 = p0 + in.strides.y;
+        const int64_t dx = in.strides.x;
+        for (; x < row_x1; x++) {
+          int xt = x - x_tile;
+          if (static_interp == DALI_INTERP_NN) {
+            for (int ch = 0; ch < nch; ch++)
+              out_row[c*x + ch] = ConvertSat<OutputType>(p0[col_offset[xt] + ch]);
+          } else {
+            SampleLinear<static_channels>(&out_row[c*x], p0 + col_offset[xt],
+                                          p1 + col_offset[xt], dx, in.channels, col_q[xt], qy);
+          }
         }
       }
+      for (; x < x_tile_end; x++)
+        sampler(&out_row[c*x], row_start + static_cast<float>(x) * dsdx, border);
     }
   }
 
-
   template <DALIInterpType static_interp>
   void RunImpl(
       KernelContext &context,
@@ -1,4 +1,4 @@
-// Copyright (c) 2019-2020, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2019-2021, NVIDIA CORPORATION. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -13,7 +13,13 @@
 // limitations under the License.
 
 #include "dali/kernels/signal/dct/dct_cpu.h"
+#if FFTS_ENABLED
+#include <ffts.h>
+#endif
 #include <cmath>
+#include <complex>
+#include <memory>
+#include <vector>
 #include "dali/core/common.h"
 #include "dali/core/convert.h"
 #include "dali/core/error_handling.h"
@@ -29,6 +35,213 @@ namespace kernels {
 namespace signal {
 namespace dct {
 
+namespace {
+
+/**
+ * @brief Length of the complex FFT used to calculate the DCT of given type and input length
+ */
+inline int64_t FftLength(int dct_type, int64_t n) {
+  switch (dct_type) {
+    case 1:
+      return 2 * (n - 1);  // even symmetric extension of the input
+    case 4:
+      return 2 * n;  // zero padded, twiddled input
+    default:
+      return n;  // types II and III use Makhoul's reordering
+  }
+}
+
+/**
+ * @brief Rough floating point operation count of a complex FFT of length m
+ *
+ * Powers of 2 take 5 * m * log2(m). Other lengths are calculated with Bluestein's algorithm,
+ * which takes two FFTs of the padded length p = next_pow2(2m - 1) and complex multiplications
+ * by the chirp - several times the cost of a power of 2 of similar length.
+ */
+inline double FftCost(int64_t m) {
+  if (is_pow2(m))
+    return 5.0 * m * std::log2(m);
+  int64_t p = next_pow2(2 * m - 1);
+  return 2 * 5.0 * p * std::log2(p) + 6.0 * p + 12.0 * m;
+}
+
+template <typename T>
+inline T Dot(const T *a, const T *b, int64_t n) {
+  // independent partial sums let the compiler vectorize the loop without reassociating it
+  T acc[4] = {0, 0, 0, 0};
+  int64_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    acc[0] += a[i] * b[i];
+    acc[1] += a[i + 1] * b[i + 1];
+    acc[2] += a[i + 2] * b[i + 2];
+    acc[3] += a[i + 3] * b[i + 3];
+  }
+  T sum = (acc[0] + acc[1]) + (acc[2] + acc[3]);
+  for (; i < n; i++)
+    sum += a[i] * b[i];
+  return sum;
+}
+
+}  // namespace
+
+bool ShouldUseFft(int dct_type, int64_t n, int64_t ndct) {
+  constexpr int64_t kMinFftLength = 32;
+  if (n < kMinFftLength)
+    return false;
+  int64_t m = FftLength(dct_type, n);
+  // the matrix product vs the FFT with the pre- and post-processing
+  return 2.0 * n * ndct > FftCost(m) + 16.0 * m;
+}
+
+/**
+ * @brief Calculates the DCT of a single precision input with a complex FFT of length O(N)
+ *
+ * Type I:   the real part of the FFT of the even symmetric extension of the input.
+ * Type II:  the FFT of the input reordered as (x0, x2, x4, ..., x5, x3, x1), post-twiddled.
+ * Type III: the inverse of the above - pre-twiddled input, FFT, inverse reordering.
+ * Type IV:  the FFT of zero padded, pre-twiddled input, post-twiddled.
+ */
+class DctFftImpl {
+ public:
+  /**
+   * @brief Prepares the plan and twiddle factors. Returns false if the FFT can't be used.
+   */
+  bool Setup(int64_t n, const DctArgs &args) {
+#if FFTS_ENABLED
+    if (plan_ && n == n_ && args == args_)
+      return true;
+    n_ = n;
+    args_ = args;
+    nfft_ = FftLength(args.dct_type, n);
+    plan_ = {ffts_init_1d(nfft_, FFTS_FORWARD), ffts_free};
+    if (!plan_)
+      return false;
+
+    int64_t ndct = args.ndct;
+    scale_0_ = scale_i_ = 1.0f;
+    pre_.clear();
+    post_.clear();
+    switch (args.dct_type) {
+      case 2:
+        if (args.normalize) {
+          scale_0_ = 1.0 / std::sqrt(n);
+          scale_i_ = std::sqrt(2.0 / n);
+        }
+        post_.resize(ndct);
+        for (int64_t k = 0; k < ndct; k++)
+          post_[k] = std::polar(1.0, -M_PI * k / (2 * n));
+        break;
+      case 3:
+        // the input at 0 is doubled, because the inverse of type II weights it by 1/2
+        scale_0_ = args.normalize ? 2.0 / std::sqrt(n) : 1.0;
+        scale_i_ = args.normalize ? std::sqrt(2.0 / n) : 1.0;
+        pre_.resize(n);
+        for (int64_t k = 0; k < n; k++)
+          pre_[k] = std::polar(1.0, -M_PI * k / (2 * n));
+        break;
+      case 4:
+        if (args.normalize)
+          scale_i_ = std::sqrt(2.0 / n);
+        pre_.resize(n);
+        for (int64_t i = 0; i < n; i++)
+          pre_[i] = std::polar(1.0, -M_PI * i / (2 * n));
+        post_.resize(ndct);
+        for (int64_t k = 0; k < ndct; k++)
+          post_[k] = std::polar(1.0, -M_PI * (2 * k + 1) / (4 * n));
+        break;
+      default:
+        break;
+    }
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  int64_t nfft() const {
+    return nfft_;
+  }
+
+  void Transform(float *out, int64_t out_stride, const float *in, int64_t in_stride,
+                 std::complex<float> *in_buf, std::complex<float> *out_buf) const {
+#if FFTS_ENABLED
+    int64_t n = n_, m = nfft_, ndct = args_.ndct;
+    switch (args_.dct_type) {
+      case 1:
+        for (int64_t i = 0; i < n; i++)
+          in_buf[i] = in[i * in_stride];
+        for (int64_t i = n; i < m; i++)
+          in_buf[i] = in_buf[m - i];
+        break;
+      case 2:
+        for (int64_t i = 0; 2 * i < n; i++)
+          in_buf[i] = in[2 * i * in_stride];
+        for (int64_t i = 0; 2 * i + 1 < n; i++)
+          in_buf[n - 1 - i] = in[(2 * i + 1) * in_stride];
+        break;
+      case 3:
+        in_buf[0] = scale_0_ * in[0];
+        for (int64_t k = 1; k < n; k++) {
+          std::complex<float> c(in[k * in_stride], in[(n - k) * in_stride]);
+          in_buf[k] = pre_[k] * (scale_i_ * c);
+        }
+        break;
+      case 4:
+        for (int64_t i = 0; i < n; i++)
+          in_buf[i] = pre_[i] * in[i * in_stride];
+        for (int64_t i = n; i < m; i++)
+          in_buf[i] = 0;
+        break;
+      default:
+        assert(false);
+    }
+
+    ffts_execute(plan_.get(), in_buf, out_buf);
+
+    int64_t out_idx = 0;
+    for (int64_t k = 0; k < ndct; k++, out_idx += out_stride) {
+      switch (args_.dct_type) {
+        case 1:
+          out[out_idx] = 0.5f * out_buf[k].real();
+          break;
+        case 2:
+          out[out_idx] = (k == 0 ? scale_0_ : scale_i_) * (post_[k] * out_buf[k]).real();
+          break;
+        case 3:
+          // undo the reordering: even outputs are at the front, odd ones at the back
+          out[out_idx] = 0.5f * out_buf[k % 2 == 0 ? k / 2 : n - 1 - k / 2].real();
+          break;
+        case 4:
+          out[out_idx] = scale_i_ * (post_[k] * out_buf[k]).real();
+          break;
+        default:
+          assert(false);
+      }
+    }
+#endif
+  }
+
+  // only single precision is supported by the FFT library
+  void Transform(double *, int64_t, const double *, int64_t,
+                 std::complex<float> *, std::complex<float> *) const {
+    assert(false);
+  }
+
+ private:
+#if FFTS_ENABLED
+  using FftsPlanPtr = std::unique_ptr<ffts_plan_t, decltype(&ffts_free)>;
+  FftsPlanPtr plan_{nullptr, ffts_free};
+#endif
+  int64_t n_ = -1;
+  int64_t nfft_ = -1;
+  DctArgs args_;
+  float scale_0_ = 1.0f, scale_i_ = 1.0f;
+  std::vector<std::complex<float>> pre_, post_;
+};
+
+template <typename OutputType, typename InputType, int Dims>
+Dct1DCpu<OutputType, InputType, Dims>::Dct1DCpu() = default;
+
 template <typename OutputType, typename InputType, int Dims>
 Dct1DCpu<OutputType, InputType, Dims>::~Dct1DCpu() = default;
 
@@ -61,14 +274,33 @@ Dct1DCpu<OutputType, InputType, Dims>::Setup(KernelContext &context,
   auto out_shape = in.shape;
   out_shape[axis_] = args.ndct;
 
-  size_t cos_table_sz = n * args.ndct;
-  if (cos_table_.size() != cos_table_sz || args != args_) {
-    cos_table_.resize(cos_table_sz);
-    FillCosineTable(cos_table_.data(), n, args);
-    args_ = args;
+  ScratchpadEstimator se;
+  use_fft_ = false;
+  if (std::is_same<InputType, float>::value &&
+      ShouldUseFft(args.dct_type, n, args.ndct)) {
+    if (!fft_)
+      fft_ = std::make_unique<DctFftImpl>();
+    use_fft_ = fft_->Setup(n, args);
   }
 
+  if (use_fft_) {
+    // ffts requires 32-byte aligned memory
+    se.add<float>(AllocType::Host, 2 * fft_->nfft(), 32);
+    se.add<float>(AllocType::Host, 2 * fft_->nfft(), 32);
+    cos_table_.clear();
+  } else {
+    // contiguous copy of an input line
+    se.add<OutputType>(AllocType::Host, n);
+    size_t cos_table_sz = n * args.ndct;
+    if (cos_table_.size() != cos_table_sz || args != args_) {
+      cos_table_.resize(cos_table_sz);
+      FillCosineTable(cos_table_.data(), n, args);
+    }
+  }
+  args_ = args;
+
   KernelRequirements req;
+  req.scratch_sizes = se.sizes;
   req.output_shapes = {TensorListShape<DynamicDimensions>({out_shape})};
   return req;
 }
@@ -81,8 +313,6 @@ void Dct1DCpu<OutputType, InputType, Dims>::Run(KernelContext &context,
   (void)args;
   (void)axis;
   assert(axis_ >= 0 && axis_ < Dims);
-  const auto n = in.shape[axis_];
-
   assert(args_.dct_type >= 1 && args_.dct_type <= 4);
 
   auto in_shape = in.shape;
@@ -90,23 +320,41 @@ void Dct1DCpu<OutputType, InputType, Dims>::Run(KernelContext &context,
   auto out_shape = out.shape;
   auto out_strides = GetStrides(out_shape);
 
+  if (use_fft_) {
+    auto nfft = fft_->nfft();
+    auto *in_buf = reinterpret_cast<std::complex<float> *>(
+        context.scratchpad->template Allocate<float>(AllocType::Host, 2 * nfft, 32));
+    auto *out_buf = reinterpret_cast<std::complex<float> *>(
+        context.scratchpad->template Allocate<float>(AllocType::Host, 2 * nfft, 32));
+    ForAxis(
+      out.data, in.data, out_shape.data(), out_strides.data(), in_shape.data(), in_strides.data(),
+      axis_, out.dim(),
+      [this, in_buf, out_buf](
+        OutputType *out_data, const InputType *in_data, int64_t out_size, int64_t out_stride,
+        int64_t in_size, int64_t in_stride) {
+          fft_->Transform(out_data, out_stride, in_data, in_stride, in_buf, out_buf);
+      });
+    return;
+  }
+
+  const auto n = in.shape[axis_];
+  auto *line_buf = context.scratchpad->template Allocate<OutputType>(AllocType::Host, n);
   ForAxis(
     out.data, in.data, out_shape.data(), out_strides.data(), in_shape.data(), in_strides.data(),
     axis_, out.dim(),
-    [this](
+    [this, line_buf](
       OutputType *out_data, const InputType *in_data, int64_t out_size, int64_t out_stride,
       int64_t in_size, int64_t in_stride) {
+        // gather the input so that the dot products access contiguous memory
+        const OutputType *line = in_data;
+        if (in_stride != 1) {
+          for (int64_t i = 0; i < in_size; i++)
+            line_buf[i] = in_data[i * in_stride];
+          line = line_buf;
+        }
         int64_t out_idx = 0;
         for (int64_t k = 0; k < out_size; k++) {
-          OutputType out_val = 0;
-          const auto *cos_table_row = cos_table_.data() + k * in_size;
-          int64_t in_idx = 0;
-          for (int64_t n = 0; n < in_size; n++) {
-            OutputType in_val = in_data[in_idx];
-            in_idx += in_stride;
-            out_val += in_val * cos_table_row[n];
-          }
-          out_data[out_idx] = out_val;
+          out_data[out_idx] = Dot(cos_table_.data() + k * in_size, line, in_size);
           out_idx += out_stride;
         }
     });
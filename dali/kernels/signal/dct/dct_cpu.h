@@ -29,6 +29,17 @@ namespace kernels {
 namespace signal {
 namespace dct {
 
+class DctFftImpl;
+
+/**
+ * @brief Decides whether the FFT based algorithm is expected to be faster than the direct one
+ *        for a DCT of given type, input length and number of coefficients
+ *
+ * Compares rough floating point operation counts: 2 * n * ndct for the matrix product and
+ * the cost of the FFT of the length used for given DCT type, plus the pre- and post-processing.
+ */
+DLL_PUBLIC bool ShouldUseFft(int dct_type, int64_t n, int64_t ndct);
+
 /**
  * @brief Discrete Cosine Transform 1D CPU kernel.
  *        Performs a DCT transformation over a single dimension in a multi-dimensional input.
@@ -37,6 +48,10 @@ namespace dct {
  *          https://en.wikipedia.org/wiki/Discrete_cosine_transform
  *          DCT generally stands for type II and inverse DCT stands for DCT type III
  *
+ * @remarks Depending on the input length and the number of coefficients, the transform is
+ *          calculated either directly, as a product with a cosine matrix (O(N * ndct)), or
+ *          with an FFT (O(N log N)), for long single precision inputs.
+ *
  * @see DCTArgs
  */
 template <typename OutputType = float,  typename InputType = float, int Dims = 2>
@@ -47,6 +62,7 @@ class DLL_PUBLIC Dct1DCpu {
   static_assert(std::is_same<OutputType, InputType>::value,
     "Data type conversion is not supported");
 
+  DLL_PUBLIC Dct1DCpu();
   DLL_PUBLIC ~Dct1DCpu();
 
   DLL_PUBLIC KernelRequirements Setup(KernelContext &context,
@@ -61,6 +77,9 @@ class DLL_PUBLIC Dct1DCpu {
   std::vector<OutputType> cos_table_;
   DctArgs args_;
   int axis_;
+
+  std::unique_ptr<DctFftImpl> fft_;
+  bool use_fft_ = false;
 };
 
 }  // namespace dct
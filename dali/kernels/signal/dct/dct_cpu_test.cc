@@ -14,6 +14,7 @@
 
 #include "dali/kernels/signal/dct/dct_cpu.h"
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <complex>
 #include <tuple>
 #include <vector>
@@ -119,6 +120,9 @@ TEST_P(Dct1DCpuTest, DctTest) {
   assert(in_shape.size() == 2);  // assuming 2D for simplicity of this test
   auto other_axis = axis_ == 1 ? 0 : 1;
 
+  // the accumulated rounding error grows with the input length
+  double eps = 1e-4 * std::max<int64_t>(1, n / 128);
+
   auto nframes = in_shape[other_axis];
   for (int64_t j = 0; j < nframes; j++) {
     int64_t in_idx = j * in_strides[other_axis];
@@ -141,16 +145,37 @@ TEST_P(Dct1DCpuTest, DctTest) {
     LOG_LINE << "DCT (type " << dct_type_ << "):";
     for (int k = 0; k < ndct_; k++) {
       LOG_LINE << " " << ref[k];
-      EXPECT_NEAR(ref[k], out_data[out_idx], 1e-4);
+      EXPECT_NEAR(ref[k], out_data[out_idx], eps);
       out_idx += out_stride;
     }
     LOG_LINE << "\n";
   }
 }
 
+TEST(Dct1DCpuFftThreshold, ShouldUseFft) {
+  // too short
+  EXPECT_FALSE(ShouldUseFft(2, 16, 16));
+  // few coefficients, as in MFCC
+  EXPECT_FALSE(ShouldUseFft(2, 1024, 13));
+  // powers of 2
+  EXPECT_TRUE(ShouldUseFft(2, 128, 128));
+  EXPECT_TRUE(ShouldUseFft(3, 1024, 1024));
+  EXPECT_TRUE(ShouldUseFft(4, 64, 64));   // FFT of length 128
+  EXPECT_TRUE(ShouldUseFft(1, 65, 65));   // FFT of length 128
+  // similar lengths which are not powers of 2 need a much longer FFT
+  EXPECT_FALSE(ShouldUseFft(2, 100, 100));
+  EXPECT_FALSE(ShouldUseFft(4, 65, 65));  // FFT of length 130
+  EXPECT_FALSE(ShouldUseFft(1, 64, 64));  // FFT of length 126
+  // ...but still pay off for long enough inputs
+  EXPECT_TRUE(ShouldUseFft(2, 1000, 1000));
+  EXPECT_TRUE(ShouldUseFft(4, 1000, 1000));
+}
+
 INSTANTIATE_TEST_SUITE_P(Dct1DCpuTest, Dct1DCpuTest, testing::Combine(
     testing::Values(std::array<int64_t, 2>{8, 8},
-                    std::array<int64_t, 2>{100, 80}),  // shape
+                    std::array<int64_t, 2>{100, 80},
+                    std::array<int64_t, 2>{3, 1000},  // long enough to use the FFT
+                    std::array<int64_t, 2>{512, 2}),  // shape
     testing::Values(1, 2, 3, 4),  // dct_type
     testing::Values(0, 1),  // axis
     testing::Values(false, true),  // normalize
@@ -1,4 +1,4 @@
-// Copyright (c) 2019-2020, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2019-2021, NVIDIA CORPORATION. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -18,8 +18,15 @@
 #ifdef __SSE2__
 #include <emmintrin.h>
 #endif
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define DALI_RESAMPLING_AVX2_DISPATCH 1
+#endif
+#include <algorithm>
 #include <cmath>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <utility>
 #include <vector>
 #include "dali/core/math_util.h"
@@ -98,11 +105,170 @@ inline int64_t resampled_length(int64_t in_length, double in_rate, double out_ra
   return std::ceil(in_length * out_rate / in_rate);
 }
 
+/**
+ * @brief Maximum number of phases for which a polyphase filter is used
+ *
+ * This covers all common audio rate conversions (e.g. 44.1 kHz -> 16 kHz has 160 phases)
+ * while keeping the coefficient table small enough to fit in L2 cache.
+ */
+constexpr int64_t kMaxPolyphasePhases = 1024;
+
+/**
+ * @brief Reduces the resampling ratio to `in_step / num_phases`
+ *
+ * @return true, if both rates are integers and the ratio has at most `max_phases` phases
+ */
+inline bool rational_ratio(int64_t &in_step, int64_t &num_phases, double in_rate, double out_rate,
+                           int64_t max_phases = kMaxPolyphasePhases) {
+  const double max_rate = 1 << 30;
+  if (!(in_rate >= 1 && out_rate >= 1 && in_rate <= max_rate && out_rate <= max_rate))
+    return false;
+  if (in_rate != std::floor(in_rate) || out_rate != std::floor(out_rate))
+    return false;
+  int64_t a = in_rate, b = out_rate;
+  while (b) {
+    int64_t r = a % b;
+    a = b;
+    b = r;
+  }
+  in_step = static_cast<int64_t>(in_rate) / a;
+  num_phases = static_cast<int64_t>(out_rate) / a;
+  return num_phases <= max_phases;
+}
+
+/**
+ * @brief Filter coefficients for all phases of a rational resampling ratio
+ *
+ * Output sample `o` is located at input position `x = o * in_step / num_phases`.
+ * With `n = floor(x)` and `p = o * in_step mod num_phases`, the sample is a dot product of
+ * `phase(p)` and the inputs `[n - lobes, n + lobes]`.
+ */
+struct PolyphaseFilter {
+  int64_t in_step = 0;
+  int64_t num_phases = 0;
+  int lobes = 0;
+  int num_taps = 0;
+  std::vector<float> coeffs;  // num_phases x num_taps
+
+  const float *phase(int64_t p) const {
+    return coeffs.data() + p * num_taps;
+  }
+};
+
+/**
+ * @brief Evaluates the window at all phases of the ratio `in_step / num_phases`
+ *
+ * The coefficients are the same as the ones calculated on the fly by the windowed resampler;
+ * taps outside of the window support are set to zero.
+ */
+inline void polyphase_filter(PolyphaseFilter &filter, const ResamplingWindow &window,
+                             int64_t in_step, int64_t num_phases) {
+  filter.in_step = in_step;
+  filter.num_phases = num_phases;
+  filter.lobes = window.lobes;
+  filter.num_taps = 2 * window.lobes + 1;
+  filter.coeffs.resize(num_phases * filter.num_taps);
+  for (int64_t p = 0; p < num_phases; p++) {
+    float frac = static_cast<double>(p) / num_phases;
+    float *coeffs = filter.coeffs.data() + p * filter.num_taps;
+    // for a non-integer position, the first tap is at distance `lobes + frac` - outside
+    coeffs[0] = p == 0 ? window(-window.lobes) : 0.0f;
+    for (int k = 1; k < filter.num_taps; k++)
+      coeffs[k] = window(k - window.lobes - frac);
+  }
+}
+
+namespace detail {
+
+#ifdef DALI_RESAMPLING_AVX2_DISPATCH
+__attribute__((target("avx2,fma")))
+inline float dot_avx2(const float *__restrict__ a, const float *__restrict__ b, int n) {
+  __m256 acc0 = _mm256_setzero_ps();
+  __m256 acc1 = _mm256_setzero_ps();
+  int i = 0;
+  for (; i + 16 <= n; i += 16) {
+    acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+    acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), acc1);
+  }
+  if (i + 8 <= n) {
+    acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+    i += 8;
+  }
+  acc0 = _mm256_add_ps(acc0, acc1);
+  __m128 f4 = _mm_add_ps(_mm256_castps256_ps128(acc0), _mm256_extractf128_ps(acc0, 1));
+  f4 = _mm_add_ps(f4, _mm_movehl_ps(f4, f4));
+  f4 = _mm_add_ss(f4, _mm_shuffle_ps(f4, f4, _MM_SHUFFLE(1, 1, 1, 1)));
+  float f = _mm_cvtss_f32(f4);
+  for (; i < n; i++)
+    f += a[i] * b[i];
+  return f;
+}
+
+inline bool has_avx2() {
+  static const bool avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+  return avx2;
+}
+#endif
+
+/**
+ * @brief Calculates a dot product of two float vectors
+ *
+ * Uses AVX2 if the CPU supports it (regardless of the compilation flags), SSE otherwise.
+ */
+inline float dot(const float *__restrict__ a, const float *__restrict__ b, int n) {
+#ifdef DALI_RESAMPLING_AVX2_DISPATCH
+  if (has_avx2())
+    return dot_avx2(a, b, n);
+#endif
+  float f = 0;
+  int i = 0;
+#ifdef __SSE2__
+  __m128 f4 = _mm_setzero_ps();
+  for (; i + 4 <= n; i += 4)
+    f4 = _mm_add_ps(f4, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+  f4 = _mm_add_ps(f4, _mm_shuffle_ps(f4, f4, _MM_SHUFFLE(1, 0, 3, 2)));
+  f4 = _mm_add_ps(f4, _mm_shuffle_ps(f4, f4, _MM_SHUFFLE(0, 1, 0, 1)));
+  f = _mm_cvtss_f32(f4);
+#endif
+  for (; i < n; i++)
+    f += a[i] * b[i];
+  return f;
+}
+
+}  // namespace detail
+
 struct Resampler {
   ResamplingWindow window;
 
   void Initialize(int lobes = 16, int lookup_size = 2048) {
     windowed_sinc(window, lookup_size, lobes);
+    polyphase_cache_ = std::make_shared<PolyphaseCache>();
+  }
+
+  /**
+   * @brief Returns the coefficient tables for given rates or nullptr, if the ratio
+   *        is not rational or has too many phases
+   *
+   * The tables are calculated on first use and shared by all copies of the resampler.
+   * This function is thread-safe.
+   */
+  std::shared_ptr<const PolyphaseFilter> GetPolyphaseFilter(double in_rate,
+                                                            double out_rate) const {
+    int64_t in_step, num_phases;
+    if (!polyphase_cache_ || !rational_ratio(in_step, num_phases, in_rate, out_rate))
+      return nullptr;
+    std::lock_guard<std::mutex> guard(polyphase_cache_->mtx);
+    auto &filters = polyphase_cache_->filters;
+    for (auto &filter : filters) {
+      if (filter->in_step == in_step && filter->num_phases == num_phases)
+        return filter;
+    }
+    auto filter = std::make_shared<PolyphaseFilter>();
+    polyphase_filter(*filter, window, in_step, num_phases);
+    if (filters.size() >= kMaxCachedFilters)
+      filters.erase(filters.begin());
+    filters.push_back(filter);
+    return filter;
   }
 
   /**
@@ -111,12 +277,33 @@ struct Resampler {
    * Calculates a range of resampled signal.
    * The function can seamlessly resample the input and produce the result in chunks.
    * To reuse memory and still simulate chunk processing, adjust the in/out pointers.
+   *
+   * If the ratio of the sampling rates is a rational number with a small denominator
+   * (e.g. 44.1 kHz -> 16 kHz), precomputed polyphase coefficients are used.
    */
   template <typename Out>
   void Resample(
         Out *__restrict__ out, int64_t out_begin, int64_t out_end, double out_rate,
         const float *__restrict__ in, int64_t n_in, double in_rate) const {
     assert(out_rate > 0 && in_rate > 0 && "Sampling rate must be positive");
+    if (auto filter = GetPolyphaseFilter(in_rate, out_rate))
+      ResamplePolyphase(out, out_begin, out_end, in, n_in, *filter);
+    else
+      ResampleWindowed(out, out_begin, out_end, out_rate, in, n_in, in_rate);
+  }
+
+  /**
+   * @brief Resample single-channel signal, evaluating the window for each output sample
+   *
+   * @param in_begin  index of the input sample at `in` - when resampling in chunks, the input
+   *                  needs to contain only the samples used by the output range
+   */
+  template <typename Out>
+  void ResampleWindowed(
+        Out *__restrict__ out, int64_t out_begin, int64_t out_end, double out_rate,
+        const float *__restrict__ in, int64_t n_in, double in_rate,
+        int64_t in_begin = 0) const {
+    assert(out_rate > 0 && in_rate > 0 && "Sampling rate must be positive");
     int64_t in_pos = 0;
     int64_t block = 1 << 10;  // still leaves 13 significant bits for fractional part
     double scale = in_rate / out_rate;
@@ -126,7 +313,7 @@ struct Resampler {
       double in_block_f = out_block * scale;
       int64_t in_block_i = std::floor(in_block_f);
       float in_pos = in_block_f - in_block_i;
-      const float *__restrict__ in_block_ptr = in + in_block_i;
+      const float *__restrict__ in_block_ptr = in + (in_block_i - in_begin);
       for (int64_t out_pos = out_block; out_pos < block_end; out_pos++, in_pos += fscale) {
         int i0, i1;
         std::tie(i0, i1) = window.input_range(in_pos);
@@ -169,7 +356,8 @@ struct Resampler {
    *
    * Calculates a range of resampled signal.
    * The function can seamlessly resample the input and produce the result in chunks.
-   * To reuse memory and still simulate chunk processing, adjust the in/out pointers.
+   * To reuse memory, the input of a chunk can hold only the frames used by that chunk,
+   * starting at the frame `in_begin`.
    *
    * @tparam static_channels   number of channels, if known at compile time, or -1
    */
@@ -177,13 +365,34 @@ struct Resampler {
   void Resample(
         Out *__restrict__ out, int64_t out_begin, int64_t out_end, double out_rate,
         const float *__restrict__ in, int64_t n_in, double in_rate,
-        int dynamic_num_channels) {
+        int dynamic_num_channels, int64_t in_begin = 0) {
+    static_assert(static_channels != 0, "Static number of channels must be positive (use static) "
+                                        "or negative (use dynamic).");
+    assert(out_rate > 0 && in_rate > 0 && "Sampling rate must be positive");
+    if (auto filter = GetPolyphaseFilter(in_rate, out_rate))
+      ResamplePolyphase<static_channels>(out, out_begin, out_end, in, n_in, *filter,
+                                         dynamic_num_channels, in_begin);
+    else
+      ResampleWindowed<static_channels>(out, out_begin, out_end, out_rate, in, n_in, in_rate,
+                                        dynamic_num_channels, in_begin);
+  }
+
+  /**
+   * @brief Resample multi-channel signal, evaluating the window for each output sample
+   *
+   * @tparam static_channels   number of channels, if known at compile time, or -1
+   * @param in_begin  index of the input frame at `in`
+   */
+  template <int static_channels, typename Out>
+  void ResampleWindowed(
+        Out *__restrict__ out, int64_t out_begin, int64_t out_end, double out_rate,
+        const float *__restrict__ in, int64_t n_in, double in_rate,
+        int dynamic_num_channels, int64_t in_begin = 0) const {
     static_assert(static_channels != 0, "Static number of channels must be positive (use static) "
                                         "or negative (use dynamic).");
     assert(out_rate > 0 && in_rate > 0 && "Sampling rate must be positive");
     if (dynamic_num_channels == 1) {
-      // fast path
-      Resample(out, out_begin, out_end, out_rate, in, n_in, in_rate);
+      ResampleWindowed(out, out_begin, out_end, out_rate, in, n_in, in_rate, in_begin);
       return;
     }
     // the check below is compile time, so num_channels will be a compile-time constant
@@ -202,7 +411,7 @@ struct Resampler {
       double in_block_f = out_block * scale;
       int64_t in_block_i = std::floor(in_block_f);
       float in_pos = in_block_f - in_block_i;
-      const float *__restrict__ in_block_ptr = in + in_block_i * num_channels;
+      const float *__restrict__ in_block_ptr = in + (in_block_i - in_begin) * num_channels;
       for (int64_t out_pos = out_block; out_pos < block_end; out_pos++, in_pos += fscale) {
         int i0, i1;
         std::tie(i0, i1) = window.input_range(in_pos);
@@ -221,7 +430,7 @@ struct Resampler {
           float w = window(x);
           for (int c = 0; c < num_channels; c++) {
             assert(in_block_ptr + in_ofs + c >= in &&
-                   in_block_ptr + in_ofs + c < in + n_in * num_channels);
+                   in_block_ptr + in_ofs + c < in + (n_in - in_begin) * num_channels);
             tmp[c] += in_block_ptr[in_ofs + c] * w;
           }
         }
@@ -244,13 +453,110 @@ struct Resampler {
   void Resample(
         Out *__restrict__ out, int64_t out_begin, int64_t out_end, double out_rate,
         const float *__restrict__ in, int64_t n_in, double in_rate,
-        int num_channels) {
+        int num_channels, int64_t in_begin = 0) {
     VALUE_SWITCH(num_channels, static_channels, (1, 2, 3, 4, 5, 6, 7, 8),
       (Resample<static_channels, Out>(out, out_begin, out_end, out_rate,
-        in, n_in, in_rate, static_channels);),
+        in, n_in, in_rate, static_channels, in_begin);),
       (Resample<-1, Out>(out, out_begin, out_end, out_rate,
-        in, n_in, in_rate, num_channels)));
+        in, n_in, in_rate, num_channels, in_begin)));
+  }
+
+  /**
+   * @brief Resample single-channel signal using precomputed polyphase coefficients
+   *
+   * The input is zero-padded outside of `[0, n_in)`.
+   *
+   * @param in_begin  index of the input sample at `in`
+   */
+  template <typename Out>
+  void ResamplePolyphase(
+        Out *__restrict__ out, int64_t out_begin, int64_t out_end,
+        const float *__restrict__ in, int64_t n_in, const PolyphaseFilter &filter,
+        int64_t in_begin = 0) const {
+    const int64_t num_phases = filter.num_phases;
+    const int64_t step_int = filter.in_step / num_phases;
+    const int64_t step_frac = filter.in_step % num_phases;
+    const int num_taps = filter.num_taps;
+    int64_t n = out_begin * filter.in_step / num_phases;
+    int64_t p = out_begin * filter.in_step % num_phases;
+    for (int64_t out_pos = out_begin; out_pos < out_end; out_pos++) {
+      int64_t i0 = n - filter.lobes;
+      int k0 = std::max<int64_t>(0, -i0);
+      int k1 = std::min<int64_t>(num_taps, n_in - i0);
+      const float *coeffs = filter.phase(p);
+      float f = k1 > k0 ? detail::dot(coeffs + k0, in + (i0 + k0 - in_begin), k1 - k0) : 0.0f;
+      out[out_pos] = ConvertSatNorm<Out>(f);
+      n += step_int;
+      p += step_frac;
+      if (p >= num_phases) {
+        p -= num_phases;
+        n++;
+      }
+    }
+  }
+
+  /**
+   * @brief Resample multi-channel signal using precomputed polyphase coefficients
+   *
+   * The input is zero-padded outside of `[0, n_in)`.
+   *
+   * @tparam static_channels   number of channels, if known at compile time, or -1
+   * @param in_begin  index of the input frame at `in`
+   */
+  template <int static_channels, typename Out>
+  void ResamplePolyphase(
+        Out *__restrict__ out, int64_t out_begin, int64_t out_end,
+        const float *__restrict__ in, int64_t n_in, const PolyphaseFilter &filter,
+        int dynamic_num_channels, int64_t in_begin = 0) const {
+    static_assert(static_channels != 0, "Static number of channels must be positive (use static) "
+                                        "or negative (use dynamic).");
+    if (dynamic_num_channels == 1) {
+      ResamplePolyphase(out, out_begin, out_end, in, n_in, filter, in_begin);
+      return;
+    }
+    const int num_channels = static_channels < 0 ? dynamic_num_channels : static_channels;
+    assert(num_channels > 0);
+
+    const int64_t num_phases = filter.num_phases;
+    const int64_t step_int = filter.in_step / num_phases;
+    const int64_t step_frac = filter.in_step % num_phases;
+    const int num_taps = filter.num_taps;
+    int64_t n = out_begin * filter.in_step / num_phases;
+    int64_t p = out_begin * filter.in_step % num_phases;
+    SmallVector<float, (static_channels < 0 ? 16 : static_channels)> tmp;
+    tmp.resize(num_channels);
+    for (int64_t out_pos = out_begin; out_pos < out_end; out_pos++) {
+      int64_t i0 = n - filter.lobes;
+      int k0 = std::max<int64_t>(0, -i0);
+      int k1 = std::min<int64_t>(num_taps, n_in - i0);
+      const float *coeffs = filter.phase(p);
+      for (int c = 0; c < num_channels; c++)
+        tmp[c] = 0;
+      const float *__restrict__ in_ptr = in + (i0 + k0 - in_begin) * num_channels;
+      for (int k = k0; k < k1; k++, in_ptr += num_channels) {
+        float w = coeffs[k];
+        for (int c = 0; c < num_channels; c++)
+          tmp[c] += in_ptr[c] * w;
+      }
+      for (int c = 0; c < num_channels; c++)
+        out[out_pos * num_channels + c] = ConvertSatNorm<Out>(tmp[c]);
+      n += step_int;
+      p += step_frac;
+      if (p >= num_phases) {
+        p -= num_phases;
+        n++;
+      }
+    }
   }
+
+ private:
+  static constexpr size_t kMaxCachedFilters = 16;
+
+  struct PolyphaseCache {
+    std::mutex mtx;
+    std::vector<std::shared_ptr<const PolyphaseFilter>> filters;
+  };
+  std::shared_ptr<PolyphaseCache> polyphase_cache_;
 };
 
 }  // namespace resampling
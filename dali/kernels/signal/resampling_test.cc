@@ -1,4 +1,4 @@
-// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2019-2021, NVIDIA CORPORATION. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -13,8 +13,11 @@
 // limitations under the License.
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
 #include <vector>
 #include <numeric>
+#include <tuple>
 #include "dali/kernels/signal/resampling.h"
 
 namespace dali {
@@ -103,6 +106,95 @@ TEST(ResampleSinc, MultiChannel) {
     "\n  RMS error: " << err << std::endl;
 }
 
+TEST(ResampleSinc, PolyphaseRatio) {
+  int64_t in_step = 0, num_phases = 0;
+  ASSERT_TRUE(rational_ratio(in_step, num_phases, 44100, 16000));
+  EXPECT_EQ(in_step, 441);
+  EXPECT_EQ(num_phases, 160);
+  ASSERT_TRUE(rational_ratio(in_step, num_phases, 48000, 16000));
+  EXPECT_EQ(in_step, 3);
+  EXPECT_EQ(num_phases, 1);
+  EXPECT_FALSE(rational_ratio(in_step, num_phases, 22050, 22053));  // too many phases
+  EXPECT_FALSE(rational_ratio(in_step, num_phases, 44100, 16000.5));
+}
+
+class ResamplePolyphaseTest : public ::testing::TestWithParam<std::tuple<int, int, int>> {};
+
+TEST_P(ResamplePolyphaseTest, CompareWithWindowed) {
+  int in_rate = std::get<0>(GetParam());
+  int out_rate = std::get<1>(GetParam());
+  int ch = std::get<2>(GetParam());
+  int n_in = in_rate / 2;
+  int n_out = resampled_length(n_in, in_rate, out_rate);
+  double scale = static_cast<double>(in_rate) / out_rate;
+  auto freq = [](int c) { return 0.1 * (1 + c * 0.012345); };
+  std::vector<float> in(n_in * ch);
+  for (int i = 0; i < n_in; i++)
+    for (int c = 0; c < ch; c++)
+      in[i * ch + c] = std::sin(i * freq(c));
+
+  Resampler R;
+  R.Initialize(16);
+  ASSERT_NE(R.GetPolyphaseFilter(in_rate, out_rate), nullptr);
+  std::vector<float> out(n_out * ch), windowed(n_out * ch);
+  R.Resample(out.data(), 0, n_out, out_rate, in.data(), n_in, in_rate, ch);
+  if (ch == 1)
+    R.ResampleWindowed(windowed.data(), 0, n_out, out_rate, in.data(), n_in, in_rate);
+  else
+    R.ResampleWindowed<-1>(windowed.data(), 0, n_out, out_rate, in.data(), n_in, in_rate, ch);
+
+  // The windowed resampler accumulates the input position in single precision, whereas
+  // the polyphase one calculates it exactly - hence different error bounds.
+  double max_err = 0, max_err_windowed = 0;
+  int margin = 100;  // skip the edges, where the signal is not band-limited
+  for (int o = margin; o < n_out - margin; o++) {
+    for (int c = 0; c < ch; c++) {
+      double ref = std::sin(o * scale * freq(c));
+      max_err = std::max(max_err, std::abs(out[o * ch + c] - ref));
+      max_err_windowed = std::max(max_err_windowed, std::abs(windowed[o * ch + c] - ref));
+    }
+  }
+  EXPECT_LE(max_err, 1e-4);
+  EXPECT_LE(max_err_windowed, 2e-3);
+  std::cerr << "Max error vs fresh signal:"
+    "\n  polyphase: " << max_err <<
+    "\n  windowed:  " << max_err_windowed << std::endl;
+
+  // chunks must produce the same result as a single pass
+  std::vector<float> chunked(n_out * ch);
+  int chunk = 1000;
+  for (int begin = 0; begin < n_out; begin += chunk) {
+    int end = std::min(begin + chunk, n_out);
+    R.Resample(chunked.data(), begin, end, out_rate, in.data(), n_in, in_rate, ch);
+  }
+  EXPECT_EQ(chunked, out);
+
+  // ...also when each chunk gets only the part of the input it uses; the chunks are aligned
+  // to the blocks of the windowed resampler
+  std::vector<float> partial(n_out * ch), partial_windowed(n_out * ch), in_part;
+  chunk = 1024;
+  int in_margin = R.window.lobes + 4;
+  for (int begin = 0; begin < n_out; begin += chunk) {
+    int end = std::min(begin + chunk, n_out);
+    int64_t in_begin = std::max<int64_t>(std::floor(begin * scale) - in_margin, 0);
+    int64_t in_end = std::min<int64_t>(std::ceil(end * scale) + in_margin, n_in);
+    in_part.assign(in.begin() + in_begin * ch, in.begin() + in_end * ch);
+    R.Resample(partial.data(), begin, end, out_rate, in_part.data(), n_in, in_rate, ch,
+               in_begin);
+    R.ResampleWindowed<-1>(partial_windowed.data(), begin, end, out_rate, in_part.data(), n_in,
+                           in_rate, ch, in_begin);
+  }
+  EXPECT_EQ(partial, out);
+  EXPECT_EQ(partial_windowed, windowed);
+}
+
+INSTANTIATE_TEST_SUITE_P(ResampleSinc, ResamplePolyphaseTest, ::testing::Values(
+  std::make_tuple(44100, 16000, 1),
+  std::make_tuple(48000, 16000, 1),
+  std::make_tuple(16000, 44100, 1),
+  std::make_tuple(44100, 16000, 2),
+  std::make_tuple(48000, 22050, 5)));
+
 }  // namespace resampling
 }  // namespace signal
 }  // namespace kernels
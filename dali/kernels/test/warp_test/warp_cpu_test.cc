@@ -15,6 +15,7 @@
 #include <gtest/gtest.h>
 #include <opencv2/imgcodecs.hpp>
 #include <opencv2/imgproc.hpp>
+#include <random>
 #include <string>
 #include <vector>
 #include "dali/kernels/imgproc/warp_cpu.h"
@@ -147,5 +148,73 @@ TEST(WarpCPU, Affine_RotateScale) {
   }
 }
 
+namespace {
+
+/**
+ * @brief Warps the image pixel by pixel, with the same sampler and the same coordinate
+ *        calculation as the affine WarpCPU, but with border handling in every pixel
+ */
+template <DALIInterpType interp, typename Border>
+void RefAffineWarp(const OutTensorCPU<uint8_t, 3> &out, const InTensorCPU<uint8_t, 3> &in,
+                   const AffineMapping2D &mapping, Border border) {
+  auto sampler = make_sampler<interp>(as_surface_channel_last(in));
+  vec2 dsdx = mapping.transform.col(0);
+  for (int y = 0; y < out.shape[0]; y++) {
+    vec2 row_start = warp::map_coords(mapping, ivec2(0, y));
+    for (int x = 0; x < out.shape[1]; x++)
+      sampler(out(y, x), row_start + static_cast<float>(x) * dsdx, border);
+  }
+}
+
+template <DALIInterpType interp, typename Border>
+void TestAffineInterior(const AffineMapping2D &mapping, Border border) {
+  std::mt19937_64 rng(1234);
+  WarpCPU<AffineMapping2D, 2, uint8_t, uint8_t, Border> warp;
+  for (int channels : { 1, 3, 5 }) {
+    TestTensorList<uint8_t, 3> in, out, ref;
+    TensorShape<3> in_shape = { 123, 301, channels };
+    TensorShape<2> out_size = { 157, 269 };
+    in.reshape(uniform_list_shape<3>(1, in_shape));
+    UniformRandomFill(in.cpu(), rng, 0, 255);
+    auto in_tv = in.cpu()[0];
+
+    KernelContext ctx = {};
+    auto req = warp.Setup(ctx, in_tv, mapping, out_size, interp, border);
+    out.reshape(req.output_shapes[0].template to_static<3>());
+    ref.reshape(req.output_shapes[0].template to_static<3>());
+    warp.Run(ctx, out.cpu()[0], in_tv, mapping, out_size, interp, border);
+    RefAffineWarp<interp>(ref.cpu()[0], in_tv, mapping, border);
+    // ties may be rounded differently
+    Check(out.cpu()[0], ref.cpu()[0], EqualEps(interp == DALI_INTERP_NN ? 0 : 1));
+  }
+}
+
+template <DALIInterpType interp>
+void TestAffineInterior(const AffineMapping2D &mapping) {
+  TestAffineInterior<interp>(mapping, BorderClamp());
+  TestAffineInterior<interp>(mapping, uint8_t(42));
+}
+
+}  // namespace
+
+TEST(WarpCPU, Affine_MatchesSampler_Rotate) {
+  vec2 center(150, 60);
+  auto tr = translation(center) * rotation2D(0.5f) * translation(-center);
+  AffineMapping2D mapping = sub<2, 3>(tr, 0, 0);
+  TestAffineInterior<DALI_INTERP_NN>(mapping);
+  TestAffineInterior<DALI_INTERP_LINEAR>(mapping);
+}
+
+TEST(WarpCPU, Affine_MatchesSampler_ScaleTranslate) {
+  for (float scale : { 0.7f, 1.0f, 1.9f }) {
+    AffineMapping2D mapping = mat2x3{{
+      { scale, 0, -10.3f },
+      { 0, 1 / scale, 7.6f }
+    }};
+    TestAffineInterior<DALI_INTERP_NN>(mapping);
+    TestAffineInterior<DALI_INTERP_LINEAR>(mapping);
+  }
+}
+
 }  // namespace kernels
 }  // namespace dali
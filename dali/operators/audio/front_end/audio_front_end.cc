@@ -0,0 +1,388 @@
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/operators/audio/front_end/audio_front_end.h"
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+#include "dali/core/boundary.h"
+#include "dali/kernels/audio/mel_scale/mel_filter_bank_cpu.h"
+#include "dali/kernels/signal/dct/dct_cpu.h"
+#include "dali/kernels/signal/decibel/decibel_calculator.h"
+#include "dali/kernels/signal/window/extract_windows_cpu.h"
+#include "dali/kernels/signal/window/window_functions.h"
+#include "dali/pipeline/data/views.h"
+
+namespace dali {
+
+DALI_SCHEMA(AudioFrontEnd)
+  .DocStr(R"code(Computes Mel Frequency Cepstral Coefficients (MFCC) from a 1D signal
+(for example, audio).
+
+The result is equivalent to applying ``Spectrogram``, ``MelFilterBank``, ``ToDecibels`` and
+``MFCC`` (with ``axis`` set to the frequency axis) in sequence, with the same arguments.
+The windows of each sample are processed in small blocks from start to end, so that the
+intermediate spectrograms are never stored in memory, which makes this operator considerably
+faster than the chain of operators.
+
+Input data is expected to be one channel (shape being ``(nsamples,)``, ``(nsamples, 1)``, or
+``(1, nsamples)``) of type float32.
+
+The output layout is ``"ft"`` (cepstral coefficients, time) or ``"tf"``, as selected with the
+``layout`` argument.)code")
+  .NumInput(1)
+  .NumOutput(1)
+  .AddOptionalArg("n_mfcc",
+    R"code(Number of MFCC coefficients.)code",
+    20)
+  .AddOptionalArg("dct_type",
+    R"code(Discrete Cosine Transform type.
+
+The supported types are 1, 2, 3, 4. See ``MFCC`` for details.)code",
+    2)
+  .AddOptionalArg("dct_normalize",
+    R"code(If set to True, the DCT uses an ortho-normal basis.
+
+This corresponds to the ``normalize`` argument of ``MFCC``. The ``normalize`` argument
+of this operator refers to the mel filter bank.
+
+.. note::
+  Normalization is not supported when dct_type=1.)code",
+    false)
+  .AddOptionalArg("lifter",
+    R"code(Cepstral filtering coefficient, which is also known as the liftering coefficient.
+
+See ``MFCC`` for details.)code",
+    0.0f)
+  .AddParent("Spectrogram")
+  .AddParent("MelFilterBank")
+  .AddParent("ToDecibels");
+
+namespace {
+
+using WindowKernel = kernels::signal::ExtractWindowsCpu<float, float, 1, false>;
+using FftKernel = kernels::signal::fft::Fft1DCpu<float, float, 2>;
+using MelKernel = kernels::audio::MelFilterBankCpu<float>;
+using DctKernel = kernels::signal::dct::Dct1DCpu<float, float, 2>;
+
+}  // namespace
+
+template <>
+AudioFrontEnd<CPUBackend>::AudioFrontEnd(const OpSpec &spec)
+    : Operator<CPUBackend>(spec)
+    , window_length_(spec.GetArgument<int>("window_length"))
+    , window_step_(spec.GetArgument<int>("window_step"))
+    , window_fn_(spec.GetRepeatedArgument<float>("window_fn")) {
+  using kernels::signal::Padding;
+  namespace fft = kernels::signal::fft;
+
+  // Spectrogram
+  DALI_ENFORCE(window_length_ > 0, make_string("Invalid window length: ", window_length_));
+  DALI_ENFORCE(window_step_ > 0, make_string("Invalid window step: ", window_step_));
+  nfft_ = spec.HasArgument("nfft") ? spec.GetArgument<int>("nfft") : window_length_;
+  DALI_ENFORCE(window_length_ <= nfft_, make_string(
+    "Window length (", window_length_, ") can't be bigger than the FFT size (", nfft_, ")"));
+  nbins_ = nfft_ / 2 + 1;
+
+  if (window_fn_.empty()) {
+    window_fn_.resize(window_length_);
+    kernels::signal::HannWindow(make_span(window_fn_));
+  }
+  DALI_ENFORCE(window_fn_.size() == static_cast<size_t>(window_length_),
+    "Window function should match the specified `window_length`");
+
+  if (spec.GetArgument<bool>("center_windows")) {
+    window_center_ = window_length_ / 2;
+    padding_ = spec.GetArgument<bool>("reflect_padding") ? Padding::Reflect : Padding::Zero;
+  } else {
+    window_center_ = 0;
+    padding_ = Padding::None;
+  }
+
+  layout_ = spec.GetArgument<TensorLayout>("layout");
+  DALI_ENFORCE(layout_ == "ft" || layout_ == "tf",
+               make_string("Unexpected layout: ", layout_));
+  time_major_ = layout_ == "tf";
+
+  fft_args_.nfft = nfft_;
+  fft_args_.transform_axis = 1;
+  int power = spec.GetArgument<int>("power");
+  switch (power) {
+    case 1:
+      fft_args_.spectrum_type = fft::FFT_SPECTRUM_MAGNITUDE;
+      break;
+    case 2:
+      fft_args_.spectrum_type = fft::FFT_SPECTRUM_POWER;
+      break;
+    default:
+      DALI_FAIL(make_string("`power` can be only 1 (energy) or 2 (power), received ", power));
+  }
+
+  // MelFilterBank
+  mel_args_.nfilter = spec.GetArgument<int>("nfilter");
+  DALI_ENFORCE(mel_args_.nfilter > 0, "number of filters should be > 0");
+  mel_args_.sample_rate = spec.GetArgument<float>("sample_rate");
+  DALI_ENFORCE(mel_args_.sample_rate > 0.0f, "sample rate should be > 0");
+  mel_args_.freq_low = spec.GetArgument<float>("freq_low");
+  DALI_ENFORCE(mel_args_.freq_low >= 0.0f, "freq_low should be >= 0");
+  mel_args_.freq_high = spec.GetArgument<float>("freq_high");
+  if (mel_args_.freq_high <= 0.0f)
+    mel_args_.freq_high = 0.5f * mel_args_.sample_rate;
+  DALI_ENFORCE(mel_args_.freq_high > mel_args_.freq_low &&
+               mel_args_.freq_high <= mel_args_.sample_rate,
+    "freq_high should be within the range (freq_low, sample_rate/2]");
+  auto mel_formula = spec.GetArgument<std::string>("mel_formula");
+  if (mel_formula == "htk") {
+    mel_args_.mel_formula = kernels::audio::MelScaleFormula::HTK;
+  } else if (mel_formula == "slaney") {
+    mel_args_.mel_formula = kernels::audio::MelScaleFormula::Slaney;
+  } else {
+    DALI_FAIL(make_string("Unsupported mel_formula value \"", mel_formula,
+      "\". Supported values are: \"slaney\", \"htk\""));
+  }
+  mel_args_.normalize = spec.GetArgument<bool>("normalize");
+  mel_args_.nfft = nfft_;
+  mel_args_.axis = 1;
+
+  // ToDecibels
+  db_args_.multiplier = spec.GetArgument<float>("multiplier");
+  db_args_.ref_max = !spec.HasArgument("reference");
+  if (!db_args_.ref_max) {
+    db_args_.s_ref = spec.GetArgument<float>("reference");
+    DALI_ENFORCE(db_args_.s_ref != 0, "`reference` argument can't be zero");
+  }
+  auto cutoff_db = spec.GetArgument<float>("cutoff_db");
+  db_args_.min_ratio = std::pow(10.0f, cutoff_db / db_args_.multiplier);
+  if (db_args_.min_ratio == 0)
+    db_args_.min_ratio = std::nextafter(0.0f, 1.0f);
+
+  // MFCC
+  dct_args_.ndct = spec.GetArgument<int>("n_mfcc");
+  DALI_ENFORCE(dct_args_.ndct > 0, "number of MFCCs should be > 0");
+  dct_args_.dct_type = spec.GetArgument<int>("dct_type");
+  DALI_ENFORCE(dct_args_.dct_type >= 1 && dct_args_.dct_type <= 4,
+    make_string("Unsupported DCT type: ", dct_args_.dct_type,
+                ". Supported types are: 1, 2, 3, 4."));
+  dct_args_.normalize = spec.GetArgument<bool>("dct_normalize");
+  if (dct_args_.normalize) {
+    DALI_ENFORCE(dct_args_.dct_type != 1, "Ortho-normalization is not supported for DCT type I.");
+  }
+  lifter_ = spec.GetArgument<float>("lifter");
+}
+
+template <>
+bool AudioFrontEnd<CPUBackend>::SetupImpl(std::vector<OutputDesc> &output_desc,
+                                          const workspace_t<CPUBackend> &ws) {
+  const auto &input = ws.InputRef<CPUBackend>(0);
+  auto in_shape = input.shape();
+  int nsamples = input.size();
+  int nthreads = ws.GetThreadPool().NumThreads();
+  kernels::KernelContext ctx;
+
+  DALI_ENFORCE(input.type().id() == DALI_FLOAT,
+               make_string("Unsupported data type: ", input.type().id()));
+
+  // Check that input is 1-D (allowing having extra dims with extent 1)
+  if (in_shape.sample_dim() > 1) {
+    for (int i = 0; i < in_shape.num_samples(); i++) {
+      auto shape = in_shape.tensor_shape(i);
+      auto n = volume(shape);
+      for (auto extent : shape) {
+        DALI_ENFORCE(extent == 1 || extent == n, make_string("Input data must be 1D or all "
+          "but one dimensions must be degenerate (extent 1). Got: ", shape));
+      }
+    }
+  }
+
+  // The kernels are set up for a full block of windows; the window extraction kernel is set up
+  // again for each block, since the length of its output depends on the length of the input
+  kmgr_window_.Resize<WindowKernel>(nthreads, nthreads);
+  kmgr_fft_.Resize<FftKernel>(nthreads, nthreads);
+  kmgr_mel_.Resize<MelKernel>(nthreads, nthreads);
+  kmgr_dct_.Resize<DctKernel>(nthreads, nthreads);
+  TensorShape<2> windows_shape{kBlockWindows, window_length_};
+  TensorShape<2> spectrum_shape{kBlockWindows, nbins_};
+  TensorShape<2> mel_shape{kBlockWindows, mel_args_.nfilter};
+  for (int t = 0; t < nthreads; t++) {
+    kmgr_fft_.Setup<FftKernel>(
+      t, ctx, make_tensor_cpu<2, const float>(nullptr, windows_shape), fft_args_);
+    kmgr_mel_.Setup<MelKernel>(
+      t, ctx, make_tensor_cpu<2, const float>(nullptr, spectrum_shape), mel_args_);
+    auto &req = kmgr_dct_.Setup<DctKernel>(
+      t, ctx, make_tensor_cpu<2, const float>(nullptr, mel_shape), dct_args_, 1);
+    ndct_ = req.output_shapes[0][0][1];
+  }
+  lifter_coeffs_.Calculate(ndct_, lifter_);
+  buffers_.resize(nthreads);
+
+  kernels::signal::ExtractWindowsArgs window_args{
+    window_length_, window_center_, window_step_, 0, padding_};
+  output_desc.resize(1);
+  output_desc[0].type = TypeInfo::Create<float>();
+  output_desc[0].shape.resize(nsamples, 2);
+  for (int i = 0; i < nsamples; i++) {
+    int64_t nwindows = window_args.num_windows(in_shape[i].num_elements());
+    DALI_ENFORCE(nwindows > 0,
+      make_string("Signal is too short (", in_shape[i].num_elements(), ") for sample ", i));
+    if (time_major_)
+      output_desc[0].shape.set_tensor_shape(i, TensorShape<2>{nwindows, ndct_});
+    else
+      output_desc[0].shape.set_tensor_shape(i, TensorShape<2>{ndct_, nwindows});
+  }
+  return true;
+}
+
+template <>
+void AudioFrontEnd<CPUBackend>::MelBlock(int thread_id, float *mel, const float *in,
+                                         int64_t length, int64_t w0, int64_t nwin) {
+  using kernels::signal::Padding;
+  auto &buf = buffers_[thread_id];
+  kernels::KernelContext ctx;
+
+  // Range of the signal covered by the windows in the block
+  int64_t start = w0 * window_step_ - window_center_;
+  int64_t span = (nwin - 1) * window_step_ + window_length_;
+  const float *signal = in + start;
+  if (start < 0 || start + span > length) {
+    buf.signal.resize(span);
+    for (int64_t t = 0; t < span; t++) {
+      int64_t idx = start + t;
+      if (padding_ == Padding::Reflect) {
+        buf.signal[t] = in[boundary::idx_reflect_101(idx, length)];
+      } else {
+        buf.signal[t] = (idx >= 0 && idx < length) ? in[idx] : 0.0f;
+      }
+    }
+    signal = buf.signal.data();
+  }
+
+  // The padding (if any) is already applied
+  kernels::signal::ExtractWindowsArgs window_args{
+    window_length_, 0, window_step_, 0, Padding::None};
+  auto signal_view = make_tensor_cpu<1>(signal, {span});
+  auto window_fn_view = make_tensor_cpu<1>(window_fn_.data(), {window_length_});
+  buf.windows.resize(nwin * window_length_);
+  auto windows_view = make_tensor_cpu<2>(buf.windows.data(), {nwin, window_length_});
+  kmgr_window_.Setup<WindowKernel>(thread_id, ctx, signal_view, window_fn_view, window_args);
+  kmgr_window_.Run<WindowKernel>(thread_id, thread_id, ctx,
+                                 windows_view, signal_view, window_fn_view, window_args);
+
+  buf.spectrum.resize(nwin * nbins_);
+  auto spectrum_view = make_tensor_cpu<2>(buf.spectrum.data(), {nwin, nbins_});
+  kmgr_fft_.Run<FftKernel>(thread_id, thread_id, ctx,
+                           spectrum_view, windows_view, fft_args_);
+
+  auto mel_view = make_tensor_cpu<2>(mel, {nwin, mel_args_.nfilter});
+  kmgr_mel_.Run<MelKernel>(thread_id, thread_id, ctx,
+                           mel_view, spectrum_view);
+}
+
+template <>
+void AudioFrontEnd<CPUBackend>::CepstrumBlock(int thread_id, float *out, float *mel, float s_ref,
+                                              int64_t nwindows, int64_t w0, int64_t nwin) {
+  auto &buf = buffers_[thread_id];
+  kernels::KernelContext ctx;
+  int nfilter = mel_args_.nfilter;
+
+  kernels::signal::MagnitudeToDecibel<float> dB(db_args_.multiplier, s_ref, db_args_.min_ratio);
+  for (int64_t i = 0; i < nwin * nfilter; i++)
+    mel[i] = dB(mel[i]);
+
+  // In time-major layout, the block is a contiguous part of the output
+  float *ceps = out + w0 * ndct_;
+  if (!time_major_) {
+    buf.ceps.resize(nwin * ndct_);
+    ceps = buf.ceps.data();
+  }
+  auto ceps_view = make_tensor_cpu<2>(ceps, {nwin, ndct_});
+  auto mel_view = make_tensor_cpu<2, const float>(mel, {nwin, nfilter});
+  kmgr_dct_.Run<DctKernel>(thread_id, thread_id, ctx, ceps_view, mel_view, dct_args_, 1);
+
+  const float *lifter_coeffs = lifter_ != 0.0f ? lifter_coeffs_.data() : nullptr;
+  if (time_major_) {
+    if (lifter_coeffs) {
+      for (int64_t w = 0; w < nwin; w++)
+        for (int k = 0; k < ndct_; k++)
+          ceps[w * ndct_ + k] *= lifter_coeffs[k];
+    }
+  } else {
+    for (int k = 0; k < ndct_; k++) {
+      float coeff = lifter_coeffs ? lifter_coeffs[k] : 1.0f;
+      float *out_row = out + k * nwindows + w0;
+      for (int64_t w = 0; w < nwin; w++)
+        out_row[w] = coeff * ceps[w * ndct_ + k];
+    }
+  }
+}
+
+template <>
+void AudioFrontEnd<CPUBackend>::ProcessSample(int thread_id, float *out, const float *in,
+                                              int64_t length) {
+  auto &buf = buffers_[thread_id];
+  int nfilter = mel_args_.nfilter;
+  kernels::signal::ExtractWindowsArgs window_args{
+    window_length_, window_center_, window_step_, 0, padding_};
+  int64_t nwindows = window_args.num_windows(length);
+
+  if (!db_args_.ref_max) {
+    buf.mel.resize(kBlockWindows * nfilter);
+    for (int64_t w0 = 0; w0 < nwindows; w0 += kBlockWindows) {
+      int64_t nwin = std::min<int64_t>(kBlockWindows, nwindows - w0);
+      MelBlock(thread_id, buf.mel.data(), in, length, w0, nwin);
+      CepstrumBlock(thread_id, out, buf.mel.data(), db_args_.s_ref, nwindows, w0, nwin);
+    }
+    return;
+  }
+
+  // The reference is the maximum of the whole mel spectrogram, so it has to be kept until
+  // all the windows are processed. It's still much smaller than the spectrogram.
+  buf.mel.resize(nwindows * nfilter);
+  for (int64_t w0 = 0; w0 < nwindows; w0 += kBlockWindows) {
+    int64_t nwin = std::min<int64_t>(kBlockWindows, nwindows - w0);
+    MelBlock(thread_id, buf.mel.data() + w0 * nfilter, in, length, w0, nwin);
+  }
+  float s_ref = 0.0f;
+  for (int64_t i = 0; i < nwindows * nfilter; i++)
+    s_ref = std::max(s_ref, buf.mel[i]);
+  // avoid division by 0
+  if (s_ref == 0.0f)
+    s_ref = 1.0f;
+  for (int64_t w0 = 0; w0 < nwindows; w0 += kBlockWindows) {
+    int64_t nwin = std::min<int64_t>(kBlockWindows, nwindows - w0);
+    CepstrumBlock(thread_id, out, buf.mel.data() + w0 * nfilter, s_ref, nwindows, w0, nwin);
+  }
+}
+
+template <>
+void AudioFrontEnd<CPUBackend>::RunImpl(workspace_t<CPUBackend> &ws) {
+  const auto &input = ws.InputRef<CPUBackend>(0);
+  auto &output = ws.OutputRef<CPUBackend>(0);
+  auto in_shape = input.shape();
+  auto &thread_pool = ws.GetThreadPool();
+  output.SetLayout(layout_);
+
+  for (int i = 0; i < in_shape.num_samples(); i++) {
+    thread_pool.AddWork(
+      [this, &input, &output, i](int thread_id) {
+        ProcessSample(thread_id, output[i].mutable_data<float>(), input[i].data<float>(),
+                      input[i].size());
+      }, in_shape.tensor_size(i));
+  }
+  thread_pool.RunAll();
+}
+
+DALI_REGISTER_OPERATOR(AudioFrontEnd, AudioFrontEnd<CPUBackend>, CPU);
+
+}  // namespace dali
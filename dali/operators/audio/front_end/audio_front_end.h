@@ -0,0 +1,108 @@
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_OPERATORS_AUDIO_FRONT_END_AUDIO_FRONT_END_H_
+#define DALI_OPERATORS_AUDIO_FRONT_END_AUDIO_FRONT_END_H_
+
+#include <vector>
+#include "dali/core/common.h"
+#include "dali/kernels/kernel_manager.h"
+#include "dali/kernels/audio/mel_scale/mel_filter_bank_args.h"
+#include "dali/kernels/signal/dct/dct_args.h"
+#include "dali/kernels/signal/decibel/to_decibels_args.h"
+#include "dali/kernels/signal/fft/fft_cpu.h"
+#include "dali/kernels/signal/window/extract_windows_args.h"
+#include "dali/operators/audio/mfcc/mfcc.h"
+#include "dali/pipeline/operator/common.h"
+#include "dali/pipeline/operator/operator.h"
+
+namespace dali {
+
+/**
+ * @brief Computes MFCCs directly from a 1D audio signal
+ *
+ * The result is equivalent to Spectrogram -> MelFilterBank -> ToDecibels -> MFCC, but the
+ * windows of each sample are processed in small blocks, so that the intermediate
+ * representations (windows, spectrum, mel spectrum) stay in cache and are never materialized
+ * for the whole batch.
+ */
+template <typename Backend>
+class AudioFrontEnd : public Operator<Backend> {
+ public:
+  explicit AudioFrontEnd(const OpSpec &spec);
+
+ protected:
+  bool CanInferOutputs() const override { return true; }
+  bool SetupImpl(std::vector<OutputDesc> &output_desc, const workspace_t<Backend> &ws) override;
+  void RunImpl(workspace_t<Backend> &ws) override;
+
+  USE_OPERATOR_MEMBERS();
+  using Operator<Backend>::RunImpl;
+
+ private:
+  /// @brief Number of windows processed at once
+  static constexpr int kBlockWindows = 32;
+
+  struct ThreadBuffers {
+    std::vector<float> signal;    // padded signal range, only for blocks crossing the boundary
+    std::vector<float> windows;   // [block, window_length]
+    std::vector<float> spectrum;  // [block, nfft / 2 + 1]
+    std::vector<float> mel;       // [block, nfilter] or [nwindows, nfilter] with `ref_max`
+    std::vector<float> ceps;      // [block, ndct]
+  };
+
+  void ProcessSample(int thread_id, float *out, const float *in, int64_t length);
+
+  /**
+   * @brief Extracts windows [w0, w0 + nwin) and converts them to a mel spectrum
+   */
+  void MelBlock(int thread_id, float *mel, const float *in, int64_t length,
+                int64_t w0, int64_t nwin);
+
+  /**
+   * @brief Converts a block of mel spectrum windows to decibels (in place) and
+   *        calculates the cepstral coefficients, writing them at window `w0` of the output
+   */
+  void CepstrumBlock(int thread_id, float *out, float *mel, float s_ref,
+                     int64_t nwindows, int64_t w0, int64_t nwin);
+
+  int window_length_ = -1;
+  int window_step_ = -1;
+  int window_center_ = 0;
+  int nfft_ = -1;
+  int nbins_ = -1;
+  int ndct_ = -1;
+  bool time_major_ = false;
+  TensorLayout layout_;
+  std::vector<float> window_fn_;
+  kernels::signal::Padding padding_ = kernels::signal::Padding::None;
+
+  kernels::signal::fft::FftArgs fft_args_;
+  kernels::audio::MelFilterBankArgs mel_args_;
+  kernels::signal::ToDecibelsArgs<float> db_args_;
+  kernels::signal::dct::DctArgs dct_args_;
+  float lifter_ = 0.0f;
+  detail::LifterCoeffs<Backend> lifter_coeffs_;
+
+  // Kernel instances are per thread, not per sample
+  kernels::KernelManager kmgr_window_;
+  kernels::KernelManager kmgr_fft_;
+  kernels::KernelManager kmgr_mel_;
+  kernels::KernelManager kmgr_dct_;
+  std::vector<ThreadBuffers> buffers_;
+};
+
+}  // namespace dali
+
+#endif  // DALI_OPERATORS_AUDIO_FRONT_END_AUDIO_FRONT_END_H_
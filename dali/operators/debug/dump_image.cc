@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cstring>
 #include "dali/operators/debug/dump_image.h"
 #include "dali/core/tensor_layout.h"
 #include "dali/util/image.h"
@@ -19,22 +20,26 @@
 namespace dali {
 
 template<>
-void DumpImage<CPUBackend>::RunImpl(SampleWorkspace &ws) {
-  auto &input = ws.Input<CPUBackend>(0);
-  auto &output = ws.Output<CPUBackend>(0);
+void DumpImage<CPUBackend>::RunImpl(HostWorkspace &ws) {
+  auto &input = ws.InputRef<CPUBackend>(0);
+  auto &output = ws.OutputRef<CPUBackend>(0);
+  output.SetLayout(input.GetLayout());
 
-  DALI_ENFORCE(input.ndim() == 3,
+  DALI_ENFORCE(input.shape().sample_dim() == 3,
       "Input images must have three dimensions.");
 
-  int h = input.dim(0);
-  int w = input.dim(1);
-  int c = input.dim(2);
-
-  WriteHWCImage(input.template data<uint8>(),
-      h, w, c, std::to_string(ws.data_idx()) + "-" + suffix_ + "-" + std::to_string(0));
-
-  // Forward the input
-  output.Copy(input, 0);
+  auto &tp = ws.GetThreadPool();
+  for (int i = 0; i < input.shape().num_samples(); i++) {
+    tp.AddWork([&, i](int) {
+      auto shape = input.shape()[i];
+      WriteHWCImage(input[i].data<uint8>(), shape[0], shape[1], shape[2],
+          std::to_string(i) + "-" + suffix_ + "-" + std::to_string(0));
+
+      // Forward the input
+      memcpy(output[i].raw_mutable_data(), input[i].raw_data(), input[i].nbytes());
+    }, volume(input.shape()[i]));
+  }
+  tp.RunAll();
 }
 
 DALI_REGISTER_OPERATOR(DumpImage, DumpImage<CPUBackend>, CPU);
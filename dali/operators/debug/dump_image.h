@@ -37,11 +37,19 @@ class DumpImage : public Operator<Backend> {
   inline ~DumpImage() override = default;
 
  protected:
+  bool CanInferOutputs() const override {
+    return true;
+  }
+
   bool SetupImpl(std::vector<OutputDesc> &output_desc, const workspace_t<Backend> &ws) override {
-    return false;
+    const auto &input = ws.template InputRef<Backend>(0);
+    output_desc.resize(1);
+    output_desc[0].shape = input.shape();
+    output_desc[0].type = input.type();
+    return true;
   }
 
-  void RunImpl(Workspace<Backend> &ws) override;
+  void RunImpl(workspace_t<Backend> &ws) override;
 
   const string suffix_;
 };
@@ -13,6 +13,11 @@
 // limitations under the License.
 
 #include "dali/operators/decoder/audio/audio_decoder_impl.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "dali/core/math_util.h"
+#include "dali/core/util.h"
 #include "dali/kernels/signal/downmixing.h"
 
 namespace dali {
@@ -104,12 +109,112 @@ void DecodeAudio(TensorView<StorageCPU, T, DynamicDimensions> audio, AudioDecode
   }
 }
 
+template <typename T>
+void DecodeAudioChunked(TensorView<StorageCPU, T, DynamicDimensions> audio,
+                        AudioDecoderBase &decoder, const AudioMetadata &meta,
+                        kernels::signal::resampling::Resampler &resampler,
+                        std::vector<float> &decode_scratch,
+                        std::vector<float> &resample_scratch,
+                        float target_sample_rate, bool downmix,
+                        const char *audio_filepath, int64_t chunk_frames) {
+  assert(meta.sample_rate > 0 && "Invalid sampling rate");
+  assert(chunk_frames > 0 && "Invalid chunk size");
+  bool should_resample = target_sample_rate > 0 && meta.sample_rate != target_sample_rate;
+  bool should_downmix = meta.channels > 1 && downmix;
+  assert(audio.data != nullptr);
+  if (volume(audio.shape) <= 0)
+    return;
+
+  if (!should_resample && !should_downmix) {
+    // Decoding straight to the output, no scratch memory needed
+    DecodeAudio<T>(audio, decoder, meta, resampler, {}, {}, target_sample_rate, downmix,
+                   audio_filepath);
+    return;
+  }
+
+  auto decode_frames = [&](float *out, int64_t nframes) {
+    int64_t ret = decoder.DecodeFrames(out, nframes);
+    DALI_ENFORCE(ret == nframes,
+      make_string("Error decoding audio file ", audio_filepath, ". Requested ",
+                  nframes, " samples but got ", ret, " samples."));
+  };
+
+  if (!should_resample) {  // downmix only
+    int64_t length = audio.shape[0];
+    assert(length <= meta.length && "Requested to decode more data than available.");
+    decode_scratch.resize(std::min(chunk_frames, length) * meta.channels);
+    for (int64_t pos = 0; pos < length; pos += chunk_frames) {
+      int64_t nframes = std::min(chunk_frames, length - pos);
+      decode_frames(decode_scratch.data(), nframes);
+      kernels::signal::Downmix(audio.data + pos, decode_scratch.data(), nframes, meta.channels);
+    }
+    return;
+  }
+
+  // The resampler processes the output in blocks of 1024 samples. Aligning the chunks to those
+  // blocks gives exactly the same result as resampling the whole signal at once.
+  constexpr int64_t kResamplerBlock = 1 << 10;
+  chunk_frames = align_up(chunk_frames, kResamplerBlock);
+
+  int channels = should_downmix ? 1 : meta.channels;
+  int64_t in_length = meta.length;
+  int64_t out_length = audio.shape[0];
+  double scale = static_cast<double>(meta.sample_rate) / target_sample_rate;
+  // Support of the resampling window, plus some slack for the rounding errors in the resampler,
+  // which accumulates the input position in single precision
+  int64_t margin = resampler.window.lobes + 4;
+  int64_t max_in_frames = std::ceil(chunk_frames * scale) + 2 * margin + 2;
+  resample_scratch.resize(std::min(max_in_frames, in_length) * channels);
+  if (should_downmix)
+    decode_scratch.resize(std::min(max_in_frames, in_length) * meta.channels);
+
+  // [buf_begin, buf_end) is the range of input frames held in the resample scratch
+  int64_t buf_begin = 0, buf_end = 0;
+  for (int64_t out_begin = 0; out_begin < out_length; out_begin += chunk_frames) {
+    int64_t out_end = std::min(out_begin + chunk_frames, out_length);
+    int64_t in_begin = clamp<int64_t>(std::floor(out_begin * scale) - margin, 0, in_length);
+    int64_t in_end = clamp<int64_t>(std::ceil(out_end * scale) + margin, 0, in_length);
+    assert(in_begin <= buf_end && "The chunks are expected to overlap");
+
+    if (in_begin > buf_begin) {
+      // Keep only the frames that are still needed
+      int64_t keep = buf_end - in_begin;
+      std::memmove(resample_scratch.data(),
+                   resample_scratch.data() + (in_begin - buf_begin) * channels,
+                   keep * channels * sizeof(float));
+      buf_begin = in_begin;
+    }
+
+    if (in_end > buf_end) {
+      int64_t nframes = in_end - buf_end;
+      assert((in_end - buf_begin) * channels <= static_cast<int64_t>(resample_scratch.size()));
+      float *dst = resample_scratch.data() + (buf_end - buf_begin) * channels;
+      if (should_downmix) {
+        decode_frames(decode_scratch.data(), nframes);
+        kernels::signal::Downmix(dst, decode_scratch.data(), nframes, meta.channels);
+      } else {
+        decode_frames(dst, nframes);
+      }
+      buf_end = in_end;
+    }
+
+    // The scratch holds the input frames starting at buf_begin
+    resampler.Resample(audio.data, out_begin, out_end, target_sample_rate,
+                       resample_scratch.data(), in_length, meta.sample_rate, channels, buf_begin);
+  }
+}
+
 #define DECLARE_IMPL(OutType)                                                                     \
   template void DecodeAudio<OutType>(                                                             \
       TensorView<StorageCPU, OutType, DynamicDimensions> audio, AudioDecoderBase & decoder,       \
       const AudioMetadata &meta, kernels::signal::resampling::Resampler &resampler,               \
       span<float> decode_scratch_mem, span<float> resample_scratch_mem,                           \
-      float target_sample_rate, bool downmix, const char *audio_filepath);
+      float target_sample_rate, bool downmix, const char *audio_filepath);                        \
+  template void DecodeAudioChunked<OutType>(                                                      \
+      TensorView<StorageCPU, OutType, DynamicDimensions> audio, AudioDecoderBase & decoder,       \
+      const AudioMetadata &meta, kernels::signal::resampling::Resampler &resampler,               \
+      std::vector<float> &decode_scratch, std::vector<float> &resample_scratch,                   \
+      float target_sample_rate, bool downmix, const char *audio_filepath, int64_t chunk_frames);
 
 DECLARE_IMPL(float);
 DECLARE_IMPL(int16_t);
@@ -16,6 +16,7 @@
 #define DALI_OPERATORS_DECODER_AUDIO_AUDIO_DECODER_IMPL_H_
 
 #include <utility>
+#include <vector>
 #include "dali/operators/decoder/audio/audio_decoder.h"
 #include "dali/operators/decoder/audio/generic_decoder.h"
 #include "dali/pipeline/data/backend.h"
@@ -72,6 +73,42 @@ DLL_PUBLIC void DecodeAudio(TensorView<StorageCPU, T, DynamicDimensions> audio,
                             span<float> decode_scratch_mem, span<float> resample_scratch_mem,
                             float target_sample_rate, bool downmix, const char *audio_filepath);
 
+/**
+ * @brief Default number of output frames produced at once by DecodeAudioChunked
+ */
+static constexpr int64_t kDecodeAudioChunkFrames = 1 << 15;
+
+/**
+ * @brief Decodes audio data, with optional downmixing and resampling, in chunks
+ *
+ * Produces the same result as DecodeAudio, but the signal is decoded, downmixed and resampled
+ * one chunk at a time, directly into the output buffer. The scratch memory is proportional
+ * to the chunk size instead of the length of the recording.
+ *
+ * @param audio Destination buffer. The function will decode as many audio samples as the shape of this argument
+ * @param decoder Decoder object, positioned at the first frame to decode.
+ * @param meta Audio metadata. ``meta.length`` is the number of frames to decode.
+ * @param resampler Resampler instance used if resampling is required
+ * @param decode_scratch Scratch memory for the decoded multi-channel frames, used when downmixing.
+ *                       Resized as needed.
+ * @param resample_scratch Scratch memory for the part of the (downmixed) signal being resampled.
+ *                         Resized as needed.
+ * @param target_sample_rate If a positive value is provided, the signal will be resampled except when its original sampling rate
+ *                           is equal to the target.
+ * @param downmix If true, the audio channes will be downmixed to a single one
+ * @param audio_filepath Path to the audio file being decoded, only used for debugging purposes
+ * @param chunk_frames Number of output frames produced at once
+ */
+template <typename T>
+DLL_PUBLIC void DecodeAudioChunked(TensorView<StorageCPU, T, DynamicDimensions> audio,
+                                   AudioDecoderBase &decoder, const AudioMetadata &meta,
+                                   kernels::signal::resampling::Resampler &resampler,
+                                   std::vector<float> &decode_scratch,
+                                   std::vector<float> &resample_scratch,
+                                   float target_sample_rate, bool downmix,
+                                   const char *audio_filepath,
+                                   int64_t chunk_frames = kDecodeAudioChunkFrames);
+
 }  // namespace dali
 
 #endif  // DALI_OPERATORS_DECODER_AUDIO_AUDIO_DECODER_IMPL_H_
@@ -13,8 +13,13 @@
 // limitations under the License.
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <string>
 #include <utility>
+#include <vector>
 #include "dali/operators/decoder/audio/audio_decoder_impl.h"
+#include "dali/pipeline/data/views.h"
 
 namespace dali {
 namespace test {
@@ -52,5 +57,93 @@ TEST(AudioDecoderImpl, ProcessOffsetAndLength) {
   }
 }
 
+namespace {
+
+/**
+ * @brief Serves interleaved float frames from memory
+ */
+class InMemoryDecoder : public AudioDecoderBase {
+ public:
+  InMemoryDecoder(std::vector<float> data, int channels)
+      : data_(std::move(data)), channels_(channels) {}
+
+ private:
+  int64_t SeekFramesImpl(int64_t nframes, int whence) override {
+    pos_ += nframes;
+    return pos_;
+  }
+
+  ptrdiff_t DecodeImpl(span<float> output) override { return 0; }
+  ptrdiff_t DecodeImpl(span<int16_t> output) override { return 0; }
+  ptrdiff_t DecodeImpl(span<int32_t> output) override { return 0; }
+
+  ptrdiff_t DecodeFramesImpl(float* output, int64_t nframes) override {
+    int64_t n = std::min<int64_t>(nframes, data_.size() / channels_ - pos_);
+    std::copy(data_.begin() + pos_ * channels_, data_.begin() + (pos_ + n) * channels_, output);
+    pos_ += n;
+    return n;
+  }
+  ptrdiff_t DecodeFramesImpl(int16_t* output, int64_t nframes) override { return 0; }
+  ptrdiff_t DecodeFramesImpl(int32_t* output, int64_t nframes) override { return 0; }
+
+  AudioMetadata OpenImpl(span<const char> encoded) override { return {}; }
+  AudioMetadata OpenFromFileImpl(const std::string &filepath) override { return {}; }
+  void CloseImpl() override {}
+
+  std::vector<float> data_;
+  int channels_;
+  int64_t pos_ = 0;
+};
+
+}  // namespace
+
+TEST(AudioDecoderImpl, DecodeAudioChunked) {
+  kernels::signal::resampling::Resampler resampler;
+  resampler.Initialize(16, 16 * 64 + 1);
+  std::mt19937 rng(1234);
+  std::uniform_real_distribution<float> dist(-1, 1);
+  for (int64_t length : {10, 5000, 100000}) {
+    for (int channels : {1, 3}) {
+      std::vector<float> signal(length * channels);
+      for (auto &x : signal)
+        x = dist(rng);
+      AudioMetadata meta{length, 16000, channels};
+      for (float rate : {16000.0f, 8000.0f, 44100.0f}) {
+        for (bool downmix : {false, true}) {
+          bool should_resample = rate != meta.sample_rate;
+          bool should_downmix = downmix && channels > 1;
+          auto shape = DecodedAudioShape(meta, rate, downmix);
+          std::vector<float> ref(volume(shape)), out(volume(shape));
+
+          InMemoryDecoder ref_decoder(signal, channels);
+          std::vector<float> decode_scratch, resample_scratch;
+          if (should_resample || should_downmix)
+            decode_scratch.resize(length * channels);
+          if (should_resample)
+            resample_scratch.resize(should_downmix ? length : length * channels);
+          DecodeAudio<float>(make_tensor_cpu(ref.data(), shape), ref_decoder, meta, resampler,
+                             make_span(decode_scratch), make_span(resample_scratch),
+                             rate, downmix, "ref");
+
+          for (int64_t chunk : {1, 4096}) {
+            InMemoryDecoder decoder(signal, channels);
+            std::vector<float> chunk_decode_scratch, chunk_resample_scratch;
+            DecodeAudioChunked<float>(make_tensor_cpu(out.data(), shape), decoder, meta, resampler,
+                                      chunk_decode_scratch, chunk_resample_scratch,
+                                      rate, downmix, "chunked", chunk);
+            // The chunks are aligned to the resampler blocks, so the result is exactly the same
+            EXPECT_EQ(ref, out) << "length: " << length << " channels: " << channels
+                                << " rate: " << rate << " downmix: " << downmix
+                                << " chunk: " << chunk;
+            if (length * channels > 8 * 4096)
+              EXPECT_LT(chunk_decode_scratch.size() + chunk_resample_scratch.size(),
+                        static_cast<size_t>(length * channels));
+          }
+        }
+      }
+    }
+  }
+}
+
 }  // namespace test
 }  // namespace dali
@@ -35,8 +35,9 @@ CachedDecoderImpl::CachedDecoderImpl(const OpSpec& spec)
     if (cache_size > 0 && cache_size >= cache_threshold) {
       const std::string cache_type = spec.GetArgument<std::string>("cache_type");
       const bool cache_debug = spec.GetArgument<bool>("cache_debug");
+      const std::string cache_name = spec.GetArgument<std::string>("cache_name");
       cache_ = ImageCacheFactory::Instance().Get(
-        device_id_, cache_type, cache_size, cache_debug, cache_threshold);
+        device_id_, cache_type, cache_size, cache_debug, cache_threshold, cache_name);
 
       use_batch_copy_kernel_ = spec.GetArgument<bool>("cache_batch_copy");
       auto batch_size = spec.GetArgument<int>("max_batch_size");
@@ -129,11 +130,24 @@ Here is a list of the available cache types:
   The warm-up time for threshold policy is 1 epoch.
 * | ``largest``: stores the largest images that can fit in the cache.
   | The warm-up time for largest policy is 2 epochs
+* | ``shared``: like ``threshold``, but the cache is placed in host shared memory named
+  | ``cache_name`` and is used by all the processes on the node which open it with that name.
 
   .. note::
     To take advantage of caching, it is recommended to configure readers with `stick_to_shard=True`
     to limit the amount of unique images seen by each decoder instance in a multi node environment.
 )code",
+      std::string())
+  .AddOptionalArg("cache_name",
+      R"code(Applies **only** to the ``mixed`` backend type and the ``shared`` cache type.
+
+Name of the shared memory chunk that holds the cache. It must start with ``/`` and it is required
+for the ``shared`` cache type. All the processes which use the same name (and the same cache
+parameters) share the cache.
+
+.. warning::
+  The cached images are identified only by their file names. Decoders which produce different
+  images from the same files (e.g. a different ``output_type``) must use different names.)code",
       std::string());
 
 }  // namespace dali
@@ -14,8 +14,12 @@
 
 #include "dali/operators/decoder/cache/image_cache_factory.h"
 #include <memory>
+#include <string>
 #include "dali/operators/decoder/cache/image_cache_blob.h"
 #include "dali/operators/decoder/cache/image_cache_largest.h"
+#if SHM_WRAPPER_ENABLED
+#include "dali/operators/decoder/cache/image_cache_shared.h"
+#endif
 
 namespace dali {
 
@@ -23,9 +27,10 @@ std::shared_ptr<ImageCache> ImageCacheFactory::Get(int device_id,
                                                    const std::string& cache_policy,
                                                    std::size_t cache_size,
                                                    bool cache_debug,
-                                                   std::size_t cache_threshold) {
+                                                   std::size_t cache_threshold,
+                                                   const std::string& cache_name) {
   std::lock_guard<std::mutex> lock(mutex_);
-  const CacheParams params{cache_policy, cache_size, cache_debug, cache_threshold};
+  const CacheParams params{cache_policy, cache_size, cache_debug, cache_threshold, cache_name};
   auto &instance = caches_[device_id];
   auto cache = instance.cache.lock();
   if (!cache) {
@@ -33,6 +38,16 @@ std::shared_ptr<ImageCache> ImageCacheFactory::Get(int device_id,
       cache.reset(new ImageCacheBlob(cache_size, cache_threshold, cache_debug));
     } else if (cache_policy == "largest") {
       cache.reset(new ImageCacheLargest(cache_size, cache_debug));
+    } else if (cache_policy == "shared") {
+#if SHM_WRAPPER_ENABLED
+      // The images are identified only by their file names, so there is no safe default -
+      // decoders producing different outputs must not share a cache
+      DALI_ENFORCE(!cache_name.empty(), "`shared` cache policy requires `cache_name` to be set");
+      cache.reset(new ImageCacheShared(cache_name, cache_size, cache_threshold, cache_debug));
+#else
+      DALI_FAIL("`shared` cache policy is not supported - DALI was built without "
+                "shared memory support");
+#endif
     } else {
       DALI_FAIL("unexpected cache policy `" + cache_policy + "`");
     }
@@ -42,7 +42,8 @@ class DLL_PUBLIC ImageCacheFactory {
     const std::string& cache_policy,
     std::size_t cache_size,
     bool cache_debug = false,
-    std::size_t cache_threshold = 0);
+    std::size_t cache_threshold = 0,
+    const std::string& cache_name = "");
 
   /**
    * @brief Get the already allocated cache
@@ -65,12 +66,14 @@ class DLL_PUBLIC ImageCacheFactory {
     std::size_t cache_size;
     bool cache_debug;
     std::size_t cache_threshold;
+    std::string cache_name;
 
     inline bool operator==(const CacheParams& oth) const {
       return cache_policy == oth.cache_policy
           && cache_size == oth.cache_size
           && cache_debug == oth.cache_debug
-          && cache_threshold == oth.cache_threshold;
+          && cache_threshold == oth.cache_threshold
+          && cache_name == oth.cache_name;
     }
   };
 
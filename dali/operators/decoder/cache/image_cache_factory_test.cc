@@ -112,5 +112,11 @@ TEST_F(ImageCacheFactoryTest, GetAndRefCount) {
   auto cache03 = factory.Get(0, "threshold", 2*1024*1024, true, 1024);
 }
 
+TEST_F(ImageCacheFactoryTest, SharedRequiresName) {
+  auto &factory = ImageCacheFactory::Instance();
+  EXPECT_THROW(factory.Get(0, "shared", 1*1024*1024, false, 0), std::runtime_error);
+  EXPECT_FALSE(factory.IsInitialized(0));
+}
+
 }  // namespace testing
 }  // namespace dali
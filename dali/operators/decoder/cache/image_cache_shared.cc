@@ -0,0 +1,351 @@
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/operators/decoder/cache/image_cache_shared.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <new>
+#include "dali/core/error_handling.h"
+#include "dali/core/format.h"
+#include "dali/core/util.h"
+#include "dali/pipeline/data/backend.h"
+
+namespace dali {
+
+namespace {
+
+constexpr std::size_t kSlotsAlignment = 64;
+constexpr std::size_t kDataAlignment = 4096;
+// The hash table is sized so that it's at most half full when the average image is this big
+constexpr std::size_t kMinAvgImageSize = 32 << 10;
+constexpr uint64_t kMinSlots = 1024;
+// How many times to reopen the chunk if it's removed by its last user while we attach
+constexpr int kMaxAttachAttempts = 16;
+
+// Bytes of the shared memory file locked with open file description locks. Unlike the classic
+// POSIX record locks, these are not shared by the instances within a process, and the kernel
+// releases them when a process exits or crashes - so a cache left by a dead process is
+// recognized as unused.
+constexpr off_t kInitLockByte = 0;      // held exclusively while attaching or detaching
+constexpr off_t kAttachedLockByte = 1;  // held (shared) by every attached instance
+
+/**
+ * @brief Sets a lock of `type` (F_RDLCK, F_WRLCK or F_UNLCK) on a byte of the file
+ *
+ * @return false if `wait` is false and the lock is held by someone else
+ */
+bool LockByte(int fd, off_t byte, short type, bool wait) {  // NOLINT(runtime/int)
+  struct flock fl = {};
+  fl.l_type = type;
+  fl.l_whence = SEEK_SET;
+  fl.l_start = byte;
+  fl.l_len = 1;
+  int ret;
+  while ((ret = fcntl(fd, wait ? F_OFD_SETLKW : F_OFD_SETLK, &fl)) == -1 && errno == EINTR) {}
+  if (ret == -1 && !wait && (errno == EAGAIN || errno == EACCES))
+    return false;
+  POSIX_CHECK_STATUS_EX(ret, "fcntl", "Cannot lock the shared image cache.");
+  return true;
+}
+
+/**
+ * @brief Checks if the name still refers to the chunk open as `fd`
+ */
+bool IsLinked(int fd, const std::string &name) {
+  int named_fd = shm_open(name.c_str(), O_RDONLY, 0);
+  if (named_fd == -1)
+    return false;
+  struct stat st, named_st;
+  bool same = fstat(fd, &st) == 0 && fstat(named_fd, &named_st) == 0 &&
+              st.st_dev == named_st.st_dev && st.st_ino == named_st.st_ino;
+  close(named_fd);
+  return same;
+}
+
+}  // namespace
+
+uint64_t ImageCacheShared::NumSlots(std::size_t cache_size) {
+  uint64_t n = kMinSlots;
+  while (n < 2 * cache_size / kMinAvgImageSize)
+    n <<= 1;
+  return n;
+}
+
+std::size_t ImageCacheShared::TotalSize(std::size_t cache_size) {
+  std::size_t slots_offset = align_up(sizeof(Header), kSlotsAlignment);
+  std::size_t data_offset = align_up(slots_offset + NumSlots(cache_size) * sizeof(Slot),
+                                     kDataAlignment);
+  return data_offset + cache_size;
+}
+
+uint64_t ImageCacheShared::KeyHash(const ImageKey &key) {
+  // FNV-1a - the hash must be identical in all processes, so std::hash is not an option
+  uint64_t h = 0xcbf29ce484222325ULL;
+  for (unsigned char c : key) {
+    h ^= c;
+    h *= 0x100000001b3ULL;
+  }
+  return h ? h : 1;  // 0 is reserved for empty slots
+}
+
+ImageCacheShared::ImageCacheShared(const std::string &name,
+                                   std::size_t cache_size,
+                                   std::size_t image_size_threshold,
+                                   bool stats_enabled)
+    : name_(name)
+    , cache_size_(cache_size)
+    , image_size_threshold_(image_size_threshold)
+    , stats_enabled_(stats_enabled) {
+  static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t),
+                "Atomics placed in shared memory must not contain locks");
+  DALI_ENFORCE(image_size_threshold <= cache_size_, "Cache size should fit at least one image");
+
+  const std::size_t total_size = TotalSize(cache_size_);
+  const uint64_t num_slots = NumSlots(cache_size_);
+  const std::size_t slots_offset = align_up(sizeof(Header), kSlotsAlignment);
+  const std::size_t data_offset = total_size - cache_size_;
+
+  // The chunk is attached and detached under an exclusive lock, so that its last user
+  // can remove it and a new user can (re)initialize it without racing with the others
+  for (int attempt = 0;; attempt++) {
+    shm_handle_ = ShmHandle::OpenNamed(name_, true);
+    LockByte(shm_handle_, kInitLockByte, F_WRLCK, true);
+    if (IsLinked(shm_handle_, name_))
+      break;
+    // the last user removed the chunk in the meantime - start over with a new one
+    DALI_ENFORCE(attempt < kMaxAttachAttempts, make_string(
+      "Cannot attach to shared image cache \"", name_, "\"."));
+  }
+
+  // If nobody else is attached, the chunk is either new or left over by processes that are
+  // gone (e.g. crashed) - in both cases it's (re)initialized.
+  const bool in_use = !LockByte(shm_handle_, kAttachedLockByte, F_WRLCK, false);
+  if (!in_use) {
+    // truncating to 0 first discards stale contents - resizing zero-fills the memory
+    POSIX_CALL_EX(ftruncate(shm_handle_, 0), "Failed to resize shared memory.");
+    POSIX_CALL_EX(ftruncate(shm_handle_, total_size), "Failed to resize shared memory.");
+  } else {
+    struct stat st;
+    POSIX_CALL(fstat(shm_handle_, &st));
+    DALI_ENFORCE(static_cast<std::size_t>(st.st_size) == total_size, make_string(
+      "Shared image cache \"", name_, "\" already exists with a different size. Expected ",
+      total_size, " bytes, got ", st.st_size, "."));
+  }
+  mapping_ = MemoryMapping(shm_handle_, total_size);
+  uint8_t *base = mapping_.get_raw_ptr();
+  header_ = reinterpret_cast<Header *>(base);
+  slots_ = reinterpret_cast<Slot *>(base + slots_offset);
+  data_ = base + data_offset;
+
+  if (!in_use) {
+    header_->magic = kMagic;
+    header_->num_slots = num_slots;
+    header_->data_offset = data_offset;
+    header_->data_size = cache_size_;
+    header_->data_tail.store(0, std::memory_order_relaxed);
+  } else {
+    DALI_ENFORCE(header_->magic == kMagic && header_->num_slots == num_slots &&
+                 header_->data_offset == data_offset && header_->data_size == cache_size_,
+                 make_string("Shared memory \"", name_,
+                             "\" doesn't contain a compatible image cache."));
+  }
+  // Downgrades our exclusive lock, if any - nobody can take it in the meantime,
+  // as we still hold the init lock
+  LockByte(shm_handle_, kAttachedLockByte, F_RDLCK, true);
+  LockByte(shm_handle_, kInitLockByte, F_UNLCK, true);
+
+  // Registering the memory makes host<->device copies faster and allows the device to access
+  // the cached images directly. If it fails, the cache still works, just slower.
+  host_registered_ = cudaHostRegister(base, total_size,
+      cudaHostRegisterPortable | cudaHostRegisterMapped) == cudaSuccess;
+  if (!host_registered_) {
+    (void)cudaGetLastError();
+    LOG_LINE << "WARNING: cannot register shared image cache memory" << std::endl;
+  }
+
+  LOG_LINE << "shared cache \"" << name_ << "\" size is " << cache_size_ / (1024 * 1024)
+           << " MB, " << num_slots << " slots" << std::endl;
+
+  CUDA_CALL(cudaStreamCreateWithPriority(&cache_stream_, cudaStreamNonBlocking, 0));
+  CUDA_CALL(cudaEventCreate(&cache_write_event_));
+}
+
+ImageCacheShared::~ImageCacheShared() {
+  CUDA_CALL(cudaStreamSynchronize(cache_stream_));
+  CUDA_CALL(cudaEventDestroy(cache_write_event_));
+  CUDA_CALL(cudaStreamDestroy(cache_stream_));
+  if (host_registered_)
+    CUDA_CALL(cudaHostUnregister(mapping_.get_raw_ptr()));
+
+  if (stats_enabled_) print_stats();
+
+  // The last user removes the name; the memory itself is released by the OS when it's
+  // no longer mapped anywhere. The locks are released when the handle is closed.
+  LockByte(shm_handle_, kInitLockByte, F_WRLCK, true);
+  if (LockByte(shm_handle_, kAttachedLockByte, F_WRLCK, false))
+    ShmHandle::UnlinkNamed(name_);
+}
+
+bool ImageCacheShared::KeyMatches(const Slot &slot, const ImageKey &key) const {
+  return slot.key_size == key.size() &&
+         !std::memcmp(data_ + slot.offset, key.data(), key.size());
+}
+
+const ImageCacheShared::Slot *ImageCacheShared::Find(const ImageKey &key) const {
+  const uint64_t h = KeyHash(key);
+  const uint64_t mask = header_->num_slots - 1;
+  for (uint64_t i = 0, idx = h & mask; i <= mask; i++, idx = (idx + 1) & mask) {
+    const Slot &slot = slots_[idx];
+    uint64_t slot_hash = slot.hash.load(std::memory_order_acquire);
+    if (slot_hash == 0)
+      return nullptr;
+    if (slot_hash == h && slot.state.load(std::memory_order_acquire) == kReady &&
+        KeyMatches(slot, key))
+      return &slot;
+  }
+  return nullptr;
+}
+
+bool ImageCacheShared::IsCached(const ImageKey& image_key) const {
+  return Find(image_key) != nullptr;
+}
+
+const ImageCache::ImageShape& ImageCacheShared::GetShape(const ImageKey& image_key) const {
+  const Slot *slot = Find(image_key);
+  DALI_ENFORCE(slot != nullptr, "cache entry [" + image_key + "] not found");
+  return slot->shape;
+}
+
+bool ImageCacheShared::Read(const ImageKey& image_key,
+                            void* destination_buffer,
+                            cudaStream_t stream) const {
+  DALI_ENFORCE(!image_key.empty());
+  DALI_ENFORCE(destination_buffer != nullptr);
+  LOG_LINE << "Read: image_key[" << image_key << "]" << std::endl;
+  const Slot *slot = Find(image_key);
+  if (!slot) {
+    if (stats_enabled_) misses_++;
+    return false;
+  }
+  // Entries are published only after the data is complete - no need to synchronize
+  MemCopy(destination_buffer, ImageData(*slot), volume(slot->shape), stream);
+  if (stats_enabled_) hits_++;
+  return true;
+}
+
+ImageCache::DecodedImage ImageCacheShared::Get(const ImageKey& image_key) const {
+  DALI_ENFORCE(!image_key.empty());
+  LOG_LINE << "Get: image_key[" << image_key << "]" << std::endl;
+  // Without registration, the memory is not accessible from the device
+  const Slot *slot = host_registered_ ? Find(image_key) : nullptr;
+  if (!slot) {
+    if (stats_enabled_) misses_++;
+    return {};
+  }
+  if (stats_enabled_) hits_++;
+  return { ImageData(*slot), slot->shape };
+}
+
+void ImageCacheShared::Add(const ImageKey& image_key, const uint8_t* data,
+                           const ImageShape& data_shape, cudaStream_t stream) {
+  const std::size_t data_size = volume(data_shape);
+  if (data_size < image_size_threshold_) return;
+  DALI_ENFORCE(!image_key.empty());
+
+  const uint64_t h = KeyHash(image_key);
+  const uint64_t mask = header_->num_slots - 1;
+  Slot *slot = nullptr;
+  for (uint64_t i = 0, idx = h & mask; i <= mask; i++, idx = (idx + 1) & mask) {
+    Slot &s = slots_[idx];
+    uint64_t slot_hash = s.hash.load(std::memory_order_acquire);
+    if (slot_hash == 0 &&
+        s.hash.compare_exchange_strong(slot_hash, h, std::memory_order_acq_rel)) {
+      s.state.store(kWriting, std::memory_order_relaxed);
+      slot = &s;
+      break;
+    }
+    if (slot_hash == h) {
+      uint32_t state = s.state.load(std::memory_order_acquire);
+      if (state == kReady && KeyMatches(s, image_key))
+        return;  // already added by this or another process
+      if (state != kReady && state != kAbandoned)
+        return;  // most likely the same image is being added by another process
+    }
+  }
+  if (!slot) {
+    LOG_LINE << "WARNING: no free slots in cache. Ignore" << std::endl;
+    if (stats_enabled_) rejected_++;
+    return;
+  }
+
+  const std::size_t entry_size = image_key.size() + data_size;
+  uint64_t offset = header_->data_tail.load(std::memory_order_relaxed);
+  do {
+    if (offset + entry_size > header_->data_size) {
+      LOG_LINE << "WARNING: not enough space in cache. Ignore" << std::endl;
+      slot->state.store(kAbandoned, std::memory_order_release);
+      if (stats_enabled_) rejected_++;
+      return;
+    }
+  } while (!header_->data_tail.compare_exchange_weak(offset, offset + entry_size,
+                                                      std::memory_order_relaxed));
+
+  std::memcpy(data_ + offset, image_key.data(), image_key.size());
+  slot->key_size = image_key.size();
+  slot->offset = offset;
+  new (&slot->shape) ImageShape(data_shape);
+
+  CUDA_CALL(cudaEventRecord(cache_write_event_, stream));
+  CUDA_CALL(cudaStreamWaitEvent(cache_stream_, cache_write_event_, 0));
+  MemCopy(ImageData(*slot), data, data_size, cache_stream_);
+  // Other processes can't synchronize with our streams - the data must be in place
+  // before the entry is published.
+  CUDA_CALL(cudaStreamSynchronize(cache_stream_));
+
+  slot->state.store(kReady, std::memory_order_release);
+  if (stats_enabled_) adds_++;
+}
+
+void ImageCacheShared::SyncToRead(cudaStream_t) const {
+  // Entries become visible only after their data is written - nothing to wait for
+}
+
+void ImageCacheShared::print_stats() const {
+  static std::mutex stats_mutex;
+  std::lock_guard<std::mutex> lock(stats_mutex);
+  const char* log_filename = std::getenv("DALI_LOG_FILE");
+  std::ofstream log_file;
+  if (log_filename) log_file.open(log_filename);
+  std::ostream& out = log_filename ? log_file : std::cout;
+  out << "################# SHARED CACHE STATS #################" << std::endl;
+  out << "cache_name: " << name_ << std::endl;
+  out << "cache_size: " << cache_size_ << std::endl;
+  out << "cache_threshold: " << image_size_threshold_ << std::endl;
+  out << "bytes_used: " << header_->data_tail.load() << std::endl;
+  out << "images_added: " << adds_ << std::endl;
+  out << "images_rejected: " << rejected_ << std::endl;
+  out << "hits: " << hits_ << std::endl;
+  out << "misses: " << misses_ << std::endl;
+  out << "#################### END   STATS ####################" << std::endl;
+}
+
+}  // namespace dali
@@ -0,0 +1,145 @@
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_OPERATORS_DECODER_CACHE_IMAGE_CACHE_SHARED_H_
+#define DALI_OPERATORS_DECODER_CACHE_IMAGE_CACHE_SHARED_H_
+
+#include <atomic>
+#include <string>
+#include "dali/core/common.h"
+#include "dali/core/os/shared_mem.h"
+#include "dali/operators/decoder/cache/image_cache.h"
+
+namespace dali {
+
+/**
+ * @brief Image cache placed in a named host shared memory chunk
+ *
+ * All the processes on a node that open the cache with the same name see the same
+ * contents, so an image decoded by one of them doesn't have to be decoded by the others.
+ *
+ * The cache consists of a header, an open-addressing hash table and a data arena.
+ * Entries are only ever added (never evicted), which allows lock-free lookups:
+ * a slot is claimed with a CAS on its hash, filled and then published by setting
+ * its state to `kReady` with release semantics.
+ *
+ * The attached instances hold a lock on the chunk, which the kernel releases when a process
+ * dies; the last instance to detach removes the chunk and a chunk with no live users
+ * (e.g. left by crashed processes) is reinitialized by the next one to attach.
+ *
+ * The memory is registered with CUDA, so the cached images can be accessed directly from
+ * the device (e.g. by the batched copy kernel used for deferred loads).
+ */
+class DLL_PUBLIC ImageCacheShared : public ImageCache {
+ public:
+  /**
+   * @param name            name of the shared memory chunk; must start with '/'
+   * @param cache_size      size of the data arena, in bytes
+   * @param image_size_threshold  images smaller than this are not cached
+   * @param stats_enabled   if true, the number of hits/misses is printed at exit
+   */
+  DLL_PUBLIC ImageCacheShared(const std::string &name,
+                              std::size_t cache_size,
+                              std::size_t image_size_threshold,
+                              bool stats_enabled = false);
+
+  ~ImageCacheShared() override;
+
+  DISABLE_COPY_MOVE_ASSIGN(ImageCacheShared);
+
+  bool IsCached(const ImageKey& image_key) const override;
+
+  bool Read(const ImageKey& image_key,
+            void* destination_data,
+            cudaStream_t stream) const override;
+
+  const ImageShape& GetShape(const ImageKey& image_key) const override;
+
+  void Add(const ImageKey& image_key,
+           const uint8_t *data,
+           const ImageShape& data_shape,
+           cudaStream_t stream) override;
+
+  DecodedImage Get(const ImageKey &image_key) const override;
+
+  void SyncToRead(cudaStream_t stream) const override;
+
+  /**
+   * @brief Size of the shared memory chunk needed for a cache with given arena size
+   */
+  static std::size_t TotalSize(std::size_t cache_size);
+
+ private:
+  enum SlotState : uint32_t {
+    kEmpty = 0,
+    kWriting = 1,
+    kReady = 2,
+    kAbandoned = 3,  // the slot was claimed, but the data didn't fit in the arena
+  };
+
+  struct Header {
+    uint64_t magic;
+    uint64_t num_slots;
+    uint64_t data_offset;
+    uint64_t data_size;
+    std::atomic<uint64_t> data_tail;
+  };
+
+  struct Slot {
+    std::atomic<uint64_t> hash;    // 0 denotes an empty slot
+    std::atomic<uint32_t> state;
+    uint32_t key_size;
+    uint64_t offset;               // offset, in the data arena, of the key followed by the image
+    ImageShape shape;
+  };
+
+  static constexpr uint64_t kMagic = 0x44414c4943414348ULL;  // "DALICACH"
+
+  static uint64_t NumSlots(std::size_t cache_size);
+  static uint64_t KeyHash(const ImageKey &key);
+
+  /**
+   * @brief Finds a published slot for the key; returns nullptr if not found
+   */
+  const Slot *Find(const ImageKey &key) const;
+
+  bool KeyMatches(const Slot &slot, const ImageKey &key) const;
+
+  uint8_t *ImageData(const Slot &slot) const {
+    return data_ + slot.offset + slot.key_size;
+  }
+
+  void print_stats() const;
+
+  std::string name_;
+  std::size_t cache_size_ = 0;
+  std::size_t image_size_threshold_ = 0;
+  bool stats_enabled_ = false;
+
+  ShmHandle shm_handle_;
+  MemoryMapping mapping_;
+  Header *header_ = nullptr;
+  Slot *slots_ = nullptr;
+  uint8_t *data_ = nullptr;
+  bool host_registered_ = false;
+
+  mutable std::atomic<uint64_t> hits_{0}, misses_{0}, adds_{0}, rejected_{0};
+
+  cudaStream_t cache_stream_;
+  cudaEvent_t cache_write_event_;
+};
+
+}  // namespace dali
+
+#endif  // DALI_OPERATORS_DECODER_CACHE_IMAGE_CACHE_SHARED_H_
@@ -0,0 +1,143 @@
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/operators/decoder/cache/image_cache_shared.h"
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace dali {
+namespace testing {
+
+namespace {
+
+const char kKey1[] = "file1.jpg";
+const std::vector<uint8_t> kValue1(300, 0xAA);
+const ImageCache::ImageShape kShape1{100, 1, 3};
+
+const char kKey2[] = "file2.jpg";
+const std::vector<uint8_t> kValue2(300, 0xBB);
+const ImageCache::ImageShape kShape2{1, 100, 3};
+
+std::string TestCacheName() {
+  return "/dali_image_cache_shared_test_" + std::to_string(getpid());
+}
+
+}  // namespace
+
+struct ImageCacheSharedTest : public ::testing::Test {
+  void SetUp() override { SetUpImpl(1 << 10); }
+
+  void SetUpImpl(std::size_t cache_size, std::size_t image_size_threshold = 0) {
+    cache_.reset();
+    cache_.reset(new ImageCacheShared(TestCacheName(), cache_size, image_size_threshold));
+  }
+
+  std::unique_ptr<ImageCacheShared> cache_;
+};
+
+TEST_F(ImageCacheSharedTest, EmptyCache) {
+  EXPECT_FALSE(cache_->IsCached(kKey1));
+  std::vector<uint8_t> cached_data(kValue1.size());
+  EXPECT_FALSE(cache_->Read(kKey1, &cached_data[0], 0));
+}
+
+TEST_F(ImageCacheSharedTest, Add) {
+  cache_->Add(kKey1, &kValue1[0], kShape1, 0);
+  EXPECT_TRUE(cache_->IsCached(kKey1));
+  EXPECT_FALSE(cache_->IsCached(kKey2));
+  EXPECT_EQ(kShape1, cache_->GetShape(kKey1));
+  std::vector<uint8_t> cached_data(kValue1.size());
+  EXPECT_TRUE(cache_->Read(kKey1, &cached_data[0], 0));
+  EXPECT_EQ(kValue1, cached_data);
+}
+
+TEST_F(ImageCacheSharedTest, AddExistingIgnored) {
+  cache_->Add(kKey1, &kValue1[0], kShape1, 0);
+  cache_->Add(kKey1, &kValue2[0], kShape2, 0);
+  EXPECT_EQ(kShape1, cache_->GetShape(kKey1));
+  std::vector<uint8_t> cached_data(kValue1.size());
+  EXPECT_TRUE(cache_->Read(kKey1, &cached_data[0], 0));
+  EXPECT_EQ(kValue1, cached_data);
+}
+
+TEST_F(ImageCacheSharedTest, CacheFull) {
+  SetUpImpl(kValue1.size() + sizeof(kKey1));
+  cache_->Add(kKey1, &kValue1[0], kShape1, 0);
+  cache_->Add(kKey2, &kValue2[0], kShape2, 0);
+  EXPECT_TRUE(cache_->IsCached(kKey1));
+  EXPECT_FALSE(cache_->IsCached(kKey2));
+}
+
+TEST_F(ImageCacheSharedTest, Threshold) {
+  SetUpImpl(1 << 10, kValue1.size() + 1);
+  cache_->Add(kKey1, &kValue1[0], kShape1, 0);
+  EXPECT_FALSE(cache_->IsCached(kKey1));
+}
+
+TEST_F(ImageCacheSharedTest, SharedBetweenInstances) {
+  ImageCacheShared other(TestCacheName(), 1 << 10, 0);
+  cache_->Add(kKey1, &kValue1[0], kShape1, 0);
+  other.Add(kKey2, &kValue2[0], kShape2, 0);
+
+  std::vector<uint8_t> cached_data(kValue1.size());
+  EXPECT_TRUE(other.Read(kKey1, &cached_data[0], 0));
+  EXPECT_EQ(kValue1, cached_data);
+  EXPECT_TRUE(cache_->Read(kKey2, &cached_data[0], 0));
+  EXPECT_EQ(kValue2, cached_data);
+}
+
+TEST_F(ImageCacheSharedTest, IncompatibleParams) {
+  EXPECT_THROW(ImageCacheShared(TestCacheName(), 1 << 20, 0), std::runtime_error);
+}
+
+TEST_F(ImageCacheSharedTest, RemovedWithLastInstance) {
+  cache_->Add(kKey1, &kValue1[0], kShape1, 0);
+  SetUpImpl(1 << 10);
+  EXPECT_FALSE(cache_->IsCached(kKey1));
+}
+
+TEST_F(ImageCacheSharedTest, StaleChunkReinitialized) {
+  cache_.reset();
+  {
+    // a chunk left over by a crashed process - it has unrelated contents and nobody holds
+    // its locks anymore
+    auto handle = ShmHandle::OpenNamed(TestCacheName(), true);
+    ASSERT_EQ(ftruncate(handle, 4096), 0);
+    MemoryMapping mapping(handle, 4096);
+    memset(mapping.get_raw_ptr(), 0x5A, 4096);
+  }
+  SetUpImpl(1 << 10);
+  EXPECT_FALSE(cache_->IsCached(kKey1));
+  cache_->Add(kKey1, &kValue1[0], kShape1, 0);
+  std::vector<uint8_t> cached_data(kValue1.size());
+  EXPECT_TRUE(cache_->Read(kKey1, &cached_data[0], 0));
+  EXPECT_EQ(kValue1, cached_data);
+}
+
+TEST_F(ImageCacheSharedTest, NotReinitializedWhileInUse) {
+  cache_->Add(kKey1, &kValue1[0], kShape1, 0);
+  {
+    ImageCacheShared other(TestCacheName(), 1 << 10, 0);
+  }
+  // the chunk is still used by `cache_` - neither removed nor reinitialized
+  ImageCacheShared other(TestCacheName(), 1 << 10, 0);
+  EXPECT_TRUE(other.IsCached(kKey1));
+}
+
+}  // namespace testing
+}  // namespace dali
@@ -13,24 +13,85 @@
 // limitations under the License.
 
 
+#include <cstring>
+#include <type_traits>
+#include "dali/core/convert.h"
 #include "dali/core/static_switch.h"
+#include "dali/kernels/common/simd.h"
 #include "dali/operators/generic/cast.h"
+#include "dali/pipeline/data/views.h"
+#include "dali/pipeline/util/sample_blocks.h"
 
 namespace dali {
 
-template<>
-void Cast<CPUBackend>::RunImpl(SampleWorkspace &ws) {
-  auto &input = ws.Input<CPUBackend>(0);
-  auto &output = ws.Output<CPUBackend>(0);
+namespace {
 
-  DALIDataType itype = input.type().id();
+template <typename OType, typename IType>
+void CastBlock(OType *out, const IType *in, int64_t n, std::false_type) {
+  for (int64_t i = 0; i < n; i++)
+    out[i] = ConvertSat<OType>(in[i]);
+}
+
+#ifdef __SSE2__
+
+/**
+ * @brief Output types for which the conversion from float is vectorized explicitly
+ *
+ * Rounding with std::round (as in ConvertSat) prevents the compiler from vectorizing the loop.
+ * Other conversions are simple enough to be vectorized by the compiler.
+ */
+template <typename T>
+struct is_simd_cast_type
+    : std::integral_constant<bool, std::is_same<T, uint8_t>::value ||
+                                   std::is_same<T, int8_t>::value ||
+                                   std::is_same<T, uint16_t>::value ||
+                                   std::is_same<T, int16_t>::value> {};
+
+template <typename OType, typename IType>
+void CastBlock(OType *out, const IType *in, int64_t n, std::true_type) {
+  int64_t i = 0;
+  for (; i + 16 <= n; i += 16)
+    kernels::simd::store16(out + i, kernels::simd::load16(in + i));
+  CastBlock(out + i, in + i, n - i, std::false_type());
+}
+
+#else
 
+template <typename T>
+struct is_simd_cast_type : std::false_type {};
+
+#endif  // __SSE2__
+
+template <typename OType, typename IType>
+void CastBlock(OType *out, const IType *in, int64_t n) {
+  if (std::is_same<OType, IType>::value) {
+    std::memcpy(out, in, n * sizeof(OType));
+    return;
+  }
+  using simd = std::integral_constant<bool, is_simd_cast_type<OType>::value &&
+                                            std::is_same<IType, float>::value>;
+  CastBlock(out, in, n, simd());
+}
+
+}  // namespace
+
+template <>
+void Cast<CPUBackend>::RunImpl(HostWorkspace &ws) {
+  const auto &input = ws.InputRef<CPUBackend>(0);
+  auto &output = ws.OutputRef<CPUBackend>(0);
+  output.SetLayout(input.GetLayout());
+  auto &tp = ws.GetThreadPool();
+
+  DALIDataType itype = input.type().id();
   TYPE_SWITCH(output_type_, type2id, OType, CAST_ALLOWED_TYPES, (
-    output.SetLayout(input.GetLayout());
-    output.mutable_data<OType>();
-    output.ResizeLike(input);
     TYPE_SWITCH(itype, type2id, IType, CAST_ALLOWED_TYPES, (
-      CPUHelper<OType, IType>(output.mutable_data<OType>(), input.data<IType>(), input.size());
+      auto in_view = view<const IType>(input);
+      auto out_view = view<OType>(output);
+      auto cast_block = [&](int sample_idx, int64_t start, int64_t n) {
+        CastBlock(out_view.data[sample_idx] + start, in_view.data[sample_idx] + start, n);
+      };
+      AddSampleBlocksWork(tp, in_view.shape, cast_block);
+      tp.RunAll();
     ), DALI_FAIL(make_string("Invalid input type: ", itype)););  // NOLINT(whitespace/parens)
   ), DALI_FAIL(make_string("Invalid output type", output_type_)););  // NOLINT(whitespace/parens)
 }
@@ -40,20 +40,21 @@ class Cast : public Operator<Backend> {
   DISABLE_COPY_MOVE_ASSIGN(Cast);
 
  protected:
+  bool CanInferOutputs() const override {
+    return true;
+  }
+
   bool SetupImpl(std::vector<OutputDesc> &output_desc, const workspace_t<Backend> &ws) override {
-    return false;
+    const auto &input = ws.template InputRef<Backend>(0);
+    output_desc.resize(1);
+    output_desc[0].shape = input.shape();
+    output_desc[0].type = TypeTable::GetTypeInfo(output_type_);
+    return true;
   }
 
-  void RunImpl(Workspace<Backend> &ws) override;
+  void RunImpl(workspace_t<Backend> &ws) override;
 
  private:
-  template <typename OType, typename IType>
-  inline void CPUHelper(OType *out, const IType *in, size_t N) {
-    for (size_t i = 0; i < N; ++i) {
-      out[i] = ConvertSat<OType>(in[i]);
-    }
-  }
-
   DALIDataType output_type_;
 
   USE_OPERATOR_MEMBERS();
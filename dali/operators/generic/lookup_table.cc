@@ -13,36 +13,45 @@
 // limitations under the License.
 
 #include "dali/operators/generic/lookup_table.h"
+#include "dali/pipeline/data/views.h"
+#include "dali/pipeline/util/sample_blocks.h"
 
 namespace dali {
 
+namespace {
+
+template <typename OutputType, typename InputType>
+void LookupValues(OutputType *out, const InputType *in, int64_t n, const OutputType *lut) {
+  constexpr auto kMaxKey = LookupTable<CPUBackend>::kMaxKey;
+  constexpr auto kDefaultValueIdx = LookupTable<CPUBackend>::kDefaultValueIdx;
+  // The keys are sign-extended to 64 bits first, so that the negative keys of any width become
+  // values larger than any valid key. All keys out of range are mapped to the default value
+  // entry, so there's no branch in the loop.
+  for (int64_t i = 0; i < n; i++) {
+    uint64_t key = static_cast<uint64_t>(static_cast<int64_t>(in[i]));
+    out[i] = lut[key <= kMaxKey ? key : kDefaultValueIdx];
+  }
+}
+
+}  // namespace
+
 template<>
-void LookupTable<CPUBackend>::RunImpl(SampleWorkspace &ws) {
-  const auto &input = ws.Input<CPUBackend>(0);
-  auto &output = ws.Output<CPUBackend>(0);
+void LookupTable<CPUBackend>::RunImpl(HostWorkspace &ws) {
+  const auto &input = ws.InputRef<CPUBackend>(0);
+  auto &output = ws.OutputRef<CPUBackend>(0);
   output.SetLayout(input.GetLayout());
-  auto data_size = input.size();
+  auto &tp = ws.GetThreadPool();
   TYPE_SWITCH(input.type().id(), dali::type2id, InputType, LUT_IN_TYPES, (
     TYPE_SWITCH(output_type_, dali::type2id, OutputType, LUT_OUT_TYPES, (
-      // We do not check the key range when the type range is smaller than the supported range
-      constexpr bool check_range =
-          !std::is_same<InputType, uint8_t>::value
-       && !std::is_same<InputType, uint16_t>::value;
-      constexpr auto max_key = ConvertSat<InputType>(kMaxKey);
-
-      auto *out_data = output.mutable_data<OutputType>();
-      const auto *in_data = input.data<InputType>();
-      OutputType default_value = ConvertSat<OutputType>(default_value_f_);
-      OutputType* lookup_table = static_cast<OutputType*>(value_mem_.get());
-      for (int i = 0; i < data_size; i++) {
-        InputType key = in_data[i];
-        if (check_range) {
-          out_data[i] = (std::is_unsigned<InputType>::value || key >= 0) && key <= max_key ?
-            lookup_table[key] : default_value;
-        } else {
-          out_data[i] = lookup_table[key];
-        }
-      }
+      auto in_view = view<const InputType>(input);
+      auto out_view = view<OutputType>(output);
+      const OutputType *lookup_table = static_cast<const OutputType*>(value_mem_.get());
+      auto lookup_block = [&](int sample_idx, int64_t start, int64_t n) {
+        LookupValues(out_view.data[sample_idx] + start, in_view.data[sample_idx] + start, n,
+                     lookup_table);
+      };
+      AddSampleBlocksWork(tp, in_view.shape, lookup_block);
+      tp.RunAll();
     ), DALI_FAIL(make_string("Unsupported output type: ", output_type_)); );       // NOLINT
   ), DALI_FAIL(make_string("Unsupported input type: ", input.type().id())); );     // NOLINT
 }
@@ -46,6 +46,8 @@ class LookupTable : public Operator<Backend> {
  public:
   static constexpr size_t kLookupTableSize = 0x10000;
   static constexpr size_t kMaxKey = kLookupTableSize - 1;
+  // an extra entry past the end of the table holds the default value
+  static constexpr size_t kDefaultValueIdx = kLookupTableSize;
 
   explicit inline LookupTable(const OpSpec &spec)
     : Operator<Backend>(spec)
@@ -69,9 +71,10 @@ class LookupTable : public Operator<Backend> {
       "`keys` size should match `values` size");
 
     TYPE_SWITCH(output_type_, dali::type2id, OutputType, LUT_OUT_TYPES, (
-        value_mem_ = {new OutputType[kLookupTableSize], detail::value_mem_deleter<OutputType>};
+        value_mem_ = {new OutputType[kLookupTableSize + 1],
+                      detail::value_mem_deleter<OutputType>};
         OutputType *values = static_cast<OutputType*>(value_mem_.get());
-        for (size_t i = 0; i < kLookupTableSize; i++) {
+        for (size_t i = 0; i <= kDefaultValueIdx; i++) {
           values[i] = ConvertSat<OutputType>(default_value_f_);
         }
         auto keys_size = keys.size();
@@ -95,7 +98,7 @@ class LookupTable : public Operator<Backend> {
     output_desc[0].shape = input.shape();
     return true;
   }
-  void RunImpl(Workspace<Backend> &ws) override;
+  void RunImpl(workspace_t<Backend> &ws) override;
 
  private:
   DALIDataType input_type_, output_type_;
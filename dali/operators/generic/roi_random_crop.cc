@@ -65,6 +65,7 @@ bounds of the input.
   Providing ``in_shape`` is incompatible with feeding the input data directly as a positional input.
 )code", nullptr, true)
     .NumInput(0, 1)
+    .Random()
     .NumOutput(1);
 
 class ROIRandomCropCPU : public Operator<CPUBackend> {
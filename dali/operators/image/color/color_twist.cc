@@ -200,6 +200,7 @@ void ColorTwistCpu::RunImpl(workspace_t<CPUBackend> &ws) {
   const auto &input = ws.template InputRef<CPUBackend>(0);
   auto &output = ws.template OutputRef<CPUBackend>(0);
   auto out_shape = output.shape();
+  int64_t total_volume = out_shape.num_elements();
   output.SetLayout(input.GetLayout());
   auto &tp = ws.GetThreadPool();
   TYPE_SWITCH(input.type().id(), type2id, InputType, (uint8_t, int16_t, int32_t, float, float16), (
@@ -207,13 +208,23 @@ void ColorTwistCpu::RunImpl(workspace_t<CPUBackend> &ws) {
           {
               using Kernel = TheKernel<OutputType, InputType>;
               for (int i = 0; i < input.shape().num_samples(); i++) {
-                tp.AddWork([&, i](int thread_id) {
-                  kernels::KernelContext ctx;
-                  auto tvin = view<const InputType, 3>(input[i]);
-                  auto tvout = view<OutputType, 3>(output[i]);
-                  kernel_manager_.Run<Kernel>(ws.thread_idx(), i, ctx, tvout, tvin,
-                                              tmatrices_[i], toffsets_[i]);
-                }, out_shape.tensor_size(i));
+                int64_t rows = out_shape.tensor_shape_span(i)[0];
+                int bands = NumBands(out_shape.tensor_size(i), total_volume, tp.NumThreads(), rows);
+                for (int band = 0; band < bands; band++) {
+                  int row_begin = rows * band / bands;
+                  int row_end = rows * (band + 1) / bands;
+                  tp.AddWork([&, i, row_begin, row_end](int thread_id) {
+                    kernels::KernelContext ctx;
+                    auto tvin = view<const InputType, 3>(input[i]);
+                    auto tvout = view<OutputType, 3>(output[i]);
+                    int width = tvin.shape[1];
+                    kernels::Roi<2> roi = {{0, row_begin}, {width, row_end}};
+                    tvout.data += tvout.shape[1] * tvout.shape[2] * row_begin;
+                    tvout.shape[0] = row_end - row_begin;
+                    kernel_manager_.Run<Kernel>(thread_id, i, ctx, tvout, tvin,
+                                                tmatrices_[i], toffsets_[i], &roi);
+                  }, out_shape.tensor_size(i) / bands);
+                }
               }
           }
       ), DALI_FAIL(make_string("Unsupported output type: ", output_type_)))  // NOLINT
@@ -15,12 +15,14 @@
 #ifndef DALI_OPERATORS_IMAGE_COLOR_COLOR_TWIST_H_
 #define DALI_OPERATORS_IMAGE_COLOR_COLOR_TWIST_H_
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <vector>
 #include "dali/core/geom/mat.h"
 #include "dali/core/static_switch.h"
 #include "dali/core/tensor_shape_print.h"
+#include "dali/core/util.h"
 #include "dali/kernels/imgproc/pointwise/linear_transformation_cpu.h"
 #include "dali/kernels/kernel_manager.h"
 #include "dali/pipeline/data/views.h"
@@ -206,6 +208,21 @@ class ColorTwistCpu : public ColorTwistBase<CPUBackend> {
   void RunImpl(workspace_t<CPUBackend> &ws) override;
 
  private:
+  /**
+   * @brief Number of row bands a sample is split into.
+   *
+   * Samples that take more than a thread's share of the batch are split, so that a few
+   * large images can be processed by all the threads.
+   */
+  static int NumBands(int64_t sample_volume, int64_t total_volume, int nthreads, int64_t rows) {
+    constexpr int64_t kMinBandRows = 16;
+    if (nthreads <= 1 || sample_volume == 0)
+      return 1;
+    int64_t bands = div_ceil(sample_volume * nthreads, static_cast<uint64_t>(total_volume));
+    bands = std::min<int64_t>(bands, rows / kMinBandRows);
+    return std::max<int64_t>(bands, 1);
+  }
+
   template <typename Kernel, typename InputType>
   TensorListShape<> CallSetup(const TensorVector<CPUBackend> &input) {
     kernels::KernelContext ctx;
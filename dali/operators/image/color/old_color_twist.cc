@@ -12,7 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <array>
 #include <cmath>
+#include <cstring>
 #include <memory>
 #include <vector>
 #include "dali/pipeline/operator/operator.h"
@@ -170,14 +172,23 @@ class OldColorTwistBase : public Operator<Backend> {
   }
 
  protected:
+  bool CanInferOutputs() const override {
+    return true;
+  }
+
   bool SetupImpl(std::vector<OutputDesc> &output_desc, const workspace_t<Backend> &ws) override {
-    return false;
+    const auto &input = ws.template InputRef<Backend>(0);
+    output_desc.resize(1);
+    output_desc[0].shape = input.shape();
+    output_desc[0].type = input.type();
+    return true;
   }
 
-  void RunImpl(Workspace<Backend> &ws) override;
+  void RunImpl(workspace_t<Backend> &ws) override;
 
   std::vector<old::ColorAugment *> augments_;
   const int C_;
+  std::vector<std::array<float, nDim * nDim>> matrices_;
 
   USE_OPERATOR_MEMBERS();
   using Operator<Backend>::RunImpl;
@@ -247,36 +258,44 @@ void OldColorTwistBase<GPUBackend>::RunImpl(DeviceWorkspace &ws) {
 }
 
 template <>
-void OldColorTwistBase<CPUBackend>::RunImpl(SampleWorkspace &ws) {
-  const auto &input = ws.Input<CPUBackend>(0);
-  auto &output = ws.Output<CPUBackend>(0);
-  const auto &input_shape = input.shape();
-
-  CheckParam(input, "Color augmentation");
-
-  const auto H = input_shape[0];
-  const auto W = input_shape[1];
-  const auto C = input_shape[2];
-
-  output.ResizeLike(input);
+void OldColorTwistBase<CPUBackend>::RunImpl(HostWorkspace &ws) {
+  const auto &input = ws.InputRef<CPUBackend>(0);
+  auto &output = ws.OutputRef<CPUBackend>(0);
   output.SetLayout(input.GetLayout());
+  int nsamples = input.shape().num_samples();
 
-  auto pImgInp = input.template data<uint8>();
-  auto pImgOut = output.template mutable_data<uint8>();
-
-  if (!augments_.empty()) {
-    float matrix[nDim][nDim];
-    float *m = reinterpret_cast<float *>(matrix);
+  // The augments keep the parameters of the current sample, so the matrices are computed
+  // up front and only the transformation itself runs in the thread pool.
+  matrices_.resize(nsamples);
+  for (int i = 0; i < nsamples; i++) {
+    float *m = matrices_[i].data();
     IdentityMatrix(m);
     for (size_t j = 0; j < augments_.size(); ++j) {
-      augments_[j]->Prepare(ws.data_idx(), spec_, &ws);
+      augments_[j]->Prepare(i, spec_, &ws);
       (*augments_[j])(m);
     }
+  }
 
-    MakeColorTransformation(pImgInp, H, W, C, m, pImgOut);
-  } else {
-    memcpy(pImgOut, pImgInp, H * W * C);
+  auto &tp = ws.GetThreadPool();
+  for (int i = 0; i < nsamples; i++) {
+    tp.AddWork([&, i](int) {
+      CheckParam(input[i], "Color augmentation");
+      const auto &input_shape = input[i].shape();
+      const auto H = input_shape[0];
+      const auto W = input_shape[1];
+      const auto C = input_shape[2];
+
+      auto pImgInp = input[i].data<uint8>();
+      auto pImgOut = output[i].mutable_data<uint8>();
+
+      if (!augments_.empty()) {
+        MakeColorTransformation(pImgInp, H, W, C, matrices_[i].data(), pImgOut);
+      } else {
+        memcpy(pImgOut, pImgInp, H * W * C);
+      }
+    }, volume(input.shape()[i]));
   }
+  tp.RunAll();
 }
 
 DALI_SCHEMA(OldColorTwist)
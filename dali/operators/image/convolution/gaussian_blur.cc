@@ -15,10 +15,12 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 #include "dali/core/static_switch.h"
+#include "dali/core/util.h"
 #include "dali/kernels/imgproc/convolution/separable_convolution_cpu.h"
 #include "dali/kernels/kernel_manager.h"
 #include "dali/operators/image/convolution/gaussian_blur.h"
@@ -158,6 +160,8 @@ class GaussianBlurOpCpu : public OpImplBase<CPUBackend> {
     auto& thread_pool = ws.GetThreadPool();
 
     int nsamples = input.shape().num_samples();
+    int64_t total_volume = input.shape().num_elements();
+    int nthreads = thread_pool.NumThreads();
     for (int sample_idx = 0; sample_idx < nsamples; sample_idx++) {
       const auto& shape = input[sample_idx].shape();
       auto elem_volume = volume(shape.begin() + dim_desc_.usable_axes_start, shape.end());
@@ -168,26 +172,71 @@ class GaussianBlurOpCpu : public OpImplBase<CPUBackend> {
         seq_elements = volume(shape.begin(), shape.begin() + dim_desc_.usable_axes_start);
         stride = elem_volume;
       }
+      int64_t rows = shape[dim_desc_.usable_axes_start];
+      int bands = NumBands(elem_volume, total_volume, nthreads, rows,
+                           params_[sample_idx].window_sizes[0]);
       for (int elem_idx = 0; elem_idx < seq_elements; elem_idx++) {
-        thread_pool.AddWork(
-            [this, &input, &output, sample_idx, elem_idx, stride](int thread_id) {
-              auto gaussian_windows = windows_[sample_idx].GetWindows();
-              auto elem_shape = input[sample_idx].shape().template last<ndim>();
-              auto in_view = TensorView<StorageCPU, const In, ndim>{
-                  input[sample_idx].template data<In>() + stride * elem_idx, elem_shape};
-              auto out_view = TensorView<StorageCPU, Out, ndim>{
-                  output[sample_idx].template mutable_data<Out>() + stride * elem_idx, elem_shape};
-              // I need a context for that particular run (or rather matching the thread &
-              // scratchpad)
-              auto ctx = ctx_;
-              kmgr_.Run<Kernel>(thread_id, sample_idx, ctx, out_view, in_view, gaussian_windows);
-            }, elem_volume);
+        for (int band = 0; band < bands; band++) {
+          int64_t row_begin = rows * band / bands;
+          int64_t row_end = rows * (band + 1) / bands;
+          thread_pool.AddWork(
+              [this, &input, &output, sample_idx, elem_idx, stride, row_begin,
+               row_end](int thread_id) {
+                auto gaussian_windows = windows_[sample_idx].GetWindows();
+                auto elem_shape = input[sample_idx].shape().template last<ndim>();
+                auto in_view = TensorView<StorageCPU, const In, ndim>{
+                    input[sample_idx].template data<In>() + stride * elem_idx, elem_shape};
+                auto out_view = TensorView<StorageCPU, Out, ndim>{
+                    output[sample_idx].template mutable_data<Out>() + stride * elem_idx,
+                    elem_shape};
+                // I need a context for that particular run (or rather matching the thread &
+                // scratchpad)
+                auto ctx = ctx_;
+                RunBand(thread_id, sample_idx, ctx, out_view, in_view, gaussian_windows,
+                        row_begin, row_end, std::integral_constant<bool, (axes > 1)>());
+              }, elem_volume / bands);
+        }
       }
     }
     thread_pool.RunAll();
   }
 
  private:
+  /**
+   * @brief Number of row bands a sample (or a sequence frame) is split into.
+   *
+   * Elements that take more than a thread's share of the batch are split, so that a few
+   * large images can be processed by all the threads. Each band recalculates the inner
+   * axes for `window_size - 1` additional rows, so the bands are kept at least twice as tall.
+   */
+  static int NumBands(int64_t elem_volume, int64_t total_volume, int nthreads, int64_t rows,
+                      int window_size) {
+    constexpr int64_t kMinBandRows = 64;
+    if (axes == 1 || nthreads <= 1 || elem_volume == 0)
+      return 1;
+    int64_t min_band_rows = std::max<int64_t>(kMinBandRows, 2 * window_size);
+    int64_t bands = div_ceil(elem_volume * nthreads, static_cast<uint64_t>(total_volume));
+    bands = std::min<int64_t>(bands, rows / min_band_rows);
+    return std::max<int64_t>(bands, 1);
+  }
+
+  template <typename Windows>
+  void RunBand(int thread_id, int sample_idx, kernels::KernelContext& ctx,
+               const TensorView<StorageCPU, Out, ndim>& out,
+               const TensorView<StorageCPU, const In, ndim>& in, const Windows& windows,
+               int64_t row_begin, int64_t row_end, std::true_type) {
+    kmgr_.Run<Kernel>(thread_id, sample_idx, ctx, out, in, windows, 1.0f, row_begin, row_end);
+  }
+
+  template <typename Windows>
+  void RunBand(int thread_id, int sample_idx, kernels::KernelContext& ctx,
+               const TensorView<StorageCPU, Out, ndim>& out,
+               const TensorView<StorageCPU, const In, ndim>& in, const Windows& windows,
+               int64_t row_begin, int64_t row_end, std::false_type) {
+    assert(row_begin == 0 && row_end == in.shape[0]);
+    kmgr_.Run<Kernel>(thread_id, sample_idx, ctx, out, in, windows);
+  }
+
   OpSpec spec_;
   DimDesc dim_desc_;
 
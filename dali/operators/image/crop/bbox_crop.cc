@@ -176,6 +176,7 @@ centroid filter and are present in the output.
 This output will be present if the option ``output_bbox_indices`` is set to True.
 )code")
     .NumInput(1, 2)  // [boxes, labels (optional),]
+    .Random()
     .InputDox(
         0, "boxes", "2D TensorList of float", R"code(Relative coordinates of the bounding boxes
 that are represented as a 2D tensor, where the first dimension refers to the index of the bounding
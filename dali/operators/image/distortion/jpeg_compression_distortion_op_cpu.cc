@@ -13,8 +13,9 @@
 // limitations under the License.
 
 #include <vector>
-#include <opencv2/opencv.hpp>
 #include "dali/operators/image/distortion/jpeg_compression_distortion_op.h"
+#include "dali/kernels/imgproc/jpeg/jpeg_distortion_cpu_kernel.h"
+#include "dali/kernels/kernel_manager.h"
 
 namespace dali {
 
@@ -43,41 +44,50 @@ Any values outside the range 1-100 will be clamped.)code",
 
 class JpegCompressionDistortionCPU : public JpegCompressionDistortion<CPUBackend> {
  public:
-  explicit JpegCompressionDistortionCPU(const OpSpec &spec) : JpegCompressionDistortion(spec) {}
+  explicit JpegCompressionDistortionCPU(const OpSpec &spec) : JpegCompressionDistortion(spec) {
+    kmgr_.Initialize<JpegDistortionKernel>();
+  }
   using Operator<CPUBackend>::RunImpl;
 
  protected:
+  bool SetupImpl(std::vector<OutputDesc> &output_desc,
+                 const workspace_t<CPUBackend> &ws) override;
   void RunImpl(workspace_t<CPUBackend> &ws) override;
 
  private:
-  struct ThreadCtx {
-    std::vector<uint8_t> encoded;
-  };
-  std::vector<ThreadCtx> thread_ctx_;
+  using JpegDistortionKernel = kernels::jpeg::JpegCompressionDistortionCPU;
+  kernels::KernelManager kmgr_;
 };
 
+bool JpegCompressionDistortionCPU::SetupImpl(std::vector<OutputDesc> &output_desc,
+                                             const workspace_t<CPUBackend> &ws) {
+  JpegCompressionDistortion<CPUBackend>::SetupImpl(output_desc, ws);
+  auto in_view = view<const uint8_t, 3>(ws.InputRef<CPUBackend>(0));
+  int nsamples = in_view.num_samples();
+  int nthreads = ws.GetThreadPool().NumThreads();
+  kmgr_.Resize<JpegDistortionKernel>(nthreads, nsamples);
+  kernels::KernelContext ctx;
+  for (int i = 0; i < nsamples; i++) {
+    kmgr_.Setup<JpegDistortionKernel>(i, ctx, in_view[i]);
+  }
+  return true;
+}
+
 void JpegCompressionDistortionCPU::RunImpl(workspace_t<CPUBackend> &ws) {
   const auto &input = ws.InputRef<CPUBackend>(0);
   auto &output = ws.OutputRef<CPUBackend>(0);
   auto in_shape = input.shape();
   int nsamples = input.size();
   auto& thread_pool = ws.GetThreadPool();
-  auto in_view = view<const uint8_t>(input);
-  auto out_view = view<uint8_t>(output);
-
-  thread_ctx_.resize(thread_pool.NumThreads());
+  auto in_view = view<const uint8_t, 3>(input);
+  auto out_view = view<uint8_t, 3>(output);
 
   for (int sample_idx = 0; sample_idx < nsamples; sample_idx++) {
     thread_pool.AddWork(
       [&, sample_idx, quality = quality_arg_[sample_idx].data[0]](int thread_id) {
-        auto &ctx = thread_ctx_[thread_id];
-        auto sh = in_shape.tensor_shape_span(sample_idx);
-        cv::Mat in_mat(sh[0], sh[1], CV_8UC3, const_cast<unsigned char*>(in_view[sample_idx].data));
-        cv::Mat out_mat(sh[0], sh[1], CV_8UC3, out_view[sample_idx].data);
-        cv::cvtColor(in_mat, out_mat, cv::COLOR_RGB2BGR);
-        cv::imencode(".jpg", out_mat, ctx.encoded, {cv::IMWRITE_JPEG_QUALITY, quality});
-        cv::imdecode(ctx.encoded, cv::IMREAD_COLOR, &out_mat);
-        cv::cvtColor(out_mat, out_mat, cv::COLOR_BGR2RGB);
+        kernels::KernelContext ctx;
+        kmgr_.Run<JpegDistortionKernel>(thread_id, sample_idx, ctx, out_view[sample_idx],
+                                        in_view[sample_idx], quality);
       }, in_shape.tensor_size(sample_idx));
   }
   thread_pool.RunAll();
@@ -16,6 +16,7 @@
 #define DALI_OPERATORS_IMAGE_REMAP_DISPLACEMENT_FILTER_IMPL_CPU_H_
 
 #include <array>
+#include <cstring>
 #include <utility>
 #include <vector>
 
@@ -90,11 +91,12 @@ class DisplacementFilter<CPUBackend, Displacement, per_channel_transform>
   }
 
   template <typename Out, typename In, DALIInterpType interp>
-  void RunWarp(SampleWorkspace &ws, int idx) {
-    auto &input = ws.Input<CPUBackend>(idx);
-    auto &output = ws.Output<CPUBackend>(idx);
+  void RunWarp(HostWorkspace &ws, int sample_idx, int thread_idx) {
+    auto &input = ws.InputRef<CPUBackend>(0)[sample_idx];
+    auto &output = ws.OutputRef<CPUBackend>(0)[sample_idx];
 
-    auto &displace = displace_[ws.thread_idx()];
+    auto &displace = displace_[thread_idx];
+    PrepareDisplacement(displace, ws, sample_idx);
     In fill[1024];
     auto in = view_as_tensor<const Out, 3>(input);
     auto out = view_as_tensor<In, 3>(output);
@@ -106,31 +108,59 @@ class DisplacementFilter<CPUBackend, Displacement, per_channel_transform>
     Warp<interp, per_channel_transform>(out, in, displace, fill);
   }
 
+  bool CanInferOutputs() const override {
+    return true;
+  }
+
+  /**
+   * @brief Do basic input checking and output setup
+   * assuming output_shape = input_shape
+   */
   bool SetupImpl(std::vector<OutputDesc> &output_desc, const HostWorkspace &ws) override {
-    return false;
+    const auto &input = ws.InputRef<CPUBackend>(0);
+    output_desc.resize(1);
+    output_desc[0].shape = input.shape();
+    output_desc[0].type = input.type();
+    return true;
   }
 
-  void RunImpl(SampleWorkspace &ws) override {
-    DataDependentSetup(ws);
+  void RunImpl(HostWorkspace &ws) override {
+    const auto &input = ws.InputRef<CPUBackend>(0);
+    auto &output = ws.OutputRef<CPUBackend>(0);
+    output.SetLayout(input.GetLayout());
+    if (has_mask_) {
+      mask_ = &(ws.ArgumentInput("mask"));
+    }
+
+    auto &tp = ws.GetThreadPool();
+    int nsamples = input.shape().num_samples();
+    for (int sample_idx = 0; sample_idx < nsamples; sample_idx++) {
+      tp.AddWork([&, sample_idx](int thread_idx) {
+        RunSample(ws, sample_idx, thread_idx);
+      }, input.shape().tensor_size(sample_idx));
+    }
+    tp.RunAll();
+  }
 
-    auto &input = ws.Input<CPUBackend>(0);
+  void RunSample(HostWorkspace &ws, int sample_idx, int thread_idx) {
+    const auto &input = ws.InputRef<CPUBackend>(0);
 
-    if (!has_mask_ || (*mask_)[ws.data_idx()].data<bool>()[0]) {
+    if (!has_mask_ || (*mask_)[sample_idx].data<bool>()[0]) {
       switch (interp_type_) {
         case DALI_INTERP_NN:
           if (IsType<float>(input.type())) {
-            RunWarp<float, float, DALI_INTERP_NN>(ws, 0);
+            RunWarp<float, float, DALI_INTERP_NN>(ws, sample_idx, thread_idx);
           } else if (IsType<uint8_t>(input.type())) {
-            RunWarp<uint8_t, uint8_t, DALI_INTERP_NN>(ws, 0);
+            RunWarp<uint8_t, uint8_t, DALI_INTERP_NN>(ws, sample_idx, thread_idx);
           } else {
             DALI_FAIL("Unexpected input type " + input.type().name());
           }
           break;
         case DALI_INTERP_LINEAR:
           if (IsType<float>(input.type())) {
-            RunWarp<float, float, DALI_INTERP_LINEAR>(ws, 0);
+            RunWarp<float, float, DALI_INTERP_LINEAR>(ws, sample_idx, thread_idx);
           } else if (IsType<uint8_t>(input.type())) {
-            RunWarp<uint8_t, uint8_t, DALI_INTERP_LINEAR>(ws, 0);
+            RunWarp<uint8_t, uint8_t, DALI_INTERP_LINEAR>(ws, sample_idx, thread_idx);
           } else {
             DALI_FAIL("Unexpected input type " + input.type().name());
           }
@@ -141,39 +171,21 @@ class DisplacementFilter<CPUBackend, Displacement, per_channel_transform>
               " only NN and LINEAR are supported for this operation");
       }
     } else {
-      auto &output = ws.Output<CPUBackend>(0);
-      output.Copy(input, ws.stream());
+      auto &output = ws.OutputRef<CPUBackend>(0);
+      memcpy(output[sample_idx].raw_mutable_data(), input[sample_idx].raw_data(),
+             input[sample_idx].nbytes());
     }
   }
 
   template <typename U = Displacement>
   std::enable_if_t<HasParam<U>::value> PrepareDisplacement(
-      SampleWorkspace *ws) {
-    auto *p = &displace_[ws->thread_idx()].param;
-    displace_[ws->thread_idx()].Prepare(p, spec_, ws, ws->data_idx());
+      U &displace, HostWorkspace &ws, int sample_idx) {
+    displace.Prepare(&displace.param, spec_, &ws, sample_idx);
   }
 
   template <typename U = Displacement>
   std::enable_if_t<!HasParam<U>::value> PrepareDisplacement(
-      SampleWorkspace *) {}
-
-  /**
-   * @brief Do basic input checking and output setup
-   * assuming output_shape = input_shape
-   */
-  virtual void DataDependentSetup(SampleWorkspace &ws) {
-    auto &input = ws.Input<CPUBackend>(0);
-    auto &output = ws.Output<CPUBackend>(0);
-    output.ResizeLike(input);
-    output.SetLayout(input.GetLayout());
-  }
-
-  void SetupSharedSampleParams(SampleWorkspace &ws) override {
-    if (has_mask_) {
-      mask_ = &(ws.ArgumentInput("mask"));
-    }
-    PrepareDisplacement(&ws);
-  }
+      U &, HostWorkspace &, int) {}
 
   USE_OPERATOR_MEMBERS();
   using Operator<CPUBackend>::RunImpl;
@@ -24,6 +24,7 @@ DALI_SCHEMA(Jitter)
 The output images are produced by moving each pixel by a random amount, in the x and y dimensions,
 and bounded by half of the ``nDegree`` parameter.)code")
   .NumInput(1)
+  .Random()
   .NumOutput(1)
   .AddOptionalArg("nDegree",
       R"code(Each pixel is moved by a random amount in the ``[-nDegree/2, nDegree/2]`` range)code",
@@ -163,21 +163,22 @@ class ResizeCropMirrorAttr : protected CropAttr {
    * @param ws
    * @return const vector<Index> One matching shape for all inputs
    */
-  virtual const std::vector<Index> CheckShapes(const SampleWorkspace *ws) {
-    const auto &input = ws->Input<CPUBackend>(0);
+  virtual TensorShape<> CheckShapes(const HostWorkspace &ws, int sample_idx) {
+    auto shape = ws.InputRef<CPUBackend>(0).shape()[sample_idx];
     // enforce that all shapes match
-    for (int i = 1; i < ws->NumInput(); ++i) {
-      DALI_ENFORCE(input.SameShape(ws->Input<CPUBackend>(i)));
+    for (int i = 1; i < ws.NumInput(); ++i) {
+      DALI_ENFORCE(shape == ws.InputRef<CPUBackend>(i).shape()[sample_idx]);
     }
 
-    DALI_ENFORCE(input.ndim() == 3, "Operator expects 3-dimensional image input.");
+    DALI_ENFORCE(shape.size() == 3, "Operator expects 3-dimensional image input.");
 
-    return std::vector<Index>{input.shape().begin(), input.shape().end()};
+    return shape;
   }
 
-  inline const TransformMeta GetTransfomMeta(const SampleWorkspace *ws, const OpSpec &spec) {
-    const auto input_shape = CheckShapes(ws);
-    return GetTransformMeta(spec, input_shape, ws, ws->data_idx(), ResizeInfoNeeded());
+  inline const TransformMeta GetTransfomMeta(const HostWorkspace &ws, const OpSpec &spec,
+                                             int sample_idx) {
+    const auto input_shape = CheckShapes(ws, sample_idx);
+    return GetTransformMeta(spec, input_shape, &ws, sample_idx, ResizeInfoNeeded());
   }
 
   DALIInterpType getInterpType() const        { return interp_type_; }
@@ -207,58 +208,67 @@ class ResizeCropMirror : public Operator<CPUBackend>, protected ResizeCropMirror
  public:
   explicit inline ResizeCropMirror(const OpSpec &spec) :
     Operator(spec), ResizeCropMirrorAttr(spec) {
-    // Resize per-image & per-thread data
+    // Resize per-thread data
     tl_workspace_.resize(num_threads_);
-
-    // per-image-set data
-    per_thread_meta_.resize(num_threads_);
   }
 
   ~ResizeCropMirror() override = default;
 
  protected:
-  bool SetupImpl(std::vector<OutputDesc> &output_desc, const HostWorkspace &ws) override {
-    return false;
+  bool CanInferOutputs() const override {
+    return true;
   }
 
-  inline void SetupSharedSampleParams(SampleWorkspace &ws) override {
-    per_thread_meta_[ws.thread_idx()] = GetTransfomMeta(&ws, spec_);
+  bool SetupImpl(std::vector<OutputDesc> &output_desc, const HostWorkspace &ws) override {
+    const auto &input = ws.InputRef<CPUBackend>(0);
+    int nsamples = input.shape().num_samples();
+    per_sample_meta_.resize(nsamples);
+    output_desc.resize(1);
+    output_desc[0].type = input.type();
+    output_desc[0].shape.resize(nsamples, 3);
+    for (int i = 0; i < nsamples; i++) {
+      per_sample_meta_[i] = GetTransfomMeta(ws, spec_, i);
+      output_desc[0].shape.set_tensor_shape(
+          i, TensorShape<>{crop_height_[i], crop_width_[i], per_sample_meta_[i].C});
+    }
+    return true;
   }
 
-  inline void RunImpl(SampleWorkspace &ws) override {
+  void RunImpl(HostWorkspace &ws) override {
     RunResizeImpl(ws, ResizeCropMirrorHost);
   }
 
-  inline void RunResizeImpl(SampleWorkspace &ws, resizeCropMirroHost func) {
-    auto &input = ws.Input<CPUBackend>(0);
-    auto &output = ws.Output<CPUBackend>(0);
-    CheckParam(input, "ResizeCropMirror");
-
-    const TransformMeta &meta = per_thread_meta_[ws.thread_idx()];
-
-    // Resize the output & run
-    output.Resize(
-        std::vector<Index>{crop_height_[ws.data_idx()], crop_width_[ws.data_idx()], meta.C});
+  inline void RunResizeImpl(HostWorkspace &ws, resizeCropMirroHost func) {
+    const auto &input = ws.InputRef<CPUBackend>(0);
+    auto &output = ws.OutputRef<CPUBackend>(0);
     output.SetLayout(input.GetLayout());
 
-    tl_workspace_[ws.thread_idx()].resize(meta.rsz_h*meta.rsz_w*meta.C);
-    DALI_CALL((*func)(
-        input.template data<uint8>(),
-        meta.H, meta.W, meta.C,
-        meta.rsz_h, meta.rsz_w,
-        meta.crop,
-        crop_height_[0], crop_width_[0],
-        meta.mirror,
-        output.template mutable_data<uint8>(),
-        interp_type_,
-        tl_workspace_[ws.thread_idx()].data()));
+    auto &tp = ws.GetThreadPool();
+    for (int i = 0; i < input.shape().num_samples(); i++) {
+      tp.AddWork([&, i, func](int thread_idx) {
+        CheckParam(input[i], "ResizeCropMirror");
+        const TransformMeta &meta = per_sample_meta_[i];
+        auto &tmp = tl_workspace_[thread_idx];
+        tmp.resize(meta.rsz_h*meta.rsz_w*meta.C);
+        DALI_CALL((*func)(
+            input[i].template data<uint8>(),
+            meta.H, meta.W, meta.C,
+            meta.rsz_h, meta.rsz_w,
+            meta.crop,
+            crop_height_[i], crop_width_[i],
+            meta.mirror,
+            output[i].template mutable_data<uint8>(),
+            interp_type_,
+            tmp.data()));
+      }, static_cast<int64_t>(crop_height_[i]) * crop_width_[i]);
+    }
+    tp.RunAll();
   }
 
   vector<vector<uint8>> tl_workspace_;
-  vector<TransformMeta> per_thread_meta_;
+  vector<TransformMeta> per_sample_meta_;
   USE_OPERATOR_MEMBERS();
   using Operator<Backend>::RunImpl;
-  using Operator<Backend>::SetupSharedSampleParams;
 };
 
 /**
@@ -273,7 +283,7 @@ class FastResizeCropMirror : public ResizeCropMirror<CPUBackend> {
   inline ~FastResizeCropMirror() override = default;
 
  protected:
-  inline void RunImpl(SampleWorkspace &ws) override {
+  void RunImpl(HostWorkspace &ws) override {
     RunResizeImpl(ws, FastResizeCropMirrorHost);
   }
 };
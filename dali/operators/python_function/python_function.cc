@@ -57,7 +57,20 @@ The function should not modify input tensors.
 once per batch or separately for every sample in the batch.
 
 If set to True, the function will receive its arguments as lists of NumPy or CuPy arrays,
-for CPU and GPU backend, respectively.)code", false);
+for CPU and GPU backend, respectively.)code", false)
+        .AddOptionalArg("parallel", R"code(Applies **only** to the CPU operator called
+separately for every sample (``batch_processing=False``).
+
+If set to True, the samples are processed by the pool of Python worker processes started by the
+pipeline, which allows the function to use multiple CPU cores despite Python's GIL. The number of
+workers and the way they are started are controlled with the ``py_num_workers`` and
+``py_start_method`` pipeline arguments. The inputs are sent to the workers and the results are
+returned through shared memory.
+
+The function must accept NumPy arrays and return NumPy arrays (or a tuple of them, for
+multiple outputs). When ``py_start_method="spawn"`` is used, the function must be picklable.
+It is run in separate processes, so it cannot rely on the state of the main process.)code",
+        false);
 
 DALI_SCHEMA(TorchPythonFunction)
         .DocStr(R"code(Executes a function that is operating on Torch tensors.
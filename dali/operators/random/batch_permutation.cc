@@ -24,6 +24,7 @@ DALI_SCHEMA(BatchPermutation)
   .DocStr(R"(Produces a batch of random integers which can be used as indices for
 indexing samples in the batch.)")
   .NumInput(0)
+  .Random()
   .NumOutput(1)
   .AddOptionalArg("allow_repetitions",
       R"(If true, the output can contain repetitions and omissions.)", false)
@@ -24,6 +24,7 @@ DALI_SCHEMA(noise__Gaussian)
 The shape and data type of the output will match the input.
 )code")
     .NumInput(1)
+    .Random()
     .NumOutput(1)
     .AddOptionalArg<float>("mean",
       R"code(Mean of the distribution.)code",
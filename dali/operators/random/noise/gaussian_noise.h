@@ -43,6 +43,12 @@ struct GaussianNoiseImpl {
     return dist_(st);
   }
 
+  template <typename F = FloatType>
+  std::enable_if_t<std::is_same<F, float>::value>
+  GenerateBatch(float *out, int64_t n, Philox4x32_10 &st) {
+    normal_fill(out, n, st, dist_.mean(), dist_.stddev());
+  }
+
   DALI_HOST_DEV void Apply(T& output, T input, FloatType n) {
     output = ConvertSat<T>(input + n);
   }
@@ -24,6 +24,7 @@ DALI_SCHEMA(noise__SaltAndPepper)
 The shape and data type of the output will match the input.
 )code")
     .NumInput(1)
+    .Random()
     .NumOutput(1)
     .AddOptionalArg<float>("prob",
       R"code(Probability of an output value to take a salt or pepper value.)code",
@@ -52,6 +52,10 @@ class SaltAndPepperNoiseImpl {
     return dist_(st);
   }
 
+  void GenerateBatch(float *out, int64_t n, Philox4x32_10 &st) {
+    uniform_fill(out, n, st, 0.0f, 1.0f);
+  }
+
   DALI_HOST_DEV void Apply(T &output, T input, float n) {
     if (n < noise_prob_) {
       if (n < salt_prob_) {
@@ -41,6 +41,7 @@ the output. A factor of 0 makes this an identity operation.
 The shape and data type of the output will match the input.
 )code")
     .NumInput(1)
+    .Random()
     .NumOutput(1)
     .AddOptionalArg<float>("factor",
       R"code(Factor parameter.)code",
@@ -15,11 +15,13 @@
 #ifndef DALI_OPERATORS_RANDOM_RNG_BASE_CPU_H_
 #define DALI_OPERATORS_RANDOM_RNG_BASE_CPU_H_
 
+#include <algorithm>
 #include <random>
 #include <utility>
 #include <vector>
 #include "dali/operators/random/rng_base.h"
 #include "dali/core/convert.h"
+#include "dali/core/philox.h"
 #include "dali/pipeline/operator/operator.h"
 #include "dali/pipeline/util/batch_rng.h"
 #include "dali/core/static_switch.h"
@@ -37,6 +39,31 @@ struct RNGBaseFields<CPUBackend, IsNoiseGen> {
   }
 };
 
+/**
+ * @brief Detects distributions that can generate a block of float values at once
+ *        with `GenerateBatch(float *out, int64_t n, RNG &rng)`
+ */
+template <typename Dist, typename RNG, typename = void>
+struct has_batch_generate : std::false_type {};
+
+template <typename Dist, typename RNG>
+struct has_batch_generate<Dist, RNG, decltype(std::declval<Dist &>().GenerateBatch(
+    std::declval<float *>(), int64_t(), std::declval<RNG &>()))> : std::true_type {};
+
+/**
+ * @brief Generates `p_count` values in blocks and passes them to `consume(p, values, n)`
+ */
+template <typename Dist, typename RNG, typename Consume>
+inline void gen_batched(Dist &dist, RNG &rng, int64_t p_count, Consume &&consume) {
+  constexpr int kBlock = 256;
+  float buf[kBlock];
+  for (int64_t p = 0; p < p_count; p += kBlock) {
+    int n = std::min<int64_t>(kBlock, p_count - p);
+    dist.GenerateBatch(buf, n, rng);
+    consume(p, buf, n);
+  }
+}
+
 template <bool IsNoiseGen>
 struct DistGen;
 
@@ -45,6 +72,12 @@ struct DistGen<false> {
   template <typename T, typename Dist, typename RNG>
   inline void gen(span<T> out, span<const T> in, Dist &dist, RNG &rng,
                   int64_t p_offset, int64_t p_count) const {
+    gen(out, in, dist, rng, p_offset, p_count, has_batch_generate<Dist, RNG>());
+  }
+
+  template <typename T, typename Dist, typename RNG>
+  inline void gen(span<T> out, span<const T> in, Dist &dist, RNG &rng,
+                  int64_t p_offset, int64_t p_count, std::false_type) const {
     (void) in;
     int64_t p_pos = p_offset;
     for (int64_t p = 0; p < p_count; p++, p_pos++) {
@@ -52,6 +85,17 @@ struct DistGen<false> {
     }
   }
 
+  template <typename T, typename Dist, typename RNG>
+  inline void gen(span<T> out, span<const T> in, Dist &dist, RNG &rng,
+                  int64_t p_offset, int64_t p_count, std::true_type) const {
+    (void) in;
+    gen_batched(dist, rng, p_count, [&](int64_t p, const float *values, int n) {
+      T *o = &out[p_offset + p];
+      for (int i = 0; i < n; i++)
+        o[i] = ConvertSat<T>(values[i]);
+    });
+  }
+
   template <typename T, typename Dist, typename RNG>
   inline void gen_all_channels(span<T> out, span<const T> in, Dist &dist, RNG &rng,
                                int64_t p_offset, int64_t p_count, int c_count,
@@ -74,6 +118,12 @@ struct DistGen<true> {
   inline void gen(span<T> out, span<const T> in, Dist& dist, RNG &rng,
                   int64_t p_offset, int64_t p_count) const {
     assert(out.size() == in.size());
+    gen(out, in, dist, rng, p_offset, p_count, has_batch_generate<Dist, RNG>());
+  }
+
+  template <typename T, typename Dist, typename RNG>
+  inline void gen(span<T> out, span<const T> in, Dist& dist, RNG &rng,
+                  int64_t p_offset, int64_t p_count, std::false_type) const {
     int64_t p_pos = p_offset;
     for (int64_t p = 0; p < p_count; p++, p_pos++) {
       auto n = dist.Generate(in[p_pos], rng);
@@ -81,6 +131,17 @@ struct DistGen<true> {
     }
   }
 
+  template <typename T, typename Dist, typename RNG>
+  inline void gen(span<T> out, span<const T> in, Dist& dist, RNG &rng,
+                  int64_t p_offset, int64_t p_count, std::true_type) const {
+    gen_batched(dist, rng, p_count, [&](int64_t p, const float *values, int n) {
+      T *o = &out[p_offset + p];
+      const T *i = &in[p_offset + p];
+      for (int k = 0; k < n; k++)
+        dist.Apply(o[k], i[k], values[k]);
+    });
+  }
+
   template <typename T, typename Dist, typename RNG>
   inline void gen_all_channels(span<T> out, span<const T> in, Dist& dist, RNG &rng,
                                int64_t p_offset, int64_t p_count,
@@ -115,7 +176,6 @@ void RNGBase<Backend, Impl, IsNoiseGen>::RunImplTyped(workspace_t<CPUBackend> &w
   auto &tp = ws.GetThreadPool();
   constexpr int64_t kThreshold = 1 << 18;
   constexpr int64_t kChunkSize = 1 << 16;
-  constexpr size_t kNumChunkSeeds = 16;
   int nsamples = output.shape().size();
   int ndim = output.shape().sample_dim();
 
@@ -164,39 +224,25 @@ void RNGBase<Backend, Impl, IsNoiseGen>::RunImplTyped(workspace_t<CPUBackend> &w
       p_stride = channel_dim == 0 ? 1 : nchannels;
     }
 
-    if (total_p_count < kThreshold) {
+    // Each chunk draws from its own Philox subsequence, selected by the chunk's offset,
+    // so the result doesn't depend on which thread generates which chunk.
+    uint64_t key = rng_[sample_id]();
+    int chunks = total_p_count < kThreshold ? 1 : div_ceil(total_p_count, kChunkSize);
+    for (int c = 0; c < chunks; c++) {
+      int64_t p_offset, p_count;
+      std::tie(p_offset, p_count) = get_chunk<T>(total_p_count, c, chunks);
       tp.AddWork(
         [=](int thread_id) {
+          Philox4x32_10 chunk_rng(key, p_offset);
           auto dist = use_default_dist ? Dist() : dists[sample_id];
           if (independent_channels) {
-            dist_gen_.template gen<T>(out_span, in_span, dist, rng_[sample_id], 0, total_p_count);
+            dist_gen_.template gen<T>(out_span, in_span, dist, chunk_rng,
+                                      p_offset, p_count);
           } else {
-            dist_gen_.template gen_all_channels<T>(out_span, in_span, dist, rng_[sample_id], 0,
-                                                   total_p_count, nchannels, c_stride, p_stride);
+            dist_gen_.template gen_all_channels<T>(out_span, in_span, dist, chunk_rng, p_offset,
+                                                   p_count, nchannels, c_stride, p_stride);
           }
-        }, total_p_count);
-    } else {
-      int chunks = div_ceil(total_p_count, kChunkSize);
-      std::array<uint32_t, kNumChunkSeeds> seed;
-      for (int c = 0; c < chunks; c++) {
-        int64_t p_offset, p_count;
-        std::tie(p_offset, p_count) = get_chunk<T>(total_p_count, c, chunks);
-        for (auto &s : seed)
-          s = rng_[sample_id]();
-        tp.AddWork(
-          [=](int thread_id) {
-            std::seed_seq seq(seed.begin(), seed.end());
-            std::mt19937_64 chunk_rng(seq);
-            auto dist = use_default_dist ? Dist() : dists[sample_id];
-            if (independent_channels) {
-              dist_gen_.template gen<T>(out_span, in_span, dist, chunk_rng,
-                                        p_offset, p_count);
-            } else {
-              dist_gen_.template gen_all_channels<T>(out_span, in_span, dist, chunk_rng, p_offset,
-                                                     p_count, nchannels, c_stride, p_stride);
-            }
-          }, p_count);
-      }
+        }, p_count);
     }
   }
   tp.RunAll();
@@ -19,6 +19,7 @@
 #include "dali/operators/random/rng_base.h"
 #include "dali/pipeline/operator/arg_helper.h"
 #include "dali/core/dev_buffer.h"
+#include "dali/core/philox.h"
 
 #define DALI_UNIFORM_DIST_TYPES \
   uint8_t, int8_t, uint16_t, int16_t, uint32_t, int32_t, uint64_t, int64_t, float, double
@@ -46,6 +47,9 @@ class uniform_real_dist {
     return val;
   }
 
+  T a() const { return dist_.a(); }
+  T b() const { return range_end_; }
+
  private:
   T range_end_ = 1;
   std::uniform_real_distribution<T> dist_;
@@ -99,6 +103,12 @@ struct UniformDistributionContinuousImpl {
     return dist_(st);
   }
 
+  template <typename F = FloatType>
+  std::enable_if_t<std::is_same<F, float>::value>
+  GenerateBatch(float *out, int64_t n, Philox4x32_10 &st) {
+    uniform_fill(out, n, st, dist_.a(), dist_.b());
+  }
+
   DistType dist_;
 };
 
@@ -14,8 +14,11 @@
 
 #include "dali/operators/reader/coco_reader_op.h"
 
+#include <algorithm>
 #include <set>
 
+#include "dali/kernels/imgproc/structure/rle_mask.h"
+
 extern "C" {
 #include "third_party/cocoapi/common/maskApi.h"
 }
@@ -83,12 +86,25 @@ This readers produces the following outputs::
 * **image_ids** (Optional, present if argument ``image_ids`` is set to True)
   One element per sample, representing an image identifier.)code")
   .AddOptionalArg("preprocessed_annotations",
-    "Path to the directory with meta files that contain preprocessed COCO annotations.",
+    R"code(Path to the directory with meta files that contain preprocessed COCO annotations.
+
+If the directory contains the single-file representation (``annotations.bin``), the file is
+memory-mapped instead of being read, so that only the parts used by this shard are loaded and
+the memory is shared between the processes that read the same annotations.)code",
     std::string())
   .DeprecateArgInFavorOf("meta_files_path", "preprocessed_annotations")  // deprecated since 0.28dev
   .AddOptionalArg("annotations_file",
       R"code(List of paths to the JSON annotations files.)code",
       std::string())
+  .AddOptionalArg("annotations_cache_dir",
+      R"code(Path to a directory in which the annotations parsed from ``annotations_file`` are cached.
+
+The cache is the memory-mappable preprocessed annotations file, specific to the annotations file
+and the arguments that affect parsing. If it exists, the JSON file is not parsed at all.
+Otherwise, it is created after parsing the annotations.
+
+Note: This argument is mutually exclusive with ``preprocessed_annotations``.)code",
+      std::string())
   .AddOptionalArg("shuffle_after_epoch",
       R"code(If set to True, the reader shuffles the entire  dataset after each epoch.)code",
       false)
@@ -148,7 +164,9 @@ Note: This argument is mutually exclusive with ``preprocessed_annotations``.)cod
   .DeprecateArgInFavorOf("save_img_ids", "image_ids")  // deprecated since 0.28dev
   .AddOptionalArg("save_preprocessed_annotations",
       R"code(If set to True, the operator saves a set of files containing binary representations of the
-preprocessed COCO annotations.)code",
+preprocessed COCO annotations.
+
+Along with the per-array files, a single memory-mappable file (``annotations.bin``) is saved.)code",
       false)
   .DeprecateArgInFavorOf("dump_meta_files",
                          "save_preprocessed_annotations")  // deprecated since 0.28dev
@@ -158,7 +176,8 @@ preprocessed COCO annotations.)code",
   .DeprecateArgInFavorOf("dump_meta_files_path",
                          "save_preprocessed_annotations_dir")  // deprecated since 0.28dev
   .AdditionalOutputsFn(COCOReaderOutputFn)
-  .AddParent("LoaderBase");
+  .AddParent("LoaderBase")
+  .AddParent("EncodedSampleCacheAttr");
 
 
 // Deprecated alias
@@ -296,112 +315,32 @@ void COCOReader::PixelwiseMasks(int image_idx, int* mask) {
 
   // Mask was originally described in RLE format
   for (uint ann_id = 0 ; ann_id < masks_info.mask_indices.size(); ann_id++) {
-    const auto &rle = masks_info.rles[ann_id];
+    auto size = masks_info.rle_sizes[ann_id];
+    auto counts = masks_info.counts(ann_id);
     auto mask_idx = masks_info.mask_indices[ann_id];
     int label = labels_span[mask_idx];
-    rleInit(&R[label], (*rle)->h, (*rle)->w, (*rle)->m, (*rle)->cnts);
+    // rleInit copies the counts, so the (possibly memory-mapped) source is not modified
+    rleInit(&R[label], size[0], size[1], counts.size(), const_cast<uint *>(counts.data()));
   }
 
   // Merge each label (from multi-polygons annotations)
-  uint lab_cnt = 0;
   for (const auto &rles : frPoly)
     rleMerge(rles.second.data(), &R[rles.first], rles.second.size(), 0);
 
-  // Merge all the labels into a pair of vectors :
-  // [2,2,2],[A,B,C] for [A,A,B,B,C,C]
-  struct Encoding {
-    uint m;
-    std::unique_ptr<uint[]> cnts;
-    std::unique_ptr<int[]> vals;
-  };
-  Encoding A;
-  A.cnts = std::make_unique<uint[]>(h * w + 1);  // upper-bound
-  A.vals = std::make_unique<int[]>(h * w + 1);
-
-  // first copy the content of the first label to the output
-  bool v = false;
-  A.m = R[*labels.begin()].m;
-  for (siz a = 0; a < R[*labels.begin()].m; a++) {
-    A.cnts[a] = R[*labels.begin()].cnts[a];
-    A.vals[a] = v ? *labels.begin() : 0;
-    v = !v;
-  }
-
-  // then merge the other labels
-  std::unique_ptr<uint[]> cnts = std::make_unique<uint[]>(h * w + 1);
-  std::unique_ptr<int[]> vals = std::make_unique<int[]>(h * w + 1);
-  for (auto label = ++labels.begin(); label != labels.end(); label++) {
-    RLE B = R[*label];
-    if (B.cnts == 0)
+  // Convert each label's (column-major) RLE to a row-wise one and paint them in the order of
+  // labels, so that where the masks overlap the last annotation wins (it's undefined by the
+  // spec). Only the runs are ever stored - the mask is materialized once, in the output.
+  auto out_view = make_tensor_cpu<2>(mask, {h, w});
+  std::fill(mask, mask + h * w, 0);
+  kernels::rle::RLEMask<int> row_rle;
+  for (int label : labels) {
+    const RLE &rle = R[label];
+    if (rle.cnts == 0)
       continue;
-
-    uint cnt_a = A.cnts[0];
-    uint cnt_b = B.cnts[0];
-    int next_val_a = A.vals[0];
-    int val_a = next_val_a;
-    int val_b = *label;
-    bool next_vb = false;
-    bool vb = next_vb;
-    uint nb_seq_a, nb_seq_b;
-    nb_seq_a = nb_seq_b = 1;
-    int m = 0;
-
-    int cnt_tot = 1;  // check if we advanced at all
-    while (cnt_tot > 0) {
-      uint c = std::min(cnt_a, cnt_b);
-      cnt_tot = 0;
-      // advance A
-      cnt_a -= c;
-      if (!cnt_a && nb_seq_a < A.m) {
-        cnt_a = A.cnts[nb_seq_a];  // next sequence for A
-        next_val_a = A.vals[nb_seq_a];
-        nb_seq_a++;
-      }
-      cnt_tot += cnt_a;
-      // advance B
-      cnt_b -= c;
-      if (!cnt_b && nb_seq_b < B.m) {
-        cnt_b = B.cnts[nb_seq_b++];  // next sequence for B
-        next_vb = !next_vb;
-      }
-      cnt_tot += cnt_b;
-
-      if (val_a && vb)  // there's already a class at this pixel
-                        // in this case, the last annotation wins (it's undefined by the spec)
-        vals[m] = (!cnt_a) ? val_a : val_b;
-      else if (val_a)
-        vals[m] = val_a;
-      else if (vb)
-        vals[m] = val_b;
-      else
-        vals[m] = 0;
-      cnts[m] = c;
-      m++;
-
-      // since we switched sequence for A or B, apply the new value from now on
-      val_a = next_val_a;
-      vb = next_vb;
-
-      if (cnt_a == 0) break;
-    }
-    // copy back the buffers to the destination encoding
-    A.m = m;
-    for (int i = 0; i < m; i++) A.cnts[i] = cnts[i];
-    for (int i = 0; i < m; i++) A.vals[i] = vals[i];
+    kernels::rle::FromColumnMajorCounts(row_rle, h, w, make_cspan(rle.cnts, rle.m), label);
+    kernels::rle::Paint(out_view, row_rle);
   }
 
-  // Decode final pixelwise masks encoded via RLE
-  memset(mask, 0, h * w * sizeof(int));
-  int x = 0, y = 0;
-  for (uint i = 0; i < A.m; i++)
-    for (uint j = 0; j < A.cnts[i]; j++) {
-      mask[x + y * w] = A.vals[i];
-      if (++y >= h) {
-        y = 0;
-        x++;
-      }
-    }
-
   // Destroy RLEs
   rlesFree(&R, *labels.rbegin() + 1);
   for (auto rles : frPoly)
@@ -98,7 +98,8 @@ This argument is mutually exclusive with ``file_list``.)", nullptr)
 ``files`` argument.
 
 If not used, sequential 0-based indices are used as labels)", nullptr)
-  .AddParent("LoaderBase");
+  .AddParent("LoaderBase")
+  .AddParent("EncodedSampleCacheAttr");
 
 
 // Deprecated alias
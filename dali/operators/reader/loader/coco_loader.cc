@@ -12,8 +12,16 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-#include <list>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
 #include <map>
+#include <sstream>
 #include <unordered_map>
 #include <iomanip>
 #include <iostream>
@@ -21,6 +29,7 @@
 
 #include "dali/operators/reader/loader/coco_loader.h"
 #include "dali/pipeline/util/lookahead_parser.h"
+#include "dali/pipeline/util/thread_pool.h"
 
 namespace dali {
 namespace detail {
@@ -93,7 +102,7 @@ void Write(std::ofstream& file, span<const T> data, const char* filename) {
 }
 
 template <typename T>
-void SaveToFile(const std::vector<T> &input, const std::string path) {
+void SaveToFile(span<const T> input, const std::string path) {
   if (input.empty())
     return;
   std::ofstream file(path, std::ios_base::binary | std::ios_base::out);
@@ -101,47 +110,34 @@ void SaveToFile(const std::vector<T> &input, const std::string path) {
 
   unsigned size = input.size();
   Write(file, size, path.c_str());
-  Write(file, make_cspan(input), path.c_str());
+  Write(file, input, path.c_str());
   DALI_ENFORCE(file.good(), make_string("Error writing to path: ", path));
 }
 
-template <>
-void SaveToFile(const std::vector<RLEMaskPtr> &input, const std::string path) {
-  if (input.empty())
+/**
+ * @brief Saves run-length encoded masks as a sequence of (h, w, m, counts[m])
+ */
+void SaveRLEsToFile(span<const uint32_t> counts, span<const int64_t> offsets,
+                    span<const ivec2> sizes, const std::string path) {
+  if (sizes.empty())
     return;
   std::ofstream file(path, std::ios_base::binary | std::ios_base::out);
   DALI_ENFORCE(file, "CocoReader meta file error while saving: " + path);
 
-  unsigned size = input.size();
+  unsigned size = sizes.size();
   Write(file, size, path.c_str());
-  for (auto &rle : input) {
-    assert((*rle)->h > 0 && (*rle)->w > 0 && (*rle)->m > 0);
-    siz dims[3] = {(*rle)->h, (*rle)->w, (*rle)->m};
+  for (int i = 0; i < sizes.size(); i++) {
+    siz m = offsets[i + 1] - offsets[i];
+    assert(sizes[i][0] > 0 && sizes[i][1] > 0 && m > 0);
+    siz dims[3] = {static_cast<siz>(sizes[i][0]), static_cast<siz>(sizes[i][1]), m};
     Write(file, span<const siz>{&dims[0], 3}, path.c_str());
-    Write(file, span<const uint>{(*rle)->cnts, static_cast<ptrdiff_t>((*rle)->m)}, path.c_str());
-  }
-}
-
-template <typename T>
-void SaveToFile(const std::vector<std::vector<T> > &input, const std::string path) {
-  if (input.empty())
-    return;
-  std::ofstream file(path, std::ios_base::binary | std::ios_base::out);
-  DALI_ENFORCE(file, "CocoReader meta file error while saving: " + path);
-
-  unsigned size = input.size();
-  Write(file, size, path.c_str());
-
-  for (auto& v : input) {
-    size = v.size();
-    assert(size > 0);
-    Write(file, size, path.c_str());
-    Write(file, make_cspan(v), path.c_str());
+    Write(file, span<const uint>{counts.data() + offsets[i], static_cast<ptrdiff_t>(m)},
+          path.c_str());
   }
 }
 
 template <>
-void SaveToFile(const ImageIdPairs &image_id_pairs, const std::string path) {
+void SaveToFile(span<const std::pair<std::string, int>> image_id_pairs, const std::string path) {
   if (image_id_pairs.empty())
     return;
   std::ofstream file(path);
@@ -165,40 +161,28 @@ void LoadFromFile(std::vector<T> &output, const std::string path) {
   Read(file, make_span(output), path.c_str());
 }
 
-template <>
-void LoadFromFile(std::vector<RLEMaskPtr> &output, const std::string path) {
+void LoadRLEsFromFile(std::vector<uint32_t> &counts, std::vector<int64_t> &offsets,
+                      std::vector<ivec2> &sizes, const std::string path) {
   std::ifstream file(path);
-  output.clear();
+  counts.clear();
+  offsets.clear();
+  sizes.clear();
   if (!file.good())
     return;
 
   unsigned size;
   Read(file, size, path.c_str());
-  output.clear();
-  output.resize(size);
-  for (auto &rle : output) {
+  sizes.resize(size);
+  offsets.resize(size + 1);
+  offsets[0] = 0;
+  for (unsigned i = 0; i < size; i++) {
     siz dims[3];
     Read(file, span<siz>{&dims[0], 3}, path.c_str());
     siz h = dims[0], w = dims[1], m = dims[2];
-    rle = std::make_shared<RLEMask>(h, w, m);
-    Read(file, span<uint>{(*rle)->cnts, static_cast<ptrdiff_t>((*rle)->m)}, path.c_str());
-  }
-}
-
-template <typename T>
-void LoadFromFile(std::vector<std::vector<T> > &output, const std::string path) {
-  std::ifstream file(path);
-  output.clear();
-  if (!file.good())
-    return;
-
-  unsigned size;
-  Read(file, size, path.c_str());
-  output.resize(size);
-  for (size_t i = 0; i < output.size(); ++i) {
-    Read(file, size, path.c_str());
-    output[i].resize(size);
-    Read(file, make_span(output[i]), path.c_str());
+    sizes[i] = ivec2(h, w);
+    counts.resize(offsets[i] + m);
+    offsets[i + 1] = counts.size();
+    Read(file, span<uint>{counts.data() + offsets[i], static_cast<ptrdiff_t>(m)}, path.c_str());
   }
 }
 
@@ -270,112 +254,367 @@ void ParseCategories(LookaheadParser &parser, std::map<int, int> &category_ids)
   }
 }
 
-void ParseAnnotations(LookaheadParser &parser, std::vector<Annotation> &annotations,
-                      float min_size_threshold, bool ltrb,
-                      bool parse_segmentation, bool parse_rle) {
+/**
+ * @brief Parses a single element of the ``annotations`` array
+ *
+ * @return true, if the annotation should be kept
+ */
+bool ParseAnnotation(LookaheadParser &parser, Annotation &annotation,
+                     float min_size_threshold, bool ltrb,
+                     bool parse_segmentation, bool parse_rle) {
   std::string rle_str;
   std::vector<uint32_t> rle_uints;
-  RAPIDJSON_ASSERT(parser.PeekType() == kArrayType);
-  parser.EnterArray();
-  while (parser.NextArrayValue()) {
-    detail::Annotation annotation;
-    if (parser.PeekType() != kObjectType) {
-      continue;
-    }
-    bool to_add = true;
-    parser.EnterObject();
-    while (const char* internal_key = parser.NextObjectKey()) {
-      if (0 == std::strcmp(internal_key, "image_id")) {
-        annotation.image_id_ = parser.GetInt();
-      } else if (0 == std::strcmp(internal_key, "category_id")) {
-        annotation.category_id_ = parser.GetInt();
-      } else if (0 == std::strcmp(internal_key, "bbox")) {
-        RAPIDJSON_ASSERT(parser.PeekType() == kArrayType);
-        parser.EnterArray();
-        int i = 0;
-        while (parser.NextArrayValue()) {
-          annotation.box_[i] = parser.GetDouble();
-          ++i;
-        }
-      } else if (parse_segmentation && 0 == std::strcmp(internal_key, "segmentation")) {
-        // That means that the mask encoding is not polygons but RLE
-        // (iscrowd==1 in Object Detection task, or Stuff Segmentation)
-        if (parse_rle && parser.PeekType() == kObjectType) {
-          annotation.tag_ = Annotation::RLE;
-          parser.EnterObject();
-          rle_str.clear();
-          rle_uints.clear();
-          int h = -1, w = -1;
-          while (const char* another_key = parser.NextObjectKey()) {
-            if (0 == std::strcmp(another_key, "size")) {
-              RAPIDJSON_ASSERT(parser.PeekType() == kArrayType);
+  if (parser.PeekType() != kObjectType) {
+    parser.SkipValue();
+    return false;
+  }
+  parser.EnterObject();
+  while (const char* internal_key = parser.NextObjectKey()) {
+    if (0 == std::strcmp(internal_key, "image_id")) {
+      annotation.image_id_ = parser.GetInt();
+    } else if (0 == std::strcmp(internal_key, "category_id")) {
+      annotation.category_id_ = parser.GetInt();
+    } else if (0 == std::strcmp(internal_key, "bbox")) {
+      RAPIDJSON_ASSERT(parser.PeekType() == kArrayType);
+      parser.EnterArray();
+      int i = 0;
+      while (parser.NextArrayValue()) {
+        annotation.box_[i] = parser.GetDouble();
+        ++i;
+      }
+    } else if (parse_segmentation && 0 == std::strcmp(internal_key, "segmentation")) {
+      // That means that the mask encoding is not polygons but RLE
+      // (iscrowd==1 in Object Detection task, or Stuff Segmentation)
+      if (parse_rle && parser.PeekType() == kObjectType) {
+        annotation.tag_ = Annotation::RLE;
+        parser.EnterObject();
+        rle_str.clear();
+        rle_uints.clear();
+        int h = -1, w = -1;
+        while (const char* another_key = parser.NextObjectKey()) {
+          if (0 == std::strcmp(another_key, "size")) {
+            RAPIDJSON_ASSERT(parser.PeekType() == kArrayType);
+            parser.EnterArray();
+            parser.NextArrayValue();
+            h = parser.GetInt();
+            parser.NextArrayValue();
+            w = parser.GetInt();
+            parser.NextArrayValue();
+          } else if (0 == std::strcmp(another_key, "counts")) {
+            if (parser.PeekType() == kStringType) {
+              rle_str = parser.GetString();
+            } else if (parser.PeekType() == kArrayType) {
               parser.EnterArray();
-              parser.NextArrayValue();
-              h = parser.GetInt();
-              parser.NextArrayValue();
-              w = parser.GetInt();
-              parser.NextArrayValue();
-            } else if (0 == std::strcmp(another_key, "counts")) {
-              if (parser.PeekType() == kStringType) {
-                rle_str = parser.GetString();
-              } else if (parser.PeekType() == kArrayType) {
-                parser.EnterArray();
-                while (parser.NextArrayValue()) {
-                  rle_uints.push_back(parser.GetInt());
-                }
-              } else {
-                parser.SkipValue();
+              while (parser.NextArrayValue()) {
+                rle_uints.push_back(parser.GetInt());
               }
             } else {
               parser.SkipValue();
             }
-          }
-          DALI_ENFORCE(h > 0 && w > 0, "Invalid or missing mask sizes");
-          if (!rle_str.empty()) {
-            annotation.rle_ = std::make_shared<RLEMask>(h, w, rle_str.c_str());
-          } else if (!rle_uints.empty()) {
-            annotation.rle_ = std::make_shared<RLEMask>(h, w, make_cspan(rle_uints));
           } else {
-            DALI_FAIL("Missing or invalid ``counts`` attribute.");
+            parser.SkipValue();
           }
-        } else if (parser.PeekType() == kArrayType) {
-          annotation.tag_ = Annotation::POLYGON;
-          int coord_offset = 0;
-          auto& segm_meta = annotation.poly_.segm_meta_;
-          auto& segm_coords = annotation.poly_.segm_coords_;
+        }
+        DALI_ENFORCE(h > 0 && w > 0, "Invalid or missing mask sizes");
+        if (!rle_str.empty()) {
+          annotation.rle_ = std::make_shared<RLEMask>(h, w, rle_str.c_str());
+        } else if (!rle_uints.empty()) {
+          annotation.rle_ = std::make_shared<RLEMask>(h, w, make_cspan(rle_uints));
+        } else {
+          DALI_FAIL("Missing or invalid ``counts`` attribute.");
+        }
+      } else if (parser.PeekType() == kArrayType) {
+        annotation.tag_ = Annotation::POLYGON;
+        int coord_offset = 0;
+        auto& segm_meta = annotation.poly_.segm_meta_;
+        auto& segm_coords = annotation.poly_.segm_coords_;
+        parser.EnterArray();
+        while (parser.NextArrayValue()) {
+          segm_meta.push_back(coord_offset);
           parser.EnterArray();
           while (parser.NextArrayValue()) {
-            segm_meta.push_back(coord_offset);
-            parser.EnterArray();
-            while (parser.NextArrayValue()) {
-              segm_coords.push_back(parser.GetDouble());
-              coord_offset++;
-            }
-            segm_meta.push_back(coord_offset);
+            segm_coords.push_back(parser.GetDouble());
+            coord_offset++;
           }
-        } else {
-          parser.SkipValue();
+          segm_meta.push_back(coord_offset);
         }
       } else {
         parser.SkipValue();
       }
+    } else {
+      parser.SkipValue();
     }
-    if (!annotation.IsOver(min_size_threshold)) {
+  }
+  if (!annotation.IsOver(min_size_threshold)) {
+    return false;
+  }
+  if (ltrb) {
+    annotation.ToLtrb();
+  }
+  return true;
+}
+
+void ParseAnnotations(LookaheadParser &parser, std::vector<Annotation> &annotations,
+                      float min_size_threshold, bool ltrb,
+                      bool parse_segmentation, bool parse_rle) {
+  RAPIDJSON_ASSERT(parser.PeekType() == kArrayType);
+  parser.EnterArray();
+  while (parser.NextArrayValue()) {
+    detail::Annotation annotation;
+    if (ParseAnnotation(parser, annotation, min_size_threshold, ltrb,
+                        parse_segmentation, parse_rle)) {
+      annotations.emplace_back(std::move(annotation));
+    }
+  }
+}
+
+/**
+ * @brief Byte range of a JSON value
+ */
+struct JsonRange {
+  char *begin, *end;
+};
+
+inline char *SkipJsonWhitespace(char *p, char *end) {
+  while (p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t'))
+    p++;
+  return p;
+}
+
+enum JsonCharClass : uint8_t { kJsonOther = 0, kJsonQuote, kJsonOpen, kJsonClose };
+
+struct JsonCharClasses {
+  JsonCharClasses() {
+    std::memset(table, kJsonOther, sizeof(table));
+    table['"'] = kJsonQuote;
+    table['{'] = table['['] = kJsonOpen;
+    table['}'] = table[']'] = kJsonClose;
+  }
+  uint8_t table[256];
+};
+
+/**
+ * @brief Finds the end of the JSON value starting at `p`
+ *
+ * Only the structure of the document is scanned: strings are skipped and nesting is tracked,
+ * but the values are neither converted nor validated.
+ *
+ * @return pointer past the end of the value or nullptr, if the value is incomplete
+ */
+char *SkipJsonValue(char *p, char *end) {
+  static const JsonCharClasses classes;
+  auto char_class = [&](char c) { return classes.table[static_cast<uint8_t>(c)]; };
+  if (p < end && char_class(*p) == kJsonOther) {
+    // a number or a literal
+    while (p < end && *p != ',' && *p != '}' && *p != ']' && *p != ' ' &&
+           *p != '\n' && *p != '\r' && *p != '\t')
+      p++;
+    return p;
+  }
+  int depth = 0;
+  while (p < end) {
+    uint8_t cls = char_class(*p++);
+    if (cls == kJsonOther)
       continue;
+    if (cls == kJsonQuote) {
+      while (p < end && *p != '"')
+        p += *p == '\\' ? 2 : 1;
+      if (p >= end)
+        return nullptr;
+      p++;
+    } else if (cls == kJsonOpen) {
+      depth++;
+    } else if (--depth < 0) {
+      return nullptr;
     }
-    if (to_add) {
-      if (ltrb) {
-        annotation.ToLtrb();
-      }
+    if (depth == 0)
+      return p;
+  }
+  return nullptr;
+}
+
+/**
+ * @brief Finds the values of the top-level keys of a JSON object
+ *
+ * @return false, if the document has an unexpected structure or a key contains escape sequences
+ */
+bool ScanJsonObject(char *begin, char *end,
+                    std::vector<std::pair<std::string, JsonRange>> &values) {
+  char *p = SkipJsonWhitespace(begin, end);
+  if (p == end || *p++ != '{')
+    return false;
+  for (;;) {
+    p = SkipJsonWhitespace(p, end);
+    if (p < end && *p == '}')
+      return true;
+    if (p == end || *p != '"')
+      return false;
+    char *key_end = SkipJsonValue(p, end);
+    if (!key_end)
+      return false;
+    std::string key(p + 1, key_end - 1);
+    if (key.find('\\') != std::string::npos)
+      return false;  // the keys are compared without unescaping
+    p = SkipJsonWhitespace(key_end, end);
+    if (p == end || *p++ != ':')
+      return false;
+    p = SkipJsonWhitespace(p, end);
+    char *value_end = SkipJsonValue(p, end);
+    if (!value_end)
+      return false;
+    values.emplace_back(std::move(key), JsonRange{ p, value_end });
+    p = SkipJsonWhitespace(value_end, end);
+    if (p < end && *p == ',')
+      p++;
+  }
+}
+
+/**
+ * @brief Splits the elements of a JSON array into chunks of (roughly) `chunk_size` bytes
+ *
+ * Each chunk is a range of complete elements, separated by commas.
+ *
+ * @return false, if the array has an unexpected structure
+ */
+bool SplitJsonArray(JsonRange array, int64_t chunk_size, std::vector<JsonRange> &chunks) {
+  char *p = array.begin, *end = array.end - 1;  // without the brackets
+  if (*p++ != '[' || *end != ']')
+    return false;
+  JsonRange chunk = { nullptr, nullptr };
+  for (;;) {
+    p = SkipJsonWhitespace(p, end);
+    if (p == end)
+      break;
+    char *elem_end = SkipJsonValue(p, end);
+    if (!elem_end)
+      return false;
+    if (!chunk.begin)
+      chunk.begin = p;
+    chunk.end = elem_end;
+    if (chunk.end - chunk.begin >= chunk_size) {
+      chunks.push_back(chunk);
+      chunk = { nullptr, nullptr };
+    }
+    p = SkipJsonWhitespace(elem_end, end);
+    if (p < end && *p++ != ',')
+      return false;
+  }
+  if (chunk.begin)
+    chunks.push_back(chunk);
+  return true;
+}
+
+/**
+ * @brief Parses the annotations from a chunk produced by SplitJsonArray
+ *
+ * Each element is terminated in place and parsed on its own.
+ */
+void ParseAnnotationsChunk(JsonRange chunk, std::vector<Annotation> &annotations,
+                           float min_size_threshold, bool ltrb,
+                           bool parse_segmentation, bool parse_rle) {
+  char *p = chunk.begin;
+  while (p < chunk.end) {
+    char *elem_end = SkipJsonValue(p, chunk.end);
+    assert(elem_end);
+    char *next = SkipJsonWhitespace(elem_end, chunk.end);
+    *elem_end = '\0';
+    LookaheadParser parser(p);
+    detail::Annotation annotation;
+    if (ParseAnnotation(parser, annotation, min_size_threshold, ltrb,
+                        parse_segmentation, parse_rle)) {
       annotations.emplace_back(std::move(annotation));
     }
+    DALI_ENFORCE(parser.IsValid(), "Error parsing JSON file.");
+    p = next < chunk.end ? SkipJsonWhitespace(next + 1, chunk.end) : chunk.end;
+  }
+}
+
+/**
+ * @brief Parses the annotations file in parallel
+ *
+ * The document is scanned for the top-level values, which are then terminated in place and
+ * parsed independently. The ``annotations`` array is additionally split into chunks, which
+ * are parsed by the threads in the pool. The result is the same as parsing the document
+ * sequentially.
+ *
+ * @return false, if the document has an unexpected structure; the buffer is not modified then
+ */
+bool ParseJsonBufferParallel(char *buffer, size_t size, const OpSpec &spec,
+                             std::vector<detail::ImageInfo> &image_infos,
+                             std::vector<detail::Annotation> &annotations,
+                             std::map<int, int> &category_ids,
+                             bool parse_segmentation, bool parse_rle, ThreadPool &tp) {
+  std::vector<std::pair<std::string, JsonRange>> values;
+  if (!ScanJsonObject(buffer, buffer + size, values))
+    return false;
+
+  // at least a few chunks per thread, to balance the load
+  const int64_t kMinChunkSize = 1 << 20;
+  std::vector<std::vector<JsonRange>> annotation_chunks;
+  for (auto &value : values) {
+    if (value.first == "annotations") {
+      int64_t chunk_size = std::max<int64_t>(
+          (value.second.end - value.second.begin) / (tp.NumThreads() * 4), kMinChunkSize);
+      annotation_chunks.emplace_back();
+      if (!SplitJsonArray(value.second, chunk_size, annotation_chunks.back()))
+        return false;
+    }
+  }
+
+  // the values are separated by at least one character, which can be now overwritten
+  for (auto &value : values)
+    *value.second.end = '\0';
+
+  float sz_threshold = spec.GetArgument<float>("size_threshold");
+  bool ltrb = spec.GetArgument<bool>("ltrb");
+
+  std::vector<std::vector<detail::Annotation>> chunk_annotations;
+  for (auto &chunks : annotation_chunks)
+    chunk_annotations.resize(chunk_annotations.size() + chunks.size());
+  int chunk_idx = 0;
+  for (auto &chunks : annotation_chunks) {
+    for (auto chunk : chunks) {
+      auto &out = chunk_annotations[chunk_idx++];
+      tp.AddWork([&, chunk](int) {
+        ParseAnnotationsChunk(chunk, out, sz_threshold, ltrb, parse_segmentation, parse_rle);
+      }, chunk.end - chunk.begin);
+    }
+  }
+  tp.AddWork([&](int) {
+    for (auto &value : values) {
+      if (value.first == "images") {
+        LookaheadParser parser(value.second.begin);
+        if (parser.PeekType() == kArrayType)
+          detail::ParseImageInfo(parser, image_infos);
+        else
+          parser.SkipValue();
+      } else if (value.first == "categories") {
+        LookaheadParser parser(value.second.begin);
+        if (parser.PeekType() == kArrayType)
+          detail::ParseCategories(parser, category_ids);
+        else
+          parser.SkipValue();
+      }
+    }
+  });
+  tp.RunAll();
+
+  size_t total = annotations.size();
+  for (auto &chunk : chunk_annotations)
+    total += chunk.size();
+  annotations.reserve(total);
+  for (auto &chunk : chunk_annotations) {
+    annotations.insert(annotations.end(), std::make_move_iterator(chunk.begin()),
+                       std::make_move_iterator(chunk.end()));
+    chunk = {};
   }
+  return true;
 }
 
 void ParseJsonFile(const OpSpec &spec, std::vector<detail::ImageInfo> &image_infos,
                    std::vector<detail::Annotation> &annotations,
                    std::map<int, int> &category_ids,
-                   bool parse_segmentation, bool parse_rle) {
+                   bool parse_segmentation, bool parse_rle, ThreadPool &tp) {
   const auto annotations_file = spec.GetArgument<string>("annotations_file");
 
   std::ifstream f(annotations_file);
@@ -390,6 +629,10 @@ void ParseJsonFile(const OpSpec &spec, std::vector<detail::ImageInfo> &image_inf
   f.read(buff.get(), file_size);
   f.close();
 
+  if (ParseJsonBufferParallel(buff.get(), file_size, spec, image_infos, annotations,
+                              category_ids, parse_segmentation, parse_rle, tp))
+    return;
+
   detail::LookaheadParser parser(buff.get());
 
   RAPIDJSON_ASSERT(parser.PeekType() == kObjectType);
@@ -409,38 +652,307 @@ void ParseJsonFile(const OpSpec &spec, std::vector<detail::ImageInfo> &image_inf
   }
 }
 
+/**
+ * @brief Single-file preprocessed annotations
+ *
+ * Layout: FileHeader, `num_sections` SectionHeaders, followed by the section data. Each section
+ * is a plain array, aligned to kSectionAlignment bytes, so that it can be used directly from
+ * a memory mapping of the file.
+ */
+constexpr const char kAnnotationsFileName[] = "annotations.bin";
+constexpr char kAnnotationsFileMagic[8] = { 'D', 'A', 'L', 'I', 'C', 'O', 'C', 'O' };
+constexpr uint32_t kAnnotationsFileVersion = 1;
+constexpr int64_t kSectionAlignment = 64;
+
+enum class AnnotationSection : uint32_t {
+  Offsets = 0,
+  Boxes,
+  Labels,
+  Counts,
+  OriginalIds,
+  Heights,
+  Widths,
+  FilenameOffsets,  // number of images + 1 entries
+  FilenameChars,
+  PolygonData,
+  PolygonOffset,
+  PolygonCount,
+  Vertices,
+  VerticesOffset,
+  VerticesCount,
+  MaskRleCounts,
+  MaskRleOffsets,
+  MaskRleSizes,
+  MaskRleIdx,
+  MaskOffsets,
+  MaskCounts,
+};
+
+struct FileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t num_sections;
+};
+
+struct SectionHeader {
+  uint32_t id;
+  uint32_t element_size;
+  int64_t offset;  // in bytes, from the beginning of the file
+  int64_t count;   // in elements
+};
+
+class AnnotationsFileWriter {
+ public:
+  template <typename T>
+  void Add(AnnotationSection id, span<const T> data) {
+    sections_.push_back({ static_cast<uint32_t>(id), static_cast<uint32_t>(sizeof(T)),
+                          0, static_cast<int64_t>(data.size()) });
+    data_.push_back(data.data());
+  }
+
+  /**
+   * @brief Writes the file under a temporary name and renames it, so that the readers
+   *        never see a partially written file
+   */
+  void Save(const std::string &filename) {
+    int64_t offset = sizeof(FileHeader) + sections_.size() * sizeof(SectionHeader);
+    for (auto &section : sections_) {
+      offset = align_up(offset, kSectionAlignment);
+      section.offset = offset;
+      offset += section.count * section.element_size;
+    }
+
+    // unique, as several processes may write the same file at once
+    const std::string tmp_filename = filename + ".tmp." + std::to_string(getpid());
+    {
+      std::ofstream file(tmp_filename, std::ios_base::binary | std::ios_base::out);
+      DALI_ENFORCE(file, "CocoReader meta file error while saving: " + tmp_filename);
+      FileHeader header;
+      std::memcpy(header.magic, kAnnotationsFileMagic, sizeof(header.magic));
+      header.version = kAnnotationsFileVersion;
+      header.num_sections = sections_.size();
+      Write(file, header, tmp_filename.c_str());
+      Write(file, make_cspan(sections_), tmp_filename.c_str());
+      for (size_t i = 0; i < sections_.size(); i++) {
+        int64_t pos = file.tellp();
+        std::vector<char> padding(sections_[i].offset - pos, 0);
+        Write(file, make_cspan(padding), tmp_filename.c_str());
+        Write(file, span<const char>{ static_cast<const char *>(data_[i]),
+                                      sections_[i].count * sections_[i].element_size },
+              tmp_filename.c_str());
+      }
+    }
+    DALI_ENFORCE(std::rename(tmp_filename.c_str(), filename.c_str()) == 0,
+                 make_string("Cannot rename ", tmp_filename, " to ", filename, ": ",
+                             std::strerror(errno)));
+  }
+
+ private:
+  std::vector<SectionHeader> sections_;
+  std::vector<const void *> data_;
+};
+
+/**
+ * @brief Maps the whole file read-only. The mapping is shared with the other processes
+ *        that map the same file and is released when the last reference is gone.
+ */
+std::shared_ptr<const void> MapFile(const std::string &filename, int64_t &length) {
+  int fd = open(filename.c_str(), O_RDONLY);
+  DALI_ENFORCE(fd >= 0, make_string("Cannot open ", filename, ": ", std::strerror(errno)));
+  struct stat st;
+  if (fstat(fd, &st) < 0) {
+    int err = errno;
+    close(fd);
+    DALI_FAIL(make_string("Cannot stat ", filename, ": ", std::strerror(err)));
+  }
+  length = st.st_size;
+  DALI_ENFORCE(length >= static_cast<int64_t>(sizeof(FileHeader)),
+               make_string("Invalid preprocessed annotations file: ", filename));
+  void *ptr = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+  int err = errno;
+  close(fd);
+  DALI_ENFORCE(ptr != MAP_FAILED,
+               make_string("Cannot map ", filename, ": ", std::strerror(err)));
+  // the access pattern depends on the shard and shuffling - don't read ahead
+  madvise(ptr, length, MADV_RANDOM);
+  return std::shared_ptr<const void>(ptr, [length](const void *p) {
+    munmap(const_cast<void *>(p), length);
+  });
+}
+
+class AnnotationsFileReader {
+ public:
+  AnnotationsFileReader(const void *data, int64_t length, const std::string &filename)
+      : base_(static_cast<const char *>(data)), filename_(filename) {
+    FileHeader header;
+    std::memcpy(&header, base_, sizeof(header));
+    DALI_ENFORCE(!std::memcmp(header.magic, kAnnotationsFileMagic, sizeof(header.magic)),
+                 make_string("Not a preprocessed annotations file: ", filename));
+    DALI_ENFORCE(header.version == kAnnotationsFileVersion,
+                 make_string("Unsupported version of preprocessed annotations file: ",
+                             header.version, " in ", filename));
+    int64_t table_end = sizeof(FileHeader) + header.num_sections * sizeof(SectionHeader);
+    DALI_ENFORCE(table_end <= length,
+                 make_string("Preprocessed annotations file is truncated: ", filename));
+    sections_.resize(header.num_sections);
+    std::memcpy(sections_.data(), base_ + sizeof(FileHeader),
+                header.num_sections * sizeof(SectionHeader));
+    for (auto &section : sections_) {
+      DALI_ENFORCE(section.offset >= table_end && section.count >= 0 &&
+                   section.offset % kSectionAlignment == 0 &&
+                   section.count <= (length - section.offset) / std::max(section.element_size, 1u),
+                   make_string("Preprocessed annotations file is corrupted: ", filename));
+    }
+  }
+
+  bool Has(AnnotationSection id) const {
+    return Find(id) != nullptr;
+  }
+
+  /**
+   * @brief Points the array to the section data; a missing section results in an empty array
+   */
+  template <typename T>
+  void Map(AnnotationArray<T> &array, AnnotationSection id, bool required = false) const {
+    auto *section = Find(id);
+    if (!section) {
+      DALI_ENFORCE(!required, make_string("Preprocessed annotations file ", filename_,
+                                          " doesn't contain the data needed for the requested "
+                                          "outputs (section ", static_cast<uint32_t>(id), ")"));
+      array.map({});
+      return;
+    }
+    DALI_ENFORCE(section->element_size == sizeof(T),
+                 make_string("Preprocessed annotations file is corrupted: ", filename_));
+    array.map({ reinterpret_cast<const T *>(base_ + section->offset), section->count });
+  }
+
+ private:
+  const SectionHeader *Find(AnnotationSection id) const {
+    for (auto &section : sections_)
+      if (section.id == static_cast<uint32_t>(id))
+        return &section;
+    return nullptr;
+  }
+
+  const char *base_;
+  std::string filename_;
+  std::vector<SectionHeader> sections_;
+};
+
+/**
+ * @brief Checks that the offsets of the consecutive items (with the end offset as the last one)
+ *        start at 0, don't decrease and don't exceed `size`
+ */
+template <typename Offset>
+bool ValidOffsets(span<const Offset> offsets, int64_t size) {
+  if (offsets.empty() || offsets[0] != 0)
+    return false;
+  for (int64_t i = 1; i < offsets.size(); i++) {
+    if (offsets[i] < offsets[i - 1])
+      return false;
+  }
+  return offsets[offsets.size() - 1] <= size;
+}
+
+/**
+ * @brief Checks that there are `num` ranges [offsets[i], offsets[i] + counts[i])
+ *        and that they are within an array of `size` elements
+ */
+template <typename Offset, typename Count>
+bool ValidRanges(span<const Offset> offsets, span<const Count> counts, int64_t num,
+                 int64_t size) {
+  if (offsets.size() != num || counts.size() != num)
+    return false;
+  for (int64_t i = 0; i < num; i++) {
+    if (offsets[i] < 0 || counts[i] < 0 || offsets[i] > size - counts[i])
+      return false;
+  }
+  return true;
+}
+
 }  // namespace detail
 
 void CocoLoader::SavePreprocessedAnnotations(const std::string &path,
                                              const ImageIdPairs &image_id_pairs) {
   using detail::SaveToFile;
-  SaveToFile(offsets_, path + "/offsets.dat");
-  SaveToFile(boxes_, path + "/boxes.dat");
-  SaveToFile(labels_, path + "/labels.dat");
-  SaveToFile(counts_, path + "/counts.dat");
-  SaveToFile(image_id_pairs, path + "/filenames.dat");
+  SaveToFile(offsets_.cspan(), path + "/offsets.dat");
+  SaveToFile(boxes_.cspan(), path + "/boxes.dat");
+  SaveToFile(labels_.cspan(), path + "/labels.dat");
+  SaveToFile(counts_.cspan(), path + "/counts.dat");
+  SaveToFile(make_cspan(image_id_pairs), path + "/filenames.dat");
+
+  if (output_polygon_masks_ || output_pixelwise_masks_) {
+    SaveToFile(polygon_data_.cspan(), path + "/polygon_data.dat");
+    SaveToFile(polygon_offset_.cspan(), path + "/polygon_offset.dat");
+    SaveToFile(polygon_count_.cspan(), path + "/polygons_count.dat");
+    SaveToFile(vertices_data_.cspan(), path + "/vertices.dat");
+    SaveToFile(vertices_offset_.cspan(), path + "/vertices_offset.dat");
+    SaveToFile(vertices_count_.cspan(), path + "/vertices_count.dat");
+  }
+
+  if (output_pixelwise_masks_) {
+    detail::SaveRLEsToFile(masks_rle_counts_.cspan(), masks_rle_offsets_.cspan(),
+                           masks_rle_sizes_.cspan(), path + "/masks_rles.dat");
+    SaveToFile(masks_rles_idx_.cspan(), path + "/masks_rles_idx.dat");
+    SaveToFile(mask_offsets_.cspan(), path + "/masks_offset.dat");
+    SaveToFile(mask_counts_.cspan(), path + "/mask_count.dat");
+    SaveToFile(heights_.cspan(), path + "/heights.dat");
+    SaveToFile(widths_.cspan(), path + "/widths.dat");
+  }
+
+  if (output_image_ids_) {
+    SaveToFile(original_ids_.cspan(), path + "/original_ids.dat");
+  }
+
+  SavePreprocessedAnnotationsFile(path + "/" + detail::kAnnotationsFileName, image_id_pairs);
+}
+
+void CocoLoader::SavePreprocessedAnnotationsFile(const std::string &filename,
+                                                 const ImageIdPairs &image_id_pairs) {
+  using detail::AnnotationSection;
+  std::vector<int64_t> filename_offsets;
+  std::vector<char> filename_chars;
+  filename_offsets.reserve(image_id_pairs.size() + 1);
+  filename_offsets.push_back(0);
+  for (const auto &p : image_id_pairs) {
+    filename_chars.insert(filename_chars.end(), p.first.begin(), p.first.end());
+    filename_offsets.push_back(filename_chars.size());
+  }
+
+  detail::AnnotationsFileWriter writer;
+  writer.Add(AnnotationSection::Offsets, offsets_.cspan());
+  writer.Add(AnnotationSection::Boxes, boxes_.cspan());
+  writer.Add(AnnotationSection::Labels, labels_.cspan());
+  writer.Add(AnnotationSection::Counts, counts_.cspan());
+  writer.Add(AnnotationSection::FilenameOffsets, make_cspan(filename_offsets));
+  writer.Add(AnnotationSection::FilenameChars, make_cspan(filename_chars));
 
   if (output_polygon_masks_ || output_pixelwise_masks_) {
-    SaveToFile(polygon_data_, path + "/polygon_data.dat");
-    SaveToFile(polygon_offset_, path + "/polygon_offset.dat");
-    SaveToFile(polygon_count_, path + "/polygons_count.dat");
-    SaveToFile(vertices_data_, path + "/vertices.dat");
-    SaveToFile(vertices_offset_, path + "/vertices_offset.dat");
-    SaveToFile(vertices_count_, path + "/vertices_count.dat");
+    writer.Add(AnnotationSection::PolygonData, polygon_data_.cspan());
+    writer.Add(AnnotationSection::PolygonOffset, polygon_offset_.cspan());
+    writer.Add(AnnotationSection::PolygonCount, polygon_count_.cspan());
+    writer.Add(AnnotationSection::Vertices, vertices_data_.cspan());
+    writer.Add(AnnotationSection::VerticesOffset, vertices_offset_.cspan());
+    writer.Add(AnnotationSection::VerticesCount, vertices_count_.cspan());
   }
 
   if (output_pixelwise_masks_) {
-    SaveToFile(masks_rles_, path + "/masks_rles.dat");
-    SaveToFile(masks_rles_idx_, path + "/masks_rles_idx.dat");
-    SaveToFile(mask_offsets_, path + "/masks_offset.dat");
-    SaveToFile(mask_counts_, path + "/mask_count.dat");
-    SaveToFile(heights_, path + "/heights.dat");
-    SaveToFile(widths_, path + "/widths.dat");
+    writer.Add(AnnotationSection::MaskRleCounts, masks_rle_counts_.cspan());
+    writer.Add(AnnotationSection::MaskRleOffsets, masks_rle_offsets_.cspan());
+    writer.Add(AnnotationSection::MaskRleSizes, masks_rle_sizes_.cspan());
+    writer.Add(AnnotationSection::MaskRleIdx, masks_rles_idx_.cspan());
+    writer.Add(AnnotationSection::MaskOffsets, mask_offsets_.cspan());
+    writer.Add(AnnotationSection::MaskCounts, mask_counts_.cspan());
+    writer.Add(AnnotationSection::Heights, heights_.cspan());
+    writer.Add(AnnotationSection::Widths, widths_.cspan());
   }
 
   if (output_image_ids_) {
-    SaveToFile(original_ids_, path + "/original_ids.dat");
+    writer.Add(AnnotationSection::OriginalIds, original_ids_.cspan());
   }
+
+  writer.Save(filename);
 }
 
 void CocoLoader::ParsePreprocessedAnnotations() {
@@ -448,44 +960,203 @@ void CocoLoader::ParsePreprocessedAnnotations() {
   const auto path = spec_.HasArgument("meta_files_path")
       ? spec_.GetArgument<string>("meta_files_path")
       : spec_.GetArgument<string>("preprocessed_annotations");
+  const auto filename = path + "/" + detail::kAnnotationsFileName;
+  struct stat st;
+  if (stat(filename.c_str(), &st) == 0) {
+    MapPreprocessedAnnotationsFile(filename);
+  } else {
+    ParsePreprocessedAnnotationsDir(path);
+  }
+}
+
+void CocoLoader::MapPreprocessedAnnotationsFile(const std::string &filename) {
+  using detail::AnnotationSection;
+  int64_t length = 0;
+  annotations_file_ = detail::MapFile(filename, length);
+  detail::AnnotationsFileReader file(annotations_file_.get(), length, filename);
+
+  file.Map(offsets_, AnnotationSection::Offsets, true);
+  file.Map(boxes_, AnnotationSection::Boxes, true);
+  file.Map(labels_, AnnotationSection::Labels, true);
+  file.Map(counts_, AnnotationSection::Counts, true);
+
+  if (output_polygon_masks_ || output_pixelwise_masks_) {
+    file.Map(polygon_data_, AnnotationSection::PolygonData);
+    file.Map(polygon_offset_, AnnotationSection::PolygonOffset);
+    file.Map(polygon_count_, AnnotationSection::PolygonCount);
+    file.Map(vertices_data_, AnnotationSection::Vertices);
+    file.Map(vertices_offset_, AnnotationSection::VerticesOffset);
+    file.Map(vertices_count_, AnnotationSection::VerticesCount);
+  }
+
+  if (output_pixelwise_masks_) {
+    file.Map(masks_rle_counts_, AnnotationSection::MaskRleCounts, true);
+    file.Map(masks_rle_offsets_, AnnotationSection::MaskRleOffsets, true);
+    file.Map(masks_rle_sizes_, AnnotationSection::MaskRleSizes, true);
+    file.Map(masks_rles_idx_, AnnotationSection::MaskRleIdx, true);
+    file.Map(mask_offsets_, AnnotationSection::MaskOffsets, true);
+    file.Map(mask_counts_, AnnotationSection::MaskCounts, true);
+    file.Map(heights_, AnnotationSection::Heights, true);
+    file.Map(widths_, AnnotationSection::Widths, true);
+  }
+
+  if (output_image_ids_) {
+    file.Map(original_ids_, AnnotationSection::OriginalIds, true);
+  }
+
+  // FileLabelLoader needs the (image, id) pairs, the rest of the data is accessed lazily
+  detail::AnnotationArray<int64_t> filename_offsets;
+  detail::AnnotationArray<char> filename_chars;
+  file.Map(filename_offsets, AnnotationSection::FilenameOffsets, true);
+  file.Map(filename_chars, AnnotationSection::FilenameChars, true);
+  int64_t num_images = filename_offsets.size() - 1;
+
+  // The data is used as is, so a damaged file must not make the reader go out of the mapping
+  using detail::ValidOffsets;
+  using detail::ValidRanges;
+  bool valid = num_images >= 0 &&
+               ValidOffsets(filename_offsets.cspan(), filename_chars.size()) &&
+               ValidRanges(offsets_.cspan(), counts_.cspan(), num_images,
+                           std::min(boxes_.size() / 4, labels_.size()));
+  if (valid && !polygon_data_.empty() && !polygon_offset_.empty() && !polygon_count_.empty()) {
+    valid = ValidRanges(polygon_offset_.cspan(), polygon_count_.cspan(), num_images,
+                        polygon_data_.size());
+  }
+  if (valid && !vertices_data_.empty() && !vertices_offset_.empty() &&
+      !vertices_count_.empty()) {
+    valid = ValidRanges(vertices_offset_.cspan(), vertices_count_.cspan(), num_images,
+                        vertices_data_.size());
+  }
+  if (valid && output_pixelwise_masks_) {
+    // every mask has its index and size, and its RLE counts span from its offset to the next one
+    int64_t num_masks = masks_rle_offsets_.size() - 1;
+    valid = num_masks >= 0 && masks_rles_idx_.size() == num_masks &&
+            masks_rle_sizes_.size() == num_masks &&
+            ValidOffsets(masks_rle_offsets_.cspan(), masks_rle_counts_.size()) &&
+            ValidRanges(mask_offsets_.cspan(), mask_counts_.cspan(), num_images, num_masks) &&
+            heights_.size() == num_images && widths_.size() == num_images;
+  }
+  if (valid && output_image_ids_)
+    valid = original_ids_.size() == num_images;
+  DALI_ENFORCE(valid, make_string("Preprocessed annotations file is corrupted: ", filename));
+  image_label_pairs_.clear();
+  image_label_pairs_.reserve(num_images);
+  for (int64_t i = 0; i < num_images; i++) {
+    image_label_pairs_.emplace_back(
+        std::string(filename_chars.data() + filename_offsets[i],
+                    filename_chars.data() + filename_offsets[i + 1]),
+        static_cast<int>(i));
+  }
+}
+
+void CocoLoader::ParsePreprocessedAnnotationsDir(const std::string &path) {
   using detail::LoadFromFile;
-  LoadFromFile(offsets_, path + "/offsets.dat");
-  LoadFromFile(boxes_, path + "/boxes.dat");
-  LoadFromFile(labels_, path + "/labels.dat");
-  LoadFromFile(counts_, path + "/counts.dat");
+  LoadFromFile(offsets_.vec(), path + "/offsets.dat");
+  LoadFromFile(boxes_.vec(), path + "/boxes.dat");
+  LoadFromFile(labels_.vec(), path + "/labels.dat");
+  LoadFromFile(counts_.vec(), path + "/counts.dat");
   LoadFromFile(image_label_pairs_, path + "/filenames.dat");
 
   if (output_polygon_masks_ || output_pixelwise_masks_) {
-    LoadFromFile(polygon_data_, path + "/polygon_data.dat");
-    LoadFromFile(polygon_offset_, path + "/polygon_offset.dat");
-    LoadFromFile(polygon_count_, path + "/polygons_count.dat");
-    LoadFromFile(vertices_data_, path + "/vertices.dat");
-    LoadFromFile(vertices_offset_, path + "/vertices_offset.dat");
-    LoadFromFile(vertices_count_, path + "/vertices_count.dat");
+    LoadFromFile(polygon_data_.vec(), path + "/polygon_data.dat");
+    LoadFromFile(polygon_offset_.vec(), path + "/polygon_offset.dat");
+    LoadFromFile(polygon_count_.vec(), path + "/polygons_count.dat");
+    LoadFromFile(vertices_data_.vec(), path + "/vertices.dat");
+    LoadFromFile(vertices_offset_.vec(), path + "/vertices_offset.dat");
+    LoadFromFile(vertices_count_.vec(), path + "/vertices_count.dat");
   }
 
   if (output_pixelwise_masks_) {
-    LoadFromFile(masks_rles_, path + "/masks_rles.dat");
-    LoadFromFile(masks_rles_idx_, path + "/masks_rles_idx.dat");
-    LoadFromFile(mask_offsets_, path + "/masks_offset.dat");
-    LoadFromFile(mask_counts_, path + "/mask_count.dat");
-    LoadFromFile(heights_, path + "/heights.dat");
-    LoadFromFile(widths_, path + "/widths.dat");
+    detail::LoadRLEsFromFile(masks_rle_counts_.vec(), masks_rle_offsets_.vec(),
+                             masks_rle_sizes_.vec(), path + "/masks_rles.dat");
+    LoadFromFile(masks_rles_idx_.vec(), path + "/masks_rles_idx.dat");
+    LoadFromFile(mask_offsets_.vec(), path + "/masks_offset.dat");
+    LoadFromFile(mask_counts_.vec(), path + "/mask_count.dat");
+    LoadFromFile(heights_.vec(), path + "/heights.dat");
+    LoadFromFile(widths_.vec(), path + "/widths.dat");
   }
 
   if (output_image_ids_) {
-    LoadFromFile(original_ids_, path + "/original_ids.dat");
+    LoadFromFile(original_ids_.vec(), path + "/original_ids.dat");
   }
 }
 
 void CocoLoader::ParseJsonAnnotations() {
+  std::string cache_file;
+  bool from_cache = false;
+  if (HasAnnotationsCacheDir(spec_)) {
+    cache_file = AnnotationsCacheFile();
+    struct stat st;
+    if (stat(cache_file.c_str(), &st) == 0) {
+      MapPreprocessedAnnotationsFile(cache_file);
+      from_cache = true;
+    }
+  }
+
+  if (!from_cache) {
+    ParseJsonAnnotationsImpl();
+    if (!cache_file.empty())
+      SavePreprocessedAnnotationsFile(cache_file, image_label_pairs_);
+  }
+
+  // we don't need the list anymore and it can contain a lot of strings
+  images_.clear();
+
+  if (spec_.GetArgument<bool>("save_preprocessed_annotations")) {
+    SavePreprocessedAnnotations(
+      spec_.GetArgument<std::string>("save_preprocessed_annotations_dir"),
+      image_label_pairs_);
+  }
+}
+
+std::string CocoLoader::AnnotationsCacheFile() const {
+  const auto annotations_file = spec_.GetArgument<std::string>("annotations_file");
+  struct stat st;
+  DALI_ENFORCE(stat(annotations_file.c_str(), &st) == 0,
+               "Could not open JSON annotations file: \"" + annotations_file + "\"");
+  char *real_path = realpath(annotations_file.c_str(), nullptr);
+  std::string path = real_path ? real_path : annotations_file;
+  free(real_path);
+
+  // everything that affects the contents of the preprocessed annotations
+  std::stringstream key;
+  key << detail::kAnnotationsFileVersion << '\n'
+      << path << '\n'
+      << st.st_size << ' ' << st.st_mtim.tv_sec << ' ' << st.st_mtim.tv_nsec << '\n'
+      << spec_.GetArgument<bool>("skip_empty") << spec_.GetArgument<bool>("ratio")
+      << spec_.GetArgument<bool>("ltrb") << output_polygon_masks_ << output_pixelwise_masks_
+      << output_image_ids_ << ' ' << std::hexfloat << spec_.GetArgument<float>("size_threshold")
+      << '\n';
+  for (auto &image : images_)
+    key << image << '\n';
+
+  // 64-bit FNV-1a
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (char c : key.str()) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 0x100000001b3ull;
+  }
+
+  const auto dir = spec_.GetArgument<std::string>("annotations_cache_dir");
+  if (mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST)
+    DALI_FAIL(make_string("Cannot create the annotations cache directory ", dir, ": ",
+                          std::strerror(errno)));
+  std::stringstream filename;
+  filename << dir << "/coco_" << std::hex << std::setw(16) << std::setfill('0') << hash << ".bin";
+  return filename.str();
+}
+
+void CocoLoader::ParseJsonAnnotationsImpl() {
   std::vector<detail::ImageInfo> image_infos;
   std::vector<detail::Annotation> annotations;
   std::map<int, int> category_ids;
 
+  ThreadPool tp(std::max(spec_.GetArgument<int>("num_threads"), 1),
+                spec_.GetArgument<int>("device_id"), false);
+
   bool parse_segmentation = output_polygon_masks_ || output_pixelwise_masks_;
   detail::ParseJsonFile(spec_, image_infos, annotations, category_ids,
-                        parse_segmentation, output_pixelwise_masks_);
+                        parse_segmentation, output_pixelwise_masks_, tp);
 
   if (images_.empty()) {
     std::sort(image_infos.begin(), image_infos.end(), [&](auto &left, auto &right) {
@@ -497,9 +1168,9 @@ void CocoLoader::ParseJsonAnnotations() {
   }
 
   std::unordered_map<std::string, const detail::ImageInfo*> img_infos_map;
-  std::unordered_map<int, std::list<const detail::Annotation*>> img_annotations_map;
+  std::unordered_map<int, int> img_groups;  // image id -> group of annotations
   img_infos_map.reserve(images_.size());
-  img_annotations_map.reserve(images_.size());
+  img_groups.reserve(images_.size());
   for (const auto &filename : images_) {
     img_infos_map[filename] = nullptr;
   }
@@ -507,17 +1178,45 @@ void CocoLoader::ParseJsonAnnotations() {
     auto it = img_infos_map.find(info.filename_);
     if (it != img_infos_map.end()) {
       it->second = &info;
-      img_annotations_map[info.original_id_] = {};
+      img_groups.emplace(info.original_id_, img_groups.size());
     }
   }
 
-  for (const auto &annotation : annotations) {
-    auto it = img_annotations_map.find(annotation.image_id_);
-    if (it != img_annotations_map.end()) {
-      it->second.push_back(&annotation);
+  // Group the annotations by image, keeping their order: the groups are looked up
+  // in parallel and the annotations are then counting-sorted by group.
+  int num_groups = img_groups.size();
+  std::vector<int> annotation_group(annotations.size());
+  const int64_t kGroupingChunk = 1 << 16;
+  for (int64_t start = 0; start < static_cast<int64_t>(annotations.size());
+       start += kGroupingChunk) {
+    int64_t end = std::min<int64_t>(start + kGroupingChunk, annotations.size());
+    tp.AddWork([&, start, end](int) {
+      for (int64_t i = start; i < end; i++) {
+        auto it = img_groups.find(annotations[i].image_id_);
+        annotation_group[i] = it != img_groups.end() ? it->second : -1;
+      }
+    });
+  }
+  tp.RunAll();
+  std::vector<int64_t> group_offsets(num_groups + 1, 0);
+  for (int group : annotation_group) {
+    if (group >= 0)
+      group_offsets[group + 1]++;
+  }
+  for (int g = 0; g < num_groups; g++)
+    group_offsets[g + 1] += group_offsets[g];
+  std::vector<const detail::Annotation*> grouped_annotations(group_offsets[num_groups]);
+  {
+    std::vector<int64_t> pos(group_offsets.begin(), group_offsets.end() - 1);
+    for (size_t i = 0; i < annotations.size(); i++) {
+      if (annotation_group[i] >= 0)
+        grouped_annotations[pos[annotation_group[i]]++] = &annotations[i];
     }
   }
 
+  if (output_pixelwise_masks_)
+    masks_rle_offsets_.push_back(0);
+
   bool skip_empty = spec_.GetArgument<bool>("skip_empty");
   bool ratio = spec_.GetArgument<bool>("ratio");
 
@@ -536,9 +1235,13 @@ void CocoLoader::ParseJsonAnnotations() {
     int64_t sample_polygons_count = 0;
     int64_t sample_vertices_offset = vertices_data_.size();
     int64_t sample_vertices_count = 0;
-    int64_t mask_offset = masks_rles_.size();
+    int64_t mask_offset = masks_rles_idx_.size();
     int64_t mask_count = 0;
-    for (const auto* annotation_ptr : img_annotations_map[image_id]) {
+    int group = img_groups[image_id];
+    span<const detail::Annotation* const> image_annotations{
+        grouped_annotations.data() + group_offsets[group],
+        group_offsets[group + 1] - group_offsets[group]};
+    for (const auto* annotation_ptr : image_annotations) {
       const auto &annotation = *annotation_ptr;
       labels_.push_back(category_ids[annotation.category_id_]);
       if (ratio) {
@@ -585,8 +1288,12 @@ void CocoLoader::ParseJsonAnnotations() {
             break;
           }
           case detail::Annotation::RLE: {
+            const auto &rle = *annotation.rle_;
+            auto &rle_counts = masks_rle_counts_.vec();
             masks_rles_idx_.push_back(objects_in_sample);
-            masks_rles_.push_back(annotation.rle_);
+            rle_counts.insert(rle_counts.end(), rle->cnts, rle->cnts + rle->m);
+            masks_rle_offsets_.push_back(rle_counts.size());
+            masks_rle_sizes_.emplace_back(rle->h, rle->w);
             mask_count++;
             break;
           }
@@ -623,15 +1330,6 @@ void CocoLoader::ParseJsonAnnotations() {
       new_image_id++;
     }
   }
-
-  // we don't need the list anymore and it can contain a lot of strings
-  images_.clear();
-
-  if (spec_.GetArgument<bool>("save_preprocessed_annotations")) {
-    SavePreprocessedAnnotations(
-      spec_.GetArgument<std::string>("save_preprocessed_annotations_dir"),
-      image_label_pairs_);
-  }
 }
 
 }  // namespace dali
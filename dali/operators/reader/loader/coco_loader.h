@@ -16,6 +16,7 @@
 #define DALI_OPERATORS_READER_LOADER_COCO_LOADER_H_
 
 #include <algorithm>
+#include <cassert>
 #include <memory>
 #include <string>
 #include <vector>
@@ -26,6 +27,7 @@
 #include "dali/core/common.h"
 #include "dali/core/error_handling.h"
 #include "dali/core/geom/vec.h"
+#include "dali/core/span.h"
 #include "dali/core/unique_handle.h"
 
 extern "C" {
@@ -55,6 +57,11 @@ inline bool HasPreprocessedAnnotations(const OpSpec &spec) {
     (spec.HasArgument("meta_files_path") && spec.GetArgument<bool>("meta_files_path"));
 }
 
+inline bool HasAnnotationsCacheDir(const OpSpec &spec) {
+  return spec.HasArgument("annotations_cache_dir") &&
+    !spec.GetArgument<std::string>("annotations_cache_dir").empty();
+}
+
 inline bool HasSavePreprocessedAnnotations(const OpSpec &spec) {
   return spec.HasArgument("save_preprocessed_annotations") ||
     (spec.HasArgument("dump_meta_files") && spec.GetArgument<bool>("dump_meta_files"));
@@ -97,6 +104,48 @@ struct RLEMask : public UniqueHandle<RLE, RLEMask> {
 
 using RLEMaskPtr = std::shared_ptr<RLEMask>;
 
+namespace detail {
+
+/**
+ * @brief Read-only array of annotation data, which either owns its elements or refers
+ *        to external memory (a memory-mapped preprocessed annotations file)
+ *
+ * The owned storage can be built with `push_back`/`emplace_back` or accessed with `vec()`.
+ */
+template <typename T>
+class AnnotationArray {
+ public:
+  const T *data() const { return mapped_ ? view_.data() : owned_.data(); }
+  int64_t size() const { return mapped_ ? view_.size() : owned_.size(); }
+  bool empty() const { return size() == 0; }
+  const T &operator[](int64_t idx) const { return data()[idx]; }
+  span<const T> cspan() const { return { data(), size() }; }
+
+  void push_back(const T &value) { owned_.push_back(value); }
+
+  template <typename... Args>
+  void emplace_back(Args &&...args) { owned_.emplace_back(std::forward<Args>(args)...); }
+
+  std::vector<T> &vec() {
+    assert(!mapped_);
+    return owned_;
+  }
+
+  void map(span<const T> data) {
+    owned_.clear();
+    owned_.shrink_to_fit();
+    view_ = data;
+    mapped_ = true;
+  }
+
+ private:
+  std::vector<T> owned_;
+  span<const T> view_;
+  bool mapped_ = false;
+};
+
+}  // namespace detail
+
 class DLL_PUBLIC CocoLoader : public FileLabelLoader {
  public:
   explicit inline CocoLoader(const OpSpec &spec)
@@ -106,7 +155,8 @@ class DLL_PUBLIC CocoLoader : public FileLabelLoader {
         "Either ``annotations_file`` or ``preprocessed_annotations`` must be provided");
     if (has_preprocessed_annotations_) {
       for (const char* arg_name : {"annotations_file", "skip_empty", "ratio", "ltrb", "images",
-                                   "size_threshold", "dump_meta_files", "dump_meta_files_path"}) {
+                                   "size_threshold", "dump_meta_files", "dump_meta_files_path",
+                                   "annotations_cache_dir"}) {
         if (spec.HasArgument(arg_name))
           DALI_FAIL(make_string("When reading data from preprocessed annotation files, \"",
                                 arg_name, "\" is not supported."));
@@ -129,8 +179,17 @@ class DLL_PUBLIC CocoLoader : public FileLabelLoader {
 
   struct PixelwiseMasksInfo {
     TensorShape<3> shape;
-    span<const RLEMaskPtr> rles;
     span<const int> mask_indices;
+    span<const ivec2> rle_sizes;        // (height, width) of each RLE mask
+    span<const int64_t> rle_offsets;    // offsets of the counts of each mask (plus the end)
+    const uint32_t *rle_counts;
+
+    /**
+     * @brief Column-major run-length counts of i-th mask, starting with the background
+     */
+    span<const uint32_t> counts(int i) const {
+      return { rle_counts + rle_offsets[i], rle_offsets[i + 1] - rle_offsets[i] };
+    }
   };
 
   struct PolygonMasksInfo {
@@ -154,10 +213,13 @@ class DLL_PUBLIC CocoLoader : public FileLabelLoader {
 
   PixelwiseMasksInfo pixelwise_masks_info(int image_idx) const {
     assert(output_pixelwise_masks_);
+    int64_t first = mask_offsets_[image_idx];
     return {
       {heights_[image_idx], widths_[image_idx], 1},
-      {masks_rles_.data() + mask_offsets_[image_idx], mask_counts_[image_idx]},
-      {masks_rles_idx_.data() + mask_offsets_[image_idx], mask_counts_[image_idx]}
+      {masks_rles_idx_.data() + first, mask_counts_[image_idx]},
+      {masks_rle_sizes_.data() + first, mask_counts_[image_idx]},
+      {masks_rle_offsets_.data() + first, mask_counts_[image_idx] + 1},
+      masks_rle_counts_.data()
     };
   }
 
@@ -195,35 +257,70 @@ class DLL_PUBLIC CocoLoader : public FileLabelLoader {
 
   void ParsePreprocessedAnnotations();
 
+  /**
+   * @brief Parses the legacy preprocessed annotations format - one file per array
+   */
+  void ParsePreprocessedAnnotationsDir(const std::string &path);
+
+  /**
+   * @brief Maps the single-file preprocessed annotations
+   *
+   * The annotation arrays point directly to the mapped file, so the pages are loaded
+   * on first access and shared by all the processes that read the same file.
+   */
+  void MapPreprocessedAnnotationsFile(const std::string &filename);
+
+  /**
+   * @brief Parses the JSON annotations or, if ``annotations_cache_dir`` is given, maps
+   *        the cached result of parsing them, creating it if necessary
+   */
   void ParseJsonAnnotations();
 
+  void ParseJsonAnnotationsImpl();
+
+  /**
+   * @brief Path of the cached preprocessed annotations, specific to the annotations file
+   *        (including its size and modification time) and the arguments that affect parsing
+   */
+  std::string AnnotationsCacheFile() const;
+
   void SavePreprocessedAnnotations(const std::string &path, const ImageIdPairs &image_id_pairs);
 
+  void SavePreprocessedAnnotationsFile(const std::string &filename,
+                                       const ImageIdPairs &image_id_pairs);
+
  private:
+  template <typename T>
+  using AnnotationArray = detail::AnnotationArray<T>;
+
   const OpSpec &spec_;
 
-  std::vector<int> heights_;
-  std::vector<int> widths_;
-  std::vector<int> offsets_;
-  std::vector<float> boxes_;
-  std::vector<int> labels_;
-  std::vector<int> counts_;
-  std::vector<int> original_ids_;
+  AnnotationArray<int> heights_;
+  AnnotationArray<int> widths_;
+  AnnotationArray<int> offsets_;
+  AnnotationArray<float> boxes_;
+  AnnotationArray<int> labels_;
+  AnnotationArray<int> counts_;
+  AnnotationArray<int> original_ids_;
 
   // polygons: (mask_idx, offset, size)
-  std::vector<ivec3> polygon_data_;
-  std::vector<int64_t> polygon_offset_;  // per-sample offset of polygons
-  std::vector<int64_t> polygon_count_;   // number of polygon per sample
+  AnnotationArray<ivec3> polygon_data_;
+  AnnotationArray<int64_t> polygon_offset_;  // per-sample offset of polygons
+  AnnotationArray<int64_t> polygon_count_;   // number of polygon per sample
   // vertices: (all polygons concatenated)
-  std::vector<vec2> vertices_data_;
-  std::vector<int64_t> vertices_offset_;  // per-sample offset of vertices
-  std::vector<int64_t> vertices_count_;   // number of vertices per sample
-
-  // masks_rles: (run-length encodings)
-  std::vector<RLEMaskPtr> masks_rles_;
-  std::vector<int> masks_rles_idx_;
-  std::vector<int64_t> mask_offsets_;  // per-sample offsets of masks
-  std::vector<int64_t> mask_counts_;   // number of masks per sample
+  AnnotationArray<vec2> vertices_data_;
+  AnnotationArray<int64_t> vertices_offset_;  // per-sample offset of vertices
+  AnnotationArray<int64_t> vertices_count_;   // number of vertices per sample
+
+  // run-length encoded masks: counts of all masks concatenated
+  AnnotationArray<uint32_t> masks_rle_counts_;
+  AnnotationArray<int64_t> masks_rle_offsets_;  // offsets of the counts of each mask (plus end)
+  AnnotationArray<ivec2> masks_rle_sizes_;      // (height, width) of each mask
+  AnnotationArray<int> masks_rles_idx_;
+  AnnotationArray<int64_t> mask_offsets_;  // per-sample offsets of masks
+  AnnotationArray<int64_t> mask_counts_;   // number of masks per sample
+
+  std::shared_ptr<const void> annotations_file_;  // keeps the mapping alive
 
   bool output_polygon_masks_ = false;
   bool output_pixelwise_masks_ = false;
@@ -0,0 +1,47 @@
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/operators/reader/loader/encoded_sample_cache.h"
+#include <utility>
+#include "dali/core/error_handling.h"
+
+namespace dali {
+
+EncodedSampleCache::EncodedSampleCache(int64_t budget, int64_t chunk_size)
+    : budget_(budget), arena_(chunk_size) {
+  DALI_ENFORCE(budget >= 0, "The budget of the encoded sample cache cannot be negative");
+}
+
+std::shared_ptr<uint8_t> EncodedSampleCache::Get(const std::string &key, int64_t &size) const {
+  auto it = entries_.find(key);
+  if (it == entries_.end())
+    return nullptr;
+  size = it->second.size;
+  return it->second.data;
+}
+
+std::shared_ptr<uint8_t> EncodedSampleCache::Allocate(int64_t size) {
+  DALI_ENFORCE(size >= 0, "The size of a sample cannot be negative");
+  if (budget_ > 0 && bytes_ + size > budget_)
+    return nullptr;
+  bytes_ += size;
+  return arena_.allocate(size);
+}
+
+void EncodedSampleCache::Insert(const std::string &key, std::shared_ptr<uint8_t> data,
+                                int64_t size) {
+  entries_[key] = { std::move(data), size };
+}
+
+}  // namespace dali
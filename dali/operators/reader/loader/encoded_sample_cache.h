@@ -0,0 +1,88 @@
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_OPERATORS_READER_LOADER_ENCODED_SAMPLE_CACHE_H_
+#define DALI_OPERATORS_READER_LOADER_ENCODED_SAMPLE_CACHE_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "dali/core/api_helper.h"
+#include "dali/core/mm/chunked_host_arena.h"
+
+namespace dali {
+
+/**
+ * @brief Keeps the encoded data of the samples read by a loader in memory
+ *
+ * The data is stored in a chunked_host_arena. A sample, once added, stays in the cache for its
+ * whole lifetime. The data can be shared with tensors without copying and remains valid as long
+ * as any tensor uses it, even if the cache is destroyed.
+ *
+ * The cache is not thread-safe - it's meant to be used by the thread that reads the samples.
+ */
+class DLL_PUBLIC EncodedSampleCache {
+ public:
+  static constexpr int64_t kDefaultChunkSize = mm::chunked_host_arena::kDefaultChunkSize;
+
+  /**
+   * @param budget     maximum total size of the cached samples, in bytes; 0 means no limit
+   * @param chunk_size chunk size of the underlying arena
+   */
+  explicit EncodedSampleCache(int64_t budget = 0, int64_t chunk_size = kDefaultChunkSize);
+
+  /**
+   * @brief Returns the data of the sample with given key, or nullptr if it's not cached
+   */
+  std::shared_ptr<uint8_t> Get(const std::string &key, int64_t &size) const;
+
+  /**
+   * @brief Allocates space for the data of a sample, to be filled and then passed to Insert
+   *
+   * Returns nullptr if the sample would exceed the budget.
+   */
+  std::shared_ptr<uint8_t> Allocate(int64_t size);
+
+  /**
+   * @brief Adds the data of a sample, allocated with Allocate, to the cache
+   */
+  void Insert(const std::string &key, std::shared_ptr<uint8_t> data, int64_t size);
+
+  /**
+   * @brief Total size of the allocated samples, in bytes
+   */
+  int64_t bytes() const {
+    return bytes_;
+  }
+
+  int64_t num_samples() const {
+    return entries_.size();
+  }
+
+ private:
+  struct Entry {
+    std::shared_ptr<uint8_t> data;
+    int64_t size;
+  };
+
+  int64_t budget_;
+  int64_t bytes_ = 0;
+  mm::chunked_host_arena arena_;
+  std::unordered_map<std::string, Entry> entries_;
+};
+
+}  // namespace dali
+
+#endif  // DALI_OPERATORS_READER_LOADER_ENCODED_SAMPLE_CACHE_H_
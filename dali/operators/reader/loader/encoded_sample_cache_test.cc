@@ -0,0 +1,78 @@
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "dali/operators/reader/loader/encoded_sample_cache.h"
+
+namespace dali {
+
+TEST(EncodedSampleCache, AddAndGet) {
+  EncodedSampleCache cache(0, 1024);
+  std::vector<int64_t> sizes = { 10, 0, 100, 255, 1000, 3, 256, 300, 5000 };
+  std::vector<const uint8_t *> ptrs;
+  for (size_t i = 0; i < sizes.size(); i++) {
+    auto data = cache.Allocate(sizes[i]);
+    ASSERT_NE(data, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(data.get()) % 64, 0u);
+    memset(data.get(), static_cast<int>(i), sizes[i]);
+    cache.Insert("sample" + std::to_string(i), data, sizes[i]);
+    ptrs.push_back(data.get());
+  }
+  EXPECT_EQ(cache.num_samples(), static_cast<int64_t>(sizes.size()));
+
+  int64_t total = 0;
+  for (size_t i = 0; i < sizes.size(); i++) {
+    int64_t size = -1;
+    auto data = cache.Get("sample" + std::to_string(i), size);
+    ASSERT_NE(data, nullptr);
+    EXPECT_EQ(size, sizes[i]);
+    EXPECT_EQ(data.get(), ptrs[i]);
+    for (int64_t j = 0; j < size; j++)
+      ASSERT_EQ(data.get()[j], i) << "sample " << i;
+    total += sizes[i];
+  }
+  EXPECT_EQ(cache.bytes(), total);
+
+  int64_t size = -1;
+  EXPECT_EQ(cache.Get("missing", size), nullptr);
+  EXPECT_EQ(size, -1);
+}
+
+TEST(EncodedSampleCache, Budget) {
+  EncodedSampleCache cache(1000, 4096);
+  EXPECT_NE(cache.Allocate(600), nullptr);
+  EXPECT_EQ(cache.Allocate(500), nullptr);
+  EXPECT_NE(cache.Allocate(400), nullptr);
+  EXPECT_EQ(cache.Allocate(1), nullptr);
+  EXPECT_EQ(cache.bytes(), 1000);
+}
+
+TEST(EncodedSampleCache, DataOutlivesCache) {
+  std::shared_ptr<uint8_t> data;
+  {
+    EncodedSampleCache cache(0, 1024);
+    auto allocated = cache.Allocate(16);
+    memset(allocated.get(), 42, 16);
+    cache.Insert("x", allocated, 16);
+    int64_t size;
+    data = cache.Get("x", size);
+  }
+  for (int i = 0; i < 16; i++)
+    EXPECT_EQ(data.get()[i], 42);
+}
+
+}  // namespace dali
@@ -28,7 +28,12 @@ void FileLabelLoader::PrepareEmpty(ImageLabelWrapper &image_label) {
 }
 
 void FileLabelLoader::ReadSample(ImageLabelWrapper &image_label) {
-  auto image_pair = image_label_pairs_[current_index_++];
+  auto image_pair = image_label_pairs_[current_index_];
+  int64 cached_size = 0;
+  auto cached = GetCachedSample(image_pair.first, cached_size);
+  if (!cached)
+    AdvisePageCache(current_index_);
+  current_index_++;
 
   // handle wrap-around
   MoveToNextShard(current_index_);
@@ -49,28 +54,37 @@ void FileLabelLoader::ReadSample(ImageLabelWrapper &image_label) {
     return;
   }
 
-  auto current_image = FileStream::Open(filesystem::join_path(file_root_, image_pair.first),
-                                        read_ahead_, !copy_read_data_);
-  Index image_size = current_image->Size();
+  if (cached) {
+    // the encoded data is kept in memory - the file is not accessed
+    image_label.image.ShareData(cached, cached_size, {cached_size});
+    image_label.image.set_type(TypeInfo::Create<uint8_t>());
+  } else {
+    auto current_image = FileStream::Open(filesystem::join_path(file_root_, image_pair.first),
+                                          read_ahead_, !copy_read_data_);
+    Index image_size = current_image->Size();
 
-  if (copy_read_data_) {
-    if (image_label.image.shares_data()) {
-      image_label.image.Reset();
+    if ((cached = CacheSample(image_pair.first, *current_image, image_size))) {
+      image_label.image.ShareData(cached, image_size, {image_size});
+      image_label.image.set_type(TypeInfo::Create<uint8_t>());
+    } else if (copy_read_data_) {
+      if (image_label.image.shares_data()) {
+        image_label.image.Reset();
+      }
+      image_label.image.Resize({image_size});
+      // copy the image
+      Index ret = current_image->Read(image_label.image.mutable_data<uint8_t>(), image_size);
+      DALI_ENFORCE(ret == image_size, make_string("Failed to read file: ", image_pair.first));
+    } else {
+      auto p = current_image->Get(image_size);
+      DALI_ENFORCE(p != nullptr, make_string("Failed to read file: ", image_pair.first));
+      // Wrap the raw data in the Tensor object.
+      image_label.image.ShareData(p, image_size, {image_size});
+      image_label.image.set_type(TypeInfo::Create<uint8_t>());
     }
-    image_label.image.Resize({image_size});
-    // copy the image
-    Index ret = current_image->Read(image_label.image.mutable_data<uint8_t>(), image_size);
-    DALI_ENFORCE(ret == image_size, make_string("Failed to read file: ", image_pair.first));
-  } else {
-    auto p = current_image->Get(image_size);
-    DALI_ENFORCE(p != nullptr, make_string("Failed to read file: ", image_pair.first));
-    // Wrap the raw data in the Tensor object.
-    image_label.image.ShareData(p, image_size, {image_size});
-    image_label.image.set_type(TypeInfo::Create<uint8_t>());
-  }
 
-  // close the file handle
-  current_image->Close();
+    // close the file handle
+    current_image->Close();
+  }
 
   // copy the label
   image_label.label = image_pair.second;
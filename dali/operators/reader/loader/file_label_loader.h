@@ -116,9 +116,21 @@ class DLL_PUBLIC FileLabelLoader : public Loader<CPUBackend, ImageLabelWrapper>
   void PrepareEmpty(ImageLabelWrapper &tensor) override;
   void ReadSample(ImageLabelWrapper &tensor) override;
 
+  void Skip() override {
+    ++current_index_;
+    MoveToNextShard(current_index_);
+  }
+
  protected:
   Index SizeImpl() override;
 
+  bool GetFileRange(Index index, FileRange &range) override {
+    range.path = filesystem::join_path(file_root_, image_label_pairs_[index].first);
+    range.offset = 0;
+    range.length = 0;
+    return true;
+  }
+
   void PrepareMetadataImpl() override {
     if (image_label_pairs_.empty()) {
       if (!has_file_list_arg_ && !has_files_arg_) {
@@ -107,7 +107,13 @@ class FileLoader : public Loader<Backend, Target> {
     image_file.filename = "";
   }
 
+  void Skip() override {
+    ++current_index_;
+    MoveToNextShard(current_index_);
+  }
+
   void ReadSample(Target &imfile) override {
+    AdvisePageCache(current_index_);
     auto image_file = images_[current_index_++];
 
     // handle wrap-around
@@ -160,10 +166,19 @@ class FileLoader : public Loader<Backend, Target> {
   }
 
  protected:
+  using FileRange = typename Loader<Backend, Target>::FileRange;
+
   Index SizeImpl() override {
     return static_cast<Index>(images_.size());
   }
 
+  bool GetFileRange(Index index, FileRange &range) override {
+    range.path = filesystem::join_path(file_root_, images_[index]);
+    range.offset = 0;
+    range.length = 0;
+    return true;
+  }
+
   void PrepareMetadataImpl() override {
     if (images_.empty()) {
       if (!has_files_arg_ && !has_file_list_arg_) {
@@ -218,6 +233,7 @@ class FileLoader : public Loader<Backend, Target> {
   using Loader<Backend, Target>::read_ahead_;
   using Loader<Backend, Target>::MoveToNextShard;
   using Loader<Backend, Target>::ShouldSkipImage;
+  using Loader<Backend, Target>::AdvisePageCache;
   using Loader<Backend, Target>::Size;
   using Loader<Backend, Target>::PrepareEmptyTensor;
 
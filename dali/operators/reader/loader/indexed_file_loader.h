@@ -42,14 +42,19 @@ class IndexedFileLoader : public Loader<CPUBackend, Tensor<CPUBackend>> {
     int64 seek_pos, size;
     size_t file_index;
     std::tie(seek_pos, size, file_index) = indices_[current_index_];
-    ++current_index_;
 
     std::string image_key = uris_[file_index] + " at index " + to_string(seek_pos);
     DALIMeta meta;
     meta.SetSourceInfo(image_key);
     meta.SetSkipSample(false);
 
-    if (file_index != current_file_index_) {
+    int64 cached_size = 0;
+    auto cached = GetCachedSample(image_key, cached_size);
+    if (!cached)
+      AdvisePageCache(current_index_);
+    ++current_index_;
+
+    if (!cached && file_index != current_file_index_) {
       current_file_->Close();
       current_file_ = FileStream::Open(uris_[file_index], read_ahead_, !copy_read_data_);
       current_file_index_ = file_index;
@@ -66,13 +71,25 @@ class IndexedFileLoader : public Loader<CPUBackend, Tensor<CPUBackend>> {
       return;
     }
 
+    if (cached) {
+      // the encoded data is kept in memory - the file is not accessed
+      should_seek_ = true;
+      tensor.ShareData(cached, cached_size, {cached_size});
+      tensor.set_type(TypeInfo::Create<uint8_t>());
+      tensor.SetMeta(meta);
+      return;
+    }
+
     if (should_seek_ || next_seek_pos_ != seek_pos) {
       current_file_->Seek(seek_pos);
       should_seek_ = false;
     }
     next_seek_pos_ = seek_pos + size;
 
-    if (!copy_read_data_) {
+    if ((cached = CacheSample(image_key, *current_file_, size))) {
+      tensor.ShareData(cached, size, {size});
+      tensor.set_type(TypeInfo::Create<uint8_t>());
+    } else if (!copy_read_data_) {
       auto p = current_file_->Get(size);
       DALI_ENFORCE(p != nullptr, "Error reading from a file " + uris_[current_file_index_]);
       // Wrap the raw data in the Tensor object.
@@ -94,6 +111,22 @@ class IndexedFileLoader : public Loader<CPUBackend, Tensor<CPUBackend>> {
     return;
   }
 
+  void Skip() override {
+    MoveToNextShard(current_index_);
+    ++current_index_;
+    // make sure that the file holding the next sample is opened, so the following
+    // ReadSample can seek to its position
+    if (current_index_ < indices_.size()) {
+      size_t file_index = std::get<2>(indices_[current_index_]);
+      if (file_index != current_file_index_) {
+        current_file_->Close();
+        current_file_ = FileStream::Open(uris_[file_index], read_ahead_, !copy_read_data_);
+        current_file_index_ = file_index;
+      }
+    }
+    should_seek_ = true;
+  }
+
   ~IndexedFileLoader() override {
     if (current_file_ != nullptr) {
       current_file_->Close();
@@ -119,6 +152,16 @@ class IndexedFileLoader : public Loader<CPUBackend, Tensor<CPUBackend>> {
     return indices_.size();
   }
 
+  bool GetFileRange(Index index, FileRange &range) override {
+    int64 seek_pos, size;
+    size_t file_index;
+    std::tie(seek_pos, size, file_index) = indices_[index];
+    range.path = uris_[file_index];
+    range.offset = seek_pos;
+    range.length = size;
+    return true;
+  }
+
   void PrepareMetadataImpl() override {
     if (!dont_use_mmap_) {
       mmap_reserver_ = FileStream::MappingReserver(
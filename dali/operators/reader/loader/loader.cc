@@ -65,6 +65,29 @@ in the constructor.)code", false)
 .. note::
   If the number of batches differs across shards, this option can cause an entire batch of repeated
   samples to be added to the dataset.)code", false)
+  .AddOptionalArg("page_cache_readahead",
+      R"code(Number of upcoming samples for which the reader asks the operating system to
+load the data into the page cache in advance.
+
+The reader knows the order in which it accesses the data, so this is more accurate than
+the kernel's own readahead, especially for datasets that don't fit in memory. The value of 0
+disables the hints.)code", 0)
+  .AddOptionalArg("page_cache_drop_consumed",
+      R"code(If set to True, the reader asks the operating system to drop the data of
+the consumed samples from the page cache.
+
+Useful for datasets larger than the memory that are read once per epoch, as it leaves
+the page cache for the data that is still going to be used.)code", false)
+  .AddOptionalArg("page_cache_budget",
+      R"code(Maximum size, in bytes, of the data read by the reader that is kept in the page
+cache.
+
+When the size of the data read and not yet dropped exceeds the budget, the reader asks
+the operating system to drop the least recently read samples from the page cache. This keeps
+the memory footprint of the reader predictable, so reading a large dataset doesn't push out
+the working sets of other processes. The data requested with ``page_cache_readahead`` and
+the data of the samples still in use may exceed the budget. The value of 0 means no limit.)code",
+      0)
 .AddOptionalArg("dont_use_mmap",
       R"code(If set to True, the Loader will use plain file I/O instead of trying to map
 the file in memory.
@@ -73,6 +96,23 @@ Mapping provides a small performance benefit when accessing a local file system,
 systems, do not provide optimum performance.
 )code", false);
 
+// Arguments of the readers whose loaders can keep the encoded samples in memory
+DALI_SCHEMA(EncodedSampleCacheAttr)
+  .DocStr(R"code(Attributes for the in-memory cache of encoded samples.)code")
+  .AddOptionalArg("cache_encoded_samples",
+      R"code(If set to True, the reader keeps the encoded data of the samples in memory.
+
+The samples are read from the storage the first time they are accessed, usually in the first
+epoch, and then served from memory, so the following epochs don't depend on the performance of
+the storage. Use it only if the data read by this reader fits in the memory, or limit
+the size of the cache with ``encoded_cache_budget``.)code", false)
+  .AddOptionalArg("encoded_cache_budget",
+      R"code(Maximum size, in bytes, of the data kept in memory when ``cache_encoded_samples``
+is set.
+
+The samples that don't fit in the budget are read from the storage in every epoch.
+The value of 0 means no limit.)code", 0);
+
 size_t start_index(const size_t shard_id,
                    const size_t shard_num,
                    const size_t size) {
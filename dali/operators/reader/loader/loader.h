@@ -15,6 +15,7 @@
 #ifndef DALI_OPERATORS_READER_LOADER_LOADER_H_
 #define DALI_OPERATORS_READER_LOADER_LOADER_H_
 
+#include <algorithm>
 #include <list>
 #include <map>
 #include <memory>
@@ -33,6 +34,8 @@
 #include "dali/pipeline/operator/op_spec.h"
 #include "dali/pipeline/data/tensor.h"
 #include "dali/operators/decoder/cache/image_cache_factory.h"
+#include "dali/operators/reader/loader/encoded_sample_cache.h"
+#include "dali/util/file.h"
 
 namespace dali {
 
@@ -73,9 +76,21 @@ class Loader {
       read_sample_counter_(0),
       returned_sample_counter_(0),
       pad_last_batch_(options.GetArgument<bool>("pad_last_batch")),
-      dont_use_mmap_(options.GetArgument<bool>("dont_use_mmap")) {
+      dont_use_mmap_(options.GetArgument<bool>("dont_use_mmap")),
+      page_cache_readahead_(options.GetArgument<int>("page_cache_readahead")),
+      page_cache_drop_consumed_(options.GetArgument<bool>("page_cache_drop_consumed")),
+      page_cache_budget_(options.GetArgument<int64_t>("page_cache_budget")) {
     DALI_ENFORCE(initial_empty_size_ > 0, "Batch size needs to be greater than 0");
+    DALI_ENFORCE(page_cache_readahead_ >= 0, "page_cache_readahead cannot be negative");
+    DALI_ENFORCE(page_cache_budget_ >= 0, "page_cache_budget cannot be negative");
     DALI_ENFORCE(num_shards_ > shard_id_, "num_shards needs to be greater than shard_id");
+    // only the readers whose loaders use the cache accept the argument
+    bool cache_encoded_samples = false;
+    if (options.TryGetArgument(cache_encoded_samples, "cache_encoded_samples") &&
+        cache_encoded_samples) {
+      encoded_cache_ = std::make_unique<EncodedSampleCache>(
+          options.GetArgument<int64_t>("encoded_cache_budget"));
+    }
     // initialize a random distribution -- this will be
     // used to pick from our sample buffer
     std::seed_seq seq({seed_});
@@ -201,6 +216,110 @@ class Loader {
     return sample_ptr;
   }
 
+  /**
+   * @brief Brings the loader to the state it would have after `samples_to_skip` calls
+   *        to ReadOne, issued in batches of `batch_size`, without reading the samples
+   *        that are not needed anymore.
+   *
+   * The bookkeeping of ReadOne (shuffle buffer slots, shard boundaries, padding and the
+   * random engine) is replayed on sample ordinals first. Then the underlying source is
+   * advanced, actually reading only the samples that end up in the shuffle buffer (and the
+   * last returned one, which may be needed for padding) and skipping all the others.
+   *
+   * Must be called before the first ReadOne.
+   */
+  void FastForward(Index samples_to_skip, int batch_size) {
+    PrepareMetadata();
+    DALI_ENFORCE(!initial_buffer_filled_,
+                 "Cannot fast forward a loader that has already returned samples");
+    DALI_ENFORCE(samples_to_skip >= 0 && batch_size > 0,
+                 make_string("Invalid fast forward parameters: samples_to_skip = ",
+                             samples_to_skip, ", batch_size = ", batch_size));
+    if (samples_to_skip == 0)
+      return;
+    DomainTimeRange tr("[DALI][Loader] FastForward", DomainTimeRange::kBlue1);
+
+    // sample_buffer_ replayed on ordinals - the number of the ReadSample call
+    // which loaded given sample
+    std::vector<Index> buffer;
+    buffer.reserve(initial_buffer_fill_);
+    Index num_read = 0;
+    Index last_returned = -1;
+
+    shards_.push_back({0, 0});
+    for (int i = 0; i < initial_buffer_fill_; ++i) {
+      buffer.push_back(num_read++);
+      IncreaseReadSampleCounter();
+      ++shards_.back().end;
+    }
+
+    for (Index s = 0; s < samples_to_skip; ++s) {
+      bool is_new_batch = s % batch_size == 0;
+      if (shards_.front().start == shards_.front().end) {
+        if ((returned_sample_counter_  < num_samples(num_shards_, Size()) || !is_new_batch) &&
+          pad_last_batch_) {
+          ++returned_sample_counter_;
+          continue;
+        }
+        shards_.pop_front();
+        returned_sample_counter_ = 0;
+      }
+
+      std::uniform_int_distribution<> dis;
+      dis = std::uniform_int_distribution<>(0, shards_.front().end - shards_.front().start - 1);
+
+      int offset = shuffle_ ? dis(e_) : 0;
+      Index idx = (shards_.front().start + offset) % buffer.size();
+      last_returned = buffer[idx];
+      std::swap(buffer[idx], buffer[shards_.front().start % buffer.size()]);
+      Index new_sample = num_read++;
+      IncreaseReadSampleCounter();
+      buffer[shards_.back().end % buffer.size()] = new_sample;
+      ++shards_.back().end;
+
+      shards_.front().start++;
+      returned_sample_counter_++;
+    }
+
+    // now advance the data source itself, in the order the samples were read
+    std::vector<Index> needed(buffer);
+    if (last_returned >= 0)
+      needed.push_back(last_returned);
+    std::sort(needed.begin(), needed.end());
+    std::map<Index, LoadTargetUniquePtr> loaded;
+    auto next_needed = needed.begin();
+    for (Index ordinal = 0; ordinal < num_read; ++ordinal) {
+      if (next_needed != needed.end() && *next_needed == ordinal) {
+        auto tensor_ptr = LoadTargetUniquePtr(new LoadTarget());
+        PrepareEmpty(*tensor_ptr);
+        ReadSample(*tensor_ptr);
+        loaded[ordinal] = std::move(tensor_ptr);
+        ++next_needed;
+      } else {
+        Skip();
+      }
+    }
+    skip_scratch_.reset();
+
+    for (Index ordinal : buffer)
+      sample_buffer_.push_back(std::move(loaded[ordinal]));
+    if (last_returned >= 0) {
+      last_sample_ptr_tmp = LoadTargetSharedPtr(loaded[last_returned].release(),
+        [this](LoadTarget* sample) {
+          LoadTargetUniquePtr recycle_ptr(sample);
+          RecycleTensor(std::move(recycle_ptr));
+      });
+    }
+
+    std::lock_guard<std::mutex> lock(empty_tensors_mutex_);
+    for (int i = 0; i < initial_empty_size_; ++i) {
+      auto tensor_ptr = LoadTargetUniquePtr(new LoadTarget());
+      PrepareEmpty(*tensor_ptr);
+      empty_tensors_.push_back(std::move(tensor_ptr));
+    }
+    initial_buffer_filled_ = true;
+  }
+
   // return a tensor to the empty pile
   // called by multiple consumer threads
   void RecycleTensor(LoadTargetUniquePtr&& tensor_ptr) {
@@ -213,6 +332,17 @@ class Loader {
   // reads.
   virtual void ReadSample(LoadTarget& tensor) = 0;
 
+  // Advance the data source past one sample, as ReadSample would, without loading it.
+  // Loaders that can just move their position should override it - the default one
+  // reads the sample into a scratch target and discards it.
+  virtual void Skip() {
+    if (!skip_scratch_) {
+      skip_scratch_ = LoadTargetUniquePtr(new LoadTarget());
+      PrepareEmpty(*skip_scratch_);
+    }
+    ReadSample(*skip_scratch_);
+  }
+
   void PrepareMetadata() {
     if (!loading_flag_) {
       std::lock_guard<std::mutex> l(prepare_metadata_mutex_);
@@ -242,6 +372,10 @@ class Loader {
     return shard_id_;
   }
 
+  Index GetSeed() {
+    return seed_;
+  }
+
   int PadLastBatch() {
     return pad_last_batch_;
   }
@@ -294,6 +428,110 @@ class Loader {
     }
   }
 
+  /**
+   * @brief Location of the data of a sample in a file
+   */
+  struct FileRange {
+    std::string path;
+    int64 offset = 0;
+    int64 length = 0;  // 0 means the range reaches the end of the file
+  };
+
+  /**
+   * @brief Describes where the sample with given index is stored, used for page cache hints.
+   *
+   * Loaders that read samples from files should override it and call AdvisePageCache
+   * from ReadSample. Returns false if the location is not known.
+   */
+  virtual bool GetFileRange(Index index, FileRange &range) {
+    return false;
+  }
+
+  /**
+   * @brief Issues page cache hints for the data source, to be called by ReadSample
+   *        with the index of the sample that is about to be read.
+   *
+   * The order in which samples are read from the source is known up to the end of the current
+   * pass (epoch or shard), so the next `page_cache_readahead` samples are marked as needed,
+   * letting the OS read them in the background instead of speculating on its own.
+   * The samples which were read long enough ago to be consumed are marked as not needed,
+   * so they don't push the useful data out of the page cache.
+   * If `page_cache_budget` is set, the oldest read samples are marked as not needed as soon
+   * as the total size of the data read and not yet dropped exceeds the budget.
+   */
+  void AdvisePageCache(Index current_index) {
+    if (page_cache_readahead_ > 0) {
+      if (current_index < hint_begin_ || current_index > hint_end_) {
+        // first read or the reader moved to a new pass
+        hint_end_ = current_index;
+      }
+      hint_begin_ = current_index;
+      Index target = current_index + page_cache_readahead_;
+      FileRange range;
+      for (; hint_end_ < target && !IsNextShard(hint_end_); ++hint_end_) {
+        if (GetFileRange(hint_end_, range))
+          FileStream::Advise(range.path, range.offset, range.length,
+                             FileStream::AccessHint::WillNeed);
+      }
+    }
+    if (page_cache_drop_consumed_ || page_cache_budget_ > 0) {
+      FileRange range;
+      if (!GetFileRange(current_index, range))
+        return;
+      if (page_cache_budget_ > 0 && range.length == 0)
+        range.length = std::max<int64>(FileStream::FileSize(range.path) - range.offset, 0);
+      read_bytes_ += range.length;
+      read_ranges_.push_back(std::move(range));
+      // when the data is copied, it's not used once read; otherwise it can still be
+      // referenced by any of the samples that are in flight
+      size_t lag = !page_cache_drop_consumed_ ? read_ranges_.size()
+                 : copy_read_data_ ? 1 : initial_buffer_fill_ + initial_empty_size_;
+      // the sample which is about to be read is never dropped
+      while (read_ranges_.size() > 1 &&
+             (read_ranges_.size() > lag ||
+              (page_cache_budget_ > 0 && read_bytes_ > page_cache_budget_))) {
+        auto &consumed = read_ranges_.front();
+        // when the length is not known, the range reaches the end of the file
+        FileStream::Advise(consumed.path, consumed.offset, consumed.length,
+                           FileStream::AccessHint::DontNeed);
+        read_bytes_ -= consumed.length;
+        read_ranges_.pop_front();
+      }
+    }
+  }
+
+  /**
+   * @brief Returns the data of a sample kept in the encoded sample cache, or nullptr
+   *        if the sample is not cached
+   */
+  std::shared_ptr<uint8_t> GetCachedSample(const std::string &key, int64 &size) {
+    if (!encoded_cache_)
+      return nullptr;
+    int64_t cached_size = 0;
+    auto data = encoded_cache_->Get(key, cached_size);
+    size = cached_size;
+    return data;
+  }
+
+  /**
+   * @brief Reads `size` bytes of a sample from the current position of `stream`
+   *        into the encoded sample cache
+   *
+   * Returns the cached data, or nullptr if the cache is disabled or full, in which case
+   * nothing is read.
+   */
+  std::shared_ptr<uint8_t> CacheSample(const std::string &key, FileStream &stream, int64 size) {
+    if (!encoded_cache_)
+      return nullptr;
+    auto data = encoded_cache_->Allocate(size);
+    if (!data)
+      return nullptr;
+    int64 n_read = stream.Read(data.get(), size);
+    DALI_ENFORCE(n_read == size, make_string("Failed to read the data of ", key));
+    encoded_cache_->Insert(key, data, size);
+    return data;
+  }
+
   bool ShouldSkipImage(const ImageCache::ImageKey& key) {
     if (!skip_cached_images_)
       return false;
@@ -371,6 +609,24 @@ class Loader {
   int virtual_shard_id_;
   // Keeps pointer to the last returned sample just in case it needs to be cloned
   LoadTargetSharedPtr last_sample_ptr_tmp;
+  // Target used by the default Skip implementation
+  LoadTargetUniquePtr skip_scratch_;
+
+  // Number of upcoming samples for which the data is requested from the OS in advance
+  int page_cache_readahead_;
+  // If true, the data of the consumed samples is dropped from the page cache
+  bool page_cache_drop_consumed_;
+  // Range of sample indices [hint_begin_, hint_end_) for which readahead was requested
+  Index hint_begin_ = -1;
+  Index hint_end_ = -1;
+  // Upper limit of the size of the data read by the loader kept in the page cache, 0 if none
+  int64_t page_cache_budget_;
+  // Recently read samples, waiting to be dropped from the page cache, and their total size
+  std::deque<FileRange> read_ranges_;
+  int64_t read_bytes_ = 0;
+
+  // Encoded data of the samples read so far, if the samples are cached
+  std::unique_ptr<EncodedSampleCache> encoded_cache_;
 
   struct ShardBoundaries {
     Index start;
@@ -13,7 +13,11 @@
 // limitations under the License.
 
 #include <gtest/gtest.h>
+#include <map>
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "dali/core/common.h"
 #include "dali/pipeline/data/backend.h"
@@ -162,6 +166,120 @@ TYPED_TEST(DataLoadStoreTest, LoaderTestFail) {
   ASSERT_THROW(reader->PrepareMetadata(), std::runtime_error);
 }
 
+TYPED_TEST(DataLoadStoreTest, LoaderFastForward) {
+  const int batch_size = 7;
+  const int samples_to_skip = 13 * batch_size;
+  const int samples_to_compare = 3 * batch_size;
+  for (bool shuffle : {false, true}) {
+    for (bool pad_last_batch : {false, true}) {
+      for (bool shuffle_after_epoch : {false, true}) {
+        if (shuffle && shuffle_after_epoch)
+          continue;  // these are mutually exclusive
+        auto make_loader = [&]() {
+          return InitLoader<FileLabelLoader>(
+              OpSpec("FileReader")
+              .AddArg("file_root", loader_test_image_folder)
+              .AddArg("max_batch_size", batch_size)
+              .AddArg("device_id", 0)
+              .AddArg("random_shuffle", shuffle)
+              .AddArg("initial_fill", 5)
+              .AddArg("pad_last_batch", pad_last_batch)
+              .AddArg("num_shards", 3)
+              .AddArg("shard_id", 1),
+              shuffle_after_epoch);
+        };
+        auto read = [&](FileLabelLoader &loader, int n, int first) {
+          std::vector<std::string> names;
+          for (int i = first; i < first + n; i++) {
+            auto sample = loader.ReadOne(i % batch_size == 0);
+            names.push_back(sample->image.GetSourceInfo());
+          }
+          return names;
+        };
+
+        auto replayed = make_loader();
+        read(*replayed, samples_to_skip, 0);
+        auto expected = read(*replayed, samples_to_compare, samples_to_skip);
+
+        auto fast_forwarded = make_loader();
+        fast_forwarded->FastForward(samples_to_skip, batch_size);
+        auto actual = read(*fast_forwarded, samples_to_compare, samples_to_skip);
+
+        EXPECT_EQ(expected, actual) << "shuffle: " << shuffle
+                                    << " pad_last_batch: " << pad_last_batch
+                                    << " shuffle_after_epoch: " << shuffle_after_epoch;
+      }
+    }
+  }
+}
+
+TYPED_TEST(DataLoadStoreTest, LoaderPageCacheHints) {
+  auto read_all = [](bool hints, bool dont_use_mmap) {
+    auto loader = InitLoader<FileLabelLoader>(
+        OpSpec("FileReader")
+        .AddArg("file_root", loader_test_image_folder)
+        .AddArg("max_batch_size", 4)
+        .AddArg("device_id", 0)
+        .AddArg("random_shuffle", true)
+        .AddArg("initial_fill", 8)
+        .AddArg("dont_use_mmap", dont_use_mmap)
+        .AddArg("num_shards", 2)
+        .AddArg("stick_to_shard", true)
+        .AddArg("page_cache_readahead", hints ? 5 : 0)
+        .AddArg("page_cache_drop_consumed", hints)
+        .AddArg("page_cache_budget", static_cast<int64_t>(hints ? 1 << 16 : 0)));
+    std::vector<std::string> names;
+    for (int i = 0; i < 3 * loader->Size(); i++) {
+      auto sample = loader->ReadOne(i % 4 == 0);
+      names.push_back(sample->image.GetSourceInfo());
+    }
+    return names;
+  };
+  // hints must not affect the returned data
+  for (bool dont_use_mmap : {true, false})
+    EXPECT_EQ(read_all(false, dont_use_mmap), read_all(true, dont_use_mmap));
+}
+
+TYPED_TEST(DataLoadStoreTest, LoaderEncodedSampleCache) {
+  auto read_all = [](bool cache, bool shuffle_after_epoch) {
+    auto loader = InitLoader<FileLabelLoader>(
+        OpSpec("FileReader")
+        .AddArg("file_root", loader_test_image_folder)
+        .AddArg("max_batch_size", 4)
+        .AddArg("device_id", 0)
+        .AddArg("cache_encoded_samples", cache), shuffle_after_epoch);
+    std::vector<std::pair<std::string, std::vector<uint8_t>>> samples;
+    std::map<std::string, const void *> first_ptrs;
+    for (int i = 0; i < 3 * loader->Size(); i++) {
+      auto sample = loader->ReadOne(i % 4 == 0);
+      const auto &image = sample->image;
+      auto name = image.GetSourceInfo();
+      auto *data = image.data<uint8_t>();
+      samples.emplace_back(name, std::vector<uint8_t>(data, data + image.size()));
+      if (cache) {
+        // the following epochs return the data read in the first one, without copying
+        EXPECT_TRUE(image.shares_data());
+        auto it = first_ptrs.emplace(name, image.raw_data()).first;
+        EXPECT_EQ(it->second, image.raw_data()) << name;
+      }
+    }
+    return samples;
+  };
+  // the cache must not affect the returned data
+  for (bool shuffle_after_epoch : {false, true})
+    EXPECT_EQ(read_all(false, shuffle_after_epoch), read_all(true, shuffle_after_epoch));
+}
+
+TYPED_TEST(DataLoadStoreTest, EncodedSampleCacheArgs) {
+  // only the readers whose loaders use the cache accept the argument
+  for (const char *name : { "readers__File", "readers__COCO", "readers__MXNet",
+                            "readers__TFRecord", "readers__Numpy" })
+    EXPECT_TRUE(SchemaRegistry::GetSchema(name).HasArgument("cache_encoded_samples")) << name;
+  for (const char *name : { "readers__Caffe", "readers__Caffe2", "readers__Sequence",
+                            "readers__Webdataset" })
+    EXPECT_FALSE(SchemaRegistry::GetSchema(name).HasArgument("cache_encoded_samples")) << name;
+}
+
 #if 0
 TYPED_TEST(DataLoadStoreTest, CachedLMDBTest) {
   shared_ptr<dali::LMDBLoader> reader(
@@ -111,31 +111,20 @@ void NemoAsrLoader::ReadAudio(Tensor<CPUBackend> &audio,
                               AudioDecoderBase &decoder,
                               std::vector<float> &decode_scratch,
                               std::vector<float> &resample_scratch) {
-  bool should_resample = sample_rate_ > 0 && audio_meta.sample_rate != sample_rate_;
-  bool should_downmix = audio_meta.channels > 1 && downmix_;
-
-  int64_t decode_scratch_sz = 0;
-  if (should_resample || should_downmix)
-    decode_scratch_sz = audio_meta.length * audio_meta.channels;
-  decode_scratch.resize(decode_scratch_sz);
-
-  // resample scratch is used to prepare a single or multiple (depending if
-  // downmixing is needed) channel float input, required by the resampling
-  // kernel
-  int64_t resample_scratch_sz = 0;
-  if (should_resample)
-    resample_scratch_sz =
-        should_downmix ? audio_meta.length : audio_meta.length * audio_meta.channels;
-  resample_scratch.resize(resample_scratch_sz);
-
-  DecodeAudio<OutputType>(
+  // Decoding, downmixing and resampling are done chunk by chunk, so that the scratch memory
+  // doesn't grow with the length of the recording
+  DecodeAudioChunked<OutputType>(
     view<OutputType>(audio), decoder, audio_meta, resampler_,
-    {decode_scratch.data(), decode_scratch_sz},
-    {resample_scratch.data(), resample_scratch_sz},
+    decode_scratch, resample_scratch,
     sample_rate_, downmix_,
     entry.audio_filepath.c_str());
 }
 
+void NemoAsrLoader::Skip() {
+  ++current_index_;
+  MoveToNextShard(current_index_);
+}
+
 void NemoAsrLoader::ReadSample(AsrSample& sample) {
   auto &entry = entries_[shuffled_indices_[current_index_]];
 
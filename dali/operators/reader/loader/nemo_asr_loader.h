@@ -135,6 +135,7 @@ class DLL_PUBLIC NemoAsrLoader : public Loader<CPUBackend, AsrSample> {
   ~NemoAsrLoader() override = default;
   void PrepareEmpty(AsrSample &sample) override;
   void ReadSample(AsrSample& sample) override;
+  void Skip() override;
 
  protected:
   void PrepareMetadataImpl() override;
@@ -220,7 +220,17 @@ void NumpyHeaderCache::UpdateCache(const string &file_name, const NumpyParseTarg
 }  // namespace detail
 
 void NumpyLoader::ReadSample(ImageFileWrapper& imfile) {
-  auto image_file = images_[current_index_++];
+  auto image_file = images_[current_index_];
+  // the header of a cached sample is always in the header cache
+  NumpyParseTarget target;
+  int64 cached_bytes = 0;
+  std::shared_ptr<uint8_t> cached;
+  bool header_cached = header_cache_.GetFromCache(image_file, target);
+  if (header_cached)
+    cached = GetCachedSample(image_file, cached_bytes);
+  if (!cached)
+    AdvisePageCache(current_index_);
+  current_index_++;
 
   // handle wrap-around
   MoveToNextShard(current_index_);
@@ -241,40 +251,47 @@ void NumpyLoader::ReadSample(ImageFileWrapper& imfile) {
     return;
   }
 
-  auto current_image = FileStream::Open(file_root_ + "/" + image_file, read_ahead_,
-                                        !copy_read_data_);
-
-  // read the header
-  NumpyParseTarget target;
-  auto ret = header_cache_.GetFromCache(image_file, target);
-  if (ret) {
-    current_image->Seek(target.data_offset);
+  if (cached) {
+    // the data is kept in memory - the file is not accessed
+    imfile.image.ShareData(cached, cached_bytes, {cached_bytes});
+    imfile.image.Resize(target.shape, target.type_info);
   } else {
-    detail::ParseHeader(current_image.get(), target);
-    header_cache_.UpdateCache(image_file, target);
-  }
+    auto current_image = FileStream::Open(file_root_ + "/" + image_file, read_ahead_,
+                                          !copy_read_data_);
+
+    // read the header
+    if (header_cached) {
+      current_image->Seek(target.data_offset);
+    } else {
+      detail::ParseHeader(current_image.get(), target);
+      header_cache_.UpdateCache(image_file, target);
+    }
 
-  Index image_bytes = target.nbytes();
+    Index image_bytes = target.nbytes();
 
-  if (copy_read_data_) {
-    if (imfile.image.shares_data()) {
-      imfile.image.Reset();
+    if ((cached = CacheSample(image_file, *current_image, image_bytes))) {
+      imfile.image.ShareData(cached, image_bytes, {image_bytes});
+      imfile.image.Resize(target.shape, target.type_info);
+    } else if (copy_read_data_) {
+      if (imfile.image.shares_data()) {
+        imfile.image.Reset();
+      }
+      imfile.image.Resize(target.shape, target.type_info);
+      // copy the image
+      Index ret = current_image->Read(static_cast<uint8_t*>(imfile.image.raw_mutable_data()),
+                                      image_bytes);
+      DALI_ENFORCE(ret == image_bytes, make_string("Failed to read file: ", image_file));
+    } else {
+      auto p = current_image->Get(image_bytes);
+      DALI_ENFORCE(p != nullptr, make_string("Failed to read file: ", image_file));
+      // Wrap the raw data in the Tensor object.
+      imfile.image.ShareData(p, image_bytes, {image_bytes});
+      imfile.image.Resize(target.shape, target.type_info);
     }
-    imfile.image.Resize(target.shape, target.type_info);
-    // copy the image
-    Index ret = current_image->Read(static_cast<uint8_t*>(imfile.image.raw_mutable_data()),
-                                    image_bytes);
-    DALI_ENFORCE(ret == image_bytes, make_string("Failed to read file: ", image_file));
-  } else {
-    auto p = current_image->Get(image_bytes);
-    DALI_ENFORCE(p != nullptr, make_string("Failed to read file: ", image_file));
-    // Wrap the raw data in the Tensor object.
-    imfile.image.ShareData(p, image_bytes, {image_bytes});
-    imfile.image.Resize(target.shape, target.type_info);
-  }
 
-  // close the file handle
-  current_image->Close();
+    // close the file handle
+    current_image->Close();
+  }
 
   // set metadata
   imfile.image.SetMeta(meta);
@@ -82,7 +82,8 @@ class NumpyLoader : public FileLoader<> {
     const OpSpec& spec,
     bool shuffle_after_epoch = false)
     : FileLoader(spec, shuffle_after_epoch),
-    header_cache_(spec.GetArgument<bool>("cache_header_information")) {}
+    header_cache_(spec.GetArgument<bool>("cache_header_information") ||
+                  spec.GetArgument<bool>("cache_encoded_samples")) {}
 
   // we want to make it possible to override this function as well
   void ReadSample(ImageFileWrapper& tensor) override;
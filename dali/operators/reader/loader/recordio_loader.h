@@ -81,6 +81,7 @@ class RecordIOLoader : public IndexedFileLoader {
   void ReadSample(Tensor<CPUBackend>& tensor) override {
     // if we moved to next shard wrap up
     MoveToNextShard(current_index_);
+    AdvisePageCache(current_index_);
 
     int64 seek_pos, size;
     size_t file_index;
@@ -152,6 +153,11 @@ class RecordIOLoader : public IndexedFileLoader {
     tensor.SetMeta(meta);
   }
 
+  void Skip() override {
+    IndexedFileLoader::Skip();
+    should_seek_ = true;
+  }
+
  private:
   bool should_seek_ = false;
 };
@@ -0,0 +1,429 @@
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/operators/reader/loader/webdataset_loader.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <sstream>
+
+namespace dali {
+
+namespace detail {
+
+namespace {
+
+constexpr int64 kTarBlockSize = 512;
+
+/**
+ * @brief Parses a numeric field of a tar header - octal or, in the GNU extension,
+ *        base-256 if the highest bit of the first byte is set
+ */
+int64 ParseTarNumber(const char *field, int length) {
+  if (static_cast<uint8_t>(field[0]) & 0x80) {
+    int64 value = field[0] & 0x7f;
+    for (int i = 1; i < length; i++)
+      value = (value << 8) | static_cast<uint8_t>(field[i]);
+    return value;
+  }
+  int i = 0;
+  for (; i < length && field[i] == ' '; i++) {}
+  int64 value = 0;
+  for (; i < length && field[i] >= '0' && field[i] <= '7'; i++)
+    value = value * 8 + (field[i] - '0');
+  return value;
+}
+
+bool ValidTarChecksum(const uint8_t *header) {
+  int64 sum = 0;
+  for (int i = 0; i < kTarBlockSize; i++)
+    sum += (i >= 148 && i < 156) ? ' ' : header[i];  // the checksum counts as spaces
+  return sum == ParseTarNumber(reinterpret_cast<const char *>(header) + 148, 8);
+}
+
+/**
+ * @brief Takes the path and the size from the records of a pax extended header,
+ *        each of which has the form "<length> <key>=<value>\n"
+ */
+void ParsePaxHeader(const std::string &data, const std::string &path,
+                    std::string &pax_path, int64 &pax_size) {
+  size_t pos = 0;
+  while (pos < data.size()) {
+    size_t space = data.find(' ', pos);
+    DALI_ENFORCE(space != std::string::npos,
+                 make_string("Invalid pax extended header in ", path));
+    size_t length = std::stoull(data.substr(pos, space - pos));
+    size_t eq = data.find('=', space);
+    DALI_ENFORCE(length > 0 && pos + length <= data.size() && eq < pos + length,
+                 make_string("Invalid pax extended header in ", path));
+    std::string key = data.substr(space + 1, eq - space - 1);
+    std::string value = data.substr(eq + 1, pos + length - eq - 2);  // without the newline
+    if (key == "path")
+      pax_path = value;
+    else if (key == "size")
+      pax_size = std::stoll(value);
+    pos += length;
+  }
+}
+
+}  // namespace
+
+std::vector<TarMember> ScanTarArchive(FileStream &stream, const std::string &path) {
+  std::vector<TarMember> members;
+  int64 archive_size = stream.Size();
+  uint8_t header[kTarBlockSize];
+  const char *h = reinterpret_cast<const char *>(header);
+  // the names and sizes from the extended headers apply to the following entry
+  std::string long_name, pax_path;
+  int64 pax_size = -1;
+
+  for (int64 pos = 0; pos + kTarBlockSize <= archive_size; ) {
+    stream.Seek(pos);
+    DALI_ENFORCE(stream.Read(header, kTarBlockSize) == static_cast<size_t>(kTarBlockSize),
+                 make_string("Failed to read the tar archive ", path));
+    if (std::all_of(header, header + kTarBlockSize, [](uint8_t b) { return b == 0; }))
+      break;  // end of the archive
+    DALI_ENFORCE(ValidTarChecksum(header),
+                 make_string("Invalid tar header at position ", pos, " in ", path));
+
+    char type = h[156];
+    bool extended_header = type == 'L' || type == 'x' || type == 'g';
+    int64 size = ParseTarNumber(h + 124, 12);
+    if (!extended_header && pax_size >= 0)
+      size = pax_size;
+    int64 data_offset = pos + kTarBlockSize;
+    DALI_ENFORCE(data_offset + size <= archive_size,
+                 make_string("The tar archive ", path, " is truncated"));
+
+    if (type == 'L' || type == 'x') {
+      std::string data(size, '\0');
+      DALI_ENFORCE(stream.Read(reinterpret_cast<uint8_t *>(&data[0]), size) ==
+                   static_cast<size_t>(size),
+                   make_string("Failed to read the tar archive ", path));
+      if (type == 'L')
+        long_name = data.c_str();  // strips the terminating null characters
+      else
+        ParsePaxHeader(data, path, pax_path, pax_size);
+    } else if (type != 'g') {
+      // only regular files are returned; directories, links etc. are skipped
+      if (type == '0' || type == '\0' || type == '7') {
+        std::string name;
+        if (!pax_path.empty()) {
+          name = pax_path;
+        } else if (!long_name.empty()) {
+          name = long_name;
+        } else {
+          name.assign(h, strnlen(h, 100));
+          // POSIX ustar archives can store the leading part of the path in the prefix field
+          if (!memcmp(h + 257, "ustar", 6) && h[345])
+            name = std::string(h + 345, strnlen(h + 345, 155)) + "/" + name;
+        }
+        members.push_back({ std::move(name), data_offset, size });
+      }
+      long_name.clear();
+      pax_path.clear();
+      pax_size = -1;
+    }
+    pos = data_offset + (size + kTarBlockSize - 1) / kTarBlockSize * kTarBlockSize;
+  }
+  return members;
+}
+
+std::vector<TarMember> ReadTarIndex(const std::string &index_path) {
+  std::vector<TarMember> members;
+  std::ifstream f(index_path);
+  DALI_ENFORCE(f.good(), "Failed to open file " + index_path);
+  int64 offset, size;
+  std::string name;
+  while (f >> offset >> size) {
+    f.get();  // the separator - the name can start with whitespace
+    std::getline(f, name);
+    members.push_back({ name, offset, size });
+  }
+  DALI_ENFORCE(f.eof(), "Wrong format of the index file " + index_path);
+  return members;
+}
+
+void SplitMemberName(const std::string &name, std::string &key, std::string &ext) {
+  size_t file_name = name.rfind('/');
+  file_name = file_name == std::string::npos ? 0 : file_name + 1;
+  size_t dot = name.find('.', file_name);
+  if (dot == std::string::npos) {
+    key = name;
+    ext.clear();
+  } else {
+    key = name.substr(0, dot);
+    ext = name.substr(dot + 1);
+  }
+}
+
+}  // namespace detail
+
+constexpr int64 WebdatasetLoader::kReadBlockSize;
+
+WebdatasetLoader::WebdatasetLoader(const OpSpec &spec)
+    : Loader(spec),
+      paths_(spec.GetRepeatedArgument<std::string>("paths")),
+      shuffle_shards_(spec.GetArgument<bool>("shuffle_shards")) {
+  DALI_ENFORCE(!paths_.empty(), "No tar archives specified.");
+  if (spec.TryGetRepeatedArgument(index_paths_, "index_paths")) {
+    DALI_ENFORCE(index_paths_.size() == paths_.size(),
+        "Number of index files needs to match the number of tar archives");
+  }
+
+  auto ext = spec.GetRepeatedArgument<std::string>("ext");
+  DALI_ENFORCE(!ext.empty(), "``ext`` needs to specify the extensions of at least one output");
+  num_outputs_ = ext.size();
+  for (int i = 0; i < num_outputs_; i++) {
+    std::stringstream alternatives(ext[i]);
+    std::string e;
+    while (std::getline(alternatives, e, ';')) {
+      DALI_ENFORCE(!e.empty(), make_string("Empty extension specified for the output ", i));
+      DALI_ENFORCE(ext_to_output_.emplace(e, i).second,
+          make_string("The extension \"", e, "\" is assigned to more than one output"));
+    }
+    DALI_ENFORCE(!ext[i].empty(), make_string("No extensions specified for the output ", i));
+  }
+
+  auto missing = spec.GetArgument<std::string>("missing_component_behavior");
+  if (missing == "empty") {
+    missing_component_behavior_ = MissingComponentBehavior::Empty;
+  } else if (missing == "skip") {
+    missing_component_behavior_ = MissingComponentBehavior::Skip;
+  } else if (missing == "error") {
+    missing_component_behavior_ = MissingComponentBehavior::Error;
+  } else {
+    DALI_FAIL(make_string("Invalid value of ``missing_component_behavior``: \"", missing,
+                          "\". Expected \"empty\", \"skip\" or \"error\"."));
+  }
+
+  /*
+   * As with `shuffle_after_epoch` in the file reader, the shards differ after every epoch,
+   * so the reader needs to stick to its shard
+   */
+  DALI_ENFORCE(!(shuffle_shards_ && stick_to_shard_),
+               "shuffle_shards and stick_to_shard cannot be both true");
+  if (shuffle_shards_) {
+    stick_to_shard_ = true;
+  }
+}
+
+WebdatasetLoader::~WebdatasetLoader() {
+  if (current_file_)
+    current_file_->Close();
+}
+
+void WebdatasetLoader::PrepareEmpty(std::vector<Tensor<CPUBackend>> &sample) {
+  // the data is always shared with the tensors, so nothing is allocated here
+  sample.resize(num_outputs_);
+  for (auto &tensor : sample) {
+    tensor.set_pinned(false);
+    tensor.set_type(TypeInfo::Create<uint8_t>());
+  }
+}
+
+void WebdatasetLoader::ReadSample(std::vector<Tensor<CPUBackend>> &sample) {
+  const auto &desc = samples_[order_[current_index_]];
+  AdvisePageCache(current_index_);
+  current_index_++;
+
+  // handle wrap-around
+  MoveToNextShard(current_index_);
+
+  DALIMeta meta;
+  meta.SetSourceInfo(paths_[desc.archive] + ":" + desc.key);
+  meta.SetSkipSample(false);
+
+  auto data = ReadRange(desc.archive, desc.offset, desc.size);
+  sample.resize(num_outputs_);
+  for (int i = 0; i < num_outputs_; i++) {
+    auto &tensor = sample[i];
+    const auto &component = components_[desc.components + i];
+    if (component.offset < 0 || component.size == 0) {
+      if (tensor.shares_data()) {
+        tensor.Reset();
+      }
+      tensor.set_type(TypeInfo::Create<uint8_t>());
+      tensor.Resize({0});
+    } else {
+      // the components share the data read for the whole sample
+      tensor.ShareData(std::shared_ptr<uint8_t>(data, data.get() + component.offset),
+                       component.size, {component.size});
+      tensor.set_type(TypeInfo::Create<uint8_t>());
+    }
+    tensor.SetMeta(meta);
+  }
+}
+
+bool WebdatasetLoader::GetFileRange(Index index, FileRange &range) {
+  const auto &desc = samples_[order_[index]];
+  if (desc.size == 0)
+    return false;
+  range.path = paths_[desc.archive];
+  range.offset = desc.offset;
+  range.length = desc.size;
+  return true;
+}
+
+void WebdatasetLoader::PrepareMetadataImpl() {
+  if (!dont_use_mmap_) {
+    mmap_reserver_ = FileStream::MappingReserver(
+                                static_cast<unsigned int>(initial_buffer_fill_));
+  }
+  copy_read_data_ = dont_use_mmap_ || !mmap_reserver_.CanShareMappedData();
+
+  for (int i = 0, n = paths_.size(); i < n; i++) {
+    std::vector<detail::TarMember> members;
+    if (!index_paths_.empty()) {
+      members = detail::ReadTarIndex(index_paths_[i]);
+    } else {
+      // without the index, only the headers are read - the data is skipped
+      auto stream = FileStream::Open(paths_[i], false, false);
+      members = detail::ScanTarArchive(*stream, paths_[i]);
+      stream->Close();
+    }
+    AddSamples(i, members);
+  }
+  DALI_ENFORCE(!samples_.empty(), "No samples found.");
+  Reset(true);
+}
+
+void WebdatasetLoader::AddSamples(int archive, const std::vector<detail::TarMember> &members) {
+  Index first_sample = samples_.size();
+  std::string key, ext;
+  size_t i = 0;
+  while (i < members.size()) {
+    SampleDesc sample;
+    sample.archive = archive;
+    detail::SplitMemberName(members[i].name, sample.key, ext);
+    sample.components = components_.size();
+    components_.resize(components_.size() + num_outputs_, { -1, 0 });
+    auto *component = &components_[sample.components];
+
+    int found = 0;
+    int64 begin = std::numeric_limits<int64>::max(), end = 0;
+    // the members of a sample are stored one after another
+    for (; i < members.size(); i++) {
+      detail::SplitMemberName(members[i].name, key, ext);
+      if (key != sample.key)
+        break;
+      auto it = ext_to_output_.find(ext);
+      if (it == ext_to_output_.end())
+        continue;
+      auto &c = component[it->second];
+      DALI_ENFORCE(c.offset < 0, make_string("The sample \"", sample.key, "\" in ",
+          paths_[archive], " has more than one component for the output ", it->second));
+      c.offset = members[i].offset;
+      c.size = members[i].size;
+      begin = std::min(begin, c.offset);
+      end = std::max(end, c.offset + c.size);
+      found++;
+    }
+
+    if (found < num_outputs_) {
+      DALI_ENFORCE(missing_component_behavior_ != MissingComponentBehavior::Error,
+          make_string("The sample \"", sample.key, "\" in ", paths_[archive], " is missing ",
+                      num_outputs_ - found, " of ", num_outputs_, " components"));
+      if (missing_component_behavior_ == MissingComponentBehavior::Skip) {
+        components_.resize(sample.components);
+        continue;
+      }
+    }
+
+    if (found == 0)
+      begin = end = 0;
+    sample.offset = begin;
+    sample.size = end - begin;
+    for (int o = 0; o < num_outputs_; o++) {
+      if (component[o].offset >= 0)
+        component[o].offset -= begin;
+    }
+    samples_.push_back(std::move(sample));
+  }
+  archive_samples_.emplace_back(first_sample, samples_.size());
+}
+
+void WebdatasetLoader::Reset(bool wrap_to_shard) {
+  if (wrap_to_shard) {
+    current_index_ = start_index(shard_id_, num_shards_, SizeImpl());
+  } else {
+    current_index_ = 0;
+  }
+
+  current_epoch_++;
+
+  if (shuffle_shards_ || order_.empty())
+    SetArchiveOrder();
+}
+
+void WebdatasetLoader::SetArchiveOrder() {
+  std::vector<int> archives(paths_.size());
+  std::iota(archives.begin(), archives.end(), 0);
+  if (shuffle_shards_) {
+    // the same order on every shard
+    std::mt19937 g(kDaliDataloaderSeed + current_epoch_);
+    std::shuffle(archives.begin(), archives.end(), g);
+  }
+  order_.clear();
+  order_.reserve(samples_.size());
+  for (int archive : archives) {
+    for (Index s = archive_samples_[archive].first; s < archive_samples_[archive].second; s++)
+      order_.push_back(s);
+  }
+}
+
+std::shared_ptr<uint8_t> WebdatasetLoader::ReadRange(int archive, int64 offset, int64 size) {
+  if (size == 0)
+    return nullptr;
+
+  if (archive != current_archive_) {
+    if (current_file_)
+      current_file_->Close();
+    current_file_ = FileStream::Open(paths_[archive], read_ahead_, !copy_read_data_);
+    current_archive_ = archive;
+    file_pos_ = 0;
+    block_.reset();
+    block_size_ = 0;
+  }
+
+  if (!copy_read_data_) {
+    if (file_pos_ != offset)
+      current_file_->Seek(offset);
+    auto p = current_file_->Get(size);
+    DALI_ENFORCE(p != nullptr, "Error reading from a file " + paths_[archive]);
+    file_pos_ = offset + size;
+    return std::static_pointer_cast<uint8_t>(p);
+  }
+
+  if (!block_ || offset < block_offset_ || offset + size > block_offset_ + block_size_) {
+    // Read a large block, so that the following samples are taken from memory. The block is
+    // kept alive by the samples which use it.
+    int64 read_size = std::max(size, std::min<int64>(kReadBlockSize,
+                                                     current_file_->Size() - offset));
+    block_.reset(new uint8_t[read_size], std::default_delete<uint8_t[]>());
+    if (file_pos_ != offset)
+      current_file_->Seek(offset);
+    int64 n_read = current_file_->Read(block_.get(), read_size);
+    DALI_ENFORCE(n_read == read_size, "Error reading from a file " + paths_[archive]);
+    block_offset_ = offset;
+    block_size_ = read_size;
+    file_pos_ = offset + read_size;
+  }
+  return std::shared_ptr<uint8_t>(block_, block_.get() + (offset - block_offset_));
+}
+
+}  // namespace dali
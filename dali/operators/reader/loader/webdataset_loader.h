@@ -0,0 +1,169 @@
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_OPERATORS_READER_LOADER_WEBDATASET_LOADER_H_
+#define DALI_OPERATORS_READER_LOADER_WEBDATASET_LOADER_H_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "dali/core/common.h"
+#include "dali/operators/reader/loader/loader.h"
+#include "dali/util/file.h"
+
+namespace dali {
+
+namespace detail {
+
+/**
+ * @brief A regular file stored in a tar archive
+ */
+struct TarMember {
+  std::string name;
+  int64 offset;  // position of the data in the archive
+  int64 size;
+};
+
+/**
+ * @brief Lists the regular files stored in a tar archive, reading only the headers
+ *
+ * Supports the ustar format, along with GNU long names and pax extended headers.
+ */
+DLL_PUBLIC std::vector<TarMember> ScanTarArchive(FileStream &stream, const std::string &path);
+
+/**
+ * @brief Reads the members of a tar archive from an index file created by `wds2idx`
+ *
+ * Each line of the file describes one member: the position of its data, its size
+ * and its name, separated with single spaces.
+ */
+DLL_PUBLIC std::vector<TarMember> ReadTarIndex(const std::string &index_path);
+
+/**
+ * @brief Splits the name of a tar member into the sample key and the extension
+ *
+ * Following the WebDataset convention, the extension starts at the first dot of the file name,
+ * so `dir/sample.seg.png` belongs to the sample `dir/sample` and has the extension `seg.png`.
+ */
+DLL_PUBLIC void SplitMemberName(const std::string &name, std::string &key, std::string &ext);
+
+}  // namespace detail
+
+/**
+ * @brief Reads samples stored in tar archives, following the WebDataset convention
+ *
+ * The consecutive members of an archive which share the key (the name up to the first dot
+ * of the file name) form a sample, and their extensions select the outputs they go to.
+ * The samples of an archive are read in the order in which they are stored, with large
+ * sequential reads (or from a memory mapping) - a single file is opened per archive.
+ * Random shuffling only goes as far as the shuffle buffer of the Loader; the order of the
+ * archives can additionally be shuffled at every epoch with `shuffle_shards`.
+ */
+class DLL_PUBLIC WebdatasetLoader : public Loader<CPUBackend, std::vector<Tensor<CPUBackend>>> {
+ public:
+  explicit WebdatasetLoader(const OpSpec &spec);
+
+  ~WebdatasetLoader() override;
+
+  void PrepareEmpty(std::vector<Tensor<CPUBackend>> &sample) override;
+  void ReadSample(std::vector<Tensor<CPUBackend>> &sample) override;
+
+  void Skip() override {
+    ++current_index_;
+    MoveToNextShard(current_index_);
+  }
+
+  /// @brief Size of the reads issued when the data is not memory mapped
+  static constexpr int64 kReadBlockSize = 16 << 20;
+
+ protected:
+  Index SizeImpl() override {
+    return samples_.size();
+  }
+
+  bool GetFileRange(Index index, FileRange &range) override;
+
+  void PrepareMetadataImpl() override;
+
+  void Reset(bool wrap_to_shard) override;
+
+ private:
+  enum class MissingComponentBehavior {
+    Empty,
+    Skip,
+    Error
+  };
+
+  struct SampleDesc {
+    int archive;
+    // the range of the archive spanning all the components of the sample
+    int64 offset;
+    int64 size;
+    // index of the first of the components of the sample in components_
+    int64 components;
+    std::string key;
+  };
+
+  struct ComponentDesc {
+    int64 offset;  // relative to the offset of the sample; -1 if the component is missing
+    int64 size;
+  };
+
+  void AddSamples(int archive, const std::vector<detail::TarMember> &members);
+
+  /**
+   * @brief Returns `size` bytes of the archive at `offset`, sequentially reading larger blocks
+   *        if the data is not memory mapped
+   */
+  std::shared_ptr<uint8_t> ReadRange(int archive, int64 offset, int64 size);
+
+  /**
+   * @brief Sets the order in which the samples are read in the current epoch,
+   *        shuffling the archives if requested
+   */
+  void SetArchiveOrder();
+
+  std::vector<std::string> paths_;
+  std::vector<std::string> index_paths_;
+  // extension -> output index
+  std::map<std::string, int> ext_to_output_;
+  int num_outputs_;
+  MissingComponentBehavior missing_component_behavior_;
+  bool shuffle_shards_;
+
+  std::vector<SampleDesc> samples_;
+  std::vector<ComponentDesc> components_;
+  // range of samples_ read from each archive
+  std::vector<std::pair<Index, Index>> archive_samples_;
+  // the order in which samples_ are read in the current epoch
+  std::vector<Index> order_;
+  Index current_index_ = 0;
+  int current_epoch_ = 0;
+
+  std::unique_ptr<FileStream> current_file_;
+  int current_archive_ = -1;
+  int64 file_pos_ = 0;
+  // the last block read from current_file_ and its position
+  std::shared_ptr<uint8_t> block_;
+  int64 block_offset_ = 0;
+  int64 block_size_ = 0;
+  FileStream::MappingReserver mmap_reserver_;
+};
+
+}  // namespace dali
+
+#endif  // DALI_OPERATORS_READER_LOADER_WEBDATASET_LOADER_H_
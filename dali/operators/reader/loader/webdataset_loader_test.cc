@@ -0,0 +1,286 @@
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "dali/operators/reader/loader/webdataset_loader.h"
+
+namespace dali {
+
+namespace {
+
+/**
+ * @brief Writes a ustar archive
+ */
+class TarWriter {
+ public:
+  explicit TarWriter(const std::string &path) : f_(path, std::ios::binary) {}
+
+  void Add(const std::string &name, const std::string &data, char type = '0',
+           const std::string &prefix = "") {
+    char h[512] = {};
+    strncpy(h, name.c_str(), 100);
+    SetOctal(h + 100, 8, 0644);  // mode
+    SetOctal(h + 108, 8, 0);  // uid
+    SetOctal(h + 116, 8, 0);  // gid
+    SetOctal(h + 124, 12, data.size());
+    SetOctal(h + 136, 12, 0);  // mtime
+    h[156] = type;
+    memcpy(h + 257, "ustar", 6);
+    memcpy(h + 263, "00", 2);
+    strncpy(h + 345, prefix.c_str(), 155);
+    memset(h + 148, ' ', 8);
+    unsigned sum = 0;
+    for (char c : h)
+      sum += static_cast<uint8_t>(c);
+    SetOctal(h + 148, 7, sum);
+    h[155] = ' ';
+    f_.write(h, sizeof(h));
+    f_.write(data.data(), data.size());
+    Pad();
+  }
+
+  void AddPax(const std::string &key, const std::string &value) {
+    std::string record = " " + key + "=" + value + "\n";
+    // the length of the record includes the length field itself
+    int length = record.size() + 1;
+    while (static_cast<int>(std::to_string(length).size() + record.size()) != length)
+      length++;
+    Add("PaxHeader", std::to_string(length) + record, 'x');
+  }
+
+  void Close() {
+    std::vector<char> end(1024, 0);
+    f_.write(end.data(), end.size());
+    f_.close();
+  }
+
+ private:
+  /**
+   * @brief Writes `width - 1` octal digits followed by a null character
+   */
+  static void SetOctal(char *field, int width, uint64_t value) {
+    std::ostringstream ss;
+    ss << std::oct << std::setw(width - 1) << std::setfill('0') << value;
+    memcpy(field, ss.str().c_str(), width);
+  }
+
+  void Pad() {
+    std::vector<char> zeros(512, 0);
+    f_.write(zeros.data(), (512 - f_.tellp() % 512) % 512);
+  }
+
+  std::ofstream f_;
+};
+
+}  // namespace
+
+class WebdatasetLoaderTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    std::string tmpl = "/tmp/webdataset_loader_test_XXXXXX";
+    tmp_dir_ = mkdtemp(&tmpl[0]);
+  }
+
+  void TearDown() override {
+    for (auto &file : files_)
+      std::remove(file.c_str());
+    rmdir(tmp_dir_.c_str());
+  }
+
+  std::string Path(const std::string &name) {
+    files_.push_back(tmp_dir_ + "/" + name);
+    return files_.back();
+  }
+
+  /**
+   * @brief Writes `num_archives` archives; sample `i` of archive `a` has the key "a_i"
+   *        and the components "<key>.jpg" or "<key>.png", "<key>.cls" and "<key>.txt",
+   *        except for every third sample, which has only the "cls" component
+   */
+  std::vector<std::string> WriteArchives(int num_archives, int samples_per_archive) {
+    std::vector<std::string> paths;
+    for (int a = 0; a < num_archives; a++) {
+      paths.push_back(Path("shard" + std::to_string(a) + ".tar"));
+      TarWriter tar(paths.back());
+      for (int i = 0; i < samples_per_archive; i++) {
+        std::string key = std::to_string(a) + "_" + std::to_string(i);
+        if (i % 3 != 2)
+          tar.Add("data/" + key + (i % 2 ? ".png" : ".jpg"), "image " + key);
+        tar.Add("data/" + key + ".cls", key);
+        tar.Add("data/" + key + ".txt", "ignored");
+      }
+      tar.Close();
+    }
+    return paths;
+  }
+
+  OpSpec Spec(const std::vector<std::string> &paths) {
+    return OpSpec("readers__Webdataset")
+        .AddArg("paths", paths)
+        .AddArg("ext", std::vector<std::string>{ "jpg;png", "cls" })
+        .AddArg("max_batch_size", 4)
+        .AddArg("device_id", 0);
+  }
+
+  std::string tmp_dir_;
+  std::vector<std::string> files_;
+};
+
+TEST_F(WebdatasetLoaderTest, ScanTarArchive) {
+  std::string path = Path("scan.tar");
+  std::string long_name = std::string(150, 'x') + ".jpg";
+  TarWriter tar(path);
+  tar.Add("dir/", "", '5');
+  tar.Add("dir/a.jpg", "0123456789");
+  tar.Add("link.jpg", "", '2');
+  tar.Add("././@LongLink", long_name + '\0', 'L');
+  tar.Add(long_name.substr(0, 99), "long");
+  tar.AddPax("path", "pax/name.cls");
+  tar.Add("ignored", std::string(600, 'p'));
+  tar.Add("b.cls", "", '0', "some/prefix");
+  tar.Close();
+
+  auto stream = FileStream::Open(path, false, false);
+  auto members = detail::ScanTarArchive(*stream, path);
+  stream->Close();
+
+  std::vector<std::pair<std::string, std::string>> expected = {
+    { "dir/a.jpg", "0123456789" },
+    { long_name, "long" },
+    { "pax/name.cls", std::string(600, 'p') },
+    { "some/prefix/b.cls", "" }
+  };
+  ASSERT_EQ(members.size(), expected.size());
+  std::ifstream f(path, std::ios::binary);
+  for (size_t i = 0; i < members.size(); i++) {
+    EXPECT_EQ(members[i].name, expected[i].first);
+    ASSERT_EQ(members[i].size, static_cast<int64>(expected[i].second.size()));
+    EXPECT_EQ(members[i].offset % 512, 0);
+    std::string data(members[i].size, '\0');
+    f.seekg(members[i].offset);
+    f.read(&data[0], data.size());
+    EXPECT_EQ(data, expected[i].second);
+  }
+}
+
+TEST_F(WebdatasetLoaderTest, ReadTarIndex) {
+  std::string path = Path("index.idx");
+  {
+    std::ofstream f(path);
+    f << "512 10 dir/a.jpg\n1536 4 name with spaces.cls\n";
+  }
+  auto members = detail::ReadTarIndex(path);
+  ASSERT_EQ(members.size(), 2u);
+  EXPECT_EQ(members[0].name, "dir/a.jpg");
+  EXPECT_EQ(members[0].offset, 512);
+  EXPECT_EQ(members[0].size, 10);
+  EXPECT_EQ(members[1].name, "name with spaces.cls");
+  EXPECT_EQ(members[1].offset, 1536);
+  EXPECT_EQ(members[1].size, 4);
+}
+
+TEST(WebdatasetLoader, SplitMemberName) {
+  std::string key, ext;
+  detail::SplitMemberName("dir.v2/sample.seg.png", key, ext);
+  EXPECT_EQ(key, "dir.v2/sample");
+  EXPECT_EQ(ext, "seg.png");
+  detail::SplitMemberName("sample", key, ext);
+  EXPECT_EQ(key, "sample");
+  EXPECT_EQ(ext, "");
+}
+
+TEST_F(WebdatasetLoaderTest, ReadSamples) {
+  auto paths = WriteArchives(2, 5);
+  for (bool dont_use_mmap : { false, true }) {
+    for (bool use_index : { false, true }) {
+      auto spec = Spec(paths).AddArg("dont_use_mmap", dont_use_mmap);
+      if (use_index) {
+        std::vector<std::string> index_paths;
+        for (auto &path : paths) {
+          index_paths.push_back(Path(path.substr(path.rfind('/') + 1) + ".idx"));
+          auto stream = FileStream::Open(path, false, false);
+          std::ofstream idx(index_paths.back());
+          for (auto &member : detail::ScanTarArchive(*stream, path))
+            idx << member.offset << " " << member.size << " " << member.name << "\n";
+        }
+        spec.AddArg("index_paths", index_paths);
+      }
+      auto loader = InitLoader<WebdatasetLoader>(spec);
+      ASSERT_EQ(loader->Size(), 10);
+      for (int a = 0; a < 2; a++) {
+        for (int i = 0; i < 5; i++) {
+          auto sample = loader->ReadOne(false);
+          ASSERT_EQ(sample->size(), 2u);
+          std::string key = std::to_string(a) + "_" + std::to_string(i);
+          auto &image = (*sample)[0];
+          auto &label = (*sample)[1];
+          std::string image_data(image.data<uint8_t>(), image.data<uint8_t>() + image.size());
+          std::string label_data(label.data<uint8_t>(), label.data<uint8_t>() + label.size());
+          EXPECT_EQ(image_data, i % 3 != 2 ? "image " + key : "");
+          EXPECT_EQ(label_data, key);
+          EXPECT_EQ(label.GetSourceInfo(), paths[a] + ":data/" + key);
+        }
+      }
+    }
+  }
+}
+
+TEST_F(WebdatasetLoaderTest, MissingComponents) {
+  auto paths = WriteArchives(1, 6);
+  auto loader = InitLoader<WebdatasetLoader>(
+      Spec(paths).AddArg("missing_component_behavior", std::string("skip")));
+  ASSERT_EQ(loader->Size(), 4);
+  for (int i : { 0, 1, 3, 4 }) {
+    auto sample = loader->ReadOne(false);
+    auto &label = (*sample)[1];
+    EXPECT_EQ(std::string(label.data<uint8_t>(), label.data<uint8_t>() + label.size()),
+              "0_" + std::to_string(i));
+  }
+
+  EXPECT_THROW(InitLoader<WebdatasetLoader>(
+      Spec(paths).AddArg("missing_component_behavior", std::string("error"))),
+      std::runtime_error);
+}
+
+TEST_F(WebdatasetLoaderTest, ShuffleShards) {
+  int num_archives = 6;
+  auto paths = WriteArchives(num_archives, 1);
+  auto loader = InitLoader<WebdatasetLoader>(Spec(paths).AddArg("shuffle_shards", true));
+  std::set<std::vector<std::string>> orders;
+  for (int epoch = 0; epoch < 4; epoch++) {
+    std::vector<std::string> order;
+    for (int i = 0; i < num_archives; i++) {
+      auto sample = loader->ReadOne(false);
+      auto &label = (*sample)[1];
+      order.emplace_back(label.data<uint8_t>(), label.data<uint8_t>() + label.size());
+    }
+    // every archive is read once in an epoch
+    EXPECT_EQ(std::set<std::string>(order.begin(), order.end()).size(), order.size());
+    orders.insert(order);
+  }
+  EXPECT_GT(orders.size(), 1u);
+}
+
+}  // namespace dali
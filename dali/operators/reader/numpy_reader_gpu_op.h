@@ -31,6 +31,8 @@ class NumpyReaderGPU : public DataReader<GPUBackend, ImageFileWrapperGPU> {
   explicit NumpyReaderGPU(const OpSpec& spec) :
     DataReader<GPUBackend, ImageFileWrapperGPU>(spec),
     thread_pool_(num_threads_, spec.GetArgument<int>("device_id"), false) {
+    DALI_ENFORCE(!spec.GetArgument<bool>("cache_encoded_samples"),
+                 "``cache_encoded_samples`` is supported only by the ``cpu`` backend.");
     prefetched_batch_tensors_.resize(prefetch_queue_depth_);
 
     // set a device guard
@@ -98,7 +98,8 @@ sizes vary a lot.)code", true)
       R"code(If set to True, the header information for each file is cached, improving access
 speed.)code",
       false)
-  .AddParent("LoaderBase");
+  .AddParent("LoaderBase")
+  .AddParent("EncodedSampleCacheAttr");
 
 
 // Deprecated alias
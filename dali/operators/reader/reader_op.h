@@ -63,7 +63,7 @@ class DataReader : public Operator<Backend> {
         consumer_cycle_(false),
         producer_cycle_(false),
         device_id_(-1),
-        samples_processed_(0) {
+        samples_consumed_(0) {
           if (std::is_same<Backend, GPUBackend>::value) {
             device_id_ = spec.GetArgument<int>("device_id");
           }
@@ -201,6 +201,42 @@ class DataReader : public Operator<Backend> {
     return ret;
   }
 
+  ReaderState GetReaderState() const override {
+    ReaderState ret;
+    ret.consumed_samples = samples_consumed_;
+    ret.epoch_size = loader_->Size(false);
+    ret.seed = loader_->GetSeed();
+    ret.number_of_shards = loader_->GetNumShards();
+    ret.shard_id = loader_->GetShardId();
+    return ret;
+  }
+
+  void RestoreReaderState(const ReaderState &state) override {
+    DALI_ENFORCE(state, "Invalid reader state");
+    {
+      std::lock_guard<std::mutex> lock(prefetch_access_mutex_);
+      DALI_ENFORCE(!prefetch_thread_.joinable() && samples_consumed_ == 0,
+                   "The reader state can be restored only before the first run of the reader");
+    }
+    DALI_ENFORCE(state.epoch_size == loader_->Size(false) &&
+                 state.seed == loader_->GetSeed() &&
+                 state.number_of_shards == loader_->GetNumShards() &&
+                 state.shard_id == loader_->GetShardId(),
+                 make_string("The reader state doesn't match the reader configuration. ",
+                             "Expected epoch_size = ", loader_->Size(false),
+                             ", seed = ", loader_->GetSeed(),
+                             ", number_of_shards = ", loader_->GetNumShards(),
+                             ", shard_id = ", loader_->GetShardId(), ", got epoch_size = ",
+                             state.epoch_size, ", seed = ", state.seed,
+                             ", number_of_shards = ", state.number_of_shards,
+                             ", shard_id = ", state.shard_id));
+    DALI_ENFORCE(state.consumed_samples % max_batch_size_ == 0,
+                 make_string("The number of consumed samples (", state.consumed_samples,
+                             ") is not a multiple of the batch size (", max_batch_size_, ")"));
+    loader_->FastForward(state.consumed_samples, max_batch_size_);
+    samples_consumed_ = state.consumed_samples;
+  }
+
   LoadTarget& GetSample(int sample_idx) {
     return *prefetched_batch_queue_[curr_batch_consumer_][sample_idx];
   }
@@ -301,6 +337,7 @@ class DataReader : public Operator<Backend> {
       std::lock_guard<std::mutex> lock(prefetch_access_mutex_);
       AdvanceIndex(curr_batch_consumer_, consumer_cycle_);
     }
+    samples_consumed_ += max_batch_size_;
     producer_.notify_one();
   }
 
@@ -341,8 +378,10 @@ class DataReader : public Operator<Backend> {
   bool producer_cycle_;
   int device_id_;
 
-  // keep track of how many samples have been processed over all threads.
-  std::atomic<int> samples_processed_;
+  // number of samples (incl. padding) consumed from the prefetch queue by the runs of the
+  // operator - this includes the batches prefetched by the executor, which the pipeline
+  // accounts for when reporting the reader state
+  std::atomic<Index> samples_consumed_;
 
   // stores any catched exceptions in the prefetch worker
   std::exception_ptr prefetch_error_;
@@ -45,7 +45,8 @@ DALI_SCHEMA(readers___TFRecordBase)
 
 The index files can be obtained from TFRecord files by using the ``tfrecord2idx`` script
 that is distributed with DALI.)code",
-      DALI_STRING_VEC);
+      DALI_STRING_VEC)
+  .AddParent("EncodedSampleCacheAttr");
 
 // Internal readers._tfrecord schema.
 DALI_SCHEMA(readers___TFRecord)
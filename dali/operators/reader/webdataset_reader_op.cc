@@ -0,0 +1,80 @@
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <vector>
+
+#include "dali/operators/reader/webdataset_reader_op.h"
+
+namespace dali {
+
+DALI_REGISTER_OPERATOR(readers__Webdataset, WebdatasetReader, CPU);
+
+DALI_SCHEMA(readers__Webdataset)
+  .DocStr(R"(Reads samples stored in tar archives, following the WebDataset convention.
+
+The members of an archive are grouped into samples by their names: consecutive files which
+differ only in the extension (the part of the file name after the first dot) belong to the
+same sample. For example, an archive with the following content::
+
+  images/0001.jpg
+  images/0001.cls
+  images/0002.jpg
+  images/0002.cls
+
+read with ``ext=["jpg", "cls"]``, yields two samples, each with the contents of the ``.jpg``
+file in the first output and the contents of the ``.cls`` file in the second one.
+The outputs are 1D ``uint8`` tensors, which contain the raw contents of the files.
+
+The archives are read sequentially - the samples of an archive are returned in the order in
+which they are stored. Setting ``random_shuffle`` shuffles the samples within the shuffle buffer
+of ``initial_fill`` samples, and ``shuffle_shards`` changes the order of the archives at every
+epoch.
+
+Without ``index_paths``, the reader lists the contents of the archives when it's initialized,
+reading only the tar headers. An index file can be created beforehand with the ``wds2idx``
+script to avoid that.
+)")
+  .NumInput(0)
+  .OutputFn([](const OpSpec &spec) {
+    return static_cast<int>(spec.GetRepeatedArgument<std::string>("ext").size());
+  })
+  .AddArg("paths", R"(The list of paths to the tar archives.)", DALI_STRING_VEC)
+  .AddArg("ext", R"(The extensions of the files which go to the consecutive outputs.
+
+Each output can be assigned more than one extension, separated with semicolons,
+for example ``"jpg;jpeg;png"``. The files with other extensions are ignored.)", DALI_STRING_VEC)
+  .AddOptionalArg<vector<string>>("index_paths",
+      R"(The list of index files, one for every archive listed in ``paths``.
+
+The index files can be created with the ``wds2idx`` script. Each line of an index file
+describes one file stored in the archive: the position of its data, its size and its name.)",
+      nullptr)
+  .AddOptionalArg("missing_component_behavior",
+      R"(Decides what happens to the samples which don't have a file for every output.
+
+Possible values are:
+
+* ``"empty"`` - the missing components are returned as empty tensors,
+* ``"skip"`` - such samples are not returned,
+* ``"error"`` - an error is raised.)", std::string("empty"))
+  .AddOptionalArg("shuffle_shards",
+      R"(If set to True, the order in which the archives are read is shuffled at every epoch.
+
+The order is the same in all the instances of the reader, so that the data set is still divided
+between the shards, but the shards change after each epoch. ``stick_to_shard`` cannot be used
+when this argument is set to True.)", false)
+  .AddParent("LoaderBase");
+
+}  // namespace dali
@@ -0,0 +1,52 @@
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_OPERATORS_READER_WEBDATASET_READER_OP_H_
+#define DALI_OPERATORS_READER_WEBDATASET_READER_OP_H_
+
+#include <cstring>
+#include <vector>
+#include "dali/operators/reader/reader_op.h"
+#include "dali/operators/reader/loader/webdataset_loader.h"
+
+namespace dali {
+
+class WebdatasetReader : public DataReader<CPUBackend, std::vector<Tensor<CPUBackend>>> {
+ public:
+  explicit WebdatasetReader(const OpSpec& spec)
+    : DataReader<CPUBackend, std::vector<Tensor<CPUBackend>>>(spec) {
+    loader_ = InitLoader<WebdatasetLoader>(spec);
+  }
+
+  void RunImpl(SampleWorkspace &ws) override {
+    const auto& sample = GetSample(ws.data_idx());
+
+    // copy the components to the outputs directly
+    for (int i = 0; i < ws.NumOutput(); i++) {
+      auto &output = ws.Output<CPUBackend>(i);
+      Index size = sample[i].size();
+      output.Resize({size});
+      output.mutable_data<uint8_t>();
+      std::memcpy(output.raw_mutable_data(), sample[i].raw_data(), size);
+      output.SetSourceInfo(sample[i].GetSourceInfo());
+    }
+  }
+
+ protected:
+  USE_READER_OPERATOR_MEMBERS(CPUBackend, std::vector<Tensor<CPUBackend>>);
+};
+
+}  // namespace dali
+
+#endif  // DALI_OPERATORS_READER_WEBDATASET_READER_OP_H_
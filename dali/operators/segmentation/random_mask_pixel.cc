@@ -51,6 +51,7 @@ This argument is mutually exclusive with ``value`` argument.
 If 0, the pixel position is sampled uniformly from all available pixels.)code",
       0, true)
     .NumInput(1)
+    .Random()
     .NumOutput(1);
 
 class RandomMaskPixelCPU : public Operator<CPUBackend> {
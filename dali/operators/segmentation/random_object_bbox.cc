@@ -46,6 +46,7 @@ The output is a bounding box of the selected blob in one of the formats describe
 
 With probability 1-foreground_prob, the entire area of the input is returned.)")
   .NumInput(1)
+  .Random()
   .OutputFn([](const OpSpec& spec) {
     int separate_corners = spec.GetArgument<string>("format") != "box";
     int output_class = spec.GetArgument<bool>("output_class");
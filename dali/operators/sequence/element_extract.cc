@@ -34,35 +34,35 @@ DALI_SCHEMA(ElementExtract)
         });
 
 template <>
-void ElementExtract<CPUBackend>::RunImpl(SampleWorkspace &ws) {
-    const auto &input = ws.Input<CPUBackend>(0);
+void ElementExtract<CPUBackend>::RunImpl(HostWorkspace &ws) {
+    const auto &input = ws.InputRef<CPUBackend>(0);
     auto element_layout = VideoLayoutInfo::GetFrameLayout(input.GetLayout());
+    auto &tp = ws.GetThreadPool();
+    int nsamples = input.shape().num_samples();
+    int elements_per_sample = element_map_.size();
+    const TypeInfo &type = input.type();
 
-    auto shape = input.shape();
-    detail::CheckInputShape(shape, element_map_);
-    auto output_shape = shape.last(shape.size() - 1);
-    auto element_size = volume(output_shape);
+    for (int k = 0; k < elements_per_sample; k++)
+        ws.OutputRef<CPUBackend>(k).SetLayout(element_layout);
 
-    auto elements_per_sample = element_map_.size();
-    auto output_offset = 0;
-
-    TypeInfo type = input.type();
-    for (std::size_t k = 0; k < elements_per_sample; k++) {
-        auto output_idx = output_offset + k;
-        auto &output = ws.Output<CPUBackend>(output_idx);
-        output.set_type(input.type());
-        output.SetLayout(element_layout);
-        output.Resize(output_shape);
-
-        auto element_idx = element_map_[k];
-        auto element_offset = element_idx * element_size;
-
-        type.Copy<CPUBackend, CPUBackend>(
-            output.raw_mutable_data(),
-            static_cast<const uint8_t*>(input.raw_data()) + element_offset * type.size(),
-            element_size,
-            0);
+    for (int i = 0; i < nsamples; i++) {
+        auto sample_shape = input.shape()[i];
+        auto element_size = volume(sample_shape.begin() + 1, sample_shape.end());
+        // one task per sample copies all the requested elements
+        tp.AddWork([&, i, element_size](int) {
+            const auto *in_data = static_cast<const uint8_t*>(input[i].raw_data());
+            for (int k = 0; k < elements_per_sample; k++) {
+                auto &output = ws.OutputRef<CPUBackend>(k);
+                auto element_offset = element_map_[k] * element_size;
+                type.Copy<CPUBackend, CPUBackend>(
+                    output[i].raw_mutable_data(),
+                    in_data + element_offset * type.size(),
+                    element_size,
+                    0);
+            }
+        }, element_size * elements_per_sample);
     }
+    tp.RunAll();
 }
 
 DALI_REGISTER_OPERATOR(ElementExtract, ElementExtract<CPUBackend>, CPU);
@@ -18,25 +18,9 @@
 
 namespace dali {
 
-namespace detail {
-
-TensorListShape<> GetOutputShape(const TensorList<GPUBackend> &input,
-                                 const std::vector<int>& element_map) {
-    TensorListShape<> output_shape(input.ntensor(), input.shape().sample_dim() - 1);
-    for (unsigned int i = 0; i < input.ntensor(); ++i) {
-        auto shape = input.tensor_shape(i);
-        CheckInputShape(shape, element_map);
-        output_shape.set_tensor_shape(i, shape.last(shape.size() - 1));
-    }
-    return output_shape;
-}
-
-}  // namespace detail
-
 template <>
 void ElementExtract<GPUBackend>::RunImpl(DeviceWorkspace &ws) {
     auto &input = ws.Input<GPUBackend>(0);
-    auto output_shape = detail::GetOutputShape(input, element_map_);
     auto element_layout = VideoLayoutInfo::GetFrameLayout(input.GetLayout());
     int elements_per_sample = element_map_.size();
     int output_offset = 0;
@@ -44,9 +28,7 @@ void ElementExtract<GPUBackend>::RunImpl(DeviceWorkspace &ws) {
     for (int k = 0; k < elements_per_sample; k++) {
         int element = element_map_[k];
         auto &output = ws.Output<GPUBackend>(output_offset + k);
-        output.set_type(input.type());
         output.SetLayout(element_layout);
-        output.Resize(output_shape);
 
         for (unsigned int i = 0; i < input.ntensor(); i++) {
             auto tensor_shape = input.tensor_shape(i);
@@ -51,11 +51,29 @@ class ElementExtract : public Operator<Backend> {
   }
 
  protected:
+  bool CanInferOutputs() const override {
+    return true;
+  }
+
   bool SetupImpl(std::vector<OutputDesc> &output_desc, const workspace_t<Backend> &ws) override {
-    return false;
+    const auto &input = ws.template InputRef<Backend>(0);
+    const auto &in_shape = input.shape();
+    int nsamples = in_shape.num_samples();
+    TensorListShape<> output_shape(nsamples, in_shape.sample_dim() - 1);
+    for (int i = 0; i < nsamples; i++) {
+      auto shape = in_shape[i];
+      detail::CheckInputShape(shape, element_map_);
+      output_shape.set_tensor_shape(i, shape.last(shape.size() - 1));
+    }
+    output_desc.resize(element_map_.size());
+    for (auto &desc : output_desc) {
+      desc.shape = output_shape;
+      desc.type = input.type();
+    }
+    return true;
   }
 
-  void RunImpl(Workspace<Backend> &ws) override;
+  void RunImpl(workspace_t<Backend> &ws) override;
 
   USE_OPERATOR_MEMBERS();
   using Operator<Backend>::RunImpl;
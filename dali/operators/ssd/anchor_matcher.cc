@@ -0,0 +1,223 @@
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/operators/ssd/anchor_matcher.h"
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <map>
+#include <utility>
+
+namespace dali {
+
+namespace {
+
+/// @brief Upper limit of grid cells along one dimension
+constexpr int kMaxGridDim = 1024;
+
+inline bool valid_anchor(const Box<2, float> &anchor) {
+  float w = anchor.hi.x - anchor.lo.x, h = anchor.hi.y - anchor.lo.y;
+  return w > 0 && h > 0 && std::isfinite(w) && std::isfinite(h);
+}
+
+}  // namespace
+
+void AnchorMatcher::SetAnchors(span<const BoundingBox> anchors) {
+  nanchors_ = anchors.size();
+  grids_.clear();
+  cell_start_.clear();
+
+  // anchors of similar size (same binary exponent of the larger extent) share a grid
+  std::map<int, std::vector<int>> buckets;
+  for (int i = 0; i < nanchors_; i++) {
+    if (!valid_anchor(anchors[i]))
+      continue;  // has zero IoU with any box
+    auto ext = anchors[i].extent();
+    buckets[std::ilogb(std::max(ext.x, ext.y))].push_back(i);
+  }
+
+  std::vector<std::pair<int, int>> entries;  // (cell, anchor)
+  std::vector<ivec2> cell_xy;
+  for (auto &bucket : buckets) {
+    auto &idx = bucket.second;
+    vec2 max_ext = 0.0f, max_abs = 0.0f;
+    vec2 min_c = anchors[idx[0]].centroid(), max_c = min_c;
+    for (int i : idx) {
+      max_ext = max(max_ext, anchors[i].extent());
+      for (int d = 0; d < 2; d++)
+        max_abs[d] = std::max({ max_abs[d], std::abs(anchors[i].lo[d]),
+                                std::abs(anchors[i].hi[d]) });
+      min_c = min(min_c, anchors[i].centroid());
+      max_c = max(max_c, anchors[i].centroid());
+    }
+    float cell = std::max({ max_ext.x, max_ext.y,
+                            (max_c.x - min_c.x) / kMaxGridDim,
+                            (max_c.y - min_c.y) / kMaxGridDim });
+
+    Grid g;
+    g.origin_x = min_c.x;
+    g.origin_y = min_c.y;
+    g.inv_cell = 1.0f / cell;
+    // a little more than half of the extent, to account for rounding errors
+    g.reach_x = max_ext.x * 0.5f + (max_ext.x + max_abs.x) * 1e-5f;
+    g.reach_y = max_ext.y * 0.5f + (max_ext.y + max_abs.y) * 1e-5f;
+    g.width = 0;
+    g.height = 0;
+    cell_xy.clear();
+    for (int i : idx) {
+      auto c = anchors[i].centroid();
+      ivec2 xy(static_cast<int>((c.x - g.origin_x) * g.inv_cell),
+               static_cast<int>((c.y - g.origin_y) * g.inv_cell));
+      g.width = std::max(g.width, xy.x + 1);
+      g.height = std::max(g.height, xy.y + 1);
+      cell_xy.push_back(xy);
+    }
+    g.first_cell = cell_start_.size();
+    cell_start_.resize(cell_start_.size() + g.width * g.height, 0);
+    for (size_t k = 0; k < idx.size(); k++)
+      entries.emplace_back(g.first_cell + cell_xy[k].y * g.width + cell_xy[k].x, idx[k]);
+    grids_.push_back(g);
+  }
+
+  // counting sort of the anchors by cell
+  cell_start_.push_back(0);
+  for (auto &e : entries)
+    cell_start_[e.first]++;
+  int total = 0;
+  for (auto &s : cell_start_) {
+    int count = s;
+    s = total;
+    total += count;
+  }
+  std::vector<int> pos(cell_start_.begin(), cell_start_.end() - 1);
+  lo_x_.resize(total);
+  lo_y_.resize(total);
+  hi_x_.resize(total);
+  hi_y_.resize(total);
+  area_.resize(total);
+  index_.resize(total);
+  for (auto &e : entries) {
+    int dst = pos[e.first]++;
+    const auto &a = anchors[e.second];
+    lo_x_[dst] = a.lo.x;
+    lo_y_[dst] = a.lo.y;
+    hi_x_[dst] = a.hi.x;
+    hi_y_[dst] = a.hi.y;
+    area_[dst] = volume(a);
+    index_[dst] = e.second;
+  }
+}
+
+inline void AnchorMatcher::ProcessRange(int begin, int end, const BoundingBox &box,
+                                        float box_area, int box_idx,
+                                        float *best_iou, int *best_box,
+                                        float &max_iou, int &max_anchor) const {
+  auto update = [&](int i, float iou) {
+    int anchor = index_[i];
+    if (iou >= best_iou[anchor]) {
+      best_iou[anchor] = iou;
+      best_box[anchor] = box_idx;
+    }
+    if (iou > max_iou || (iou == max_iou && anchor > max_anchor)) {
+      max_iou = iou;
+      max_anchor = anchor;
+    }
+  };
+
+  int i = begin;
+#ifdef __SSE2__
+  __m128 blo_x = _mm_set1_ps(box.lo.x), blo_y = _mm_set1_ps(box.lo.y);
+  __m128 bhi_x = _mm_set1_ps(box.hi.x), bhi_y = _mm_set1_ps(box.hi.y);
+  __m128 barea = _mm_set1_ps(box_area);
+  __m128 zero = _mm_setzero_ps();
+  for (; i + 4 <= end; i += 4) {
+    __m128 w = _mm_sub_ps(_mm_min_ps(bhi_x, _mm_loadu_ps(&hi_x_[i])),
+                          _mm_max_ps(blo_x, _mm_loadu_ps(&lo_x_[i])));
+    __m128 h = _mm_sub_ps(_mm_min_ps(bhi_y, _mm_loadu_ps(&hi_y_[i])),
+                          _mm_max_ps(blo_y, _mm_loadu_ps(&lo_y_[i])));
+    __m128 overlap = _mm_and_ps(_mm_cmpgt_ps(w, zero), _mm_cmpgt_ps(h, zero));
+    if (!_mm_movemask_ps(overlap))
+      continue;
+    __m128 inter = _mm_mul_ps(w, h);
+    __m128 uni = _mm_sub_ps(_mm_add_ps(barea, _mm_loadu_ps(&area_[i])), inter);
+    __m128 iou = _mm_and_ps(overlap, _mm_div_ps(inter, uni));
+    int mask = _mm_movemask_ps(_mm_cmpgt_ps(iou, zero));
+    if (!mask)
+      continue;
+    float ious[4];
+    _mm_storeu_ps(ious, iou);
+    for (int k = 0; k < 4; k++)
+      if (mask & (1 << k))
+        update(i + k, ious[k]);
+  }
+#endif
+  for (; i < end; i++) {
+    float w = std::min(box.hi.x, hi_x_[i]) - std::max(box.lo.x, lo_x_[i]);
+    float h = std::min(box.hi.y, hi_y_[i]) - std::max(box.lo.y, lo_y_[i]);
+    if (!(w > 0 && h > 0))
+      continue;
+    float inter = w * h;
+    float iou = inter / ((box_area + area_[i]) - inter);
+    if (iou > 0)
+      update(i, iou);
+  }
+}
+
+void AnchorMatcher::Match(span<int> matches, span<const BoundingBox> boxes, float criteria,
+                          Scratch &scratch) const {
+  assert(matches.size() == nanchors_);
+  if (nanchors_ == 0)
+    return;
+  auto &best_iou = scratch.best_iou;
+  auto &best_box = scratch.best_box;
+  best_iou.assign(nanchors_, 0.0f);
+  best_box.assign(nanchors_, -1);
+
+  for (int b = 0; b < boxes.size(); b++) {
+    const auto &box = boxes[b];
+    float box_area = volume(box);
+    float max_iou = 0;
+    int max_anchor = -1;
+    for (auto &g : grids_) {
+      float fx0 = (box.lo.x - g.reach_x - g.origin_x) * g.inv_cell;
+      float fx1 = (box.hi.x + g.reach_x - g.origin_x) * g.inv_cell;
+      float fy0 = (box.lo.y - g.reach_y - g.origin_y) * g.inv_cell;
+      float fy1 = (box.hi.y + g.reach_y - g.origin_y) * g.inv_cell;
+      if (!(fx1 >= 0 && fx0 < g.width && fy1 >= 0 && fy0 < g.height))
+        continue;
+      int gx0 = fx0 > 0 ? static_cast<int>(fx0) : 0;
+      int gy0 = fy0 > 0 ? static_cast<int>(fy0) : 0;
+      int gx1 = fx1 < g.width ? static_cast<int>(fx1) : g.width - 1;
+      int gy1 = fy1 < g.height ? static_cast<int>(fy1) : g.height - 1;
+      for (int gy = gy0; gy <= gy1; gy++) {
+        int row = g.first_cell + gy * g.width;
+        ProcessRange(cell_start_[row + gx0], cell_start_[row + gx1 + 1], box, box_area, b,
+                     best_iou.data(), best_box.data(), max_iou, max_anchor);
+      }
+    }
+    // The best anchor for this box is matched regardless of the criteria. When the box doesn't
+    // overlap any anchor, all IoUs are zero and the last anchor is selected.
+    int forced = max_iou > 0 ? max_anchor : nanchors_ - 1;
+    best_iou[forced] = 2.0f;
+    best_box[forced] = b;
+  }
+
+  for (int a = 0; a < nanchors_; a++)
+    matches[a] = best_iou[a] > criteria ? best_box[a] : -1;
+}
+
+}  // namespace dali
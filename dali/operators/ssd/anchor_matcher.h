@@ -0,0 +1,99 @@
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_OPERATORS_SSD_ANCHOR_MATCHER_H_
+#define DALI_OPERATORS_SSD_ANCHOR_MATCHER_H_
+
+#include <vector>
+#include "dali/core/api_helper.h"
+#include "dali/core/geom/box.h"
+#include "dali/core/span.h"
+
+namespace dali {
+
+/**
+ * @brief Matches bounding boxes with a fixed set of anchors, as in SSD
+ *
+ * Each box is matched with the anchor that has the highest IoU with it. Each remaining anchor
+ * is matched with the box that has the highest IoU with it, provided that the IoU exceeds
+ * the criteria. Ties are resolved in favor of the box (or anchor) with the higher index.
+ * The result is the same as obtained from a dense boxes x anchors IoU matrix.
+ *
+ * The anchors are bucketed by scale and each bucket is indexed by a uniform grid over the anchor
+ * centers, with cells as large as the largest anchor in the bucket. For a given box, only
+ * the anchors whose centers lie close enough to overlap it are visited. Anchors are stored
+ * sorted by grid cell, so a row of cells is a contiguous range and IoU is computed for several
+ * anchors at once.
+ */
+class DLL_PUBLIC AnchorMatcher {
+ public:
+  using BoundingBox = Box<2, float>;
+
+  /**
+   * @brief Per-thread intermediate buffers
+   */
+  struct Scratch {
+    std::vector<float> best_iou;
+    std::vector<int> best_box;
+  };
+
+  AnchorMatcher() = default;
+  explicit AnchorMatcher(span<const BoundingBox> anchors) {
+    SetAnchors(anchors);
+  }
+
+  void SetAnchors(span<const BoundingBox> anchors);
+
+  int num_anchors() const {
+    return nanchors_;
+  }
+
+  /**
+   * @brief Finds the box matched with each anchor
+   *
+   * @param matches  for each anchor, the index of the matched box or -1 if there's no match
+   * @param boxes    the boxes to match with the anchors
+   * @param criteria minimum IoU (exclusive) required to match an anchor with a box that didn't
+   *                 select that anchor as its best match
+   */
+  void Match(span<int> matches, span<const BoundingBox> boxes, float criteria,
+             Scratch &scratch) const;
+
+ private:
+  struct Grid {
+    float origin_x, origin_y;
+    float inv_cell;
+    float reach_x, reach_y;  // half of the largest anchor extent
+    int width, height;
+    int first_cell;          // index of the first cell in cell_start_
+  };
+
+  /**
+   * @brief Calculates IoU of `box` with anchors [begin, end) of the sorted anchor list
+   *        and updates the per-anchor best matches
+   */
+  void ProcessRange(int begin, int end, const BoundingBox &box, float box_area, int box_idx,
+                    float *best_iou, int *best_box, float &max_iou, int &max_anchor) const;
+
+  int nanchors_ = 0;
+  std::vector<Grid> grids_;
+  std::vector<int> cell_start_;
+  // anchors in grid order (structure of arrays)
+  std::vector<float> lo_x_, lo_y_, hi_x_, hi_y_, area_;
+  std::vector<int> index_;
+};
+
+}  // namespace dali
+
+#endif  // DALI_OPERATORS_SSD_ANCHOR_MATCHER_H_
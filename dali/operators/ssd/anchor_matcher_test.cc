@@ -0,0 +1,131 @@
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+#include "dali/operators/ssd/anchor_matcher.h"
+#include "dali/pipeline/util/bounding_box_utils.h"
+
+namespace dali {
+
+namespace {
+
+using BoundingBox = AnchorMatcher::BoundingBox;
+
+/**
+ * @brief Dense reference - full boxes x anchors IoU matrix
+ */
+std::vector<int> RefMatch(const std::vector<BoundingBox> &anchors,
+                          const std::vector<BoundingBox> &boxes, float criteria) {
+  int nanchors = anchors.size(), nboxes = boxes.size();
+  std::vector<float> ious(nboxes * nanchors);
+  for (int b = 0; b < nboxes; b++) {
+    float *row = &ious[b * nanchors];
+    int best = 0;
+    for (int a = 0; a < nanchors; a++) {
+      row[a] = intersection_over_union(boxes[b], anchors[a]);
+      if (row[a] >= row[best])
+        best = a;
+    }
+    row[best] = 2;
+  }
+  std::vector<int> matches(nanchors, -1);
+  for (int a = 0; a < nanchors && nboxes > 0; a++) {
+    int best = 0;
+    for (int b = 1; b < nboxes; b++)
+      if (ious[b * nanchors + a] >= ious[best * nanchors + a])
+        best = b;
+    if (ious[best * nanchors + a] > criteria)
+      matches[a] = best;
+  }
+  return matches;
+}
+
+/**
+ * @brief SSD300-like anchors - several feature map sizes and aspect ratios
+ */
+std::vector<BoundingBox> SSDAnchors() {
+  std::vector<BoundingBox> anchors;
+  int fsizes[] = { 38, 19, 10, 5, 3, 1 };
+  float scales[] = { 0.07f, 0.15f, 0.33f, 0.51f, 0.69f, 0.87f, 1.05f };
+  for (int l = 0; l < 6; l++) {
+    float s = scales[l], s2 = std::sqrt(scales[l] * scales[l + 1]);
+    vec2 sizes[] = { { s, s }, { s2, s2 }, { s * 1.41421f, s / 1.41421f },
+                     { s / 1.41421f, s * 1.41421f } };
+    for (int y = 0; y < fsizes[l]; y++) {
+      for (int x = 0; x < fsizes[l]; x++) {
+        vec2 c = { (x + 0.5f) / fsizes[l], (y + 0.5f) / fsizes[l] };
+        for (auto sz : sizes)
+          anchors.push_back({ clamp(c - sz * 0.5f, vec2(0), vec2(1)),
+                              clamp(c + sz * 0.5f, vec2(0), vec2(1)) });
+      }
+    }
+  }
+  return anchors;
+}
+
+std::vector<BoundingBox> RandomBoxes(int n, std::mt19937 &rng) {
+  std::uniform_real_distribution<float> pos(-0.1f, 1.0f), size(0.0f, 0.5f);
+  std::vector<BoundingBox> boxes(n);
+  for (auto &box : boxes) {
+    box.lo = { pos(rng), pos(rng) };
+    box.hi = box.lo + vec2(size(rng), size(rng));
+  }
+  return boxes;
+}
+
+void CheckMatch(const std::vector<BoundingBox> &anchors,
+                const std::vector<BoundingBox> &boxes, float criteria) {
+  AnchorMatcher matcher(make_cspan(anchors));
+  AnchorMatcher::Scratch scratch;
+  std::vector<int> matches(anchors.size());
+  matcher.Match(make_span(matches), make_cspan(boxes), criteria, scratch);
+  auto ref = RefMatch(anchors, boxes, criteria);
+  for (size_t a = 0; a < anchors.size(); a++)
+    ASSERT_EQ(matches[a], ref[a]) << "anchor " << a << " criteria " << criteria;
+}
+
+}  // namespace
+
+TEST(AnchorMatcher, SSDAnchors) {
+  std::mt19937 rng(1234);
+  auto anchors = SSDAnchors();
+  for (int nboxes : { 0, 1, 3, 20, 100 }) {
+    auto boxes = RandomBoxes(nboxes, rng);
+    for (float criteria : { 0.0f, 0.3f, 0.5f, 1.0f })
+      CheckMatch(anchors, boxes, criteria);
+  }
+}
+
+TEST(AnchorMatcher, RandomAnchors) {
+  std::mt19937 rng(4321);
+  for (int iter = 0; iter < 20; iter++) {
+    auto anchors = RandomBoxes(1 + rng() % 300, rng);
+    anchors.push_back({ vec2(0.5f), vec2(0.5f) });  // degenerate
+    auto boxes = RandomBoxes(rng() % 40, rng);
+    CheckMatch(anchors, boxes, 0.5f);
+  }
+}
+
+TEST(AnchorMatcher, Ties) {
+  // identical anchors and boxes - the highest index should win
+  std::vector<BoundingBox> anchors(5, { vec2(0.1f), vec2(0.4f) });
+  anchors.push_back({ vec2(0.6f), vec2(0.9f) });
+  std::vector<BoundingBox> boxes(3, { vec2(0.1f), vec2(0.4f) });
+  boxes.push_back({ vec2(2.0f), vec2(3.0f) });  // doesn't overlap any anchor
+  CheckMatch(anchors, boxes, 0.5f);
+}
+
+}  // namespace dali
@@ -21,68 +21,6 @@ namespace dali {
 
 using BoundingBox = BoxEncoder<CPUBackend>::BoundingBox;
 
-void BoxEncoder<CPUBackend>::CalculateIousForBox(float *ious, const BoundingBox &box) const {
-  ious[0] = intersection_over_union(box, anchors_[0]);
-  unsigned best_idx = 0;
-  float best_iou = ious[0];
-
-  for (unsigned anchor_idx = 1; anchor_idx < anchors_.size(); ++anchor_idx) {
-    ious[anchor_idx] = intersection_over_union(box, anchors_[anchor_idx]);
-
-    if (ious[anchor_idx] >= best_iou) {
-      best_iou = ious[anchor_idx];
-      best_idx = anchor_idx;
-    }
-  }
-
-  // For best default box matched with current object let iou = 2, to make sure there is a match,
-  // as this object will be the best (highest IoU), for this default box
-  ious[best_idx] = 2.;
-}
-
-vector<float> BoxEncoder<CPUBackend>::CalculateIous(const vector<BoundingBox> &boxes) const {
-  vector<float> ious(boxes.size() * anchors_.size());
-
-  for (unsigned bbox_idx = 0; bbox_idx < boxes.size(); ++bbox_idx) {
-    auto ious_row = ious.data() + bbox_idx * anchors_.size();
-    CalculateIousForBox(ious_row, boxes[bbox_idx]);
-  }
-
-  return ious;
-}
-
-unsigned BoxEncoder<CPUBackend>::FindBestBoxForAnchor(
-  unsigned anchor_idx, const vector<float> &ious, unsigned num_boxes) const {
-  unsigned best_idx = 0;
-  float best_iou = ious[anchor_idx];
-
-  for (unsigned bbox_idx = 1; bbox_idx < num_boxes; ++bbox_idx) {
-    if (ious[bbox_idx * anchors_.size() + anchor_idx] >= best_iou) {
-      best_iou = ious[bbox_idx * anchors_.size() + anchor_idx];
-      best_idx = bbox_idx;
-    }
-  }
-
-  return best_idx;
-}
-
-vector<std::pair<unsigned, unsigned>> BoxEncoder<CPUBackend>::MatchBoxesWithAnchors(
-  const vector<BoundingBox> &boxes) const {
-  const auto ious = CalculateIous(boxes);
-  vector<std::pair<unsigned, unsigned>> matches;
-
-  for (unsigned anchor_idx = 0; anchor_idx < anchors_.size(); ++anchor_idx) {
-    const auto best_idx = FindBestBoxForAnchor(anchor_idx, ious, boxes.size());
-
-    // Filter matches by criteria
-    if (ious[best_idx * anchors_.size() + anchor_idx] > criteria_) {
-      matches.push_back({best_idx, anchor_idx});
-    }
-  }
-
-  return matches;
-}
-
 template <int ndim>
 void WriteBoxToOutput(float *out_box_data, const vec<ndim, float> &center,
                       const vec<ndim, float> &extent) {
@@ -132,56 +70,80 @@ GetOffsets(vec2 box_center,
 }
 
 void BoxEncoder<CPUBackend>::WriteMatchesToOutput(
-  const vector<std::pair<unsigned, unsigned>> matches, const vector<BoundingBox> &boxes,
+  span<const int> matches, span<const BoundingBox> boxes,
   const int *labels, float *out_boxes, int *out_labels) const {
-  if (offset_) {
-    for (const auto &match : matches) {
-      auto box = boxes[match.first];
-      auto anchor = anchors_[match.second];
-
+  for (int anchor_idx = 0; anchor_idx < matches.size(); anchor_idx++) {
+    int box_idx = matches[anchor_idx];
+    if (box_idx < 0)
+      continue;
+    const auto &box = boxes[box_idx];
+    if (offset_) {
+      const auto &anchor = anchors_[anchor_idx];
       vec2 center, extent;
       std::tie(center, extent) = GetOffsets(box.centroid(), box.extent(), anchor.centroid(),
                                             anchor.extent(), means_, stds_, scale_);
-      WriteBoxToOutput(out_boxes + match.second * BoundingBox::size, center, extent);
-      out_labels[match.second] = labels[match.first];
-    }
-  } else {
-    for (const auto &match : matches) {
-      auto box = boxes[match.first];
-      WriteBoxToOutput(out_boxes + match.second * BoundingBox::size, box.centroid(),
+      WriteBoxToOutput(out_boxes + anchor_idx * BoundingBox::size, center, extent);
+    } else {
+      WriteBoxToOutput(out_boxes + anchor_idx * BoundingBox::size, box.centroid(),
                        box.extent());
-      out_labels[match.second] = labels[match.first];
     }
+    out_labels[anchor_idx] = labels[box_idx];
   }
 }
 
-void BoxEncoder<CPUBackend>::RunImpl(SampleWorkspace &ws) {
-  const auto &bboxes_input = ws.Input<CPUBackend>(kBoxesInId);
-  const auto &labels_input = ws.Input<CPUBackend>(kLabelsInId);
-  const auto num_boxes = bboxes_input.dim(0);
-  const auto labels = labels_input.data<int>();
+void BoxEncoder<CPUBackend>::EncodeSample(float *out_boxes, int *out_labels,
+                                          const float *in_boxes, const int *labels,
+                                          int num_boxes, ThreadBuffers &buffers) const {
+  WriteAnchorsToOutput(out_boxes, out_labels);
+  if (num_boxes == 0)
+    return;
 
-  vector<BoundingBox> boxes;
+  auto &boxes = buffers.boxes;
   boxes.resize(num_boxes);
-  ReadBoxes(make_span(boxes), make_cspan(bboxes_input.data<float>(), bboxes_input.size()), {}, {});
-
-  // Create output
-  auto &bboxes_output = ws.Output<CPUBackend>(kBoxesOutId);
-  bboxes_output.set_type(bboxes_input.type());
-  bboxes_output.Resize({static_cast<int>(anchors_.size()), BoundingBox::size});
-  auto out_boxes = bboxes_output.mutable_data<float>();
+  ReadBoxes(make_span(boxes), make_cspan(in_boxes, num_boxes * BoundingBox::size), {}, {});
 
-  auto &labels_output = ws.Output<CPUBackend>(kLabelsOutId);
-  labels_output.set_type(labels_input.type());
-  labels_output.Resize({static_cast<int>(anchors_.size())});
-  auto out_labels = labels_output.mutable_data<int>();
+  auto &matches = buffers.matches;
+  matches.resize(anchors_.size());
+  matcher_.Match(make_span(matches), make_cspan(boxes), criteria_, buffers.scratch);
+  WriteMatchesToOutput(make_cspan(matches), make_cspan(boxes), labels, out_boxes, out_labels);
+}
 
-  WriteAnchorsToOutput(out_boxes, out_labels);
-  if (num_boxes == 0)
-    return;
+bool BoxEncoder<CPUBackend>::SetupImpl(std::vector<OutputDesc> &output_desc,
+                                       const HostWorkspace &ws) {
+  const auto &boxes_input = ws.InputRef<CPUBackend>(kBoxesInId);
+  const auto &labels_input = ws.InputRef<CPUBackend>(kLabelsInId);
+  DALI_ENFORCE(boxes_input.type().id() == DALI_FLOAT, "Bounding boxes must be of float type.");
+  DALI_ENFORCE(labels_input.type().id() == DALI_INT32, "Labels must be of int32 type.");
+  int nsamples = boxes_input.shape().size();
+  int64_t nanchors = anchors_.size();
+  output_desc.resize(2);
+  output_desc[kBoxesOutId].type = boxes_input.type();
+  output_desc[kBoxesOutId].shape =
+      uniform_list_shape(nsamples, TensorShape<2>{nanchors, BoundingBox::size});
+  output_desc[kLabelsOutId].type = labels_input.type();
+  output_desc[kLabelsOutId].shape = uniform_list_shape(nsamples, TensorShape<1>{nanchors});
+  return true;
+}
 
-  const auto matches = MatchBoxesWithAnchors(boxes);
-  WriteMatchesToOutput(matches, boxes, labels, out_boxes, out_labels);
+void BoxEncoder<CPUBackend>::RunImpl(HostWorkspace &ws) {
+  auto boxes_in = view<const float>(ws.InputRef<CPUBackend>(kBoxesInId));
+  auto labels_in = view<const int>(ws.InputRef<CPUBackend>(kLabelsInId));
+  auto boxes_out = view<float>(ws.OutputRef<CPUBackend>(kBoxesOutId));
+  auto labels_out = view<int>(ws.OutputRef<CPUBackend>(kLabelsOutId));
+  int nsamples = boxes_in.shape.size();
+  auto &tp = ws.GetThreadPool();
+  buffers_.resize(tp.NumThreads());
+
+  for (int sample_idx = 0; sample_idx < nsamples; sample_idx++) {
+    int num_boxes = boxes_in.shape.tensor_size(sample_idx) / BoundingBox::size;
+    tp.AddWork(
+      [&, sample_idx, num_boxes](int thread_id) {
+        EncodeSample(boxes_out[sample_idx].data, labels_out[sample_idx].data,
+                     boxes_in[sample_idx].data, labels_in[sample_idx].data,
+                     num_boxes, buffers_[thread_id]);
+      }, anchors_.size() * (num_boxes + 1));
+  }
+  tp.RunAll();
 }
 
 DALI_REGISTER_OPERATOR(BoxEncoder, BoxEncoder<CPUBackend>, CPU);
@@ -21,6 +21,7 @@
 #include <utility>
 #include "dali/core/cuda_utils.h"
 #include "dali/core/tensor_shape.h"
+#include "dali/operators/ssd/anchor_matcher.h"
 #include "dali/pipeline/operator/operator.h"
 #include "dali/pipeline/util/bounding_box_utils.h"
 
@@ -53,6 +54,7 @@ class BoxEncoder<CPUBackend>: public Operator<CPUBackend> {
 
     anchors_.resize(nanchors);
     ReadBoxes(make_span(anchors_), make_cspan(anchors), {}, {});
+    matcher_.SetAnchors(make_cspan(anchors_));
 
     means_ = spec.GetArgument<vector<float>>("means");
     DALI_ENFORCE(means_.size() == 4,
@@ -70,37 +72,39 @@ class BoxEncoder<CPUBackend>: public Operator<CPUBackend> {
   DISABLE_COPY_MOVE_ASSIGN(BoxEncoder);
 
  protected:
-  bool SetupImpl(std::vector<OutputDesc> &output_desc, const HostWorkspace &ws) override {
-    return false;
+  bool CanInferOutputs() const override {
+    return true;
   }
 
-  void RunImpl(Workspace<CPUBackend> &ws) override;
+  bool SetupImpl(std::vector<OutputDesc> &output_desc, const HostWorkspace &ws) override;
+
+  void RunImpl(HostWorkspace &ws) override;
   using Operator<CPUBackend>::RunImpl;
 
  private:
   const float criteria_;
   vector<BoundingBox> anchors_;
+  AnchorMatcher matcher_;
+
+  struct ThreadBuffers {
+    vector<BoundingBox> boxes;
+    vector<int> matches;
+    AnchorMatcher::Scratch scratch;
+  };
+  vector<ThreadBuffers> buffers_;
 
   bool offset_;
   vector<float> means_;
   vector<float> stds_;
   float scale_;
 
-  vector<float> CalculateIous(const vector<BoundingBox> &boxes) const;
-
-  void CalculateIousForBox(float *ious, const BoundingBox &box) const;
+  void EncodeSample(float *out_boxes, int *out_labels, const float *in_boxes,
+                    const int *labels, int num_boxes, ThreadBuffers &buffers) const;
 
   void WriteAnchorsToOutput(float *out_boxes, int *out_labels) const;
 
-  void WriteMatchesToOutput(const vector<std::pair<unsigned, unsigned>> matches,
-                            const vector<BoundingBox> &boxes, const int *labels,
-                            float *out_boxes, int *out_labels) const;
-
-  vector<std::pair<unsigned, unsigned>> MatchBoxesWithAnchors(
-    const vector<BoundingBox> &boxes) const;
-
-  unsigned FindBestBoxForAnchor(
-    unsigned anchor_idx, const vector<float> &ious, unsigned num_boxes) const;
+  void WriteMatchesToOutput(span<const int> matches, span<const BoundingBox> boxes,
+                            const int *labels, float *out_boxes, int *out_labels) const;
 
   static const int kBoxesInId = 0;
   static const int kLabelsInId = 1;
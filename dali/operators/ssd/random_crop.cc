@@ -13,14 +13,14 @@
 // limitations under the License.
 
 
-#include <vector>
+#include <algorithm>
+#include <cstring>
 #include <random>
 #include <utility>
-#include <algorithm>
+#include <vector>
 
 #include "dali/operators/ssd/random_crop.h"
 #include "dali/pipeline/operator/common.h"
-#include "dali/util/ocv.h"
 
 namespace dali {
 
@@ -32,6 +32,7 @@ When the IoU falls below the threshold, a new random crop is generated up to num
 As an input, the operator accepts image, bounding boxes and labels. At the output cropped image,
 cropped and valid bounding boxes and valid labels are returned.)code")
   .NumInput(3)   // [img, bbox, label]
+  .Random()
   .NumOutput(3)  // [img, bbox, label]
   .AddOptionalArg("num_attempts", R"code(Number of attempts.)code", 1)
   .Deprecate("RandomBBoxCrop");  // deprecated in DALI 0.30
@@ -73,258 +74,215 @@ cropped and valid bounding boxes and valid labels are returned.)code")
 namespace detail {
 
 // input in ltrb format
-// box1 is [N, 4], box2 is [M, 4]
-// calculate IoU of every box1 vs. every box2 : O(N^2)
-Tensor<CPUBackend> cpu_iou(const Tensor<CPUBackend>& box1,
-                           const Tensor<CPUBackend>& box2) {
-  Tensor<CPUBackend> ious;
-  ious.set_pinned(false);
-
-  int N = box1.dim(0);
-  // Note: We know M=1 in this use-case
-  // int M = box2.dim(0);
-  const int M = 1;
-
-  const float* box1_data = box1.data<float>();
-  const float* box2_data = box2.data<float>();
-
-  ious.Resize({N, 1});
-  float *ious_data = ious.mutable_data<float>();
-
-  std::vector<std::pair<float, float>> lt, rb;
-
-  /*
-   * # Left Top & Right Bottom
-   * lt = torch.max(be1[:,:,:2], be2[:,:,:2])
-   * rb = torch.min(be1[:,:,2:], be2[:,:,2:])
-   */
-  for (int i = 0; i < N; ++i) {
-    const float *b1 = box1_data + i * box1.dim(1);
-    const float *b2 = box2_data;
-
-    // want the maximum top, left
-    float l = std::max(b1[0], b2[0]);
-    float t = std::max(b1[1], b2[1]);
-
-    // minimum bottom, right
-    float r = std::min(b1[2], b2[2]);
-    float b = std::min(b1[3], b2[3]);
-
-    lt.push_back(std::make_pair(l, t));
-    rb.push_back(std::make_pair(r, b));
-  }
-
-  // delta = rb - lt
-  // delta[delta < 0] = 0
-  // intersect = delta[:,:,0] * delta[:,:, 1]
-  vector<float> intersect(N);
-  for (int i = 0; i < N; ++i) {
-    float first_elem = rb[i].first - lt[i].first;
-    float second_elem = rb[i].second - lt[i].second;
-
-    // delta[delta < 0] = 0
-    first_elem = (first_elem < 0) ? 0 : first_elem;
-    second_elem = (second_elem < 0) ? 0 : second_elem;
-    float inter = first_elem * second_elem;
-
-    intersect[i] = inter;
-  }
-
-  // delta1 = be1[:, :, 2:] - be1[:, :, :2]
-  // area1 = delta1[:, :, 0] * delta[:, :, 1]
-  vector<float> area1(N);
-  for (int i = 0; i < N; ++i) {
-    const float* box = box1_data + i * 4;
-    // area is (b-t) * (r-l)
-    area1[i] = (box[3] - box[1]) * (box[2] - box[0]);
-  }
-  // delta2 = be2[:, :, 2:] - be2[:, :, :2]
-  // area2 = delta2[:, :, 0] * delta[:, :, 2]
-  const float* box = box2_data;
+// boxes is [N, 4], crop is [4]
+// returns true if IoU of every box with the crop is at least min_iou
+bool all_ious_above(const float *boxes, int N, const float *crop, float min_iou) {
   // area is (b-t) * (r-l)
-  auto area2 = (box[3] - box[1]) * (box[2] - box[0]);
-
-  // iou = intersect / (area1 + area2 - intersect)
+  float crop_area = (crop[3] - crop[1]) * (crop[2] - crop[0]);
   for (int i = 0; i < N; ++i) {
-    // index into N*M arrays
-    auto idx = i;
-    ious_data[idx] = intersect[idx] / (area1[i] + area2 - intersect[idx]);
+    const float *box = boxes + i * 4;
+    // delta = rb - lt
+    // delta[delta < 0] = 0
+    float w = std::max(std::min(box[2], crop[2]) - std::max(box[0], crop[0]), 0.0f);
+    float h = std::max(std::min(box[3], crop[3]) - std::max(box[1], crop[1]), 0.0f);
+    float intersect = w * h;
+    float box_area = (box[3] - box[1]) * (box[2] - box[0]);
+    // iou = intersect / (area1 + area2 - intersect)
+    if (intersect / (box_area + crop_area - intersect) < min_iou)
+      return false;
   }
-  return ious;
+  return true;
 }
 
 // img is [H, W, C], bounds [l, t, r, b]
-// output [r-l, b-t, C]
-void crop(const Tensor<CPUBackend>& img, vector<int> bounds, Tensor<CPUBackend>& out) {
-  // output dimensions
-  const int width = bounds[2] - bounds[0];
-  const int height = bounds[3] - bounds[1];
-  // input dimensions
-  const int H = img.dim(0);
-  const int W = img.dim(1);
-  const int C = img.dim(2);
-
-  out.Resize({height, width, C});
-  uint8_t *out_data = out.mutable_data<uint8_t>();
-
-  int out_idx = 0;
-  for (int h = bounds[1]; h < bounds[3]; ++h) {
-    const int idx = h * W * C + bounds[0] * C;
-    memcpy(out_data + out_idx, img.data<uint8_t>() + idx, (bounds[2] - bounds[0]) * C);
-    out_idx += (bounds[2] - bounds[0]) * C;
+// output [b-t, r-l, C]
+void crop(uint8_t *out_data, const uint8_t *img_data, const TensorShape<> &img_shape,
+          int l, int t, int r, int b) {
+  const int W = img_shape[1];
+  const int C = img_shape[2];
+  const int row_size = (r - l) * C;
+  for (int h = t; h < b; ++h) {
+    memcpy(out_data, img_data + (h * W + l) * C, row_size);
+    out_data += row_size;
   }
 }
 
 }  // namespace detail
 
 template <>
-void SSDRandomCrop<CPUBackend>::RunImpl(SampleWorkspace &ws) {
+bool SSDRandomCrop<CPUBackend>::SetupImpl(std::vector<OutputDesc> &output_desc,
+                                          const HostWorkspace &ws) {
   // [H, W, C], dtype=uint8_t
-  const auto& img = ws.Input<CPUBackend>(0);
+  const auto &images = ws.InputRef<CPUBackend>(0);
   // [N] : [ltrb, ... ], dtype=float
-  const auto& bboxes = ws.Input<CPUBackend>(1);
-  const auto& labels = ws.Input<CPUBackend>(2);
-  int sample = ws.data_idx();
-
-  auto N = bboxes.dim(0);
-  const float* bbox_data = bboxes.data<float>();
-
-  const int* label_data = labels.data<int>();
-
-  // [1x4]
-  Tensor<CPUBackend> crop_attempt;
-  crop_attempt.set_pinned(false);
-  crop_attempt.Resize({1, 4});
-  float *crop_ptr = crop_attempt.mutable_data<float>();
-  // iterate until a suitable crop has been found
-  while (true) {
-    auto opt_idx = int_dis_(rngs_[sample]);
-    auto option = sample_options_[opt_idx];
-
-    if (option.no_crop()) {
-      // copy directly to output without modification
-      ws.Output<CPUBackend>(0).Copy(img, 0);
-      ws.Output<CPUBackend>(1).Copy(bboxes, 0);
-      ws.Output<CPUBackend>(2).Copy(labels, 0);
-      return;
-    }
-
-    // input is HWC ordering
-    auto htot = img.dim(0);
-    auto wtot = img.dim(1);
-
-    auto min_iou = option.min_iou();
-
-    // make num_attempts_ tries to get a valid crop
-    for (int i = 0; i < num_attempts_; ++i) {
-      auto w = float_dis_(rngs_[sample]);
-      auto h = float_dis_(rngs_[sample]);
-      // aspect ratio check
-      if ((w / h < 0.5) || (w / h > 2.)) {
-        continue;
-      }
-
-      // need RNG generators for left, top
-      std::uniform_real_distribution<float> l_dis(0., 1. - w), t_dis(0., 1. - h);
-      double left = l_dis(rngs_[sample]);
-      double top = t_dis(rngs_[sample]);
-
-      double right = left + w;
-      double bottom = top + h;
-
-      crop_ptr[0] = left;
-      crop_ptr[1] = top;
-      crop_ptr[2] = right;
-      crop_ptr[3] = bottom;
-
-      // returns ious : [N, M]
-
-      Tensor<CPUBackend> ious = detail::cpu_iou(bboxes, crop_attempt);
-      const float *ious_data = ious.data<float>();
+  const auto &bboxes = ws.InputRef<CPUBackend>(1);
+  const auto &labels = ws.InputRef<CPUBackend>(2);
+  int nsamples = images.shape().num_samples();
+  crops_.resize(nsamples);
+
+  // The crops are drawn in parallel - each sample has its own generator, so the result
+  // doesn't depend on the scheduling.
+  auto &tp = ws.GetThreadPool();
+  for (int sample = 0; sample < nsamples; sample++) {
+    tp.AddWork([&, sample](int) {
+      auto &crop = crops_[sample];
+      auto img_shape = images.shape()[sample];
+      int N = bboxes.shape()[sample][0];
+      const float *bbox_data = bboxes[sample].data<float>();
+      crop.box_indices.clear();
+      crop.boxes.clear();
+      // distributions may hold state - each task uses its own copy
+      auto int_dis = int_dis_;
+      auto float_dis = float_dis_;
+
+      // iterate until a suitable crop has been found
+      while (true) {
+        auto opt_idx = int_dis(rngs_[sample]);
+        auto option = sample_options_[opt_idx];
+
+        if (option.no_crop()) {
+          crop.no_crop = true;
+          return;
+        }
 
-      // make sure all the calculated IoUs are in the range (min_iou, max_iou)
-      // Note: ious has size N*M, but M = 1 in this case
-      bool fail = false;
-      for (int j = 0; j < N * 1; ++j) {
-        if (ious_data[j] < min_iou) fail = true;
-      }
-      // generate a new crop
-      if (fail) {
-        continue;
+        // input is HWC ordering
+        auto htot = img_shape[0];
+        auto wtot = img_shape[1];
+
+        auto min_iou = option.min_iou();
+
+        // make num_attempts_ tries to get a valid crop
+        for (int i = 0; i < num_attempts_; ++i) {
+          auto w = float_dis(rngs_[sample]);
+          auto h = float_dis(rngs_[sample]);
+          // aspect ratio check
+          if ((w / h < 0.5) || (w / h > 2.)) {
+            continue;
+          }
+
+          // need RNG generators for left, top
+          std::uniform_real_distribution<float> l_dis(0., 1. - w), t_dis(0., 1. - h);
+          double left = l_dis(rngs_[sample]);
+          double top = t_dis(rngs_[sample]);
+
+          double right = left + w;
+          double bottom = top + h;
+
+          float crop_box[4] = { static_cast<float>(left), static_cast<float>(top),
+                                static_cast<float>(right), static_cast<float>(bottom) };
+
+          // make sure all the calculated IoUs are in the range (min_iou, max_iou)
+          // generate a new crop otherwise
+          if (!detail::all_ious_above(bbox_data, N, crop_box, min_iou)) {
+            continue;
+          }
+
+          // discard any bboxes whose center is not in the cropped image
+          crop.box_indices.clear();
+          for (int j = 0; j < N; ++j) {
+            const auto* bbox = bbox_data + j * 4;
+            auto xc = 0.5*(bbox[0] + bbox[2]);
+            auto yc = 0.5*(bbox[1] + bbox[3]);
+
+            bool valid = (xc >= left) && (xc <= right) && (yc >= top) && (yc <= bottom);
+            if (valid)
+              crop.box_indices.push_back(j);
+          }
+          // If we don't have any valid boxes, generate a new crop
+          if (crop.box_indices.empty()) {
+            continue;
+          }
+
+          // transform the valid bboxes
+          crop.boxes.resize(crop.box_indices.size() * 4);
+          for (size_t j = 0; j < crop.box_indices.size(); ++j) {
+            const auto *bbox_i = bbox_data + crop.box_indices[j] * 4;
+            auto *bbox_o = &crop.boxes[j * 4];
+
+            // scaling
+            double minus[] = {left, top, left, top};
+            double scale[] = {w, h, w, h};
+            for (int k = 0; k < 4; ++k) {
+              // scale and translate the input box
+              double coord = (bbox_i[k] - minus[k]) / scale[k];
+              // ..and clamp it to 0..1 range
+              bbox_o[k] = std::min(std::max(coord, 0.0), 1.0);
+            }
+          }
+
+          // everything is good, generate the crop parameters
+          crop.no_crop = false;
+          crop.left = std::llround(left * wtot);
+          crop.top = std::llround(top * htot);
+          crop.right = std::llround(right * wtot);
+          crop.bottom = std::llround(bottom * htot);
+          return;
+        }  // end num_attempts loop
       }
+    }, bboxes.shape().tensor_size(sample) * num_attempts_);
+  }
+  tp.RunAll();
+
+  output_desc.resize(3);
+  output_desc[0].type = images.type();
+  output_desc[0].shape = images.shape();
+  output_desc[1].type = bboxes.type();
+  output_desc[1].shape = bboxes.shape();
+  output_desc[2].type = labels.type();
+  output_desc[2].shape = labels.shape();
+  for (int sample = 0; sample < nsamples; sample++) {
+    const auto &crop = crops_[sample];
+    if (crop.no_crop)
+      continue;
+    int channels = images.shape()[sample][2];
+    int num_boxes = crop.box_indices.size();
+    output_desc[0].shape.set_tensor_shape(
+        sample, TensorShape<>{crop.bottom - crop.top, crop.right - crop.left, channels});
+    output_desc[1].shape.set_tensor_shape(sample, TensorShape<>{num_boxes, 4});
+    output_desc[2].shape.set_tensor_shape(sample, TensorShape<>{num_boxes});
+  }
+  return true;
+}
 
-      // discard any bboxes whose center is not in the cropped image
-      int valid_bboxes = 0;
-      std::vector<int> mask;
-      for (int j = 0; j < N; ++j) {
-        const auto* bbox = bbox_data + j * 4;
-        auto xc = 0.5*(bbox[0] + bbox[2]);
-        auto yc = 0.5*(bbox[1] + bbox[3]);
-
-        bool valid = (xc >= left) && (xc <= right) && (yc >= top) && (yc <= bottom);
-        if (valid) {
-          mask.push_back(j);
-          valid_bboxes += 1;
-        }
-      }
-      // If we don't have any valid boxes, generate a new crop
-      if (!valid_bboxes) {
-        continue;
+template <>
+void SSDRandomCrop<CPUBackend>::RunImpl(HostWorkspace &ws) {
+  const auto &images = ws.InputRef<CPUBackend>(0);
+  const auto &bboxes = ws.InputRef<CPUBackend>(1);
+  const auto &labels = ws.InputRef<CPUBackend>(2);
+  auto &img_out = ws.OutputRef<CPUBackend>(0);
+  auto &bbox_out = ws.OutputRef<CPUBackend>(1);
+  auto &label_out = ws.OutputRef<CPUBackend>(2);
+  img_out.SetLayout(images.GetLayout());
+  int nsamples = images.shape().num_samples();
+
+  auto &tp = ws.GetThreadPool();
+  for (int sample = 0; sample < nsamples; sample++) {
+    tp.AddWork([&, sample](int) {
+      const auto &crop = crops_[sample];
+      if (crop.no_crop) {
+        // copy directly to output without modification
+        memcpy(img_out[sample].raw_mutable_data(), images[sample].raw_data(),
+               images[sample].nbytes());
+        memcpy(bbox_out[sample].raw_mutable_data(), bboxes[sample].raw_data(),
+               bboxes[sample].nbytes());
+        memcpy(label_out[sample].raw_mutable_data(), labels[sample].raw_data(),
+               labels[sample].nbytes());
+        return;
       }
 
-      // now we know how many output bboxes there will be, we can allocate
-      // the output.
-      auto &img_out = ws.Output<CPUBackend>(0);
-      img_out.SetLayout(img.GetLayout());
-      auto &bbox_out = ws.Output<CPUBackend>(1);
-      auto &label_out = ws.Output<CPUBackend>(2);
-
-      bbox_out.Resize({valid_bboxes, 4});
-      auto *bbox_out_data = bbox_out.mutable_data<float>();
-
-      label_out.Resize({valid_bboxes});
-      auto *label_out_data = label_out.mutable_data<int>();
-
-      // copy valid bboxes to output and transform them
-      for (int j = 0; j < valid_bboxes; ++j) {
-        int idx = mask[j];
-
-        // this bbox is being preserved
-        const auto *bbox_i = bbox_data + idx * 4;
-        auto *bbox_o = bbox_out_data + j * 4;
-
-        // bbox_o[4] = bbox_i[4];
-        label_out_data[j] = label_data[idx];
-
-        // scaling
-        double minus[] = {left, top, left, top};
-        double scale[] = {w, h, w, h};
-        for (int k = 0; k < 4; ++k) {
-          // scale and translate the input box
-          double coord = (bbox_i[k] - minus[k]) / scale[k];;
-          // ..and clamp it to 0..1 range
-          bbox_o[k] = std::min(std::max(coord, 0.0), 1.0);
-        }
-      }  // end bbox copy
-
-      // everything is good, generate the crop parameters
-      const int left_idx = std::llround(left * wtot);
-      const int top_idx = std::llround(top * htot);
-      const int right_idx = std::llround(right * wtot);
-      const int bottom_idx = std::llround(bottom * htot);
+      const int *label_data = labels[sample].data<int>();
+      auto *label_out_data = label_out[sample].mutable_data<int>();
+      for (size_t j = 0; j < crop.box_indices.size(); ++j)
+        label_out_data[j] = label_data[crop.box_indices[j]];
+      memcpy(bbox_out[sample].mutable_data<float>(), crop.boxes.data(),
+             crop.boxes.size() * sizeof(float));
 
       // perform the crop
-      detail::crop(img, {left_idx, top_idx, right_idx, bottom_idx},
-                   img_out);
-
-      return;
-    }  // end num_attempts loop
-  }  // end sample loop
-}
-
-template <>
-void SSDRandomCrop<CPUBackend>::SetupSharedSampleParams(SampleWorkspace &ws) {
-  return;
+      detail::crop(img_out[sample].mutable_data<uint8_t>(), images[sample].data<uint8_t>(),
+                   images.shape()[sample], crop.left, crop.top, crop.right, crop.bottom);
+    }, img_out.shape().tensor_size(sample));
+  }
+  tp.RunAll();
 }
 
 DALI_REGISTER_OPERATOR(SSDRandomCrop, SSDRandomCrop<CPUBackend>, CPU);
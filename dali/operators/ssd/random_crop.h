@@ -55,17 +55,22 @@ class SSDRandomCrop : public Operator<Backend> {
   using Operator<Backend>::RunImpl;
 
  protected:
-  bool SetupImpl(std::vector<OutputDesc> &output_desc, const workspace_t<Backend> &ws) override {
-    return false;
+  bool CanInferOutputs() const override {
+    return true;
   }
 
-  void RunImpl(Workspace<Backend> &ws) override;
-  void SetupSharedSampleParams(Workspace<Backend> &ws) override;
+  bool SetupImpl(std::vector<OutputDesc> &output_desc, const workspace_t<Backend> &ws) override;
+  void RunImpl(workspace_t<Backend> &ws) override;
 
  private:
+  /**
+   * @brief Crop selected for a sample in SetupImpl and applied in RunImpl
+   */
   struct CropInfo {
-    int x, y;
-    int w, h;
+    bool no_crop = true;
+    int left, top, right, bottom;  // in pixels
+    std::vector<int> box_indices;  // input boxes kept in the output
+    std::vector<float> boxes;      // the kept boxes, relative to the crop window
   };
 
   struct SampleOption {
@@ -87,6 +92,8 @@ class SSDRandomCrop : public Operator<Backend> {
 
   int num_attempts_;
 
+  std::vector<CropInfo> crops_;
+
   // RNG stuff
   BatchRNG<std::mt19937> rngs_;
   std::uniform_int_distribution<> int_dis_;
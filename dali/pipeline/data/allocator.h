@@ -17,6 +17,7 @@
 
 #include "dali/core/cuda_utils.h"
 #include "dali/pipeline/operator/operator_factory.h"
+#include "dali/util/numa.h"
 
 namespace dali {
 
@@ -78,18 +79,34 @@ DALI_DECLARE_OPTYPE_REGISTRY(GPUAllocator, GPUAllocator);
 
 /**
  * @brief Default CPU memory allocator.
+ *
+ * If the NUMA policy (see numa::GetPolicy) binds all the threads to one node, the large
+ * allocations are placed on that node. Otherwise, the pages are placed on the node of the thread
+ * which touches them first.
  */
 class CPUAllocator : public AllocatorBase {
  public:
   explicit CPUAllocator(const OpSpec &spec) : AllocatorBase(spec) {}
   ~CPUAllocator() override = default;
 
+  /// @brief Minimum size of the allocations placed on the NUMA node of the policy
+  static constexpr size_t kNumaAllocThreshold = 1 << 20;
+
   void New(void **ptr, size_t bytes) override {
-    *ptr = ::operator new(bytes);
+    int node = numa::AllocationNode(numa::GetPolicy());
+    if (bytes >= kNumaAllocThreshold && node >= 0)
+      *ptr = numa::AllocateOnNode(bytes, node);
+    else
+      *ptr = ::operator new(bytes);
   }
 
-  void Delete(void *ptr, size_t /* unused */) override {
-    ::operator delete(ptr);
+  void Delete(void *ptr, size_t bytes) override {
+    if (bytes >= kNumaAllocThreshold && numa::AllocationNode(numa::GetPolicy()) >= 0) {
+      if (ptr != nullptr)
+        numa::FreeOnNode(ptr, bytes);
+    } else {
+      ::operator delete(ptr);
+    }
   }
 };
 
@@ -14,11 +14,16 @@
 
 #include <algorithm>
 #include <condition_variable>
+#include <cstring>
 #include <iterator>
+#include <memory>
 #include <mutex>
 #include <set>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "dali/pipeline/executor/executor.h"
 #include "dali/pipeline/executor/queue_metadata.h"
@@ -31,6 +36,114 @@ namespace dali {
 template class DLL_PUBLIC Executor<AOT_WS_Policy<UniformQueuePolicy>, UniformQueuePolicy>;
 template class DLL_PUBLIC Executor<AOT_WS_Policy<SeparateQueuePolicy>, SeparateQueuePolicy>;
 
+namespace {
+
+template <typename Batch>
+void FillMemoizedOutput(Batch &out, int output_idx,
+                        const std::vector<std::vector<MemoCache::OutputDesc>> &descs,
+                        const std::vector<std::vector<std::shared_ptr<const uint8_t>>> &data,
+                        bool gpu, cudaStream_t stream) {
+  int batch_size = descs.size();
+  const auto &first = descs[0][output_idx];
+  TensorListShape<> shape(batch_size, first.shape.sample_dim());
+  for (int s = 0; s < batch_size; s++)
+    shape.set_tensor_shape(s, descs[s][output_idx].shape);
+  out.Resize(shape, TypeTable::GetTypeInfo(first.type));
+  out.SetLayout(first.layout);
+  for (int s = 0; s < batch_size; s++) {
+    auto nbytes = descs[s][output_idx].nbytes();
+    if (gpu) {
+      CUDA_CALL(cudaMemcpyAsync(out.raw_mutable_tensor(s), data[s][output_idx].get(), nbytes,
+                                cudaMemcpyHostToDevice, stream));
+    } else {
+      memcpy(out.raw_mutable_tensor(s), data[s][output_idx].get(), nbytes);
+    }
+  }
+}
+
+template <typename Workspace>
+void FillMemoizedOutputs(const MemoPoint &memo, const std::vector<std::string> &keys,
+                         Workspace &ws) {
+  int batch_size = keys.size();
+  std::vector<std::vector<MemoCache::OutputDesc>> descs(batch_size);
+  std::vector<std::vector<std::shared_ptr<const uint8_t>>> data(batch_size);
+  for (int s = 0; s < batch_size; s++) {
+    DALI_ENFORCE(memo.cache->Get(keys[s], descs[s], data[s]),
+                 make_string("The memoized outputs of the sample \"", keys[s], "\" are missing."));
+  }
+  cudaStream_t stream = ws.has_stream() ? ws.stream() : 0;
+  for (int o = 0; o < ws.NumOutput(); o++) {
+    if (ws.template OutputIsType<CPUBackend>(o))
+      FillMemoizedOutput(ws.template OutputRef<CPUBackend>(o), o, descs, data, false, stream);
+    else
+      FillMemoizedOutput(ws.template OutputRef<GPUBackend>(o), o, descs, data, true, stream);
+  }
+}
+
+template <typename Batch>
+void GetMemoizedOutput(const Batch &out, const std::vector<int> &samples,
+                       std::vector<std::vector<MemoCache::OutputDesc>> &descs,
+                       std::vector<std::vector<const void *>> &ptrs) {
+  for (size_t i = 0; i < samples.size(); i++) {
+    MemoCache::OutputDesc desc;
+    desc.shape = out.tensor_shape(samples[i]);
+    desc.type = out.type().id();
+    desc.layout = out.GetLayout();
+    descs[i].push_back(std::move(desc));
+    ptrs[i].push_back(out.raw_tensor(samples[i]));
+  }
+}
+
+template <typename Workspace>
+void StoreMemoizedOutputs(const MemoPoint &memo, const std::vector<std::string> &keys,
+                          Workspace &ws) {
+  std::vector<int> samples;
+  for (size_t s = 0; s < keys.size(); s++) {
+    if (!keys[s].empty() && !memo.cache->Contains(keys[s]))
+      samples.push_back(s);
+  }
+  if (samples.empty())
+    return;
+
+  std::vector<std::vector<MemoCache::OutputDesc>> descs(samples.size());
+  std::vector<std::vector<const void *>> ptrs(samples.size());
+  // host copies of the GPU outputs
+  std::vector<std::vector<uint8_t>> staging;
+  for (int o = 0; o < ws.NumOutput(); o++) {
+    if (ws.template OutputIsType<CPUBackend>(o)) {
+      const auto &out = ws.template OutputRef<CPUBackend>(o);
+      if (out.ntensor() != keys.size())
+        return;
+      GetMemoizedOutput(out, samples, descs, ptrs);
+      continue;
+    }
+    const auto &out = ws.template OutputRef<GPUBackend>(o);
+    if (out.ntensor() != keys.size())
+      return;
+    GetMemoizedOutput(out, samples, descs, ptrs);
+    int64_t total = 0;
+    for (auto &sample_descs : descs)
+      total += sample_descs.back().nbytes();
+    staging.emplace_back(total);
+    int64_t offset = 0;
+    for (size_t i = 0; i < samples.size(); i++) {
+      auto nbytes = descs[i].back().nbytes();
+      uint8_t *dst = staging.back().data() + offset;
+      CUDA_CALL(cudaMemcpyAsync(dst, ptrs[i].back(), nbytes, cudaMemcpyDeviceToHost,
+                                ws.stream()));
+      ptrs[i].back() = dst;
+      offset += nbytes;
+    }
+  }
+  if (!staging.empty())
+    CUDA_CALL(cudaStreamSynchronize(ws.stream()));
+
+  for (size_t i = 0; i < samples.size(); i++)
+    memo.cache->Insert(keys[samples[i]], descs[i], ptrs[i]);
+}
+
+}  // namespace
+
 template <typename WorkspacePolicy, typename QueuePolicy>
 void Executor<WorkspacePolicy, QueuePolicy>::PreRun() {
   auto batch_size = InferBatchSize(batch_size_providers_);
@@ -66,10 +179,16 @@ void Executor<WorkspacePolicy, QueuePolicy>::RunCPUImpl() {
   auto batch_size = batch_sizes_cpu_.front();
   batch_sizes_cpu_.pop();
 
+  MemoIteration memo_iter;
+  memo_iter.keys.resize(memo_points_.size());
+  memo_iter.hits.resize(memo_points_.size(), false);
+
   // Run the cpu-ops in the thread
   // Process each CPU Op in batch
   for (int cpu_op_id = 0; cpu_op_id < graph_->NumOp(OpType::CPU) && !exec_error_; ++cpu_op_id) {
     OpNode &op_node = graph_->Node(OpType::CPU, cpu_op_id);
+    if (IsSkippedByMemoization(op_node, memo_iter))
+      continue;
     typename WorkspacePolicy::template ws_t<OpType::CPU> ws =
         WorkspacePolicy::template GetWorkspace<OpType::CPU>(cpu_idxs, *graph_, cpu_op_id);
 
@@ -78,7 +197,7 @@ void Executor<WorkspacePolicy, QueuePolicy>::RunCPUImpl() {
     DomainTimeRange tr("[DALI][CPU op] " + op_node.instance_name, DomainTimeRange::kBlue1);
 
     try {
-      RunHelper(op_node, ws);
+      RunMemoized(op_node, ws, memo_iter);
       FillStats(cpu_memory_stats_, ws, "CPU_" + op_node.instance_name, cpu_memory_stats_mutex_);
     } catch (std::exception &e) {
       HandleError("CPU", op_node, e.what());
@@ -87,6 +206,12 @@ void Executor<WorkspacePolicy, QueuePolicy>::RunCPUImpl() {
     }
   }
 
+  if (!memo_points_.empty()) {
+    std::lock_guard<std::mutex> lock(memo_iterations_mutex_);
+    memo_iterations_mixed_.push(memo_iter);
+    memo_iterations_gpu_.push(std::move(memo_iter));
+  }
+
   // Pass the work to the mixed stage
   QueuePolicy::ReleaseIdxs(OpType::CPU, cpu_idxs);
 }
@@ -104,6 +229,8 @@ void Executor<WorkspacePolicy, QueuePolicy>::RunMixedImpl() {
     return;
   }
 
+  auto memo_iter = PopMemoIteration(memo_iterations_mixed_);
+
   // short path for pure CPU pipeline
   if (device_id_ == CPU_ONLY_DEVICE_ID) {
     if (callback_) {
@@ -124,6 +251,8 @@ void Executor<WorkspacePolicy, QueuePolicy>::RunMixedImpl() {
 
   for (int i = 0; i < graph_->NumOp(OpType::MIXED) && !exec_error_; ++i) {
     OpNode &op_node = graph_->Node(OpType::MIXED, i);
+    if (IsSkippedByMemoization(op_node, memo_iter))
+      continue;
     try {
       typename WorkspacePolicy::template ws_t<OpType::MIXED> ws =
           WorkspacePolicy::template GetWorkspace<OpType::MIXED>(mixed_idxs, *graph_, i);
@@ -131,7 +260,7 @@ void Executor<WorkspacePolicy, QueuePolicy>::RunMixedImpl() {
       ws.SetBatchSizes(batch_size);
 
       DomainTimeRange tr("[DALI][Mixed op] " + op_node.instance_name, DomainTimeRange::kOrange);
-      RunHelper(op_node, ws);
+      RunMemoized(op_node, ws, memo_iter);
       FillStats(mixed_memory_stats_, ws, "MIXED_" + op_node.instance_name,
                 mixed_memory_stats_mutex_);
       if (ws.has_stream() && ws.has_event()) {
@@ -175,6 +304,8 @@ void Executor<WorkspacePolicy, QueuePolicy>::RunGPUImpl() {
     return;
   }
 
+  auto memo_iter = PopMemoIteration(memo_iterations_gpu_);
+
   // short path for pure CPU pipeline
   if (device_id_ == CPU_ONLY_DEVICE_ID) {
     // We do not release, but handle to used outputs
@@ -192,6 +323,8 @@ void Executor<WorkspacePolicy, QueuePolicy>::RunGPUImpl() {
 
   for (int i = 0; i < graph_->NumOp(OpType::GPU) && !exec_error_; ++i) {
     OpNode &op_node = graph_->Node(OpType::GPU, i);
+    if (IsSkippedByMemoization(op_node, memo_iter))
+      continue;
     try {
       typename WorkspacePolicy::template ws_t<OpType::GPU> ws =
           WorkspacePolicy::template GetWorkspace<OpType::GPU>(gpu_idxs, *graph_, i);
@@ -205,7 +338,7 @@ void Executor<WorkspacePolicy, QueuePolicy>::RunGPUImpl() {
       }
 
       DomainTimeRange tr("[DALI][GPU op] " + op_node.instance_name, DomainTimeRange::knvGreen);
-      RunHelper(op_node, ws);
+      RunMemoized(op_node, ws, memo_iter);
       FillStats(gpu_memory_stats_, ws, "GPU_" + op_node.instance_name, gpu_memory_stats_mutex_);
       if (ws.has_event()) {
         CUDA_CALL(cudaEventRecord(ws.event(), ws.stream()));
@@ -345,6 +478,41 @@ void Executor<WorkspacePolicy, QueuePolicy>::RunHelper(OpNode &op_node, Workspac
   }
 }
 
+template <typename WorkspacePolicy, typename QueuePolicy>
+template <typename Workspace>
+void Executor<WorkspacePolicy, QueuePolicy>::RunMemoized(OpNode &op_node, Workspace &ws,
+                                                         MemoIteration &memo_iter) {
+  for (size_t i = 0; i < memo_points_.size(); i++) {
+    if (memo_points_[i].node == op_node.id && memo_iter.hits[i]) {
+      FillMemoizedOutputs(memo_points_[i], memo_iter.keys[i], ws);
+      return;
+    }
+  }
+
+  RunHelper(op_node, ws);
+
+  for (size_t i = 0; i < memo_points_.size(); i++) {
+    auto &memo = memo_points_[i];
+    if (memo.key_node == op_node.id) {
+      // The samples are identified by the first non-empty source info among the outputs
+      // of the reader. The upstream of the memoized operator is skipped only if all
+      // the samples of the batch are found in the cache.
+      int batch_size = ws.template OutputRef<CPUBackend>(0).ntensor();
+      auto &keys = memo_iter.keys[i];
+      keys.assign(batch_size, std::string());
+      bool hit = batch_size > 0;
+      for (int s = 0; s < batch_size; s++) {
+        for (int o = 0; o < ws.NumOutput() && keys[s].empty(); o++)
+          keys[s] = ws.template OutputRef<CPUBackend>(o).GetMeta(s).GetSourceInfo();
+        hit = hit && !keys[s].empty() && memo.cache->Contains(keys[s]);
+      }
+      memo_iter.hits[i] = hit;
+    }
+    if (memo.node == op_node.id)
+      StoreMemoizedOutputs(memo, memo_iter.keys[i], ws);
+  }
+}
+
 
 template <typename WorkspacePolicy, typename QueuePolicy>
 int Executor<WorkspacePolicy, QueuePolicy>::InferBatchSize(
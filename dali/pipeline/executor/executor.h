@@ -29,6 +29,7 @@
 #include "dali/core/error_handling.h"
 #include "dali/core/nvtx.h"
 #include "dali/pipeline/data/backend.h"
+#include "dali/pipeline/executor/memoization.h"
 #include "dali/pipeline/executor/queue_metadata.h"
 #include "dali/pipeline/executor/queue_policy.h"
 #include "dali/pipeline/executor/workspace_policy.h"
@@ -318,6 +319,21 @@ class DLL_PUBLIC Executor : public ExecutorBase, public WorkspacePolicy, public
 
   std::queue<int> batch_sizes_cpu_, batch_sizes_mixed_, batch_sizes_gpu_;
 
+  /**
+   * @brief The state of the memoized operators in an iteration, indexed like memo_points_
+   *
+   * It's determined by the CPU stage, once the readers have run, and passed to the
+   * following stages.
+   */
+  struct MemoIteration {
+    std::vector<std::vector<std::string>> keys;  // source info of the samples
+    std::vector<bool> hits;  // whether all the samples of the batch are memoized
+  };
+
+  std::vector<MemoPoint> memo_points_;
+  std::queue<MemoIteration> memo_iterations_mixed_, memo_iterations_gpu_;
+  std::mutex memo_iterations_mutex_;
+
   OpGraph *graph_ = nullptr;
   // we need to keep this above the stream_pool_ so we still have it when the stream_pool_
   // destructor runs and it waits for streams to finish
@@ -361,6 +377,39 @@ class DLL_PUBLIC Executor : public ExecutorBase, public WorkspacePolicy, public
   template <typename Workspace>
   void RunHelper(OpNode &op_node, Workspace &ws);
 
+  /**
+   * @brief Runs the operator or, if it's memoized and all the samples are found in the cache,
+   *        fills its outputs from the cache
+   */
+  template <typename Workspace>
+  void RunMemoized(OpNode &op_node, Workspace &ws, MemoIteration &memo_iter);
+
+  /**
+   * @brief Whether the operator only computes the inputs of a memoized operator whose outputs
+   *        are taken from the cache in this iteration
+   */
+  bool IsSkippedByMemoization(const OpNode &op_node, const MemoIteration &memo_iter) const {
+    for (size_t i = 0; i < memo_points_.size(); i++) {
+      if (memo_iter.hits[i] && memo_points_[i].skippable.count(op_node.id))
+        return true;
+    }
+    return false;
+  }
+
+  MemoIteration PopMemoIteration(std::queue<MemoIteration> &memo_iterations) {
+    std::lock_guard<std::mutex> lock(memo_iterations_mutex_);
+    if (memo_iterations.empty()) {
+      // nothing is memoized or the CPU stage failed
+      MemoIteration memo_iter;
+      memo_iter.keys.resize(memo_points_.size());
+      memo_iter.hits.resize(memo_points_.size(), false);
+      return memo_iter;
+    }
+    auto memo_iter = std::move(memo_iterations.front());
+    memo_iterations.pop();
+    return memo_iter;
+  }
+
   void DiscoverBatchSizeProviders() {
     for (Index i = 0; i < graph_->NumOp(); i++) {
       auto bsp = dynamic_cast<BatchSizeProvider *>(graph_->Node(i).op.get());
@@ -455,6 +504,8 @@ void Executor<WorkspacePolicy, QueuePolicy>::Build(OpGraph *graph, vector<string
   SetupOutputQueuesForGraph();
 
   DiscoverBatchSizeProviders();
+
+  memo_points_ = FindMemoPoints(*graph_, pipeline_outputs_);
 }
 
 
@@ -0,0 +1,235 @@
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/pipeline/executor/memoization.h"
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <utility>
+#include "dali/core/error_handling.h"
+#include "dali/pipeline/operator/op_schema.h"
+
+namespace dali {
+
+namespace {
+
+bool InheritsFrom(const OpSchema &schema, const std::string &name) {
+  for (const auto &parent_name : schema.GetParents()) {
+    if (parent_name == name || InheritsFrom(SchemaRegistry::GetSchema(parent_name), name))
+      return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+MemoCache::MemoCache(int64_t budget, const std::string &spill_dir, int64_t chunk_size)
+    : budget_(budget), spill_dir_(spill_dir), arena_(chunk_size) {
+  DALI_ENFORCE(budget >= 0, "The memoization budget cannot be negative");
+}
+
+MemoCache::~MemoCache() {
+  if (spill_fd_ >= 0)
+    close(spill_fd_);
+}
+
+bool MemoCache::Contains(const std::string &key) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.count(key) > 0;
+}
+
+int64_t MemoCache::Spill(const void *data, int64_t size) {
+  if (spill_fd_ < 0) {
+    std::string path = spill_dir_ + "/dali_memo_XXXXXX";
+    spill_fd_ = mkstemp(&path[0]);
+    DALI_ENFORCE(spill_fd_ >= 0, make_string("Could not create a file in the memoization spill "
+                 "directory ", spill_dir_, ": ", std::strerror(errno)));
+    // the data is only accessed through the descriptor
+    unlink(path.c_str());
+  }
+  int64_t offset = spilled_bytes_;
+  auto *src = static_cast<const uint8_t *>(data);
+  for (int64_t written = 0; written < size; ) {
+    ssize_t n = pwrite(spill_fd_, src + written, size - written, offset + written);
+    DALI_ENFORCE(n > 0 || (n < 0 && errno == EINTR),
+                 make_string("Could not write to the memoization spill file: ",
+                             std::strerror(errno)));
+    if (n > 0)
+      written += n;
+  }
+  spilled_bytes_ += size;
+  return offset;
+}
+
+bool MemoCache::Insert(const std::string &key, const std::vector<OutputDesc> &outputs,
+                       const std::vector<const void *> &data) {
+  DALI_ENFORCE(outputs.size() == data.size(), "Expected the data of every output");
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (entries_.count(key))
+    return true;
+
+  int64_t total = 0;
+  for (auto &output : outputs)
+    total += output.nbytes();
+  bool spill = budget_ > 0 && bytes_ + total > budget_;
+  if (spill && spill_dir_.empty())
+    return false;
+
+  std::vector<Entry> entry;
+  entry.reserve(outputs.size());
+  for (size_t i = 0; i < outputs.size(); i++) {
+    int64_t size = outputs[i].nbytes();
+    if (spill) {
+      entry.push_back({ outputs[i], size, nullptr, Spill(data[i], size) });
+    } else {
+      auto dst = arena_.allocate(size);
+      memcpy(dst.get(), data[i], size);
+      entry.push_back({ outputs[i], size, std::move(dst), -1 });
+    }
+  }
+  if (!spill)
+    bytes_ += total;
+  entries_.emplace(key, std::move(entry));
+  return true;
+}
+
+bool MemoCache::Get(const std::string &key, std::vector<OutputDesc> &outputs,
+                    std::vector<std::shared_ptr<const uint8_t>> &data) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end())
+    return false;
+  outputs.clear();
+  data.clear();
+  for (auto &output : it->second) {
+    outputs.push_back(output.desc);
+    if (output.data) {
+      data.push_back(output.data);
+      continue;
+    }
+    auto buffer = mm::chunked_host_arena::allocate_block(output.size);
+    for (int64_t read = 0; read < output.size; ) {
+      ssize_t n = pread(spill_fd_, buffer.get() + read, output.size - read,
+                        output.file_offset + read);
+      DALI_ENFORCE(n > 0 || (n < 0 && errno == EINTR),
+                   make_string("Could not read from the memoization spill file: ",
+                               std::strerror(errno)));
+      if (n > 0)
+        read += n;
+    }
+    data.push_back(std::move(buffer));
+  }
+  return true;
+}
+
+int64_t MemoCache::num_samples() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+int64_t MemoCache::bytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return bytes_;
+}
+
+int64_t MemoCache::spilled_bytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return spilled_bytes_;
+}
+
+std::vector<MemoPoint> FindMemoPoints(const OpGraph &graph,
+                                      const std::vector<TensorNodeId> &pipeline_outputs) {
+  std::set<TensorNodeId> outputs(pipeline_outputs.begin(), pipeline_outputs.end());
+  auto produces_output = [&](const OpNode &node) {
+    for (auto tid : node.children_tensors) {
+      if (outputs.count(tid))
+        return true;
+    }
+    return false;
+  };
+
+  std::vector<MemoPoint> memo_points;
+  for (OpNodeId id = 0; id < graph.NumOp(); id++) {
+    const OpNode &node = graph.Node(id);
+    if (!node.spec.GetArgument<bool>("memoize"))
+      continue;
+
+    auto check = [&](const OpNode &op) {
+      const auto &schema = op.spec.GetSchema();
+      DALI_ENFORCE(!schema.IsRandom() && !schema.IsNoPrune(), make_string(
+          "Cannot memoize the outputs of the operator \"", node.instance_name, "\", because they "
+          "depend on the operator \"", op.instance_name, "\", which is not deterministic."));
+    };
+    check(node);
+
+    std::set<OpNodeId> ancestors;
+    std::vector<OpNodeId> to_visit(node.parents.begin(), node.parents.end());
+    while (!to_visit.empty()) {
+      OpNodeId parent = to_visit.back();
+      to_visit.pop_back();
+      if (!ancestors.insert(parent).second)
+        continue;
+      const OpNode &parent_node = graph.Node(parent);
+      check(parent_node);
+      to_visit.insert(to_visit.end(), parent_node.parents.begin(), parent_node.parents.end());
+    }
+
+    MemoPoint memo;
+    memo.node = id;
+    memo.key_node = -1;
+    for (OpNodeId ancestor : ancestors) {
+      const OpNode &ancestor_node = graph.Node(ancestor);
+      if (!ancestor_node.parents.empty())
+        continue;
+      DALI_ENFORCE(memo.key_node < 0, make_string("Cannot memoize the outputs of the operator \"",
+                   node.instance_name, "\", because they depend on more than one data source."));
+      memo.key_node = ancestor;
+    }
+    DALI_ENFORCE(memo.key_node >= 0, make_string("Cannot memoize the outputs of the operator \"",
+                 node.instance_name, "\", because they don't depend on a reader."));
+    const OpNode &key_node = graph.Node(memo.key_node);
+    DALI_ENFORCE(key_node.op_type == OpType::CPU &&
+                 InheritsFrom(key_node.spec.GetSchema(), "LoaderBase"),
+                 make_string("Cannot memoize the outputs of the operator \"", node.instance_name,
+                             "\", because they depend on the operator \"",
+                             key_node.instance_name, "\", which is not a CPU reader."));
+
+    // The node ids follow the topological order, so the children of an operator
+    // are visited before the operator itself
+    for (auto it = ancestors.rbegin(); it != ancestors.rend(); ++it) {
+      const OpNode &ancestor_node = graph.Node(*it);
+      if (*it == memo.key_node || produces_output(ancestor_node))
+        continue;
+      bool only_feeds_memo = true;
+      for (OpNodeId child : ancestor_node.children) {
+        if (child != id && !memo.skippable.count(child)) {
+          only_feeds_memo = false;
+          break;
+        }
+      }
+      if (only_feeds_memo)
+        memo.skippable.insert(*it);
+    }
+
+    auto budget = node.spec.GetArgument<int64_t>("memoize_budget");
+    auto spill_dir = node.spec.GetArgument<std::string>("memoize_spill_dir");
+    memo.cache = std::make_unique<MemoCache>(budget, spill_dir);
+    memo_points.push_back(std::move(memo));
+  }
+  return memo_points;
+}
+
+}  // namespace dali
@@ -0,0 +1,153 @@
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_PIPELINE_EXECUTOR_MEMOIZATION_H_
+#define DALI_PIPELINE_EXECUTOR_MEMOIZATION_H_
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "dali/core/common.h"
+#include "dali/core/mm/chunked_host_arena.h"
+#include "dali/core/tensor_layout.h"
+#include "dali/core/tensor_shape.h"
+#include "dali/pipeline/data/types.h"
+#include "dali/pipeline/graph/op_graph.h"
+
+namespace dali {
+
+/**
+ * @brief Keeps the outputs of a memoized operator, per sample, in host memory
+ *
+ * The data is stored in a chunked_host_arena. When the memory budget is
+ * exhausted, the samples are appended to a file in the spill directory instead (the file is
+ * removed as soon as it's created, so it doesn't outlive the cache) or, without a spill
+ * directory, they are not stored at all. Samples are never evicted.
+ *
+ * The cache is thread-safe: the samples are looked up by the CPU stage of the executor and
+ * inserted by the stage that runs the memoized operator.
+ */
+class DLL_PUBLIC MemoCache {
+ public:
+  static constexpr int64_t kDefaultChunkSize = mm::chunked_host_arena::kDefaultChunkSize;
+
+  /**
+   * @brief Describes one of the outputs of a sample
+   */
+  struct OutputDesc {
+    TensorShape<> shape;
+    DALIDataType type = DALI_NO_TYPE;
+    TensorLayout layout;
+
+    int64_t nbytes() const {
+      return volume(shape) * TypeTable::GetTypeInfo(type).size();
+    }
+  };
+
+  /**
+   * @param budget     maximum total size of the samples kept in memory, in bytes; 0 means no limit
+   * @param spill_dir  directory for the samples exceeding the budget; empty means no spilling
+   * @param chunk_size chunk size of the underlying arena
+   */
+  explicit MemoCache(int64_t budget = 0, const std::string &spill_dir = "",
+                     int64_t chunk_size = kDefaultChunkSize);
+
+  ~MemoCache();
+
+  DISABLE_COPY_MOVE_ASSIGN(MemoCache);
+
+  bool Contains(const std::string &key) const;
+
+  /**
+   * @brief Stores the outputs of a sample; `data[i]` is the host data of the output `i`
+   *
+   * Does nothing if the sample is already stored.
+   * Returns false if the sample is not stored, because it exceeds the budget.
+   */
+  bool Insert(const std::string &key, const std::vector<OutputDesc> &outputs,
+              const std::vector<const void *> &data);
+
+  /**
+   * @brief Returns the outputs of a sample, or false if the sample is not stored
+   *
+   * The data of spilled samples is read to new buffers, owned by the returned pointers.
+   */
+  bool Get(const std::string &key, std::vector<OutputDesc> &outputs,
+           std::vector<std::shared_ptr<const uint8_t>> &data) const;
+
+  int64_t num_samples() const;
+
+  /**
+   * @brief Total size of the samples kept in memory, in bytes
+   */
+  int64_t bytes() const;
+
+  /**
+   * @brief Total size of the samples written to the spill file, in bytes
+   */
+  int64_t spilled_bytes() const;
+
+ private:
+  struct Entry {
+    OutputDesc desc;
+    int64_t size;
+    std::shared_ptr<uint8_t> data;  // null if the output is spilled
+    int64_t file_offset;
+  };
+
+  /// @brief Appends the data to the spill file and returns its offset
+  int64_t Spill(const void *data, int64_t size);
+
+  mutable std::mutex mutex_;
+  int64_t budget_;
+  std::string spill_dir_;
+  int64_t bytes_ = 0;
+  int64_t spilled_bytes_ = 0;
+  mm::chunked_host_arena arena_;
+  int spill_fd_ = -1;
+  std::unordered_map<std::string, std::vector<Entry>> entries_;
+};
+
+/**
+ * @brief An operator with the `memoize` argument set, along with the part of the graph
+ *        which doesn't need to run when all the samples of the batch are memoized
+ */
+struct MemoPoint {
+  OpNodeId node;
+  /// The reader which the memoized operator depends on; its source info identifies the samples
+  OpNodeId key_node;
+  /// The operators which only compute the inputs of `node` (directly or not)
+  std::set<OpNodeId> skippable;
+  std::unique_ptr<MemoCache> cache;
+};
+
+/**
+ * @brief Finds the memoized operators in the graph and checks that they can be memoized
+ *
+ * A memoized operator and all the operators it depends on must be deterministic and they must
+ * depend on a single reader.
+ *
+ * @param pipeline_outputs the outputs of the pipeline - the operators producing them are
+ *                         never skipped
+ */
+DLL_PUBLIC std::vector<MemoPoint> FindMemoPoints(const OpGraph &graph,
+                                                 const std::vector<TensorNodeId> &pipeline_outputs);
+
+}  // namespace dali
+
+#endif  // DALI_PIPELINE_EXECUTOR_MEMOIZATION_H_
@@ -0,0 +1,308 @@
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "dali/pipeline/executor/memoization.h"
+#include "dali/pipeline/operator/operator.h"
+#include "dali/pipeline/pipeline.h"
+#include "dali/test/dali_test_config.h"
+
+namespace dali {
+
+namespace {
+
+/**
+ * @brief Stores a sample with two outputs: `size` floats equal to `value` and a scalar int
+ */
+bool InsertSample(MemoCache &cache, const std::string &key, int64_t size, float value) {
+  std::vector<float> data(size, value);
+  int label = size;
+  std::vector<MemoCache::OutputDesc> outputs(2);
+  outputs[0].shape = { size };
+  outputs[0].type = DALI_FLOAT;
+  outputs[0].layout = "X";
+  outputs[1].shape = {};
+  outputs[1].type = DALI_INT32;
+  return cache.Insert(key, outputs, { data.data(), &label });
+}
+
+void CheckSample(const MemoCache &cache, const std::string &key, int64_t size, float value) {
+  std::vector<MemoCache::OutputDesc> outputs;
+  std::vector<std::shared_ptr<const uint8_t>> data;
+  ASSERT_TRUE(cache.Get(key, outputs, data));
+  ASSERT_EQ(outputs.size(), 2u);
+  ASSERT_EQ(data.size(), 2u);
+  EXPECT_EQ(outputs[0].shape, TensorShape<>(size));
+  EXPECT_EQ(outputs[0].type, DALI_FLOAT);
+  EXPECT_EQ(outputs[0].layout, "X");
+  EXPECT_EQ(outputs[1].shape, TensorShape<>());
+  EXPECT_EQ(outputs[1].type, DALI_INT32);
+  auto *floats = reinterpret_cast<const float *>(data[0].get());
+  for (int64_t i = 0; i < size; i++)
+    ASSERT_EQ(floats[i], value) << key;
+  EXPECT_EQ(*reinterpret_cast<const int *>(data[1].get()), size);
+}
+
+}  // namespace
+
+TEST(MemoCache, InsertAndGet) {
+  MemoCache cache(0, "", 1024);
+  std::vector<int64_t> sizes = { 10, 0, 100, 1000, 3 };
+  for (size_t i = 0; i < sizes.size(); i++)
+    EXPECT_TRUE(InsertSample(cache, "sample" + std::to_string(i), sizes[i], i + 0.5f));
+  EXPECT_EQ(cache.num_samples(), static_cast<int64_t>(sizes.size()));
+  EXPECT_TRUE(cache.Contains("sample3"));
+  EXPECT_FALSE(cache.Contains("missing"));
+
+  int64_t total = 0;
+  for (size_t i = 0; i < sizes.size(); i++) {
+    CheckSample(cache, "sample" + std::to_string(i), sizes[i], i + 0.5f);
+    total += sizes[i] * sizeof(float) + sizeof(int);
+  }
+  EXPECT_EQ(cache.bytes(), total);
+  EXPECT_EQ(cache.spilled_bytes(), 0);
+
+  // inserting a sample again doesn't change it
+  EXPECT_TRUE(InsertSample(cache, "sample0", 5, 42));
+  CheckSample(cache, "sample0", 10, 0.5f);
+
+  std::vector<MemoCache::OutputDesc> outputs;
+  std::vector<std::shared_ptr<const uint8_t>> data;
+  EXPECT_FALSE(cache.Get("missing", outputs, data));
+}
+
+TEST(MemoCache, Budget) {
+  MemoCache cache(500, "", 4096);
+  EXPECT_TRUE(InsertSample(cache, "a", 100, 1));
+  EXPECT_FALSE(InsertSample(cache, "b", 100, 2));
+  EXPECT_TRUE(InsertSample(cache, "c", 10, 3));
+  EXPECT_FALSE(cache.Contains("b"));
+  EXPECT_EQ(cache.num_samples(), 2);
+  EXPECT_EQ(cache.bytes(), 110 * 4 + 2 * 4);
+}
+
+TEST(MemoCache, Spill) {
+  std::string tmpl = "/tmp/memo_cache_test_XXXXXX";
+  std::string dir = mkdtemp(&tmpl[0]);
+  {
+    MemoCache cache(500, dir, 4096);
+    for (int i = 0; i < 10; i++)
+      EXPECT_TRUE(InsertSample(cache, std::to_string(i), 50 + i, i));
+    EXPECT_EQ(cache.num_samples(), 10);
+    EXPECT_LE(cache.bytes(), 500);
+    EXPECT_GT(cache.spilled_bytes(), 0);
+    for (int i = 9; i >= 0; i--)
+      CheckSample(cache, std::to_string(i), 50 + i, i);
+  }
+  // the spill file is removed right after it's created
+  EXPECT_EQ(rmdir(dir.c_str()), 0);
+}
+
+/**
+ * @brief Adds 1 to every byte of the first input and counts the samples it processes
+ *        in `counts[counter]`
+ */
+class MemoTestCounter : public Operator<CPUBackend> {
+ public:
+  explicit MemoTestCounter(const OpSpec &spec)
+      : Operator<CPUBackend>(spec), counter_(spec.GetArgument<int>("counter")) {}
+
+  static std::atomic<int> counts[2];
+
+ protected:
+  bool SetupImpl(std::vector<OutputDesc> &output_desc, const HostWorkspace &ws) override {
+    return false;
+  }
+
+  void RunImpl(HostWorkspace &ws) override {
+    const auto &input = ws.InputRef<CPUBackend>(0);
+    auto &output = ws.OutputRef<CPUBackend>(0);
+    output.Resize(input.shape(), input.type());
+    for (size_t s = 0; s < input.ntensor(); s++) {
+      auto *in = static_cast<const uint8_t *>(input.raw_tensor(s));
+      auto *out = static_cast<uint8_t *>(output.raw_mutable_tensor(s));
+      int64_t nbytes = volume(input.tensor_shape(s)) * input.type().size();
+      for (int64_t i = 0; i < nbytes; i++)
+        out[i] = in[i] + 1;
+    }
+    counts[counter_] += input.ntensor();
+  }
+
+ private:
+  int counter_;
+};
+
+std::atomic<int> MemoTestCounter::counts[2];
+
+DALI_REGISTER_OPERATOR(MemoTestCounter, MemoTestCounter, CPU);
+DALI_REGISTER_OPERATOR(MemoTestRandomCounter, MemoTestCounter, CPU);
+
+DALI_SCHEMA(MemoTestCounter)
+  .DocStr("Counts the processed samples")
+  .NumInput(1, 2)
+  .NumOutput(1)
+  .AddOptionalArg("counter", "Index of the counter", 0);
+
+DALI_SCHEMA(MemoTestRandomCounter)
+  .DocStr("Counts the processed samples, pretending to be random")
+  .NumInput(1, 2)
+  .NumOutput(1)
+  .Random()
+  .AddParent("MemoTestCounter");
+
+class MemoizationPipelineTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    for (auto &count : MemoTestCounter::counts)
+      count = 0;
+  }
+
+  std::unique_ptr<Pipeline> MakePipeline() {
+    std::unique_ptr<Pipeline> pipe(new Pipeline(kBatchSize, 2, CPU_ONLY_DEVICE_ID));
+    AddReader(*pipe, "reader", "raw");
+    return pipe;
+  }
+
+  void AddReader(Pipeline &pipe, const std::string &name, const std::string &output) {
+    pipe.AddOperator(OpSpec("FileReader")
+        .AddArg("device", "cpu")
+        .AddArg("file_root", testing::dali_extra_path() + "/db/single/jpeg")
+        .AddArg("pad_last_batch", true)
+        .AddOutput(output, "cpu")
+        .AddOutput(output + "_label", "cpu"), name);
+  }
+
+  void AddCounter(Pipeline &pipe, const std::string &name, const std::string &input,
+                  const std::string &output, int counter, bool memoize = false) {
+    pipe.AddOperator(OpSpec(name)
+        .AddArg("device", "cpu")
+        .AddArg("counter", counter)
+        .AddArg("memoize", memoize)
+        .AddInput(input, "cpu")
+        .AddOutput(output, "cpu"));
+  }
+
+  /**
+   * @brief The number of samples processed in an epoch, including the ones padding
+   *        the last batch
+   */
+  int EpochSamples(Pipeline &pipe) {
+    return div_ceil(pipe.GetReaderMeta("reader").epoch_size, kBatchSize) * kBatchSize;
+  }
+
+  /**
+   * @brief Runs an epoch and returns the samples of the first output, along with the labels
+   */
+  std::vector<std::pair<std::vector<uint8_t>, int>> RunEpoch(Pipeline &pipe) {
+    std::vector<std::pair<std::vector<uint8_t>, int>> samples;
+    for (int i = 0; i < EpochSamples(pipe); i += kBatchSize) {
+      pipe.RunCPU();
+      pipe.RunGPU();
+      DeviceWorkspace ws;
+      pipe.Outputs(&ws);
+      const auto &data = ws.OutputRef<CPUBackend>(0);
+      const auto &labels = ws.OutputRef<CPUBackend>(1);
+      EXPECT_EQ(data.ntensor(), static_cast<size_t>(kBatchSize));
+      for (size_t s = 0; s < data.ntensor(); s++) {
+        auto *bytes = static_cast<const uint8_t *>(data.raw_tensor(s));
+        samples.emplace_back(
+            std::vector<uint8_t>(bytes, bytes + volume(data.tensor_shape(s))),
+            *static_cast<const int *>(labels.raw_tensor(s)));
+      }
+    }
+    return samples;
+  }
+
+  static constexpr int kBatchSize = 4;
+};
+
+TEST_F(MemoizationPipelineTest, SkipsUpstreamOnHit) {
+  auto pipe = MakePipeline();
+  AddCounter(*pipe, "MemoTestCounter", "raw", "upstream", 0);
+  AddCounter(*pipe, "MemoTestCounter", "upstream", "memoized", 1, true);
+  pipe->Build({{"memoized", "cpu"}, {"raw_label", "cpu"}});
+  int epoch_size = EpochSamples(*pipe);
+  ASSERT_GT(epoch_size, 0);
+
+  auto first = RunEpoch(*pipe);
+  EXPECT_EQ(MemoTestCounter::counts[0].load(), epoch_size);
+  EXPECT_EQ(MemoTestCounter::counts[1].load(), epoch_size);
+
+  // all the samples are taken from the cache - neither the memoized operator
+  // nor the one computing its input run
+  for (int epoch = 0; epoch < 2; epoch++) {
+    auto next = RunEpoch(*pipe);
+    EXPECT_EQ(MemoTestCounter::counts[0].load(), epoch_size);
+    EXPECT_EQ(MemoTestCounter::counts[1].load(), epoch_size);
+    EXPECT_EQ(next, first);
+  }
+}
+
+TEST_F(MemoizationPipelineTest, OutputsOfUpstreamRun) {
+  // the upstream operator produces a pipeline output, so it can't be skipped
+  auto pipe = MakePipeline();
+  AddCounter(*pipe, "MemoTestCounter", "raw", "upstream", 0);
+  AddCounter(*pipe, "MemoTestCounter", "upstream", "memoized", 1, true);
+  pipe->Build({{"memoized", "cpu"}, {"raw_label", "cpu"}, {"upstream", "cpu"}});
+  int epoch_size = EpochSamples(*pipe);
+
+  auto first = RunEpoch(*pipe);
+  auto second = RunEpoch(*pipe);
+  EXPECT_EQ(second, first);
+  EXPECT_EQ(MemoTestCounter::counts[0].load(), 2 * epoch_size);
+  EXPECT_EQ(MemoTestCounter::counts[1].load(), epoch_size);
+}
+
+TEST_F(MemoizationPipelineTest, RandomUpstream) {
+  auto pipe = MakePipeline();
+  AddCounter(*pipe, "MemoTestRandomCounter", "raw", "upstream", 0);
+  AddCounter(*pipe, "MemoTestCounter", "upstream", "memoized", 1, true);
+  EXPECT_THROW(pipe->Build({{"memoized", "cpu"}, {"raw_label", "cpu"}}), std::runtime_error);
+}
+
+TEST_F(MemoizationPipelineTest, RandomMemoized) {
+  auto pipe = MakePipeline();
+  AddCounter(*pipe, "MemoTestRandomCounter", "raw", "memoized", 1, true);
+  EXPECT_THROW(pipe->Build({{"memoized", "cpu"}, {"raw_label", "cpu"}}), std::runtime_error);
+}
+
+TEST_F(MemoizationPipelineTest, MultipleSources) {
+  auto pipe = MakePipeline();
+  AddReader(*pipe, "reader2", "raw2");
+  pipe->AddOperator(OpSpec("MemoTestCounter")
+      .AddArg("device", "cpu")
+      .AddArg("memoize", true)
+      .AddInput("raw", "cpu")
+      .AddInput("raw2", "cpu")
+      .AddOutput("memoized", "cpu"));
+  EXPECT_THROW(pipe->Build({{"memoized", "cpu"}, {"raw_label", "cpu"}, {"raw2_label", "cpu"}}),
+               std::runtime_error);
+}
+
+TEST_F(MemoizationPipelineTest, NotAReader) {
+  Pipeline pipe(kBatchSize, 2, CPU_ONLY_DEVICE_ID);
+  pipe.AddExternalInput("data");
+  AddCounter(pipe, "MemoTestCounter", "data", "memoized", 1, true);
+  EXPECT_THROW(pipe.Build({{"memoized", "cpu"}}), std::runtime_error);
+}
+
+}  // namespace dali
@@ -132,6 +132,16 @@ DLL_PUBLIC bool OpSchema::IsDeprecatedArg(const std::string &arg_name) const {
   return false;
 }
 
+DLL_PUBLIC bool OpSchema::IsRandom() const {
+  if (random_)
+    return true;
+  for (const auto &parent_name : parents_) {
+    if (SchemaRegistry::GetSchema(parent_name).IsRandom())
+      return true;
+  }
+  return false;
+}
+
 DLL_PUBLIC const DeprecatedArgDef &OpSchema::DeprecatedArgMeta(const std::string &arg_name) const {
   auto it = deprecated_arguments_.find(arg_name);
   if (it != deprecated_arguments_.end()) {
@@ -87,6 +87,23 @@ to accommodate a batch of samples of this size.)code", std::vector<int>{0});
 
     AddOptionalArg("preserve",  R"code(Prevents the operator from being removed from the
 graph even if its outputs are not used.)code", false);
+
+    AddOptionalArg("memoize", R"code(Caches the outputs of the operator, so that the part of
+the pipeline that computes them is not run again for the samples that were already processed.
+
+The samples are identified by the source info assigned to them by the reader. The operator and
+all the operators it depends on must be deterministic, and they must depend on a single reader.
+On a cache hit, the operators which only compute the inputs of the memoized operator are skipped,
+while the reader still runs.)code", false);
+
+    AddOptionalArg("memoize_budget", R"code(The number of bytes of the outputs memoized in
+host memory. 0 means no limit.
+
+When the budget is exhausted, the outputs are written to ``memoize_spill_dir`` or, if it is not
+provided, the remaining samples are not memoized.)code", 0);
+
+    AddOptionalArg("memoize_spill_dir", R"code(A directory to which the memoized outputs are
+written when ``memoize_budget`` is exhausted.)code", std::string());
   }
 
 
@@ -600,6 +617,15 @@ graph even if its outputs are not used.)code", false);
     return *this;
   }
 
+  /**
+   * @brief Notes that the outputs of this operator are random, so the operator
+   * cannot be a part of a memoized subgraph.
+   */
+  DLL_PUBLIC inline OpSchema& Random() {
+    random_ = true;
+    return *this;
+  }
+
   /**
    * @brief Informs that the data passes though this operator unchanged, only
    *        the metadata is affected.
@@ -776,6 +802,11 @@ graph even if its outputs are not used.)code", false);
     return no_prune_;
   }
 
+  /**
+   * @brief Whether the operator or any of its parents is marked as random
+   */
+  DLL_PUBLIC bool IsRandom() const;
+
   DLL_PUBLIC inline bool IsSerializable() const {
     return serializable_;
   }
@@ -946,6 +977,7 @@ graph even if its outputs are not used.)code", false);
   bool is_doc_partially_hidden_ = false;
 
   bool no_prune_ = false;
+  bool random_ = false;
 
   bool serializable_ = true;
 
@@ -53,6 +53,27 @@ struct DLL_PUBLIC ReaderMeta {
   }
 };
 
+/**
+ * @brief Compact snapshot of a reader position, used to resume the reading from a checkpoint
+ *
+ * The state of the loader (shard position, shuffle buffer and its random engine) is
+ * a deterministic function of the number of consumed samples, so only that is stored.
+ * The remaining fields are used to validate that the state is restored in a reader
+ * configured the same way.
+ */
+struct DLL_PUBLIC ReaderState {
+  Index consumed_samples = -1;    // number of samples consumed from the reader, incl. padding
+  Index epoch_size = -1;          // raw epoch size
+  Index seed = -1;                // seed of the reader
+  int number_of_shards = -1;      // number of shards
+  int shard_id = -1;              // shard id of given reader
+
+  DLL_PUBLIC operator bool() const {
+    return consumed_samples != -1 && epoch_size != -1 && number_of_shards != -1 &&
+           shard_id != -1;
+  }
+};
+
 /**
  * Names for most commonly used arguments, to keep consistency between arg naming amongst operators.
  */
@@ -159,6 +180,26 @@ class DLL_PUBLIC OperatorBase {
     return {};
   }
 
+  /**
+   * @brief For reader Ops, returns the snapshot of the reader position.
+   * See ReaderState structure for the data returned
+   * For all other Ops, returns an invalid state
+   *
+   * The consumed samples include the batches the executor prefetched, but the pipeline
+   * hasn't returned yet - use Pipeline::GetReaderState to get the resumable position.
+   */
+  DLL_PUBLIC virtual ReaderState GetReaderState() const {
+    return {};
+  }
+
+  /**
+   * @brief For reader Ops, restores the reader position from the snapshot obtained with
+   * GetReaderState. Must be called before the first run of the operator.
+   */
+  DLL_PUBLIC virtual void RestoreReaderState(const ReaderState &state) {
+    DALI_FAIL(make_string("Operator ", spec_.name(), " is not a reader and has no state"));
+  }
+
   DLL_PUBLIC const OpSpec& GetSpec() const {
     return spec_;
   }
@@ -510,6 +510,7 @@ void Pipeline::Outputs(DeviceWorkspace *ws) {
       "\"Build()\" must be called prior to executing the pipeline.");
     try {
       executor_->Outputs(ws);
+      returned_batches_++;
     } catch (std::exception &e) {
       throw std::runtime_error("Critical error in pipeline:\n"
           + std::string(e.what())
@@ -524,6 +525,7 @@ void Pipeline::ShareOutputs(DeviceWorkspace *ws) {
       "\"Build()\" must be called prior to executing the pipeline.");
     try {
       executor_->ShareOutputs(ws);
+      returned_batches_++;
     } catch (std::exception &e) {
       throw std::runtime_error("Critical error in pipeline:\n"
           + std::string(e.what())
@@ -712,6 +714,57 @@ ReaderMeta Pipeline::GetReaderMeta(std::string name) {
   return meta;
 }
 
+ReaderState Pipeline::ReturnedReaderState(const OpNode &node) {
+  ReaderState state = node.op->GetReaderState();
+  if (state) {
+    // The operator counts all the batches it produced, also the ones prefetched by the
+    // executor. The readers produce full batches, once per iteration.
+    auto restored = restored_samples_.find(node.instance_name);
+    state.consumed_samples = (restored != restored_samples_.end() ? restored->second : 0) +
+                             returned_batches_ * max_batch_size_;
+  }
+  return state;
+}
+
+std::map<std::string, ReaderState> Pipeline::GetReaderState() {
+  std::map<std::string, ReaderState> ret;
+  for (Index i = 0; i < graph_.NumOp(); ++i) {
+    const OpNode &current = graph_.Node(i);
+    ReaderState state = ReturnedReaderState(current);
+    if (state) {
+      ret.insert(make_pair(current.instance_name, state));
+    }
+  }
+  return ret;
+}
+
+ReaderState Pipeline::GetReaderState(const std::string &name) {
+  ReaderState state;
+  for (Index i = 0; i < graph_.NumOp(); ++i) {
+    const OpNode &current = graph_.Node(i);
+    if (current.instance_name == name) {
+      state = ReturnedReaderState(current);
+      break;
+    }
+  }
+  return state;
+}
+
+void Pipeline::RestoreReaderState(const std::string &name, const ReaderState &state) {
+  DALI_ENFORCE(built_, "\"Build()\" must be called prior to restoring the reader state.");
+  DALI_ENFORCE(returned_batches_ == 0,
+               "The reader state can be restored only before the first run of the pipeline");
+  for (Index i = 0; i < graph_.NumOp(); ++i) {
+    const OpNode &current = graph_.Node(i);
+    if (current.instance_name == name) {
+      current.op->RestoreReaderState(state);
+      restored_samples_[name] = state.consumed_samples;
+      return;
+    }
+  }
+  DALI_FAIL(make_string("Operator \"", name, "\" not found in the pipeline."));
+}
+
 const std::string &Pipeline::output_name(int id) const {
   DALI_ENFORCE(built_, "\"Build()\" must be called prior to calling \"output_name()\".");
   DALI_ENFORCE_VALID_INDEX(id, output_names_.size());
@@ -413,6 +413,25 @@ class DLL_PUBLIC Pipeline {
    */
   DLL_PUBLIC ReaderMeta GetReaderMeta(std::string name);
 
+  /**
+   * @brief Returns the map of (node name, reader state) for all nodes that return a valid state
+   *
+   * The state describes the position after the batches already returned by Outputs or
+   * ShareOutputs - the batches prefetched by the executor are not counted as consumed.
+   */
+  DLL_PUBLIC std::map<std::string, ReaderState> GetReaderState();
+
+  /**
+   * @brief Returns the reader state for a node with given name
+   */
+  DLL_PUBLIC ReaderState GetReaderState(const std::string &name);
+
+  /**
+   * @brief Restores the state of a reader with given name, so it continues from the position
+   * stored in the state. Must be called after Build and before the first run.
+   */
+  DLL_PUBLIC void RestoreReaderState(const std::string &name, const ReaderState &state);
+
   /**
    * @brief Returns the number of threads used by the pipeline.
    */
@@ -493,6 +512,9 @@ class DLL_PUBLIC Pipeline {
   // Helper to add pipeline meta-data
   void PrepareOpSpec(OpSpec *spec, int logical_id);
 
+  // The state of the reader at the node, describing the position after the returned batches
+  ReaderState ReturnedReaderState(const OpNode &node);
+
   void PropagateMemoryHint(OpNode &node);
 
   inline void AddToOpSpecs(const std::string &inst_name, const OpSpec &spec, int logical_id);
@@ -542,6 +564,12 @@ class DLL_PUBLIC Pipeline {
   // Mapping between logical id and index in op_spces_;
   std::map<int, std::vector<size_t>> logical_ids_;
   std::map<int, int64_t> logical_id_to_seed_;
+
+  // number of batches returned by Outputs and ShareOutputs, used to tell the reader position
+  // that corresponds to the returned batches
+  int64_t returned_batches_ = 0;
+  // consumed_samples of the restored reader states, by the instance name
+  std::map<std::string, Index> restored_samples_;
 };
 
 }  // namespace dali
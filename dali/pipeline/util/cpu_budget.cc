@@ -0,0 +1,98 @@
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/pipeline/util/cpu_budget.h"
+#include <algorithm>
+#include <cstdlib>
+#include "dali/core/error_handling.h"
+
+namespace dali {
+
+CPUBudget::CPUBudget(int limit) : limit_(limit) {
+  DALI_ENFORCE(limit >= 0, "The CPU thread budget cannot be negative");
+}
+
+CPUBudget &CPUBudget::Global() {
+  static CPUBudget budget([]() {
+    const char *env = std::getenv("DALI_CPU_THREAD_BUDGET");
+    return env ? std::max(atoi(env), 0) : 0;
+  }());
+  return budget;
+}
+
+void CPUBudget::SetLimit(int limit) {
+  DALI_ENFORCE(limit >= 0, "The CPU thread budget cannot be negative");
+  std::lock_guard<std::mutex> lock(mutex_);
+  limit_ = limit;
+  Distribute();
+}
+
+bool CPUBudget::Acquire(const void *client) {
+  if (limit_ == 0)
+    return false;
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (limit_ == 0)
+    return false;
+  if (waiting_ == 0 && in_use_ < limit_) {
+    in_use_++;
+    return true;
+  }
+  // the reference stays valid - the entry is only removed by the thread that uses it
+  auto &c = clients_[client];
+  c.waiting++;
+  waiting_++;
+  Distribute();
+  granted_.wait(lock, [&]() { return c.granted > 0; });
+  c.granted--;
+  c.waiting--;
+  waiting_--;
+  if (c.waiting == 0)
+    clients_.erase(client);
+  return true;
+}
+
+void CPUBudget::Release() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  in_use_--;
+  Distribute();
+}
+
+void CPUBudget::Distribute() {
+  bool any_granted = false;
+  while (limit_ == 0 || in_use_ < limit_) {
+    // the next client, after the one served last, with a thread waiting for a slot
+    auto next = clients_.upper_bound(last_client_);
+    auto it = next;
+    for (; it != clients_.end(); ++it) {
+      if (it->second.waiting > it->second.granted)
+        break;
+    }
+    if (it == clients_.end()) {
+      for (it = clients_.begin(); it != next; ++it) {
+        if (it->second.waiting > it->second.granted)
+          break;
+      }
+      if (it == next)
+        break;
+    }
+    it->second.granted++;
+    in_use_++;
+    last_client_ = it->first;
+    any_granted = true;
+  }
+  if (any_granted)
+    granted_.notify_all();
+}
+
+}  // namespace dali
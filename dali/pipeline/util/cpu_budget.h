@@ -0,0 +1,97 @@
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_PIPELINE_UTIL_CPU_BUDGET_H_
+#define DALI_PIPELINE_UTIL_CPU_BUDGET_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include "dali/core/common.h"
+
+namespace dali {
+
+/**
+ * @brief Limits the number of work items run at the same time by the thread pools in the process
+ *
+ * Every pipeline has its own thread pool, so running several pipelines in one process starts
+ * many more worker threads than there are cores. With a limit set, a worker thread takes
+ * a slot before running a work item and returns it afterwards. The idle threads just wait, so
+ * the number of threads competing for the cores doesn't exceed the limit.
+ *
+ * When the slots are taken, they are handed out to the waiting clients (thread pools) in
+ * a round-robin fashion, so that a pipeline issuing a lot of work doesn't starve the others.
+ */
+class DLL_PUBLIC CPUBudget {
+ public:
+  /**
+   * @param limit maximum number of slots taken at the same time; 0 means no limit
+   */
+  explicit CPUBudget(int limit = 0);
+
+  /**
+   * @brief The budget shared by all the thread pools in the process
+   *
+   * The limit is initially taken from the DALI_CPU_THREAD_BUDGET environment variable.
+   */
+  static CPUBudget &Global();
+
+  /**
+   * @brief Changes the limit; 0 means no limit
+   *
+   * The slots already taken are not affected.
+   */
+  void SetLimit(int limit);
+
+  int Limit() const {
+    return limit_;
+  }
+
+  /**
+   * @brief Waits until a slot is given to the client
+   *
+   * Returns false, without waiting, if there is no limit - in that case Release
+   * must not be called.
+   */
+  bool Acquire(const void *client);
+
+  /**
+   * @brief Returns a slot taken with Acquire
+   */
+  void Release();
+
+  DISABLE_COPY_MOVE_ASSIGN(CPUBudget);
+
+ private:
+  struct Client {
+    int waiting = 0;
+    int granted = 0;  // slots given to the client and not taken by its waiting threads yet
+  };
+
+  /// @brief Gives the free slots to the waiting clients, in turns
+  void Distribute();
+
+  std::mutex mutex_;
+  std::condition_variable granted_;
+  std::atomic<int> limit_;
+  int in_use_ = 0;
+  int waiting_ = 0;
+  std::map<const void *, Client> clients_;
+  const void *last_client_ = nullptr;
+};
+
+}  // namespace dali
+
+#endif  // DALI_PIPELINE_UTIL_CPU_BUDGET_H_
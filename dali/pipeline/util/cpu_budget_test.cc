@@ -0,0 +1,118 @@
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/pipeline/util/cpu_budget.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "dali/pipeline/util/thread_pool.h"
+
+namespace dali {
+
+namespace test {
+
+TEST(CPUBudget, NoLimit) {
+  CPUBudget budget;
+  EXPECT_FALSE(budget.Acquire(nullptr));
+}
+
+TEST(CPUBudget, Limit) {
+  CPUBudget budget(3);
+  std::atomic<int> running{0}, max_running{0};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 16; i++) {
+    threads.emplace_back([&, i]() {
+      for (int j = 0; j < 10; j++) {
+        ASSERT_TRUE(budget.Acquire(reinterpret_cast<void *>(i % 4 + 1)));
+        int now = ++running;
+        int prev = max_running;
+        while (prev < now && !max_running.compare_exchange_weak(prev, now)) {}
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        --running;
+        budget.Release();
+      }
+    });
+  }
+  for (auto &t : threads)
+    t.join();
+  EXPECT_LE(max_running, 3);
+  EXPECT_GE(max_running, 1);
+}
+
+TEST(CPUBudget, RoundRobin) {
+  CPUBudget budget(1);
+  int a = 0, b = 0;
+  ASSERT_TRUE(budget.Acquire(&a));
+
+  // client `a` queues much more work than `b`, which still gets every other slot
+  std::mutex order_mutex;
+  std::vector<int *> order;
+  std::vector<std::thread> threads;
+  auto run = [&](int *client) {
+    threads.emplace_back([&, client]() {
+      ASSERT_TRUE(budget.Acquire(client));
+      {
+        std::lock_guard<std::mutex> lock(order_mutex);
+        order.push_back(client);
+      }
+      budget.Release();
+    });
+  };
+  for (int i = 0; i < 4; i++)
+    run(&a);
+  run(&b);
+  run(&b);
+  // let all the threads wait for the slot
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  budget.Release();
+  for (auto &t : threads)
+    t.join();
+
+  ASSERT_EQ(order.size(), 6u);
+  // both of the `b` threads run within the first four slots
+  EXPECT_EQ(std::count(order.begin(), order.begin() + 4, &b), 2);
+}
+
+TEST(CPUBudget, ThreadPools) {
+  CPUBudget::Global().SetLimit(2);
+  {
+    ThreadPool tp1(4, 0, false), tp2(4, 0, false);
+    std::atomic<int> running{0}, max_running{0};
+    auto work = [&](int) {
+      int now = ++running;
+      int prev = max_running;
+      while (prev < now && !max_running.compare_exchange_weak(prev, now)) {}
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      --running;
+    };
+    for (int i = 0; i < 32; i++) {
+      tp1.AddWork(work);
+      tp2.AddWork(work);
+    }
+    tp1.RunAll(false);
+    tp2.RunAll(false);
+    tp1.WaitForWork();
+    tp2.WaitForWork();
+    EXPECT_LE(max_running, 2);
+  }
+  CPUBudget::Global().SetLimit(0);
+}
+
+}  // namespace test
+
+}  // namespace dali
@@ -0,0 +1,52 @@
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_PIPELINE_UTIL_SAMPLE_BLOCKS_H_
+#define DALI_PIPELINE_UTIL_SAMPLE_BLOCKS_H_
+
+#include <algorithm>
+#include <cstdint>
+#include "dali/core/tensor_shape.h"
+#include "dali/pipeline/util/thread_pool.h"
+
+namespace dali {
+
+/// @brief Default number of elements in a block scheduled by AddSampleBlocksWork
+constexpr int64_t kDefaultSampleBlockSize = 1 << 16;
+
+/**
+ * @brief Schedules elementwise processing of a batch on the thread pool, with the samples
+ *        split into blocks of at most `block_size` elements, to balance the load
+ *
+ * For each block, `func(sample_idx, start, n)` is called with the offset of the block
+ * in the sample and the number of its elements. The work is only added to the pool - it's
+ * started by the following ThreadPool::RunAll, which `func` must outlive.
+ */
+template <typename Func>
+void AddSampleBlocksWork(ThreadPool &tp, const TensorListShape<> &shape, const Func &func,
+                         int64_t block_size = kDefaultSampleBlockSize) {
+  for (int sample_idx = 0; sample_idx < shape.num_samples(); sample_idx++) {
+    int64_t size = shape.tensor_size(sample_idx);
+    for (int64_t start = 0; start < size; start += block_size) {
+      int64_t n = std::min(size - start, block_size);
+      tp.AddWork([&func, sample_idx, start, n](int) {
+        func(sample_idx, start, n);
+      }, n);
+    }
+  }
+}
+
+}  // namespace dali
+
+#endif  // DALI_PIPELINE_UTIL_SAMPLE_BLOCKS_H_
@@ -0,0 +1,55 @@
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/pipeline/util/sample_blocks.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <vector>
+#include "dali/core/util.h"
+
+namespace dali {
+
+namespace test {
+
+TEST(SampleBlocks, CoversEverySampleOnce) {
+  ThreadPool tp(4, 0, false);
+  TensorListShape<> shape = {{ {0, 4}, {1, 5}, {100, 1}, {10, 10}, {3, 7} }};
+  const int64_t block_size = 8;
+  std::vector<std::vector<std::atomic<int>>> visits(shape.num_samples());
+  for (int i = 0; i < shape.num_samples(); i++)
+    visits[i] = std::vector<std::atomic<int>>(shape.tensor_size(i));
+  std::atomic<int> num_blocks{0};
+  auto visit = [&](int sample_idx, int64_t start, int64_t n) {
+    EXPECT_GT(n, 0);
+    EXPECT_LE(n, block_size);
+    for (int64_t i = start; i < start + n; i++)
+      visits[sample_idx][i]++;
+    num_blocks++;
+  };
+  AddSampleBlocksWork(tp, shape, visit, block_size);
+  EXPECT_EQ(num_blocks.load(), 0);
+  tp.RunAll();
+
+  int expected_blocks = 0;
+  for (int i = 0; i < shape.num_samples(); i++) {
+    expected_blocks += div_ceil(shape.tensor_size(i), block_size);
+    for (auto &v : visits[i])
+      EXPECT_EQ(v.load(), 1);
+  }
+  EXPECT_EQ(num_blocks.load(), expected_blocks);
+}
+
+}  // namespace test
+
+}  // namespace dali
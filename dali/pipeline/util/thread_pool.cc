@@ -21,6 +21,8 @@
 #include "dali/core/format.h"
 #include "dali/core/cuda_utils.h"
 #include "dali/core/device_guard.h"
+#include "dali/pipeline/util/cpu_budget.h"
+#include "dali/util/numa.h"
 
 namespace dali {
 
@@ -136,6 +138,10 @@ void ThreadPool::ThreadMain(int thread_id, int device_id, bool set_affinity) {
       nvml::SetCPUAffinity(core);
     }
 #endif
+    // the NUMA policy takes precedence over the affinity set above
+    int numa_node = numa::ThreadNode(numa::GetPolicy(), thread_id);
+    if (numa_node >= 0)
+      numa::BindThreadToNode(numa_node);
   } catch (std::exception &e) {
     tl_errors_[thread_id].push(e.what());
   } catch (...) {
@@ -158,6 +164,10 @@ void ThreadPool::ThreadMain(int thread_id, int device_id, bool set_affinity) {
     // Unlock the lock
     lock.unlock();
 
+    // Wait for a free slot if the number of threads running at once
+    // across all the thread pools in the process is limited
+    bool budgeted = CPUBudget::Global().Acquire(this);
+
     // If an error occurs, we save it in tl_errors_. When
     // WaitForWork is called, we will check for any errors
     // in the threads and return an error if one occured.
@@ -173,6 +183,9 @@ void ThreadPool::ThreadMain(int thread_id, int device_id, bool set_affinity) {
       lock.unlock();
     }
 
+    if (budgeted)
+      CPUBudget::Global().Release();
+
     // Mark this thread as idle & check for complete work
     lock.lock();
     --active_threads_;
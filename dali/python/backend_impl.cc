@@ -30,6 +30,7 @@
 #include "dali/pipeline/operator/op_spec.h"
 #include "dali/pipeline/operator/operator.h"
 #include "dali/pipeline/pipeline.h"
+#include "dali/pipeline/util/cpu_budget.h"
 #include "dali/plugin/plugin_manager.h"
 #include "dali/python/python3_compat.h"
 #include "dali/util/half.hpp"
@@ -1079,6 +1080,19 @@ void ExposeBufferPolicyFunctions(py::module &m) {
   m.def("GetDeviceBufferGrowthFactor", Buffer<GPUBackend>::GetGrowthFactor);
 }
 
+void ExposeCPUBudgetFunctions(py::module &m) {
+  m.def("SetCPUThreadBudget", [](int limit) {
+    if (limit < 0)
+      throw py::value_error("The CPU thread budget must be a non-negative number "
+                            "(0 means no limit).");
+    CPUBudget::Global().SetLimit(limit);
+  });
+
+  m.def("GetCPUThreadBudget", []() {
+    return CPUBudget::Global().Limit();
+  });
+}
+
 py::dict DeprecatedArgMetaToDict(const DeprecatedArgDef & meta) {
   py::dict d;
   d["msg"] = meta.msg;
@@ -1098,6 +1112,26 @@ py::dict ReaderMetaToDict(const ReaderMeta &meta) {
   return d;
 }
 
+py::dict ReaderStateToDict(const ReaderState &state) {
+  py::dict d;
+  d["consumed_samples"] = state.consumed_samples;
+  d["epoch_size"] = state.epoch_size;
+  d["seed"] = state.seed;
+  d["number_of_shards"] = state.number_of_shards;
+  d["shard_id"] = state.shard_id;
+  return d;
+}
+
+ReaderState ReaderStateFromDict(const py::dict &d) {
+  ReaderState state;
+  state.consumed_samples = d["consumed_samples"].cast<Index>();
+  state.epoch_size = d["epoch_size"].cast<Index>();
+  state.seed = d["seed"].cast<Index>();
+  state.number_of_shards = d["number_of_shards"].cast<int>();
+  state.shard_id = d["shard_id"].cast<int>();
+  return state;
+}
+
 py::dict ExecutorMetaToDict(const ExecutorMetaMap &meta) {
   py::dict d;
   for (const auto &stat : meta) {
@@ -1141,6 +1175,8 @@ PYBIND11_MODULE(backend_impl, m) {
 
   ExposeBufferPolicyFunctions(m);
 
+  ExposeCPUBudgetFunctions(m);
+
   m.def("LoadLibrary", &PluginManager::LoadLibrary);
 
   m.def("GetCxx11AbiFlag", &GetCxx11AbiFlag);
@@ -1450,6 +1486,25 @@ PYBIND11_MODULE(backend_impl, m) {
           DALI_ENFORCE(meta,
               "Operator " + op_name + "  not found or does not expose valid metadata.");
           return ReaderMetaToDict(meta);
+        })
+    .def("reader_state", [](Pipeline* p) {
+          std::map<std::string, ReaderState> state_map = p->GetReaderState();
+          py::dict d;
+          for (auto const& value : state_map) {
+            d[value.first.c_str()] = ReaderStateToDict(value.second);
+          }
+          return d;
+        })
+    .def("reader_state",
+        [](Pipeline* p, const std::string& op_name) {
+          ReaderState state = p->GetReaderState(op_name);
+          DALI_ENFORCE(state,
+              "Operator " + op_name + "  not found or does not expose valid state.");
+          return ReaderStateToDict(state);
+        })
+    .def("restore_reader_state",
+        [](Pipeline* p, const std::string& op_name, const py::dict &state) {
+          p->RestoreReaderState(op_name, ReaderStateFromDict(state));
         });
 
 #define DALI_OPSPEC_ADDARG(T) \
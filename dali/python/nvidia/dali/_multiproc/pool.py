@@ -342,6 +342,12 @@ class WorkerPool:
         self.pool = pool
         self.queue_depths = queue_depths
         self.rec_pipes = self.pool.get_recv_pipes()
+        # The contexts may be used from different threads (e.g. parallel ExternalSource from
+        # the main thread and parallel PythonFunction from the executor thread). The results
+        # of all the contexts come through the same pipes, so only one thread at a time can
+        # receive them - it dispatches them to the right contexts.
+        self._recv_lock = threading.Lock()
+        self._workers_exited = False
 
     @classmethod
     def from_groups(
@@ -395,9 +401,12 @@ class WorkerPool:
             # or failed with error, once user receives batch that raised exception they should reset
             # the context before scheduling new tasks
             return
+        with self._recv_lock:
+            # TODO check if raising from doubly scheduled task makes sense?
+            # the batch must be known before the tasks are sent - another thread may
+            # receive the results right away
+            context.push_scheduled(batch_i, tasks)
         self._distribute(context_i, batch_i, dst_chunk_i, tasks)
-        # TODO check if raising from doubly scheduled task makes sense?
-        context.push_scheduled(batch_i, tasks)
 
     def _distribute(self, context_i, batch_i, dst_chunk_i, tasks):
         num_workers = self.pool.num_workers
@@ -426,19 +435,28 @@ class WorkerPool:
             callbacks passed when constructing the pool.
         """
         context = self.contexts[context_i]
-        assert len(context.scheduled) > 0, "No task has been scheduled"
-        batch_i, tasks = context.pop_scheduled()
-        while context.is_not_received(batch_i, tasks) and not context.is_error(batch_i):
-            self._receive_chunk()
-        context.handle_error(batch_i)
-        res = context.get_batch(batch_i, tasks)
-        return res
+        with self._recv_lock:
+            assert len(context.scheduled) > 0, "No task has been scheduled"
+            batch_i, tasks = context.pop_scheduled()
+        while True:
+            # the lock is released after every chunk, so that a thread whose batch has been
+            # completed by another thread doesn't wait for the other thread's batch
+            with self._recv_lock:
+                if not context.is_not_received(batch_i, tasks) or context.is_error(batch_i):
+                    context.handle_error(batch_i)
+                    return context.get_batch(batch_i, tasks)
+                self._receive_chunk()
 
     def _receive_chunk(self):
+        """Receives the chunks that are ready and dispatches them to their contexts.
+        Needs to be called while holding the ``_recv_lock``."""
+        if self._workers_exited:
+            raise RuntimeError("Worker exited unexpectedly")
         ready_workers = multiprocessing.connection.wait(self.rec_pipes)
         for worker_pipe in ready_workers:
             completed_tasks = worker_pipe.recv()
             if completed_tasks is None:
+                self._workers_exited = True
                 raise RuntimeError("Worker exited unexpectedly")
             worker_id = completed_tasks.worker_id
             batch_i = completed_tasks.batch_i
@@ -461,11 +479,13 @@ class WorkerPool:
         return self.pool.pids()
 
     def reset(self):
-        for context in self.contexts:
-            context.reset()
+        with self._recv_lock:
+            for context in self.contexts:
+                context.reset()
 
     def reset_context(self, context_i):
-        self.contexts[context_i].reset()
+        with self._recv_lock:
+            self.contexts[context_i].reset()
 
     def close(self):
         self.pool.close()
@@ -1001,18 +1001,89 @@ class PythonFunction(PythonFunctionBase):
                                                               lambda t: t.toDlpack(),
                                                               *dlpack_inputs)
 
-    def __init__(self, function, num_outputs=1, device='cpu', batch_processing=False, **kwargs):
+    def __init__(self, function, num_outputs=1, device='cpu', batch_processing=False,
+                 parallel=False, **kwargs):
         if device == 'gpu':
             _setup_cupy()
-        func = (lambda *ts: PythonFunction._function_wrapper_cpu(batch_processing, function, *ts))\
-               if device == 'cpu' else \
-               (lambda *ts: PythonFunction._function_wrapper_gpu(batch_processing, function, *ts))
+        self._parallel_context = None
+        if parallel:
+            if device != 'cpu':
+                raise ValueError("Only CPU PythonFunction can be run in parallel.")
+            if batch_processing:
+                raise ValueError("PythonFunction with ``parallel`` set to True must be called "
+                                 "separately for every sample (``batch_processing=False``).")
+            if num_outputs == 0:
+                raise ValueError("PythonFunction with ``parallel`` set to True must return "
+                                 "at least one output.")
+            self._parallel_context = _PythonFunctionParallelContext(function, num_outputs)
+            func = self._parallel_context.run
+            # the samples are dispatched to the workers by the context, the operator itself
+            # processes whole batches
+            batch_processing = True
+        else:
+            func = (lambda *ts: PythonFunction._function_wrapper_cpu(batch_processing, function, *ts))\
+                   if device == 'cpu' else \
+                   (lambda *ts: PythonFunction._function_wrapper_gpu(batch_processing, function, *ts))
         super(PythonFunction, self).__init__(impl_name="DLTensorPythonFunctionImpl",
                                              function=func,
                                              num_outputs=num_outputs, device=device,
                                              synchronize_stream=False,
                                              batch_processing=batch_processing, **kwargs)
 
+    def __call__(self, *inputs, **kwargs):
+        if self._parallel_context is not None and len(inputs) == 0:
+            raise ValueError("PythonFunction with ``parallel`` set to True requires at least "
+                             "one input.")
+        return super(PythonFunction, self).__call__(*inputs, **kwargs)
+
+
+class _PythonFunctionParallelContext:
+    """Runs the per-sample function of a parallel PythonFunction in the Python workers pool
+    of the pipeline. The inputs are sent to the workers through pipes and the results are
+    returned in the shared memory chunks managed by the pool.
+
+    Exposes ``callback`` and ``prefetch_queue_depth`` so that it can be passed to
+    ``WorkerPool.from_groups`` alongside the parallel ExternalSource groups.
+    """
+
+    def __init__(self, function, num_outputs):
+        self.callback = function
+        self.num_outputs = num_outputs
+        # the operator waits for the results before returning, so only one batch is in flight
+        self.prefetch_queue_depth = 1
+        self.detach_pool()
+
+    def attach_pool(self, pool, context_i):
+        self.pool = pool
+        self.context_i = context_i
+        self.batch_i = 0
+        self.dst_chunk_i = 0
+
+    def detach_pool(self):
+        self.attach_pool(None, None)
+
+    def _run_sequential(self, tasks):
+        return [self.callback(*task) for task in tasks]
+
+    def _run_parallel(self, tasks):
+        self.pool.schedule_batch(self.context_i, self.batch_i, self.dst_chunk_i, tasks)
+        self.batch_i += 1
+        self.dst_chunk_i = (self.dst_chunk_i + 1) % self.pool.queue_depths[self.context_i]
+        return self.pool.receive_batch(self.context_i)
+
+    def run(self, *dlpack_inputs):
+        batch_size = len(dlpack_inputs[0])
+        tasks = [tuple(_dlpack_to_array(dl_input[i]) for dl_input in dlpack_inputs)
+                 for i in range(batch_size)]
+        # with ``py_num_workers=0`` the function runs in the main process
+        outs = self._run_parallel(tasks) if self.pool is not None else self._run_sequential(tasks)
+        if self.num_outputs == 0:
+            return
+        if self.num_outputs == 1 and not isinstance(outs[0], (tuple, list)):
+            return [_dlpack_from_array(out) for out in outs]
+        return tuple([_dlpack_from_array(sample[i]) for sample in outs]
+                     for i in range(self.num_outputs))
+
 
 class DLTensorPythonFunction(PythonFunctionBase):
     global _cpu_ops
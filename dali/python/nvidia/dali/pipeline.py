@@ -119,10 +119,12 @@ Parameters
     If DALI should print operator output buffer statistics.
     Usefull for `bytes_per_sample_hint` operator parameter.
 `py_num_workers`: int, optional, default = 1
-    The number of Python workers that will process ``ExternalSource`` callbacks.
-    The pool starts only if there is at least one ExternalSource with ``parallel`` set to True.
-    Setting it to 0 disables the pool and all ExternalSource operators fall back to non-parallel
-    mode even if ``parallel`` is set to True.
+    The number of Python workers that will process ``ExternalSource`` callbacks and
+    ``PythonFunction`` calls.
+    The pool starts only if there is at least one ExternalSource or PythonFunction with
+    ``parallel`` set to True.
+    Setting it to 0 disables the pool and all ExternalSource and PythonFunction operators fall back
+    to non-parallel mode even if ``parallel`` is set to True.
 `py_start_method` : str, default = "fork"
     Determines how Python workers are started. Supported methods:
 
@@ -179,6 +181,7 @@ Parameters
         self._py_pool = None
         self._input_callbacks = None
         self._parallel_input_callbacks = None
+        self._parallel_py_functions = None
         self._seq_input_callbacks = None
         self._enable_memory_stats = enable_memory_stats
         self._prefetch_queue_depth = prefetch_queue_depth
@@ -351,6 +354,62 @@ Parameters
             return self._pipe.reader_meta(name)
         return self._pipe.reader_meta()
 
+    def reader_state(self, name = None):
+        """Returns the snapshot of the reader position as a dictionary. If no name is provided
+        it returns a dictionary with data for all readers as {reader_name : state}.
+
+        The state describes the position after the batches already returned by the pipeline,
+        so the batches prefetched by the executor are read again after the state is restored.
+        It can be saved along with the training checkpoint and passed to
+        :meth:`restore_reader_state` of an identically configured pipeline to resume reading
+        without replaying the already consumed samples.
+
+        Available state keys:
+
+        ``consumed_samples``:  number of samples (including padding) returned by the reader
+
+        ``epoch_size``:        raw epoch size
+
+        ``seed``:              seed of the reader
+
+        ``number_of_shards``:  number of shards
+
+        ``shard_id``:          shard id of given reader
+
+        Parameters
+        ----------
+        name : str, optional, default = None
+            The reader which state should be returned.
+        """
+        if not self._built:
+            raise RuntimeError("Pipeline must be built first.")
+        if name is not None:
+            return self._pipe.reader_state(name)
+        return self._pipe.reader_state()
+
+    def restore_reader_state(self, state, name = None):
+        """Restores the reader position from the snapshot obtained with :meth:`reader_state`.
+
+        The readers skip the already consumed samples without reading them and rebuild their
+        shuffle buffers, so the following batches are the same as the ones the original
+        pipeline would return. Must be called after :meth:`build` and before the first run.
+
+        Parameters
+        ----------
+        state : dict
+            State of a single reader, if `name` is provided, or a dictionary
+            {reader_name : state} as returned by :meth:`reader_state` otherwise.
+        name : str, optional, default = None
+            The reader which state should be restored.
+        """
+        if not self._built:
+            raise RuntimeError("Pipeline must be built first.")
+        if not self._first_iter:
+            raise RuntimeError("Reader state can be restored only before the first run.")
+        states = {name: state} if name is not None else state
+        for reader_name, reader_state in states.items():
+            self._pipe.restore_reader_state(reader_name, reader_state)
+
     @staticmethod
     def current():
         """Returns the instance of the current pipeline set by :meth:`push_current`."""
@@ -550,10 +609,14 @@ Parameters
         self._py_graph_built = True
 
     def _start_py_workers(self):
-        if not self._parallel_input_callbacks:
+        if not self._parallel_input_callbacks and not self._parallel_py_functions:
             return
+        # parallel PythonFunctions use the contexts following the ExternalSource ones
         self._py_pool = WorkerPool.from_groups(
-            self._parallel_input_callbacks, self._prefetch_queue_depth, self._py_start_method, self._py_num_workers)
+            self._parallel_input_callbacks + self._parallel_py_functions,
+            self._prefetch_queue_depth, self._py_start_method, self._py_num_workers)
+        for i, fn_context in enumerate(self._parallel_py_functions):
+            fn_context.attach_pool(self._py_pool, len(self._parallel_input_callbacks) + i)
         # pool instance releases shared memory when garbage collected, thus it must outlive the pipeline instance
         # when external source is used with no_copy=True
         weakref.finalize(self, lambda pool : pool.close(), self._py_pool)
@@ -602,6 +665,13 @@ Parameters
             self._parallel_input_callbacks = [group for group in groups if group.parallel]
             self._seq_input_callbacks = [group for group in groups if not group.parallel]
 
+        fn_contexts = []
+        for op in self._ops:
+            fn_context = getattr(op._op, "_parallel_context", None)
+            if fn_context is not None and fn_context not in fn_contexts:
+                fn_contexts.append(fn_context)
+        self._parallel_py_functions = fn_contexts if self._py_num_workers > 0 else []
+
     def start_py_workers(self):
         """
         Start Python workers (that will run ``ExternalSource`` callbacks).
@@ -0,0 +1,96 @@
+# Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+from nvidia.dali.pipeline import Pipeline
+import nvidia.dali.ops as ops
+import numpy as np
+from test_utils import compare_pipelines
+from test_utils import RandomlyShapedDataIterator
+from nose.tools import raises
+
+class AudioFrontEndPipeline(Pipeline):
+    def __init__(self, batch_size, iterator, fused, spectrogram_args, mel_args, db_args,
+                 mfcc_args, num_threads=3, device_id=0):
+        super(AudioFrontEndPipeline, self).__init__(batch_size, num_threads, device_id)
+        self.iterator = iterator
+        self.inputs = ops.ExternalSource()
+        self.fused = fused
+        if fused:
+            args = dict(spectrogram_args, **mel_args, **db_args)
+            args['n_mfcc'] = mfcc_args['n_mfcc']
+            args['dct_type'] = mfcc_args['dct_type']
+            args['dct_normalize'] = mfcc_args['normalize']
+            args['lifter'] = mfcc_args['lifter']
+            self.front_end = ops.AudioFrontEnd(**args)
+        else:
+            time_major = spectrogram_args.get('layout', 'ft') == 'tf'
+            self.spectrogram = ops.Spectrogram(**spectrogram_args)
+            self.mel = ops.MelFilterBank(**mel_args)
+            self.to_db = ops.ToDecibels(**db_args)
+            self.mfcc = ops.MFCC(axis=1 if time_major else 0, **mfcc_args)
+
+    def define_graph(self):
+        self.data = self.inputs()
+        if self.fused:
+            return self.front_end(self.data)
+        return self.mfcc(self.to_db(self.mel(self.spectrogram(self.data))))
+
+    def iter_setup(self):
+        data = self.iterator.next()
+        self.feed_input(self.data, data)
+
+def check_audio_front_end_vs_chain(batch_size, spectrogram_args, mel_args, db_args, mfcc_args):
+    min_shape = (200,)
+    max_shape = (20000,)
+    eii1 = RandomlyShapedDataIterator(batch_size, min_shape, max_shape, dtype=np.float32)
+    eii2 = RandomlyShapedDataIterator(batch_size, min_shape, max_shape, dtype=np.float32)
+    compare_pipelines(
+        AudioFrontEndPipeline(batch_size, iter(eii1), True,
+                              spectrogram_args, mel_args, db_args, mfcc_args),
+        AudioFrontEndPipeline(batch_size, iter(eii2), False,
+                              spectrogram_args, mel_args, db_args, mfcc_args),
+        batch_size=batch_size, N_iterations=3, eps=1e-03, compare_layouts=False)
+
+def test_audio_front_end_vs_chain():
+    for batch_size in [1, 4]:
+        for layout in ['ft', 'tf']:
+            for center, reflect in [(True, True), (True, False), (False, False)]:
+                for nfft, window_length, window_step, nfilter, db_args, \
+                        dct_type, n_mfcc, norm, lifter in \
+                    [(512, 400, 160, 64, {'cutoff_db': -80.0}, 2, 20, False, 0.0),
+                     (None, 256, 128, 40, {'reference': 1.0}, 2, 13, True, 22.0),
+                     (1024, 1024, 300, 128, {'multiplier': 20.0}, 3, 40, False, 0.0)]:
+                    spectrogram_args = {'nfft': nfft, 'window_length': window_length,
+                                        'window_step': window_step, 'layout': layout,
+                                        'center_windows': center, 'reflect_padding': reflect,
+                                        'power': 2}
+                    mel_args = {'nfilter': nfilter, 'sample_rate': 16000.0}
+                    mfcc_args = {'n_mfcc': n_mfcc, 'dct_type': dct_type, 'normalize': norm,
+                                 'lifter': lifter}
+                    yield check_audio_front_end_vs_chain, batch_size, spectrogram_args, \
+                        mel_args, db_args, mfcc_args
+
+@raises(RuntimeError)
+def check_audio_front_end_wrong_args(args):
+    eii = RandomlyShapedDataIterator(1, (200,), (2000,), dtype=np.float32)
+    pipe = AudioFrontEndPipeline(1, iter(eii), True, args, {}, {},
+                                 {'n_mfcc': 20, 'dct_type': 1, 'normalize': False, 'lifter': 0.0})
+    pipe.build()
+    pipe.run()
+
+def test_audio_front_end_wrong_args():
+    for args in [{'window_length': 512, 'nfft': 256},  # window longer than the FFT
+                 {'window_length': 512, 'power': 3},   # unsupported power
+                 {'layout': 'tt'}]:                    # unsupported layout
+        yield check_audio_front_end_wrong_args, args
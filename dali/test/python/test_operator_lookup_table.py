@@ -16,6 +16,7 @@ from nvidia.dali.pipeline import Pipeline
 import nvidia.dali.ops as ops
 import nvidia.dali.types as types
 import nvidia.dali as dali
+import nvidia.dali.fn as fn
 from nvidia.dali.backend_impl import TensorListGPU
 import numpy as np
 from numpy.testing import assert_array_equal, assert_allclose
@@ -130,3 +131,24 @@ def test_lookup_table_vs_python_op():
                  (10, (300, 300, 3), 'random', 0.9),
                  (3,  (300, 300, 3), 'small',  0.4)]:
                 yield check_lookup_table_vs_python_op, device, batch_size, layout, shape, dtype, dictionary_type, default_value
+
+def check_lookup_table_negative_keys(device, in_dtype, key):
+    # the negative inputs must not be mistaken for the largest keys
+    data = np.array([-1, -2, np.iinfo(in_dtype).min, 0, 1], dtype=in_dtype)
+    pipe = Pipeline(batch_size=1, num_threads=1, device_id=0)
+    with pipe:
+        input_data = fn.external_source(source=lambda: [data], batch=True)
+        if device == 'gpu':
+            input_data = input_data.gpu()
+        pipe.set_outputs(fn.lookup_table(input_data, keys=[key, 1], values=[5.0, 2.0],
+                                         default_value=-10.0))
+    pipe.build()
+    out, = pipe.run()
+    if device == 'gpu':
+        out = out.as_cpu()
+    assert_array_equal(out.at(0), np.array([-10, -10, -10, -10, 2], dtype=np.float32))
+
+def test_lookup_table_negative_keys():
+    for device in ['cpu', 'gpu']:
+        for in_dtype, key in [(np.int8, 255), (np.int16, 65535)]:
+            yield check_lookup_table_negative_keys, device, in_dtype, key
@@ -526,3 +526,64 @@ def test_invalid_layouts_arg():
         pipe.set_outputs(out)
     pipe.build()
     pipe.run()
+
+
+def parallel_pid_and_square(x):
+    return numpy.array([os.getpid()], dtype=numpy.int64), x * x
+
+
+def test_parallel():
+    batch_size = 8
+    for num_workers in [0, 1, 3]:
+        pipe = Pipeline(batch_size, 1, 0, 999, exec_async=False, exec_pipelined=False,
+                        py_num_workers=num_workers)
+        with pipe:
+            data = fn.random.uniform(range=(0, 10), shape=(4,))
+            pids, squares = fn.python_function(data, function=parallel_pid_and_square,
+                                               num_outputs=2, parallel=True)
+            pipe.set_outputs(data, squares, pids)
+        pipe.build()
+        for _ in range(3):
+            data, squares, pids = pipe.run()
+            seen_pids = set()
+            for i in range(batch_size):
+                numpy.testing.assert_allclose(numpy.array(squares[i]),
+                                              numpy.array(data[i]) ** 2, rtol=1e-6)
+                seen_pids.add(int(numpy.array(pids[i])[0]))
+            if num_workers == 0:
+                assert seen_pids == {os.getpid()}
+            else:
+                assert len(seen_pids) == num_workers
+                assert os.getpid() not in seen_pids
+
+
+@raises(ValueError)
+def test_parallel_batch_processing():
+    fn.python_function(function=lambda x: x, batch_processing=True, parallel=True)
+
+
+def parallel_sample_source(sample_info):
+    return numpy.full((4,), sample_info.idx_in_epoch, dtype=numpy.float32)
+
+
+def parallel_square(x):
+    return x * x
+
+
+def test_parallel_with_parallel_external_source():
+    # the python_function results are received in the executor thread while the main thread
+    # receives the external_source batches from the same workers
+    batch_size = 8
+    pipe = Pipeline(batch_size, 2, 0, 999, exec_async=True, exec_pipelined=True,
+                    py_num_workers=3)
+    with pipe:
+        data = fn.external_source(source=parallel_sample_source, parallel=True, batch=False)
+        squares = fn.python_function(data, function=parallel_square, parallel=True)
+        pipe.set_outputs(data, squares)
+    pipe.build()
+    for it in range(20):
+        data, squares = pipe.run()
+        for i in range(batch_size):
+            expected = numpy.full((4,), it * batch_size + i, dtype=numpy.float32)
+            numpy.testing.assert_array_equal(numpy.array(data[i]), expected)
+            numpy.testing.assert_array_equal(numpy.array(squares[i]), expected * expected)
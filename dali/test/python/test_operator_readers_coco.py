@@ -16,9 +16,12 @@ from nvidia.dali import Pipeline, pipeline_def
 import nvidia.dali.fn as fn
 from test_utils import compare_pipelines, get_dali_extra_path
 import os
-from nose.tools import raises
+from nose.tools import raises, assert_raises
 import tempfile
+import json
 import numpy as np
+import shutil
+import struct
 
 test_data_root = get_dali_extra_path()
 file_root = os.path.join(test_data_root, 'db', 'coco', 'images')
@@ -142,6 +145,159 @@ def test_operator_coco_reader_same_images():
             np.testing.assert_array_equal(boxes1.at(0), boxes2.at(0))
             np.testing.assert_array_equal(boxes1.at(0), boxes3.at(0))
 
+@pipeline_def(batch_size=2, device_id=0, num_threads=4)
+def coco_masks_pipe(file_root, **coco_args):
+    inputs, boxes, labels, masks, ids = fn.readers.coco(file_root=file_root, pixelwise_masks=True,
+                                                        image_ids=True, **coco_args)
+    return boxes, labels, masks, ids
+
+def check_coco_reader_preprocessed(annotations_file):
+    file_root = os.path.join(test_data_root, 'db', 'coco_pixelwise', 'images')
+    with tempfile.TemporaryDirectory() as annotations_dir:
+        json_pipe = coco_masks_pipe(file_root, annotations_file=annotations_file,
+                                    save_preprocessed_annotations=True,
+                                    save_preprocessed_annotations_dir=annotations_dir)
+        json_pipe.build()
+        json_pipe.run()
+        assert os.path.exists(os.path.join(annotations_dir, 'annotations.bin'))
+
+        # memory-mapped single file
+        mapped_pipe = coco_masks_pipe(file_root, preprocessed_annotations=annotations_dir)
+        compare_pipelines(coco_masks_pipe(file_root, annotations_file=annotations_file),
+                          mapped_pipe, 2, 5)
+
+        # legacy per-array files
+        os.remove(os.path.join(annotations_dir, 'annotations.bin'))
+        legacy_pipe = coco_masks_pipe(file_root, preprocessed_annotations=annotations_dir)
+        compare_pipelines(coco_masks_pipe(file_root, annotations_file=annotations_file),
+                          legacy_pipe, 2, 5)
+
+def test_coco_reader_preprocessed():
+    coco_pixelwise_dir = os.path.join(test_data_root, 'db', 'coco_pixelwise')
+    for annotations_file in ['instances.json', 'instances_rle_counts.json']:
+        yield check_coco_reader_preprocessed, os.path.join(coco_pixelwise_dir, annotations_file)
+
+def test_coco_reader_annotations_cache():
+    file_root = os.path.join(test_data_root, 'db', 'coco_pixelwise', 'images')
+    annotations_file = os.path.join(test_data_root, 'db', 'coco_pixelwise', 'instances.json')
+    with tempfile.TemporaryDirectory() as cache_dir:
+        # the first pipeline parses the JSON file and creates the cache, the second one uses it
+        for _ in range(2):
+            cached_pipe = coco_masks_pipe(file_root, annotations_file=annotations_file,
+                                          annotations_cache_dir=cache_dir)
+            compare_pipelines(coco_masks_pipe(file_root, annotations_file=annotations_file),
+                              cached_pipe, 2, 5)
+            assert len(os.listdir(cache_dir)) == 1
+
+        # different arguments - a different cache file
+        ratio_pipe = coco_masks_pipe(file_root, annotations_file=annotations_file,
+                                     annotations_cache_dir=cache_dir, ratio=True)
+        compare_pipelines(coco_masks_pipe(file_root, annotations_file=annotations_file,
+                                          ratio=True),
+                          ratio_pipe, 2, 5)
+        assert len(os.listdir(cache_dir)) == 2
+
+@pipeline_def(batch_size=2, device_id=0, num_threads=4)
+def coco_polygons_pipe(file_root, annotations_file):
+    _, boxes, labels, polygons, vertices, ids = fn.readers.coco(
+        file_root=file_root, annotations_file=annotations_file, polygon_masks=True,
+        image_ids=True)
+    return boxes, labels, polygons, vertices, ids
+
+def test_coco_reader_large_annotations_file():
+    # A file big enough to have the annotations parsed in several chunks (of at least 1 MB each).
+    # The strings contain escapes and brackets, so that the chunks are split only between
+    # the complete annotations, wherever the boundaries fall.
+    with open(train_annotations) as f:
+        coco = json.load(f)
+    rng = np.random.default_rng(1234)
+    annotations_per_image = 4000
+    expected_boxes = {}
+    coco['annotations'] = []
+    for image in coco['images']:
+        boxes = rng.uniform(1, 100, size=(annotations_per_image, 4)).astype(np.float32)
+        expected_boxes[image['id']] = boxes
+        for box in boxes.tolist():
+            x, y, w, h = box
+            n = len(coco['annotations'])
+            coco['annotations'].append({
+                'id': n,
+                'caption': 'a "quoted" }], {[ \\ \u00e9 ' + 'x' * (n % 37),
+                'image_id': image['id'],
+                'category_id': coco['categories'][n % len(coco['categories'])]['id'],
+                'segmentation': [[x, y, x + w, y, x + w, y + h]],
+                'bbox': box,
+                'area': w * h,
+                'iscrowd': 0})
+    document = json.dumps(coco)
+    assert len(document) > 4 * (1 << 20)
+    with tempfile.TemporaryDirectory() as annotations_dir:
+        parallel_file = os.path.join(annotations_dir, 'parallel.json')
+        with open(parallel_file, 'w') as f:
+            f.write(document)
+        # a top-level key with an escape sequence makes the reader parse the file sequentially
+        sequential_file = os.path.join(annotations_dir, 'sequential.json')
+        with open(sequential_file, 'w') as f:
+            f.write('{"n\\u006fte": 0, ' + document[1:])
+
+        num_images = len(coco['images'])
+        compare_pipelines(coco_polygons_pipe(file_root, parallel_file),
+                          coco_polygons_pipe(file_root, sequential_file), 2, num_images // 2)
+
+        pipe = coco_polygons_pipe(file_root, parallel_file)
+        pipe.build()
+        for _ in range(num_images // 2):
+            boxes, _, polygons, _, ids = pipe.run()
+            for s in range(len(ids)):
+                image_id = int(ids.at(s)[0])
+                np.testing.assert_array_equal(boxes.at(s), expected_boxes[image_id])
+                assert len(polygons.at(s)) == annotations_per_image
+
+def patch_annotations_section(filename, section_id, index, value):
+    # the layout of annotations.bin: magic, version and the number of sections,
+    # followed by a table of (id, element size, offset, count) entries
+    with open(filename, 'r+b') as f:
+        _, _, num_sections = struct.unpack('<8sII', f.read(16))
+        for _ in range(num_sections):
+            id, element_size, offset, count = struct.unpack('<IIqq', f.read(24))
+            if id == section_id:
+                assert 0 <= index < count
+                f.seek(offset + index * element_size)
+                f.write(struct.pack('<q' if element_size == 8 else '<i', value))
+                return
+    assert False, f"No section {section_id} in {filename}"
+
+def check_coco_reader_corrupted(file_root, annotations_dir, section_id, index, value):
+    with tempfile.TemporaryDirectory() as corrupted_dir:
+        shutil.copy(os.path.join(annotations_dir, 'annotations.bin'), corrupted_dir)
+        patch_annotations_section(os.path.join(corrupted_dir, 'annotations.bin'),
+                                  section_id, index, value)
+        pipe = coco_masks_pipe(file_root, preprocessed_annotations=corrupted_dir)
+        with assert_raises(RuntimeError):
+            pipe.build()
+            pipe.run()
+
+def test_coco_reader_corrupted_preprocessed():
+    file_root = os.path.join(test_data_root, 'db', 'coco_pixelwise', 'images')
+    annotations_file = os.path.join(test_data_root, 'db', 'coco_pixelwise',
+                                    'instances_rle_counts.json')
+    # AnnotationSection ids of the offset arrays
+    offsets, filename_offsets, mask_rle_offsets, mask_offsets = 0, 7, 16, 19
+    with tempfile.TemporaryDirectory() as annotations_dir:
+        json_pipe = coco_masks_pipe(file_root, annotations_file=annotations_file,
+                                    save_preprocessed_annotations=True,
+                                    save_preprocessed_annotations_dir=annotations_dir)
+        json_pipe.build()
+        json_pipe.run()
+        for section_id, index, value in [(filename_offsets, 0, 1),
+                                         (filename_offsets, 1, -1),
+                                         (filename_offsets, 1, 1 << 40),
+                                         (mask_rle_offsets, 0, 1 << 40),
+                                         (mask_offsets, 0, 1 << 40),
+                                         (mask_offsets, 0, -1),
+                                         (offsets, 0, 1 << 30)]:
+            check_coco_reader_corrupted(file_root, annotations_dir, section_id, index, value)
+
 @raises(RuntimeError)
 def test_invalid_args():
     pipeline = Pipeline(batch_size=2, num_threads=4, device_id=0)
@@ -1624,3 +1624,43 @@ def test_invoke_serialize_error_handling_string():
 @raises(TypeError)
 def test_invoke_serialize_error_handling_not_string():
     _identity_pipe().serialize(42)
+
+
+def test_restore_reader_state():
+    batch_size = 5
+    @pipeline_def(batch_size=batch_size, num_threads=2, device_id=0, seed=1234)
+    def file_pipe():
+        _, labels = fn.readers.file(file_root=jpeg_folder, random_shuffle=True, initial_fill=8,
+                                    pad_last_batch=True, num_shards=2, shard_id=1, name="Reader")
+        return labels
+
+    pipe = file_pipe()
+    pipe.build()
+    for _ in range(11):
+        pipe.run()
+    state = pipe.reader_state()
+    assert state["Reader"]["consumed_samples"] == 11 * batch_size
+    expected = [pipe.run()[0].as_array() for _ in range(4)]
+
+    restored = file_pipe()
+    restored.build()
+    restored.restore_reader_state(state)
+    for i in range(4):
+        check_batch(restored.run()[0], expected[i], batch_size)
+    assert restored.reader_state("Reader")["consumed_samples"] == 15 * batch_size
+
+
+@raises(RuntimeError)
+def test_restore_reader_state_mismatch():
+    @pipeline_def(batch_size=2, num_threads=1, device_id=0)
+    def file_pipe(shard_id):
+        _, labels = fn.readers.file(file_root=jpeg_folder, num_shards=2, shard_id=shard_id,
+                                    name="Reader")
+        return labels
+
+    pipe = file_pipe(0)
+    pipe.build()
+    pipe.run()
+    restored = file_pipe(1)
+    restored.build()
+    restored.restore_reader_state(pipe.reader_state())
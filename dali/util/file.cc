@@ -12,6 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include <string>
 
 #include "dali/util/file.h"
@@ -20,15 +23,21 @@
 
 namespace dali {
 
-std::unique_ptr<FileStream> FileStream::Open(const std::string& uri, bool read_ahead,
-                                             bool use_mmap) {
-  std::string processed_uri;
+namespace {
 
+std::string ProcessUri(const std::string &uri) {
   if (uri.find("file://") == 0) {
-    processed_uri = uri.substr(std::string("file://").size());
+    return uri.substr(std::string("file://").size());
   } else {
-    processed_uri = uri;
+    return uri;
   }
+}
+
+}  // namespace
+
+std::unique_ptr<FileStream> FileStream::Open(const std::string& uri, bool read_ahead,
+                                             bool use_mmap) {
+  std::string processed_uri = ProcessUri(uri);
 
   if (use_mmap) {
     return std::unique_ptr<FileStream>(new MmapedFileStream(processed_uri, read_ahead));
@@ -37,6 +46,22 @@ std::unique_ptr<FileStream> FileStream::Open(const std::string& uri, bool read_a
   }
 }
 
+void FileStream::Advise(const std::string &uri, int64 offset, int64 length, AccessHint hint) {
+  int fd = open(ProcessUri(uri).c_str(), O_RDONLY);
+  if (fd < 0)
+    return;
+  int advice = hint == AccessHint::WillNeed ? POSIX_FADV_WILLNEED : POSIX_FADV_DONTNEED;
+  posix_fadvise(fd, offset, length, advice);
+  close(fd);
+}
+
+int64 FileStream::FileSize(const std::string &uri) {
+  struct stat sb;
+  if (stat(ProcessUri(uri).c_str(), &sb) == -1)
+    return -1;
+  return sb.st_size;
+}
+
 bool FileStream::ReserveFileMappings(unsigned int num) {
   return MmapedFileStream::ReserveFileMappings(num);
 }
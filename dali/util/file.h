@@ -70,6 +70,24 @@ class DLL_PUBLIC FileStream {
   };
   static std::unique_ptr<FileStream> Open(const std::string &uri, bool read_ahead, bool use_mmap);
 
+  enum class AccessHint {
+    WillNeed,  // the range will be accessed soon, the OS may start reading it in the background
+    DontNeed   // the range won't be accessed again, the OS may drop it from the page cache
+  };
+
+  /**
+   * @brief Hints the OS about the expected access to a range of a file, which doesn't need
+   *        to be opened. `length` equal to 0 means the range reaches the end of the file.
+   *
+   * Hints are best-effort: any errors are ignored.
+   */
+  static void Advise(const std::string &uri, int64 offset, int64 length, AccessHint hint);
+
+  /**
+   * @brief Returns the size of a file, which doesn't need to be opened, or -1 on error
+   */
+  static int64 FileSize(const std::string &uri);
+
   virtual void Close() = 0;
   virtual size_t Read(uint8_t *buffer, size_t n_bytes) = 0;
   virtual shared_ptr<void> Get(size_t n_bytes) = 0;
@@ -0,0 +1,196 @@
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/util/numa.h"
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/sysinfo.h>
+#include <unistd.h>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include "dali/core/error_handling.h"
+
+namespace dali {
+namespace numa {
+
+namespace {
+
+// Memory policies of the Linux kernel (linux/mempolicy.h), set with raw system calls,
+// so that there is no dependency on libnuma
+constexpr int kMPolPreferred = 1;
+
+constexpr int kMaxNodes = 1024;
+constexpr int kBitsPerWord = 8 * sizeof(unsigned long);  // NOLINT(runtime/int)
+
+/**
+ * @brief Sets the preferred node of the range of memory or, if `addr` is null,
+ *        of the calling thread; failures (e.g. in containers without the permissions)
+ *        are not fatal, as the placement is only an optimization
+ */
+void SetPreferredNode(void *addr, size_t len, int node) {
+  unsigned long mask[kMaxNodes / kBitsPerWord] = {};  // NOLINT(runtime/int)
+  mask[node / kBitsPerWord] |= 1ul << (node % kBitsPerWord);
+  if (addr)
+    syscall(SYS_mbind, addr, len, kMPolPreferred, mask, kMaxNodes + 1, 0);
+  else
+    syscall(SYS_set_mempolicy, kMPolPreferred, mask, kMaxNodes + 1);
+}
+
+std::vector<std::vector<int>> ReadNodeCPUs() {
+  std::vector<std::vector<int>> nodes;
+  for (int node = 0; node < kMaxNodes; node++) {
+    std::ifstream f("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+    if (!f)
+      break;
+    std::string list;
+    std::getline(f, list);
+    nodes.push_back(ParseCPUList(list));
+  }
+  if (nodes.empty()) {
+    nodes.emplace_back();
+    for (int cpu = 0; cpu < get_nprocs_conf(); cpu++)
+      nodes.back().push_back(cpu);
+  }
+  return nodes;
+}
+
+}  // namespace
+
+Policy ParsePolicy(const std::string &policy) {
+  Policy ret;
+  if (policy.empty() || policy == "none")
+    return ret;
+  if (policy == "interleave") {
+    ret.kind = Policy::Interleave;
+    return ret;
+  }
+  char *end = nullptr;
+  long node = strtol(policy.c_str(), &end, 10);  // NOLINT(runtime/int)
+  DALI_ENFORCE(*end == '\0' && node >= 0 && node < kMaxNodes,
+               make_string("Invalid NUMA policy: \"", policy, "\". Expected \"none\", "
+                           "\"interleave\" or a NUMA node number."));
+  ret.kind = Policy::Node;
+  ret.node = node;
+  return ret;
+}
+
+const Policy &GetPolicy() {
+  static const Policy policy = []() {
+    const char *env = std::getenv("DALI_NUMA_POLICY");
+    Policy policy = ParsePolicy(env ? env : "");
+    if (policy.kind == Policy::Node && policy.node >= NumNodes()) {
+      DALI_WARN(make_string("DALI_NUMA_POLICY requests the NUMA node ", policy.node,
+                            ", but there are only ", NumNodes(), " nodes. Ignoring..."));
+      policy = {};
+    }
+    return policy;
+  }();
+  return policy;
+}
+
+std::vector<int> ParseCPUList(const std::string &list) {
+  std::vector<int> cpus;
+  std::stringstream ss(list);
+  std::string range;
+  while (std::getline(ss, range, ',')) {
+    if (range.empty())
+      continue;
+    auto dash = range.find('-');
+    int first = std::stoi(range.substr(0, dash));
+    int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+    for (int cpu = first; cpu <= last; cpu++)
+      cpus.push_back(cpu);
+  }
+  return cpus;
+}
+
+const std::vector<std::vector<int>> &NodeCPUs() {
+  static const std::vector<std::vector<int>> nodes = ReadNodeCPUs();
+  return nodes;
+}
+
+int NumNodes() {
+  return NodeCPUs().size();
+}
+
+int CurrentNode() {
+  int cpu = sched_getcpu();
+  const auto &nodes = NodeCPUs();
+  for (size_t node = 0; node < nodes.size(); node++) {
+    for (int node_cpu : nodes[node]) {
+      if (node_cpu == cpu)
+        return node;
+    }
+  }
+  return 0;
+}
+
+int ThreadNode(const Policy &policy, int thread_idx) {
+  switch (policy.kind) {
+    case Policy::Node:
+      return policy.node;
+    case Policy::Interleave: {
+      // skip the nodes which only have memory
+      std::vector<int> nodes;
+      for (int node = 0; node < NumNodes(); node++) {
+        if (!NodeCPUs()[node].empty())
+          nodes.push_back(node);
+      }
+      return nodes.empty() ? -1 : nodes[thread_idx % nodes.size()];
+    }
+    default:
+      return -1;
+  }
+}
+
+int AllocationNode(const Policy &policy) {
+  // With "interleave", the memory is allocated by the threads of the executor, which are
+  // not bound to any node, while the data is written by the bound workers of the thread pools.
+  return policy.kind == Policy::Node ? policy.node : -1;
+}
+
+void BindThreadToNode(int node) {
+  DALI_ENFORCE(node >= 0 && node < NumNodes(), make_string("Invalid NUMA node: ", node));
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  for (int cpu : NodeCPUs()[node])
+    CPU_SET(cpu, &cpus);
+  int error = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+  if (error != 0) {
+    DALI_WARN(make_string("Binding the thread to the NUMA node ", node, " failed! Error code: ",
+                          error));
+    return;
+  }
+  SetPreferredNode(nullptr, 0, node);
+}
+
+void *AllocateOnNode(size_t bytes, int node) {
+  void *ptr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (ptr == MAP_FAILED)
+    throw std::bad_alloc();
+  // The pages are not populated yet - they will be placed on the node when first touched
+  SetPreferredNode(ptr, bytes, node);
+  return ptr;
+}
+
+void FreeOnNode(void *ptr, size_t bytes) {
+  munmap(ptr, bytes);
+}
+
+}  // namespace numa
+}  // namespace dali
@@ -0,0 +1,102 @@
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_UTIL_NUMA_H_
+#define DALI_UTIL_NUMA_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "dali/core/api_helper.h"
+
+namespace dali {
+namespace numa {
+
+/**
+ * @brief How the worker threads of the thread pools are placed on the NUMA nodes
+ */
+struct Policy {
+  enum Kind {
+    None,        // the threads are not bound to NUMA nodes
+    Node,        // all the threads run on `node`
+    Interleave,  // the consecutive threads of a pool run on the consecutive nodes with CPUs
+  };
+  Kind kind = None;
+  int node = -1;
+};
+
+/**
+ * @brief Parses a NUMA policy: "none" (or an empty string), "interleave" or a node number
+ */
+DLL_PUBLIC Policy ParsePolicy(const std::string &policy);
+
+/**
+ * @brief The policy of the process, taken from the DALI_NUMA_POLICY environment variable
+ */
+DLL_PUBLIC const Policy &GetPolicy();
+
+/**
+ * @brief Parses a list of CPUs in the format used by sysfs, e.g. "0-3,8,10-11"
+ */
+DLL_PUBLIC std::vector<int> ParseCPUList(const std::string &list);
+
+/**
+ * @brief The CPUs of every NUMA node of the system
+ *
+ * If the topology cannot be read, all the CPUs are reported as a single node.
+ */
+DLL_PUBLIC const std::vector<std::vector<int>> &NodeCPUs();
+
+DLL_PUBLIC int NumNodes();
+
+/**
+ * @brief The NUMA node of the CPU the calling thread is running on
+ */
+DLL_PUBLIC int CurrentNode();
+
+/**
+ * @brief The node on which the thread with the given index in a thread pool should run,
+ *        or -1 if the policy doesn't bind the threads to nodes
+ */
+DLL_PUBLIC int ThreadNode(const Policy &policy, int thread_idx);
+
+/**
+ * @brief The node on which the large allocations are placed, regardless of the allocating
+ *        thread, or -1 if the placement is left to the memory policy of the thread which
+ *        touches the memory first
+ */
+DLL_PUBLIC int AllocationNode(const Policy &policy);
+
+/**
+ * @brief Restricts the calling thread to the CPUs of the node and makes the node
+ *        the preferred one for the memory the thread touches first
+ */
+DLL_PUBLIC void BindThreadToNode(int node);
+
+/**
+ * @brief Allocates memory whose pages are preferably placed on the node
+ *
+ * The memory is mapped directly, so it should be used for larger allocations only.
+ */
+DLL_PUBLIC void *AllocateOnNode(size_t bytes, int node);
+
+/**
+ * @brief Frees the memory allocated with AllocateOnNode
+ */
+DLL_PUBLIC void FreeOnNode(void *ptr, size_t bytes);
+
+}  // namespace numa
+}  // namespace dali
+
+#endif  // DALI_UTIL_NUMA_H_
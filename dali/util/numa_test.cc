@@ -0,0 +1,191 @@
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/util/numa.h"
+#include <gtest/gtest.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace dali {
+namespace numa {
+
+namespace {
+
+// get_mempolicy flags (linux/mempolicy.h)
+constexpr int kMPolFNode = 1;
+constexpr int kMPolFAddr = 2;
+
+/**
+ * @brief The node of the page containing `addr` (which must be touched), or -1 if it cannot
+ *        be queried
+ */
+int PageNode(const void *addr) {
+  int node = -1;
+  if (syscall(SYS_get_mempolicy, &node, nullptr, 0, addr, kMPolFNode | kMPolFAddr) != 0)
+    return -1;
+  return node;
+}
+
+/**
+ * @brief Whether the process may place memory on the node (e.g. a container may be restricted
+ *        to some of the nodes)
+ */
+bool MemoryAllowed(int node) {
+  std::ifstream f("/proc/self/status");
+  std::string line;
+  const std::string key = "Mems_allowed_list:";
+  while (std::getline(f, line)) {
+    if (line.compare(0, key.size(), key) == 0) {
+      auto nodes = ParseCPUList(line.substr(line.find_first_not_of(" \t", key.size())));
+      return std::find(nodes.begin(), nodes.end(), node) != nodes.end();
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+TEST(Numa, ParseCPUList) {
+  EXPECT_EQ(ParseCPUList("0-3,8,10-11\n"), (std::vector<int>{ 0, 1, 2, 3, 8, 10, 11 }));
+  EXPECT_EQ(ParseCPUList("5"), std::vector<int>{ 5 });
+  EXPECT_EQ(ParseCPUList(""), std::vector<int>{});
+}
+
+TEST(Numa, ParsePolicy) {
+  EXPECT_EQ(ParsePolicy("").kind, Policy::None);
+  EXPECT_EQ(ParsePolicy("none").kind, Policy::None);
+  EXPECT_EQ(ParsePolicy("interleave").kind, Policy::Interleave);
+  auto policy = ParsePolicy("1");
+  EXPECT_EQ(policy.kind, Policy::Node);
+  EXPECT_EQ(policy.node, 1);
+  EXPECT_THROW(ParsePolicy("local"), std::runtime_error);
+  EXPECT_THROW(ParsePolicy("-1"), std::runtime_error);
+}
+
+TEST(Numa, ThreadNode) {
+  ASSERT_GE(NumNodes(), 1);
+  EXPECT_EQ(ThreadNode(ParsePolicy("none"), 3), -1);
+  EXPECT_EQ(ThreadNode(ParsePolicy("0"), 3), 0);
+  std::vector<int> nodes_with_cpus;
+  for (int node = 0; node < NumNodes(); node++) {
+    if (!NodeCPUs()[node].empty())
+      nodes_with_cpus.push_back(node);
+  }
+  ASSERT_FALSE(nodes_with_cpus.empty());
+  for (int i = 0; i < 8; i++) {
+    EXPECT_EQ(ThreadNode(ParsePolicy("interleave"), i),
+              nodes_with_cpus[i % nodes_with_cpus.size()]);
+  }
+}
+
+TEST(Numa, AllocationNode) {
+  EXPECT_EQ(AllocationNode(ParsePolicy("none")), -1);
+  // the buffers are allocated by threads not bound to nodes - the pages are placed
+  // when the bound workers touch them
+  EXPECT_EQ(AllocationNode(ParsePolicy("interleave")), -1);
+  EXPECT_EQ(AllocationNode(ParsePolicy("1")), 1);
+}
+
+TEST(Numa, BindThreadToNode) {
+  for (int node = 0; node < NumNodes(); node++) {
+    const auto &cpus = NodeCPUs()[node];
+    if (cpus.empty())
+      continue;  // memory-only node
+    std::thread([&]() {
+      BindThreadToNode(node);
+      int cpu = sched_getcpu();
+      cpu_set_t allowed;
+      ASSERT_EQ(sched_getaffinity(0, sizeof(allowed), &allowed), 0);
+      // the binding fails (with a warning) if the process is restricted to other CPUs
+      bool bound = true;
+      for (int i = 0; i < CPU_SETSIZE; i++) {
+        if (CPU_ISSET(i, &allowed) && std::find(cpus.begin(), cpus.end(), i) == cpus.end())
+          bound = false;
+      }
+      if (bound) {
+        EXPECT_NE(std::find(cpus.begin(), cpus.end(), cpu), cpus.end());
+        EXPECT_EQ(CurrentNode(), node);
+      }
+    }).join();
+  }
+}
+
+TEST(Numa, AllocateOnNode) {
+  size_t size = 3 << 20;
+  auto *data = static_cast<uint8_t *>(AllocateOnNode(size, NumNodes() - 1));
+  ASSERT_NE(data, nullptr);
+  memset(data, 42, size);
+  for (size_t i = 0; i < size; i += 4096)
+    ASSERT_EQ(data[i], 42);
+  FreeOnNode(data, size);
+}
+
+TEST(Numa, AllocateOnNodePlacement) {
+  // the pages are placed on the requested node, whichever thread touches them first
+  size_t size = 4 << 20;
+  for (int node = 0; node < NumNodes(); node++) {
+    if (!MemoryAllowed(node))
+      continue;
+    auto *data = static_cast<uint8_t *>(AllocateOnNode(size, node));
+    memset(data, 42, size);
+    int page_node = PageNode(data + size / 2);
+    FreeOnNode(data, size);
+    if (page_node < 0)
+      GTEST_SKIP() << "Cannot query the NUMA node of a page";
+    EXPECT_EQ(page_node, node);
+  }
+}
+
+TEST(Numa, FirstTouchPlacement) {
+  // A buffer allocated by an unbound thread is placed on the node of the bound thread
+  // which writes it first. The size exceeds the largest malloc mmap threshold, so that
+  // the pages are fresh.
+  size_t size = 64 << 20;
+  for (int node = 0; node < NumNodes(); node++) {
+    const auto &cpus = NodeCPUs()[node];
+    if (cpus.empty() || !MemoryAllowed(node))
+      continue;
+    auto *data = static_cast<uint8_t *>(::operator new(size));
+    int page_node = -1;
+    bool bound = true;
+    std::thread([&]() {
+      BindThreadToNode(node);
+      cpu_set_t allowed;
+      ASSERT_EQ(sched_getaffinity(0, sizeof(allowed), &allowed), 0);
+      for (int i = 0; i < CPU_SETSIZE; i++) {
+        if (CPU_ISSET(i, &allowed) && std::find(cpus.begin(), cpus.end(), i) == cpus.end())
+          bound = false;
+      }
+      memset(data, 42, size);
+      page_node = PageNode(data + size / 2);
+    }).join();
+    ::operator delete(data);
+    if (page_node < 0)
+      GTEST_SKIP() << "Cannot query the NUMA node of a page";
+    if (bound)
+      EXPECT_EQ(page_node, node);
+  }
+}
+
+}  // namespace numa
+}  // namespace dali
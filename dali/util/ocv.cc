@@ -19,7 +19,9 @@
 #include <algorithm>
 #include <tuple>
 #include "dali/core/error_handling.h"
+#include "dali/core/geom/mat.h"
 #include "dali/kernels/imgproc/color_manipulation/color_space_conversion_impl.h"
+#include "dali/kernels/imgproc/pointwise/linear_transformation_cpu.h"
 
 namespace dali {
 
@@ -71,49 +73,67 @@ template <DALIImageType input_type, DALIImageType output_type>
 void custom_conversion_pixel(const uint8_t* input, uint8_t* output);
 
 template <>
-inline void custom_conversion_pixel<DALI_RGB, DALI_YCbCr>(const uint8_t* input, uint8_t* output) {
-  vec<3, uint8_t> rgb = {input[0], input[1], input[2]};
-  output[0] = kernels::color::itu_r_bt_601::rgb_to_y<uint8_t>(rgb);
-  output[1] = kernels::color::itu_r_bt_601::rgb_to_cb<uint8_t>(rgb);
-  output[2] = kernels::color::itu_r_bt_601::rgb_to_cr<uint8_t>(rgb);
+inline void custom_conversion_pixel<DALI_GRAY, DALI_YCbCr>(const uint8_t* input, uint8_t* output) {
+  output[0] = kernels::color::itu_r_bt_601::gray_to_y<uint8_t>(input[0]);
+  output[1] = 128;
+  output[2] = 128;
 }
 
 template <>
-inline void custom_conversion_pixel<DALI_BGR, DALI_YCbCr>(const uint8_t* input, uint8_t* output) {
-  vec<3, uint8_t> rgb = {input[2], input[1], input[0]};
-  output[0] = kernels::color::itu_r_bt_601::rgb_to_y<uint8_t>(rgb);
-  output[1] = kernels::color::itu_r_bt_601::rgb_to_cb<uint8_t>(rgb);
-  output[2] = kernels::color::itu_r_bt_601::rgb_to_cr<uint8_t>(rgb);
+inline void custom_conversion_pixel<DALI_YCbCr, DALI_GRAY>(const uint8_t* input, uint8_t* output) {
+  output[0] = kernels::color::itu_r_bt_601::y_to_gray<uint8_t>(input[0]);
 }
 
-template <>
-inline void custom_conversion_pixel<DALI_YCbCr, DALI_RGB>(const uint8_t* input, uint8_t* output) {
-  vec<3, uint8_t> ycbcr{input[0], input[1], input[2]};
-  auto rgb = kernels::color::itu_r_bt_601::ycbcr_to_rgb<uint8_t>(ycbcr);
-  output[0] = rgb[0];
-  output[1] = rgb[1];
-  output[2] = rgb[2];
+/**
+ * @brief ITU-R BT.601 conversions between RGB and YCbCr, for 8-bit values, as affine transforms
+ *
+ * The coefficients are the same as in kernels::color::itu_r_bt_601.
+ */
+static mat3 RgbToYCbCrMat() {
+  return {{
+    { 0.257f,  0.504f,  0.098f},
+    {-0.148f, -0.291f,  0.439f},
+    { 0.439f, -0.368f, -0.071f}
+  }};
 }
 
-template <>
-inline void custom_conversion_pixel<DALI_YCbCr, DALI_BGR>(const uint8_t* input, uint8_t* output) {
-  vec<3, uint8_t> ycbcr{input[0], input[1], input[2]};
-  auto rgb = kernels::color::itu_r_bt_601::ycbcr_to_rgb<uint8_t>(ycbcr);
-  output[0] = rgb[2];
-  output[1] = rgb[1];
-  output[2] = rgb[0];
+static mat3 YCbCrToRgbMat() {
+  return {{
+    {1.164f,  0.000f,  1.596f},
+    {1.164f, -0.392f, -0.813f},
+    {1.164f,  2.017f,  0.000f}
+  }};
 }
 
-template <>
-inline void custom_conversion_pixel<DALI_GRAY, DALI_YCbCr>(const uint8_t* input, uint8_t* output) {
-  output[0] = kernels::color::itu_r_bt_601::gray_to_y<uint8_t>(input[0]);
-  output[1] = 128;
-  output[2] = 128;
+/**
+ * @brief Reverses the order of channels in the input (columns) or output (rows) of `m`
+ */
+static mat3 SwapRB(const mat3 &m, bool input) {
+  mat3 ret;
+  for (int i = 0; i < 3; i++)
+    for (int j = 0; j < 3; j++)
+      ret(i, j) = input ? m(i, 2 - j) : m(2 - i, j);
+  return ret;
 }
 
-template <>
-inline void custom_conversion_pixel<DALI_YCbCr, DALI_GRAY>(const uint8_t* input, uint8_t* output) {
-  output[0] = kernels::color::itu_r_bt_601::y_to_gray<uint8_t>(input[0]);
+static void affine_conversion(const cv::Mat& img, cv::Mat& output_img,
+                              const mat3 &m, vec3 offset) {
+  kernels::TransformPixels3(output_img.data, img.data, img.rows * img.cols, m, offset);
+}
+
+static void ycbcr_conversion(DALIImageType input_type, const cv::Mat& img,
+                             DALIImageType output_type, cv::Mat& output_img) {
+  const vec3 ycbcr_offset = {16, 128, 128};
+  if (output_type == DALI_YCbCr) {
+    mat3 m = RgbToYCbCrMat();
+    affine_conversion(img, output_img, input_type == DALI_BGR ? SwapRB(m, true) : m,
+                      ycbcr_offset);
+  } else {
+    mat3 m = YCbCrToRgbMat();
+    if (output_type == DALI_BGR)
+      m = SwapRB(m, false);
+    affine_conversion(img, output_img, m, -(m * ycbcr_offset));
+  }
 }
 
 template <DALIImageType input_type, DALIImageType output_type>
@@ -150,17 +170,9 @@ void OpenCvColorConversion(DALIImageType input_type, const cv::Mat& input_img,
   const ColorConversionPair kGrayToYCbCr { DALI_GRAY,  DALI_YCbCr };
   const ColorConversionPair kYCbCrToGray { DALI_YCbCr, DALI_GRAY };
 
-  if ( conversion == kRGBToYCbCr ) {
-    custom_conversion<DALI_RGB, DALI_YCbCr>(input_img, output_img);
-    return;
-  } else if ( conversion == kBGRToYCbCr ) {
-    custom_conversion<DALI_BGR, DALI_YCbCr>(input_img, output_img);
-    return;
-  } else if ( conversion == kYCbCrToRGB ) {
-    custom_conversion<DALI_YCbCr, DALI_RGB>(input_img, output_img);
-    return;
-  } else if ( conversion == kYCbCrToBGR ) {
-    custom_conversion<DALI_YCbCr, DALI_BGR>(input_img, output_img);
+  if ( conversion == kRGBToYCbCr || conversion == kBGRToYCbCr ||
+       conversion == kYCbCrToRGB || conversion == kYCbCrToBGR ) {
+    ycbcr_conversion(input_type, input_img, output_type, output_img);
     return;
   } else if ( conversion == kGrayToYCbCr ) {
     custom_conversion<DALI_GRAY, DALI_YCbCr>(input_img, output_img);
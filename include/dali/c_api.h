@@ -72,6 +72,18 @@ typedef struct {
 } daliReaderMetadata;
 
 
+/*
+ * Need to keep that in sync with ReaderState from operator.h
+ */
+typedef struct {
+  int64_t consumed_samples;    // number of samples consumed from the reader, incl. padding
+  int64_t epoch_size;          // raw epoch size
+  int64_t seed;                // seed of the reader
+  int number_of_shards;        // number of shards
+  int shard_id;                // shard id of given reader
+} daliReaderState;
+
+
 /*
  * Need to keep that in sync with ExecutorMeta from executor.h
  */
@@ -407,6 +419,25 @@ DLL_PUBLIC void daliLoadLibrary(const char *lib_path);
  */
 DLL_PUBLIC void daliGetReaderMetadata(daliPipelineHandle* pipe_handle, const char *reader_name,
                                       daliReaderMetadata* meta);
+
+/**
+ * @brief Returns the snapshot of the named reader position, which can be used
+ *        to resume the reading with `daliRestoreReaderState`
+ *  @param reader_name Name of the reader to query
+ *  @param state Pointer to the state to be filled by the function
+ */
+DLL_PUBLIC void daliGetReaderState(daliPipelineHandle* pipe_handle, const char *reader_name,
+                                   daliReaderState* state);
+
+/**
+ * @brief Restores the named reader position from the snapshot obtained with
+ *        `daliGetReaderState`. The reader skips the already consumed samples without
+ *        reading them. Must be called before the first run of the pipeline.
+ *  @param reader_name Name of the reader to restore
+ *  @param state Pointer to the state to be restored
+ */
+DLL_PUBLIC void daliRestoreReaderState(daliPipelineHandle* pipe_handle, const char *reader_name,
+                                       const daliReaderState* state);
 /**
  * @brief Obtains the executor statistics
  *  @param operator_meta Pointer to the memory allocated by the function with operator_meta_num
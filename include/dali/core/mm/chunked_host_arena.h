@@ -0,0 +1,69 @@
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_CORE_MM_CHUNKED_HOST_ARENA_H_
+#define DALI_CORE_MM_CHUNKED_HOST_ARENA_H_
+
+#include <cstdint>
+#include <memory>
+#include "dali/core/api_helper.h"
+
+namespace dali {
+namespace mm {
+
+/**
+ * @brief Hands out host memory taken from large, reference counted chunks
+ *
+ * Meant for many small buffers which live as long as the owner of the arena (e.g. cached
+ * samples), so that they don't fragment the heap. The buffers are never freed individually -
+ * each of them shares the ownership of its chunk, which is released together with the last
+ * buffer taken from it, even if the arena itself is gone by then.
+ *
+ * The buffers are aligned to kAlignment bytes, so that they can be reinterpreted as any type.
+ * Requests larger than a quarter of the chunk get a block of their own, so at most a quarter
+ * of a chunk is wasted when it's abandoned for a new one.
+ *
+ * The arena is not thread-safe.
+ */
+class DLL_PUBLIC chunked_host_arena {
+ public:
+  static constexpr int64_t kDefaultChunkSize = 64 << 20;
+  static constexpr int64_t kAlignment = 64;
+
+  explicit chunked_host_arena(int64_t chunk_size = kDefaultChunkSize);
+
+  /**
+   * @brief Returns a buffer of `size` bytes, which keeps its memory alive
+   */
+  std::shared_ptr<uint8_t> allocate(int64_t size);
+
+  /**
+   * @brief Allocates a standalone buffer, aligned like the ones obtained from an arena
+   */
+  static std::shared_ptr<uint8_t> allocate_block(int64_t size);
+
+  int64_t chunk_size() const noexcept {
+    return chunk_size_;
+  }
+
+ private:
+  int64_t chunk_size_;
+  std::shared_ptr<uint8_t> chunk_;
+  int64_t chunk_used_ = 0;
+};
+
+}  // namespace mm
+}  // namespace dali
+
+#endif  // DALI_CORE_MM_CHUNKED_HOST_ARENA_H_
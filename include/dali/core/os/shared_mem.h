@@ -15,7 +15,9 @@
 #ifndef DALI_CORE_OS_SHARED_MEM_H_
 #define DALI_CORE_OS_SHARED_MEM_H_
 
+#include <errno.h>
 #include <stdint.h>
+#include <string.h>
 #include <memory>
 #include <string>
 #include "dali/core/common.h"
@@ -28,7 +30,7 @@ namespace dali {
 using shm_handle_t = int;
 using fd_handle_t = int;
 
-void handle_strerror(int errnum, char *buf, size_t buflen) {
+inline void handle_strerror(int errnum, char *buf, size_t buflen) {
   #if (_POSIX_C_SOURCE >= 200112L) && !_GNU_SOURCE
     DALI_ENFORCE(strerror_r(errnum, buf, buflen) == 0, "Call to strerror_r failed.");
   #else
@@ -90,6 +92,20 @@ class DLL_PUBLIC ShmHandle : public UniqueHandle<shm_handle_t, ShmHandle> {
    */
   static ShmHandle CreateHandle();
 
+  /**
+   * Open a named shared memory chunk, so that it can be accessed by other processes on the node
+   * through the same ``name``. If ``create`` is true and the chunk does not exist yet, it is
+   * created (with size 0). If provided, ``created`` is set to indicate whether this call
+   * created the chunk.
+   */
+  static ShmHandle OpenNamed(const std::string &name, bool create, bool *created = nullptr);
+
+  /**
+   * Remove the name of a shared memory chunk. The memory is released when the last process
+   * unmaps it.
+   */
+  static void UnlinkNamed(const std::string &name);
+
   static void DestroyHandle(shm_handle_t h);
 
   static constexpr shm_handle_t null_handle() {
@@ -0,0 +1,452 @@
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_CORE_PHILOX_H_
+#define DALI_CORE_PHILOX_H_
+
+#if defined(__SSE2__) && !defined(__CUDA_ARCH__)
+#include <emmintrin.h>
+#define DALI_PHILOX_SSE2 1
+#endif
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace dali {
+
+/**
+ * @brief Counter-based Philox4x32-10 random number generator
+ *
+ * The output is a pure function of the key and the position in the stream, so any part of
+ * the stream can be generated without generating what precedes it. The 128-bit counter is
+ * split into a 64-bit subsequence and a 64-bit block index, mirroring `curand_init`.
+ *
+ * The class satisfies the UniformRandomBitGenerator requirements and can be used with
+ * the standard library distributions.
+ */
+class Philox4x32_10 {
+ public:
+  using result_type = uint32_t;
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+  Philox4x32_10() = default;
+
+  /**
+   * @param key         the seed
+   * @param subsequence selects an independent stream for given key
+   * @param offset      number of 32-bit values skipped at the beginning of the subsequence
+   */
+  explicit Philox4x32_10(uint64_t key, uint64_t subsequence = 0, uint64_t offset = 0) {
+    init(key, subsequence, offset);
+  }
+
+  void init(uint64_t key, uint64_t subsequence = 0, uint64_t offset = 0) {
+    key_[0] = static_cast<uint32_t>(key);
+    key_[1] = static_cast<uint32_t>(key >> 32);
+    ctr_[2] = static_cast<uint32_t>(subsequence);
+    ctr_[3] = static_cast<uint32_t>(subsequence >> 32);
+    set_block(0);
+    idx_ = 4;
+    skipahead(offset);
+  }
+
+  /**
+   * @brief Skips `n` 32-bit values
+   */
+  void skipahead(uint64_t n) {
+    uint64_t pos = position() + n;
+    set_block(pos >> 2);
+    idx_ = pos & 3;
+    if (idx_) {
+      Block(out_, ctr_, key_);
+      inc_block();
+    }
+    if (!idx_)
+      idx_ = 4;
+  }
+
+  /**
+   * @brief The index of the next value in the current subsequence
+   */
+  uint64_t position() const {
+    return (block() << 2) - (4 - idx_);
+  }
+
+  result_type operator()() {
+    if (idx_ == 4) {
+      Block(out_, ctr_, key_);
+      inc_block();
+      idx_ = 0;
+    }
+    return out_[idx_++];
+  }
+
+  /**
+   * @brief Fills `out` with the next `n` values - equivalent to calling operator() `n` times
+   */
+  void fill(uint32_t *out, int64_t n) {
+    for (; idx_ < 4 && n > 0; n--)
+      *out++ = out_[idx_++];
+#ifdef DALI_PHILOX_SSE2
+    for (; n >= 16; n -= 16, out += 16)
+      Block4(out);
+#endif
+    for (; n >= 4; n -= 4, out += 4) {
+      Block(out, ctr_, key_);
+      inc_block();
+    }
+    if (n > 0) {
+      Block(out_, ctr_, key_);
+      inc_block();
+      for (idx_ = 0; idx_ < n; idx_++)
+        out[idx_] = out_[idx_];
+    }
+  }
+
+ private:
+  static constexpr uint32_t kM0 = 0xD2511F53u, kM1 = 0xCD9E8D57u;
+  static constexpr uint32_t kW0 = 0x9E3779B9u, kW1 = 0xBB67AE85u;
+  static constexpr int kRounds = 10;
+
+  uint64_t block() const {
+    return ctr_[0] | (static_cast<uint64_t>(ctr_[1]) << 32);
+  }
+
+  void set_block(uint64_t b) {
+    ctr_[0] = static_cast<uint32_t>(b);
+    ctr_[1] = static_cast<uint32_t>(b >> 32);
+  }
+
+  void inc_block() {
+    set_block(block() + 1);
+  }
+
+  static inline void mulhilo(uint32_t a, uint32_t b, uint32_t &hi, uint32_t &lo) {
+    uint64_t p = static_cast<uint64_t>(a) * b;
+    hi = static_cast<uint32_t>(p >> 32);
+    lo = static_cast<uint32_t>(p);
+  }
+
+  static inline void Block(uint32_t *out, const uint32_t *ctr, const uint32_t *key) {
+    uint32_t c0 = ctr[0], c1 = ctr[1], c2 = ctr[2], c3 = ctr[3];
+    uint32_t k0 = key[0], k1 = key[1];
+    for (int r = 0; r < kRounds; r++) {
+      uint32_t hi0, lo0, hi1, lo1;
+      mulhilo(kM0, c0, hi0, lo0);
+      mulhilo(kM1, c2, hi1, lo1);
+      c0 = hi1 ^ c1 ^ k0;
+      c1 = lo1;
+      c2 = hi0 ^ c3 ^ k1;
+      c3 = lo0;
+      k0 += kW0;
+      k1 += kW1;
+    }
+    out[0] = c0;
+    out[1] = c1;
+    out[2] = c2;
+    out[3] = c3;
+  }
+
+#ifdef DALI_PHILOX_SSE2
+  static inline void mulhilo(__m128i a, __m128i m, __m128i &hi, __m128i &lo) {
+    __m128i p02 = _mm_mul_epu32(a, m);
+    __m128i p13 = _mm_mul_epu32(_mm_srli_epi64(a, 32), m);
+    // [lo0, lo2, hi0, hi2], [lo1, lo3, hi1, hi3]
+    p02 = _mm_shuffle_epi32(p02, _MM_SHUFFLE(3, 1, 2, 0));
+    p13 = _mm_shuffle_epi32(p13, _MM_SHUFFLE(3, 1, 2, 0));
+    lo = _mm_unpacklo_epi32(p02, p13);
+    hi = _mm_unpackhi_epi32(p02, p13);
+  }
+
+  /**
+   * @brief Generates 4 consecutive blocks at once, one block per SIMD lane
+   */
+  inline void Block4(uint32_t *out) {
+    uint64_t b = block();
+    uint32_t lo[4], hi[4];
+    for (int i = 0; i < 4; i++) {
+      lo[i] = static_cast<uint32_t>(b + i);
+      hi[i] = static_cast<uint32_t>((b + i) >> 32);
+    }
+    set_block(b + 4);
+    __m128i c0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(lo));
+    __m128i c1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(hi));
+    __m128i c2 = _mm_set1_epi32(ctr_[2]);
+    __m128i c3 = _mm_set1_epi32(ctr_[3]);
+    __m128i k0 = _mm_set1_epi32(key_[0]), k1 = _mm_set1_epi32(key_[1]);
+    const __m128i m0 = _mm_set1_epi32(kM0), m1 = _mm_set1_epi32(kM1);
+    const __m128i w0 = _mm_set1_epi32(kW0), w1 = _mm_set1_epi32(kW1);
+    for (int r = 0; r < kRounds; r++) {
+      __m128i hi0, lo0, hi1, lo1;
+      mulhilo(c0, m0, hi0, lo0);
+      mulhilo(c2, m1, hi1, lo1);
+      c0 = _mm_xor_si128(_mm_xor_si128(hi1, c1), k0);
+      c1 = lo1;
+      c2 = _mm_xor_si128(_mm_xor_si128(hi0, c3), k1);
+      c3 = lo0;
+      k0 = _mm_add_epi32(k0, w0);
+      k1 = _mm_add_epi32(k1, w1);
+    }
+    // transpose, so that each block's outputs are contiguous
+    __m128i t0 = _mm_unpacklo_epi32(c0, c1);
+    __m128i t1 = _mm_unpacklo_epi32(c2, c3);
+    __m128i t2 = _mm_unpackhi_epi32(c0, c1);
+    __m128i t3 = _mm_unpackhi_epi32(c2, c3);
+    __m128i *o = reinterpret_cast<__m128i *>(out);
+    _mm_storeu_si128(o + 0, _mm_unpacklo_epi64(t0, t1));
+    _mm_storeu_si128(o + 1, _mm_unpackhi_epi64(t0, t1));
+    _mm_storeu_si128(o + 2, _mm_unpacklo_epi64(t2, t3));
+    _mm_storeu_si128(o + 3, _mm_unpackhi_epi64(t2, t3));
+  }
+#endif
+
+  uint32_t key_[2] = { 0, 0 };
+  uint32_t ctr_[4] = { 0, 0, 0, 0 };
+  uint32_t out_[4] = { 0, 0, 0, 0 };
+  int idx_ = 4;
+};
+
+namespace philox_detail {
+
+constexpr int kBatch = 256;
+
+inline float int_as_float(uint32_t x) {
+  float f;
+  std::memcpy(&f, &x, sizeof(f));
+  return f;
+}
+
+inline uint32_t float_as_int(float f) {
+  uint32_t x;
+  std::memcpy(&x, &f, sizeof(x));
+  return x;
+}
+
+/**
+ * @brief Uniform value in [0, 1) from the upper 24 bits
+ */
+inline float uniform01(uint32_t x) {
+  return (x >> 8) * (1.0f / (1 << 24));
+}
+
+// The polynomials below are evaluated in exactly the same order in the scalar and in the
+// SIMD variants, so that the results don't depend on the instruction set.
+
+/**
+ * @brief Natural logarithm of a positive, normal number (Cephes logf)
+ */
+inline float log_poly(float u) {
+  uint32_t bits = float_as_int(u);
+  float e = static_cast<int>(bits >> 23) - 126;
+  float m = int_as_float((bits & 0x807FFFFFu) | 0x3F000000u);  // [0.5, 1)
+  float x;
+  if (m < 0.707106781186547524f) {
+    e -= 1;
+    x = (m - 1.0f) + m;
+  } else {
+    x = m - 1.0f;
+  }
+  float z = x * x;
+  float y = 7.0376836292e-2f;
+  y = y * x - 1.1514610310e-1f;
+  y = y * x + 1.1676998740e-1f;
+  y = y * x - 1.2420140846e-1f;
+  y = y * x + 1.4249322787e-1f;
+  y = y * x - 1.6668057665e-1f;
+  y = y * x + 2.0000714765e-1f;
+  y = y * x - 2.4999993993e-1f;
+  y = y * x + 3.3333331174e-1f;
+  y = y * x * z;
+  y = y + e * -2.12194440e-4f;
+  y = y - 0.5f * z;
+  return (x + y) + e * 0.693359375f;
+}
+
+/**
+ * @brief Sine and cosine for |x| <= pi/4 (Cephes sinf/cosf)
+ */
+inline void sincos_poly(float x, float &s, float &c) {
+  float z = x * x;
+  float ps = -1.9515295891e-4f;
+  ps = ps * z + 8.3321608736e-3f;
+  ps = ps * z - 1.6666654611e-1f;
+  s = (ps * z) * x + x;
+  float pc = 2.443315711809948e-5f;
+  pc = pc * z - 1.388731625493765e-3f;
+  pc = pc * z + 4.166664568298827e-2f;
+  c = (pc * z) * z - 0.5f * z + 1.0f;
+}
+
+/**
+ * @brief Box-Muller transform of two random words into two standard normal values
+ *
+ * The angle is built from a quadrant (2 highest bits of `b`) and an offset within
+ * the quadrant, which avoids range reduction.
+ */
+inline void box_muller(uint32_t a, uint32_t b, float &z0, float &z1) {
+  float u = ((a >> 8) + 1) * (1.0f / (1 << 24));  // (0, 1]
+  float r = std::sqrt(-2.0f * log_poly(u));
+  float t = (((b >> 8) & 0x3FFFFFu) * (1.0f / (1 << 22)) - 0.5f) * 1.57079632679489662f;
+  float s, c;
+  sincos_poly(t, s, c);
+  if (b & 0x40000000u)
+    std::swap(s, c);
+  uint32_t sign_c = (b ^ (b << 1)) & 0x80000000u;
+  uint32_t sign_s = b & 0x80000000u;
+  z0 = r * int_as_float(float_as_int(c) ^ sign_c);
+  z1 = r * int_as_float(float_as_int(s) ^ sign_s);
+}
+
+#ifdef DALI_PHILOX_SSE2
+
+inline __m128 log_poly(__m128 u) {
+  __m128i bits = _mm_castps_si128(u);
+  __m128 e = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(126)));
+  __m128 m = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x807FFFFF)),
+                                           _mm_set1_epi32(0x3F000000)));
+  __m128 mask = _mm_cmplt_ps(m, _mm_set1_ps(0.707106781186547524f));
+  const __m128 one = _mm_set1_ps(1.0f);
+  e = _mm_sub_ps(e, _mm_and_ps(mask, one));
+  __m128 x = _mm_add_ps(_mm_sub_ps(m, one), _mm_and_ps(mask, m));
+  __m128 z = _mm_mul_ps(x, x);
+  __m128 y = _mm_set1_ps(7.0376836292e-2f);
+  y = _mm_sub_ps(_mm_mul_ps(y, x), _mm_set1_ps(1.1514610310e-1f));
+  y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(1.1676998740e-1f));
+  y = _mm_sub_ps(_mm_mul_ps(y, x), _mm_set1_ps(1.2420140846e-1f));
+  y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(1.4249322787e-1f));
+  y = _mm_sub_ps(_mm_mul_ps(y, x), _mm_set1_ps(1.6668057665e-1f));
+  y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(2.0000714765e-1f));
+  y = _mm_sub_ps(_mm_mul_ps(y, x), _mm_set1_ps(2.4999993993e-1f));
+  y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(3.3333331174e-1f));
+  y = _mm_mul_ps(_mm_mul_ps(y, x), z);
+  y = _mm_add_ps(y, _mm_mul_ps(e, _mm_set1_ps(-2.12194440e-4f)));
+  y = _mm_sub_ps(y, _mm_mul_ps(_mm_set1_ps(0.5f), z));
+  return _mm_add_ps(_mm_add_ps(x, y), _mm_mul_ps(e, _mm_set1_ps(0.693359375f)));
+}
+
+inline void sincos_poly(__m128 x, __m128 &s, __m128 &c) {
+  __m128 z = _mm_mul_ps(x, x);
+  __m128 ps = _mm_set1_ps(-1.9515295891e-4f);
+  ps = _mm_add_ps(_mm_mul_ps(ps, z), _mm_set1_ps(8.3321608736e-3f));
+  ps = _mm_sub_ps(_mm_mul_ps(ps, z), _mm_set1_ps(1.6666654611e-1f));
+  s = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(ps, z), x), x);
+  __m128 pc = _mm_set1_ps(2.443315711809948e-5f);
+  pc = _mm_sub_ps(_mm_mul_ps(pc, z), _mm_set1_ps(1.388731625493765e-3f));
+  pc = _mm_add_ps(_mm_mul_ps(pc, z), _mm_set1_ps(4.166664568298827e-2f));
+  c = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(_mm_mul_ps(pc, z), z), _mm_mul_ps(_mm_set1_ps(0.5f), z)),
+                 _mm_set1_ps(1.0f));
+}
+
+inline void box_muller(__m128i a, __m128i b, __m128 &z0, __m128 &z1) {
+  __m128 u = _mm_mul_ps(_mm_cvtepi32_ps(_mm_add_epi32(_mm_srli_epi32(a, 8), _mm_set1_epi32(1))),
+                        _mm_set1_ps(1.0f / (1 << 24)));
+  __m128 r = _mm_sqrt_ps(_mm_mul_ps(_mm_set1_ps(-2.0f), log_poly(u)));
+  __m128i frac = _mm_and_si128(_mm_srli_epi32(b, 8), _mm_set1_epi32(0x3FFFFF));
+  __m128 t = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(frac),
+                                              _mm_set1_ps(1.0f / (1 << 22))),
+                                   _mm_set1_ps(0.5f)),
+                        _mm_set1_ps(1.57079632679489662f));
+  __m128 s, c;
+  sincos_poly(t, s, c);
+  __m128 swap = _mm_castsi128_ps(_mm_srai_epi32(_mm_slli_epi32(b, 1), 31));
+  __m128 s2 = _mm_or_ps(_mm_and_ps(swap, c), _mm_andnot_ps(swap, s));
+  __m128 c2 = _mm_or_ps(_mm_and_ps(swap, s), _mm_andnot_ps(swap, c));
+  const __m128i sign = _mm_set1_epi32(0x80000000);
+  __m128 sign_c = _mm_castsi128_ps(_mm_and_si128(_mm_xor_si128(b, _mm_slli_epi32(b, 1)), sign));
+  __m128 sign_s = _mm_castsi128_ps(_mm_and_si128(b, sign));
+  z0 = _mm_mul_ps(r, _mm_xor_ps(c2, sign_c));
+  z1 = _mm_mul_ps(r, _mm_xor_ps(s2, sign_s));
+}
+
+#endif
+
+}  // namespace philox_detail
+
+/**
+ * @brief Fills `out` with `n` values uniformly distributed in [lo, hi)
+ *
+ * Consumes exactly one 32-bit value per output.
+ */
+inline void uniform_fill(float *out, int64_t n, Philox4x32_10 &rng, float lo, float hi) {
+  using namespace philox_detail;  // NOLINT
+  uint32_t raw[kBatch];
+  float scale = (hi - lo) * (1.0f / (1 << 24));
+  float max_val = std::nextafter(hi, lo);
+  while (n > 0) {
+    int count = std::min<int64_t>(n, kBatch);
+    rng.fill(raw, count);
+    int i = 0;
+#ifdef DALI_PHILOX_SSE2
+    __m128 vlo = _mm_set1_ps(lo), vscale = _mm_set1_ps(scale), vmax = _mm_set1_ps(max_val);
+    for (; i + 4 <= count; i += 4) {
+      __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(raw + i));
+      __m128 u = _mm_cvtepi32_ps(_mm_srli_epi32(x, 8));
+      _mm_storeu_ps(out + i, _mm_min_ps(_mm_add_ps(_mm_mul_ps(u, vscale), vlo), vmax));
+    }
+#endif
+    for (; i < count; i++)
+      out[i] = std::min((raw[i] >> 8) * scale + lo, max_val);
+    out += count;
+    n -= count;
+  }
+}
+
+/**
+ * @brief Fills `out` with `n` normally distributed values
+ *
+ * Consumes two 32-bit values per pair of outputs (rounded up).
+ */
+inline void normal_fill(float *out, int64_t n, Philox4x32_10 &rng, float mean, float stddev) {
+  using namespace philox_detail;  // NOLINT
+  uint32_t raw[kBatch];
+  while (n > 0) {
+    int count = std::min<int64_t>(n, kBatch);
+    int npairs = (count + 1) >> 1;
+    rng.fill(raw, 2 * npairs);
+    int i = 0;
+#ifdef DALI_PHILOX_SSE2
+    __m128 vmean = _mm_set1_ps(mean), vstddev = _mm_set1_ps(stddev);
+    for (; i + 8 <= count; i += 8) {
+      // a = raw[i], raw[i+2], ...; b = raw[i+1], raw[i+3], ...
+      __m128 v0 = _mm_loadu_ps(reinterpret_cast<const float *>(raw + i));
+      __m128 v1 = _mm_loadu_ps(reinterpret_cast<const float *>(raw + i + 4));
+      __m128i a = _mm_castps_si128(_mm_shuffle_ps(v0, v1, _MM_SHUFFLE(2, 0, 2, 0)));
+      __m128i b = _mm_castps_si128(_mm_shuffle_ps(v0, v1, _MM_SHUFFLE(3, 1, 3, 1)));
+      __m128 z0, z1;
+      box_muller(a, b, z0, z1);
+      z0 = _mm_add_ps(_mm_mul_ps(z0, vstddev), vmean);
+      z1 = _mm_add_ps(_mm_mul_ps(z1, vstddev), vmean);
+      _mm_storeu_ps(out + i, _mm_unpacklo_ps(z0, z1));
+      _mm_storeu_ps(out + i + 4, _mm_unpackhi_ps(z0, z1));
+    }
+#endif
+    for (; i < count; i += 2) {
+      float z0, z1;
+      box_muller(raw[i], raw[i + 1], z0, z1);
+      out[i] = z0 * stddev + mean;
+      if (i + 1 < count)
+        out[i + 1] = z1 * stddev + mean;
+    }
+    out += count;
+    n -= count;
+  }
+}
+
+}  // namespace dali
+
+#endif  // DALI_CORE_PHILOX_H_